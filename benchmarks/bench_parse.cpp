@@ -0,0 +1,101 @@
+/**
+ * @file bench_parse.cpp
+ * @brief Throughput of 81-character grid parsing
+ *
+ * Compares the SIMD kernel, the scalar kernel and the general-purpose
+ * parseSimpleGrid on a synthetic line-per-puzzle corpus.
+ *
+ * Usage:
+ *   bench_parse [num_lines]
+ */
+
+#include "SudokuGridScan.h"
+#include "SudokuParser.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace sudoku;
+
+template <class Fn>
+void report(const char *name, size_t numLines, Fn &&fn)
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    long long checksum = fn();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    double bytes = static_cast<double>(numLines) * 82;
+    std::cout << std::setw(18) << name
+              << std::setw(12) << bytes / seconds / 1e9 << " GB/s"
+              << std::setw(12) << numLines / seconds / 1e6 << " M lines/s"
+              << "   (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numLines = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    // Corpus laid out as in a file: 81 characters and a newline per puzzle
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> dist(0, 9);
+    std::string corpus(numLines * 82, '\n');
+    for (size_t i = 0; i < numLines; i++)
+    {
+        for (int j = 0; j < 81; j++)
+        {
+            int v = dist(rng);
+            corpus[i * 82 + j] = v == 0 ? '.' : static_cast<char>('0' + v);
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Parsing " << numLines << " lines, kernel: " << gridscan::kernelName() << "\n\n";
+
+    uint8_t cells[81];
+    report("scanGrid81", numLines, [&]()
+           {
+               long long sum = 0;
+               for (size_t i = 0; i < numLines; i++)
+               {
+                   sum += gridscan::scanGrid81(corpus.data() + i * 82, cells);
+                   sum += cells[i % 81];
+               }
+               return sum; });
+
+    report("scanGrid81Scalar", numLines, [&]()
+           {
+               long long sum = 0;
+               for (size_t i = 0; i < numLines; i++)
+               {
+                   sum += gridscan::scanGrid81Scalar(corpus.data() + i * 82, cells);
+                   sum += cells[i % 81];
+               }
+               return sum; });
+
+    SudokuPuzzle puzzle;
+    report("parseCompactGrid", numLines, [&]()
+           {
+               long long sum = 0;
+               for (size_t i = 0; i < numLines; i++)
+               {
+                   sum += SudokuParser::parseCompactGrid(std::string_view(corpus.data() + i * 82, 81), puzzle);
+                   sum += puzzle.grid[0][i % 9];
+               }
+               return sum; });
+
+    size_t slowLines = std::min<size_t>(numLines, 100000);
+    report("parseFromString", slowLines, [&]()
+           {
+               long long sum = 0;
+               for (size_t i = 0; i < slowLines; i++)
+               {
+                   // Leading space forces the general-purpose path
+                   sum += SudokuParser::parseFromString(" " + corpus.substr(i * 82, 81)).grid[0][i % 9];
+               }
+               return sum; });
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file bench_scaling.cpp
+ * @brief Scaling benchmark across grid geometries
+ *
+ * For each geometry, builds puzzles by clearing a fraction of the cells of a
+ * solved grid and reports encoding size and solve / uniqueness times.
+ *
+ * Usage:
+ *   bench_scaling [puzzles_per_geometry] [clear_ratio]
+ */
+
+#include "SudokuSolver.h"
+#include "SudokuParser.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+using namespace sudoku;
+
+template <class Geo>
+void runGeometry(int numPuzzles, double clearRatio)
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    BasicSudokuSolver<Geo> solver;
+    std::mt19937 rng(12345);
+
+    BasicSudokuPuzzle<Geo> empty;
+    auto start = Clock::now();
+    auto full = solver.solve(empty);
+    double emptyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (!full.solved)
+    {
+        std::cout << Geo::GRID_SIZE << "x" << Geo::GRID_SIZE << ": failed to solve empty grid\n";
+        return;
+    }
+
+    std::vector<int> cells(Geo::NUM_CELLS);
+    for (int i = 0; i < Geo::NUM_CELLS; i++)
+    {
+        cells[i] = i;
+    }
+    int toClear = static_cast<int>(Geo::NUM_CELLS * clearRatio);
+
+    double solveMs = 0.0;
+    double uniqueMs = 0.0;
+    double maxMs = 0.0;
+    int unique = 0;
+    int variables = 0;
+    int clauses = 0;
+
+    for (int n = 0; n < numPuzzles; n++)
+    {
+        BasicSudokuPuzzle<Geo> puzzle;
+        std::copy(&full.grid[0][0], &full.grid[0][0] + Geo::NUM_CELLS, &puzzle.grid[0][0]);
+        std::shuffle(cells.begin(), cells.end(), rng);
+        for (int i = 0; i < toClear; i++)
+        {
+            puzzle.grid[cells[i] / Geo::GRID_SIZE][cells[i] % Geo::GRID_SIZE] = EMPTY_CELL;
+        }
+
+        auto solution = solver.solve(puzzle);
+        solveMs += solution.solveTimeMs;
+        variables = solver.getNumVariables();
+        clauses = solver.getNumClauses();
+
+        auto checked = solver.solve(puzzle, true);
+        uniqueMs += checked.solveTimeMs;
+        maxMs = std::max(maxMs, checked.solveTimeMs);
+        if (checked.isUnique())
+            unique++;
+    }
+
+    std::cout << std::setw(5) << (std::to_string(Geo::GRID_SIZE) + "x" + std::to_string(Geo::GRID_SIZE))
+              << std::setw(5) << (std::to_string(Geo::BOX_ROWS) + "x" + std::to_string(Geo::BOX_COLS))
+              << std::setw(10) << variables
+              << std::setw(11) << clauses
+              << std::setw(12) << emptyMs
+              << std::setw(12) << solveMs / numPuzzles
+              << std::setw(12) << uniqueMs / numPuzzles
+              << std::setw(12) << maxMs
+              << std::setw(8) << unique << "/" << numPuzzles << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+    int numPuzzles = argc > 1 ? std::stoi(argv[1]) : 20;
+    double clearRatio = argc > 2 ? std::stod(argv[2]) : 0.5;
+
+    std::cout << "Scaling benchmark: " << numPuzzles << " puzzles per geometry, "
+              << static_cast<int>(clearRatio * 100) << "% of cells cleared\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::setw(5) << "grid" << std::setw(5) << "box"
+              << std::setw(10) << "vars" << std::setw(11) << "clauses"
+              << std::setw(12) << "empty ms" << std::setw(12) << "solve ms"
+              << std::setw(12) << "unique ms" << std::setw(12) << "max ms"
+              << std::setw(10) << "unique" << "\n";
+
+    runGeometry<Geometry4x4>(numPuzzles, clearRatio);
+    runGeometry<Geometry6x6>(numPuzzles, clearRatio);
+    runGeometry<Geometry8x8>(numPuzzles, clearRatio);
+    runGeometry<Geometry9x9>(numPuzzles, clearRatio);
+    runGeometry<Geometry12x12>(numPuzzles, clearRatio);
+    runGeometry<Geometry16x16>(numPuzzles, clearRatio);
+    runGeometry<Geometry25x25>(numPuzzles, clearRatio);
+
+    return 0;
+}
@@ -0,0 +1,311 @@
+/**
+ * @file sudoku_load.cpp
+ * @brief Load generator for sudoku_solve --daemon
+ *
+ * Opens several concurrent connections, keeps a window of pipelined requests
+ * outstanding on each, and reports throughput, latency percentiles and error
+ * counts. Puzzles come from a file of 81-character lines, or are generated
+ * up front.
+ *
+ * Usage:
+ *   sudoku_load (--socket <path> | --port <N>) [--clients N] [--requests N]
+ *               [--window N] [--file puzzles.txt] [--op solve|unique|generate]
+ *               [--deadline ms] [--distinct N]
+ */
+
+#include "SudokuGenerator.h"
+#include "SudokuJson.h"
+#include "SudokuWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace sudoku;
+using Clock = std::chrono::steady_clock;
+
+struct LoadConfig
+{
+    std::string socketPath;
+    int port = -1;
+    int clients = 4;
+    size_t requests = 1000; // Per client
+    size_t window = 16;     // Outstanding requests per client
+    std::string op = "solve";
+    double deadlineMs = 0;
+};
+
+struct ClientResult
+{
+    std::vector<double> latenciesMs;
+    size_t overloaded = 0;
+    size_t expired = 0;
+    size_t errors = 0;
+};
+
+int connectTo(const LoadConfig &config)
+{
+    int fd;
+    if (!config.socketPath.empty())
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, config.socketPath.c_str(), sizeof(address.sun_path) - 1);
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+            throw std::runtime_error("cannot connect to " + config.socketPath + ": " + std::strerror(errno));
+    }
+    else
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(config.port));
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+            throw std::runtime_error("cannot connect to port " + std::to_string(config.port) + ": " + std::strerror(errno));
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return fd;
+}
+
+std::string makeRequest(const LoadConfig &config, size_t id, const std::string &puzzle)
+{
+    std::string request = "{\"id\":";
+    SudokuWriter::appendInt(request, static_cast<long long>(id));
+    request += ",\"op\":\"" + config.op + "\"";
+    if (config.op == "generate")
+    {
+        request += ",\"type\":\"standard\",\"unique\":false,\"seed\":";
+        SudokuWriter::appendInt(request, static_cast<long long>(id));
+    }
+    else
+    {
+        request += ",\"puzzle\":\"" + puzzle + "\"";
+    }
+    if (config.deadlineMs > 0)
+    {
+        request += ",\"deadlineMs\":";
+        SudokuWriter::appendGeneral(request, config.deadlineMs);
+    }
+    request += "}\n";
+    return request;
+}
+
+void runClient(const LoadConfig &config, const std::vector<std::string> &puzzles, size_t offset, ClientResult &result)
+{
+    int fd = connectTo(config);
+    std::vector<Clock::time_point> sentAt(config.requests);
+    size_t sent = 0;
+    size_t received = 0;
+    std::string buffer;
+    char chunk[64 * 1024];
+
+    while (received < config.requests)
+    {
+        // Top the window up with one write
+        std::string batch;
+        while (sent < config.requests && sent - received < config.window)
+        {
+            batch += makeRequest(config, sent, puzzles[(offset + sent) % puzzles.size()]);
+            sentAt[sent++] = Clock::now();
+        }
+        if (!batch.empty() && ::send(fd, batch.data(), batch.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(batch.size()))
+            throw std::runtime_error("send failed");
+
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+            throw std::runtime_error("daemon closed the connection");
+        buffer.append(chunk, static_cast<size_t>(n));
+
+        size_t start = 0;
+        size_t end;
+        while ((end = buffer.find('\n', start)) != std::string::npos)
+        {
+            std::string_view line(buffer.data() + start, end - start);
+            start = end + 1;
+
+            long long id = -1;
+            std::string error;
+            json::forEachMember(line, [&](std::string_view key, std::string_view value)
+                                {
+                if (key == "id")
+                    id = json::parseInt(value);
+                else if (key == "error")
+                    error = json::decodeString(value); });
+            if (id < 0 || static_cast<size_t>(id) >= config.requests)
+                throw std::runtime_error("response without a valid id: " + std::string(line));
+
+            result.latenciesMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - sentAt[id]).count());
+            if (error == "overloaded")
+                result.overloaded++;
+            else if (error == "deadline exceeded")
+                result.expired++;
+            else if (!error.empty())
+                result.errors++;
+            received++;
+        }
+        buffer.erase(0, start);
+    }
+    ::close(fd);
+}
+
+int main(int argc, char *argv[])
+{
+    LoadConfig config;
+    std::string puzzleFile;
+    size_t distinct = 64;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--socket" && hasValue)
+            config.socketPath = argv[++i];
+        else if (arg == "--port" && hasValue)
+            config.port = std::stoi(argv[++i]);
+        else if (arg == "--clients" && hasValue)
+            config.clients = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--requests" && hasValue)
+            config.requests = std::stoul(argv[++i]);
+        else if (arg == "--window" && hasValue)
+            config.window = std::max<size_t>(1, std::stoul(argv[++i]));
+        else if (arg == "--file" && hasValue)
+            puzzleFile = argv[++i];
+        else if (arg == "--op" && hasValue)
+            config.op = argv[++i];
+        else if (arg == "--deadline" && hasValue)
+            config.deadlineMs = std::stod(argv[++i]);
+        else if (arg == "--distinct" && hasValue)
+            distinct = std::max<size_t>(1, std::stoul(argv[++i]));
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " (--socket <path> | --port <N>) [--clients N] [--requests N]\n"
+                      << "       [--window N] [--file puzzles.txt] [--op solve|unique|generate]\n"
+                      << "       [--deadline ms] [--distinct N]\n";
+            return 1;
+        }
+    }
+    if (config.socketPath.empty() && config.port < 0)
+    {
+        std::cerr << "Error: --socket or --port is required\n";
+        return 1;
+    }
+
+    // Fewer distinct puzzles than requests exercises the daemon's coalescing
+    std::vector<std::string> puzzles;
+    if (!puzzleFile.empty())
+    {
+        std::ifstream in(puzzleFile);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.size() >= 81)
+                puzzles.push_back(line.substr(0, 81));
+        }
+    }
+    else
+    {
+        SudokuGenerator generator;
+        GeneratorConfig gen;
+        gen.type = SudokuType::STANDARD;
+        gen.minCages = gen.maxCages = 0;
+        gen.minInequalities = gen.maxInequalities = 0;
+        gen.minGivens = 17;
+        gen.maxGivens = 30;
+        gen.ensureUniqueSolution = false;
+        for (size_t i = 0; i < distinct; i++)
+        {
+            gen.seed = static_cast<unsigned int>(i + 1);
+            std::string line;
+            SudokuWriter::appendGridLine(line, generator.generate(gen).grid);
+            puzzles.push_back(line);
+        }
+    }
+    if (puzzles.empty())
+    {
+        std::cerr << "Error: no puzzles\n";
+        return 1;
+    }
+
+    std::vector<ClientResult> results(config.clients);
+    std::vector<std::thread> threads;
+    std::mutex errorMutex;
+    std::string failure;
+
+    auto start = Clock::now();
+    for (int c = 0; c < config.clients; c++)
+    {
+        threads.emplace_back([&, c]()
+                             {
+                                 try
+                                 {
+                                     runClient(config, puzzles, static_cast<size_t>(c) * 7, results[c]);
+                                 }
+                                 catch (const std::exception &e)
+                                 {
+                                     std::lock_guard<std::mutex> lock(errorMutex);
+                                     failure = e.what();
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (!failure.empty())
+    {
+        std::cerr << "Error: " << failure << "\n";
+        return 1;
+    }
+
+    std::vector<double> latencies;
+    ClientResult total;
+    for (const auto &result : results)
+    {
+        latencies.insert(latencies.end(), result.latenciesMs.begin(), result.latenciesMs.end());
+        total.overloaded += result.overloaded;
+        total.expired += result.expired;
+        total.errors += result.errors;
+    }
+    if (latencies.empty())
+    {
+        std::cerr << "Error: no requests sent\n";
+        return 1;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p)
+    {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Requests:    " << latencies.size() << " (" << config.clients << " clients, window "
+              << config.window << ", " << puzzles.size() << " distinct puzzles)\n";
+    std::cout << "Time:        " << seconds << " s\n";
+    std::cout << "Throughput:  " << std::setprecision(1) << latencies.size() / seconds << " requests/s\n";
+    std::cout << std::setprecision(3);
+    std::cout << "Latency ms:  p50 " << percentile(0.50) << "  p90 " << percentile(0.90)
+              << "  p99 " << percentile(0.99) << "  max " << latencies.back() << "\n";
+    std::cout << "Overloaded:  " << total.overloaded << "\n";
+    std::cout << "Expired:     " << total.expired << "\n";
+    std::cout << "Errors:      " << total.errors << "\n";
+    return total.errors == 0 ? 0 : 1;
+}
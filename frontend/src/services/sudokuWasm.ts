@@ -1,28 +1,70 @@
 // WASM Service - 封装 Worker 调用
-import type { SolveResult, PuzzleType } from '@/types/sudoku'
+import { cageColors } from '@/types/sudoku'
+import type { GeneratedPuzzle, GenerationProgress, SolveResult, SudokuPuzzle, PuzzleType } from '@/types/sudoku'
 
 interface WorkerMessage {
   id: string
-  type: 'solve' | 'generate' | 'init'
+  type: 'solve' | 'generate' | 'prefetch' | 'init'
   payload?: any
 }
 
+interface GenerateOptions {
+  type?: PuzzleType
+  minCages?: number
+  maxCages?: number
+  minInequalities?: number
+  maxInequalities?: number
+  seed?: number
+  fillAllCells?: boolean
+  ensureUniqueSolution?: boolean
+  difficulty?: number
+}
+
 interface WorkerResponse {
   id: string
+  type?: 'progress'
   success: boolean
   data?: any
   error?: string
 }
 
+// 复制为普通对象：Vue 响应式代理无法通过 postMessage 传递
+function toPlainPuzzle(puzzle: SudokuPuzzle): SudokuPuzzle {
+  return {
+    grid: puzzle.grid.map((row) => [...row]),
+    cages: puzzle.cages.map((cage) => ({
+      sum: cage.sum,
+      cells: cage.cells.map(({ row, col }) => ({ row, col }))
+    })),
+    inequalities: puzzle.inequalities.map((ineq) => ({
+      cell1: { row: ineq.cell1.row, col: ineq.cell1.col },
+      cell2: { row: ineq.cell2.row, col: ineq.cell2.col },
+      type: ineq.type
+    }))
+  }
+}
+
 class SudokuWasmService {
   private worker: Worker | null = null
   private pendingRequests = new Map<string, {
     resolve: (value: any) => void
     reject: (reason: any) => void
+    onProgress?: (progress: any) => void
   }>()
   private initPromise: Promise<void> | null = null
   private isReady = false
 
+  // 取消生成：跨源隔离时通过共享标志通知 Worker (槽 0 = 要取消的票号)，
+  // 否则只能终止 Worker，下次调用时重新创建。
+  // 槽 1 计数已发出的用户请求，Worker 据此让它们抢占正在进行的预取
+  private cancelSlots: Int32Array | null = null
+  private generationTicket = 0
+  private activeGeneration = 0
+
+  // 已请求预取的参数；Worker 被终止重建后，在下一个用户请求之后重新发送
+  private prefetchOptions = new Map<string, GenerateOptions>()
+  private prefetchLost = false
+
   // 生成唯一 ID
   private generateId(): string {
     return `${Date.now()}-${Math.random().toString(36).substr(2, 9)}`
@@ -42,8 +84,13 @@ class SudokuWasmService {
         )
 
         this.worker.onmessage = (event: MessageEvent<WorkerResponse>) => {
-          const { id, success, data, error } = event.data
+          const { id, type, success, data, error } = event.data
           const pending = this.pendingRequests.get(id)
+
+          if (type === 'progress') {
+            pending?.onProgress?.(data)
+            return
+          }
           
           if (pending) {
             this.pendingRequests.delete(id)
@@ -70,7 +117,14 @@ class SudokuWasmService {
           reject
         })
         
-        this.worker.postMessage({ id, type: 'init' } as WorkerMessage)
+        if (typeof SharedArrayBuffer !== 'undefined' && self.crossOriginIsolated) {
+          this.cancelSlots = new Int32Array(new SharedArrayBuffer(8))
+        }
+        this.worker.postMessage({
+          id,
+          type: 'init',
+          payload: { cancelBuffer: this.cancelSlots?.buffer }
+        } as WorkerMessage)
       } catch (err) {
         reject(err)
       }
@@ -80,7 +134,7 @@ class SudokuWasmService {
   }
 
   // 发送消息到 Worker
-  private sendMessage<T>(type: string, payload?: any): Promise<T> {
+  private sendMessage<T>(type: string, payload?: any, onProgress?: (progress: any) => void): Promise<T> {
     return new Promise((resolve, reject) => {
       if (!this.worker) {
         reject(new Error('Worker not initialized'))
@@ -88,33 +142,76 @@ class SudokuWasmService {
       }
 
       const id = this.generateId()
-      this.pendingRequests.set(id, { resolve, reject })
+      this.pendingRequests.set(id, { resolve, reject, onProgress })
       
       this.worker.postMessage({ id, type, payload } as WorkerMessage)
     })
   }
 
-  // 求解数独
-  async solve(puzzleStr: string, checkUniqueness = false): Promise<SolveResult> {
+  // 发送用户请求 (求解/生成)：先通知 Worker 让出预取，
+  // 再补发因终止 Worker 而丢失的预取，使其排在这个请求之后
+  private sendUserRequest<T>(type: string, payload?: any, onProgress?: (progress: any) => void): Promise<T> {
+    if (this.cancelSlots) {
+      Atomics.add(this.cancelSlots, 1, 1)
+    }
+    const result = this.sendMessage<T>(type, payload, onProgress)
+    if (this.prefetchLost) {
+      this.prefetchLost = false
+      for (const options of this.prefetchOptions.values()) {
+        this.sendMessage('prefetch', options).catch((err) => console.warn('Prefetch failed:', err))
+      }
+    }
+    return result
+  }
+
+  // 求解数独 (谜题以类型化数组传入 WASM，无需文本序列化)
+  async solve(puzzle: SudokuPuzzle, checkUniqueness = false): Promise<SolveResult> {
+    await this.init()
+    return this.sendUserRequest('solve', { puzzle: toPlainPuzzle(puzzle), checkUniqueness })
+  }
+
+  // 生成数独；随机生成 (无 seed) 优先取用 Worker 预取的谜题
+  async generate(
+    options: GenerateOptions = {},
+    onProgress?: (progress: GenerationProgress) => void
+  ): Promise<GeneratedPuzzle> {
     await this.init()
-    return this.sendMessage('solve', { puzzleStr, checkUniqueness })
+    const ticket = ++this.generationTicket
+    this.activeGeneration = ticket
+    let generated: GeneratedPuzzle
+    try {
+      generated = await this.sendUserRequest<GeneratedPuzzle>('generate', { ...options, ticket }, onProgress)
+    } finally {
+      if (this.activeGeneration === ticket) {
+        this.activeGeneration = 0
+      }
+    }
+    // 笼子配色只在主线程使用，不经过 Worker
+    generated.puzzle.cages.forEach((cage, i) => {
+      cage.color = cageColors[i % cageColors.length]
+    })
+    return generated
   }
 
-  // 生成数独
-  async generate(options: {
-    type?: PuzzleType
-    minCages?: number
-    maxCages?: number
-    minInequalities?: number
-    maxInequalities?: number
-    seed?: number
-    includeSolution?: boolean
-    fillAllCells?: boolean
-    ensureUniqueSolution?: boolean
-    difficulty?: number
-  } = {}): Promise<string> {
+  // 让 Worker 在空闲时为这组参数预先生成几道谜题
+  async prefetch(options: GenerateOptions = {}): Promise<void> {
+    this.prefetchOptions.set(JSON.stringify(options), options)
     await this.init()
-    return this.sendMessage('generate', options)
+    await this.sendMessage('prefetch', options)
+  }
+
+  // 取消正在进行的生成；generate() 以 'Generation cancelled' 错误结束
+  cancelGeneration() {
+    if (!this.activeGeneration) return
+    if (this.cancelSlots) {
+      Atomics.store(this.cancelSlots, 0, this.activeGeneration)
+      return
+    }
+    const pending = [...this.pendingRequests.values()]
+    this.destroy()
+    pending.forEach(({ reject }) => reject(new Error('Generation cancelled')))
+    // 立即重发会让新 Worker 忙于预取；留到下一个用户请求之后
+    this.prefetchLost = this.prefetchOptions.size > 0
   }
 
   // 检查是否就绪
@@ -129,6 +226,7 @@ class SudokuWasmService {
       this.worker = null
       this.isReady = false
       this.initPromise = null
+      this.cancelSlots = null
       this.pendingRequests.clear()
     }
   }
@@ -33,6 +33,20 @@ export interface SolveResult {
   error?: string;
 }
 
+export interface GeneratedPuzzle {
+  puzzle: SudokuPuzzle;
+  solution: number[][];
+}
+
+// 生成进度：阶段与已完成/最多剩余的求解次数
+export type GenerationPhase = "fill" | "uniqueness" | "minimize";
+
+export interface GenerationProgress {
+  phase: GenerationPhase;
+  trialsDone: number;
+  trialsRemaining: number;
+}
+
 export type PuzzleType = "standard" | "killer" | "inequality" | "mixed";
 
 // 笼子颜色方案
@@ -1,14 +1,26 @@
 // Web Worker for WASM operations
 // 在 Worker 中运行 WASM 以避免阻塞主线程
+// 谜题与解答通过 WASM 内存中的类型化数组 (getBuffers) 交换，不经过文本序列化
+
+import type {
+  Cage,
+  GeneratedPuzzle,
+  GenerationPhase,
+  GenerationProgress,
+  Inequality,
+  SolveResult,
+  SudokuPuzzle
+} from '../types/sudoku'
 
 interface WorkerMessage {
   id: string
-  type: 'solve' | 'generate' | 'init'
+  type: 'solve' | 'generate' | 'prefetch' | 'init'
   payload?: any
 }
 
 interface WorkerResponse {
   id: string
+  type?: 'progress'
   success: boolean
   data?: any
   error?: string
@@ -16,9 +28,137 @@ interface WorkerResponse {
 
 declare function createSudokuModule(options?: any): Promise<any>
 
+// 一道谜题的类型化数组，布局见 src/wasm_bindings.cpp (generateBatch 的元素也是这一格式)
+interface PuzzleArrays {
+  grid: Uint8Array
+  solution: Uint8Array
+  cages: Int32Array
+  inequalities: Int32Array
+}
+
+// WASM 内存中的交换缓冲区
+interface WasmBuffers extends PuzzleArrays {
+  stats: Float64Array
+}
+
+// 生成参数，字段名与 generateBatch 的 options 一致
+interface GenerateOptions {
+  type: string
+  minCages: number
+  maxCages: number
+  minInequalities: number
+  maxInequalities: number
+  seed: number
+  fillAllCells: boolean
+  ensureUniqueSolution: boolean
+  difficulty: number
+}
+
+const GRID_SIZE = 9
+
+// 与 wasm_bindings.cpp 中的 TypedStatus 一致
+const STATUS_CANCELLED = -2
+const STATUS_ERROR = -1
+const STATUS_UNSOLVED = 0
+const STATUS_UNIQUE = 2
+const STATUS_NOT_UNIQUE = 3
+
+// 与 wasm_bindings.cpp 中的 StatsSlot 一致
+const STATS_SOLVE_MS = 0
+const STATS_VARIABLES = 4
+const STATS_CLAUSES = 5
+
 let wasmModule: any = null
 let initPromise: Promise<void> | null = null
 
+// 与 GenerationPhase (SudokuGenerator.h) 的顺序一致
+const PHASES: GenerationPhase[] = ['fill', 'uniqueness', 'minimize']
+
+// 主线程共享的取消标志 (SharedArrayBuffer，仅跨源隔离时可用)：
+// 槽 0 写入要取消的生成票号，槽 1 为主线程已发出的用户请求 (求解/生成) 数。
+// 生成期间 Worker 无法处理消息，只能由进度回调轮询
+let cancelSlots: Int32Array | null = null
+const SLOT_CANCEL_TICKET = 0
+const SLOT_USER_REQUESTS = 1
+
+// 已收到的用户请求数；少于槽 1 说明有用户请求在排队
+let userRequestsSeen = 0
+
+function userRequestWaiting(): boolean {
+  return cancelSlots !== null && Atomics.load(cancelSlots, SLOT_USER_REQUESTS) !== userRequestsSeen
+}
+
+// 每次调用前重新获取视图：WASM 内存增长后旧视图会失效
+function getBuffers(): WasmBuffers {
+  return wasmModule.getBuffers() as WasmBuffers
+}
+
+function cellIndex(row: number, col: number): number {
+  return row * GRID_SIZE + col
+}
+
+function readGrid(view: Uint8Array): number[][] {
+  const grid: number[][] = []
+  for (let row = 0; row < GRID_SIZE; row++) {
+    grid.push(Array.from(view.subarray(row * GRID_SIZE, (row + 1) * GRID_SIZE)))
+  }
+  return grid
+}
+
+function writePuzzle(buffers: WasmBuffers, puzzle: SudokuPuzzle) {
+  for (let row = 0; row < GRID_SIZE; row++) {
+    for (let col = 0; col < GRID_SIZE; col++) {
+      buffers.grid[cellIndex(row, col)] = puzzle.grid[row]?.[col] ?? 0
+    }
+  }
+
+  const cages = buffers.cages
+  let pos = 1
+  for (const cage of puzzle.cages) {
+    cages[pos++] = cage.sum
+    cages[pos++] = cage.cells.length
+    for (const cell of cage.cells) {
+      cages[pos++] = cellIndex(cell.row, cell.col)
+    }
+  }
+  cages[0] = puzzle.cages.length
+
+  const inequalities = buffers.inequalities
+  inequalities[0] = puzzle.inequalities.length
+  puzzle.inequalities.forEach((ineq, i) => {
+    inequalities[1 + 3 * i] = cellIndex(ineq.cell1.row, ineq.cell1.col)
+    inequalities[2 + 3 * i] = cellIndex(ineq.cell2.row, ineq.cell2.col)
+    inequalities[3 + 3 * i] = ineq.type === '>' ? 1 : -1
+  })
+}
+
+function readPuzzle(buffers: PuzzleArrays): SudokuPuzzle {
+  const toCell = (index: number) => ({ row: Math.floor(index / GRID_SIZE), col: index % GRID_SIZE })
+
+  const cages: Cage[] = []
+  const cageInts = buffers.cages
+  let pos = 1
+  for (let n = 0; n < cageInts[0]!; n++) {
+    const sum = cageInts[pos++]!
+    const size = cageInts[pos++]!
+    const cells = Array.from(cageInts.subarray(pos, pos + size), toCell)
+    pos += size
+    cages.push({ sum, cells })
+  }
+
+  const inequalities: Inequality[] = []
+  const ineqInts = buffers.inequalities
+  for (let n = 0; n < ineqInts[0]!; n++) {
+    inequalities.push({
+      cell1: toCell(ineqInts[1 + 3 * n]!),
+      cell2: toCell(ineqInts[2 + 3 * n]!),
+      type: ineqInts[3 + 3 * n]! > 0 ? '>' : '<'
+    })
+  }
+
+  return { grid: readGrid(buffers.grid), cages, inequalities }
+}
+
 // 获取基础路径
 function getBasePath(): string {
   // 从 Worker 的 location 获取基础路径
@@ -35,6 +175,53 @@ function getBasePath(): string {
   return url.origin + '/Sudoku-Solver/'
 }
 
+function normalizeOptions(payload: any): GenerateOptions {
+  return {
+    type: payload.type || 'mixed',
+    minCages: payload.minCages || 12,
+    maxCages: payload.maxCages || 18,
+    minInequalities: payload.minInequalities || 15,
+    maxInequalities: payload.maxInequalities || 25,
+    seed: payload.seed || 0,
+    fillAllCells: payload.fillAllCells || false,
+    ensureUniqueSolution: payload.ensureUniqueSolution || true,
+    difficulty: payload.difficulty || 50
+  }
+}
+
+// 多线程模块 (sudoku_wasm_mt) 依赖 SharedArrayBuffer，只有跨源隔离
+// (COOP/COEP 响应头) 的页面才可用；否则使用单线程模块
+function canUseThreads(): boolean {
+  return typeof SharedArrayBuffer !== 'undefined' && (self as any).crossOriginIsolated === true
+}
+
+// 加载一个 WASM 模块；name 为不带扩展名的文件名
+async function loadModule(basePath: string, name: string): Promise<any> {
+  const wasmJsUrl = basePath + 'wasm/' + name + '.js'
+  const wasmBinaryUrl = basePath + 'wasm/' + name + '.wasm'
+
+  console.log('Loading WASM from:', wasmJsUrl)
+
+  // 使用 importScripts 加载 WASM JS glue code
+  // @ts-ignore - importScripts 只在 Worker 环境中可用
+  importScripts(wasmJsUrl)
+
+  // @ts-ignore - createSudokuModule 由上面的脚本定义
+  if (typeof createSudokuModule !== 'function') {
+    throw new Error('createSudokuModule not found after loading script')
+  }
+  // 配置 WASM 文件位置；pthread 工作线程需要重新加载同一个 glue 脚本
+  return createSudokuModule({
+    mainScriptUrlOrBlob: wasmJsUrl,
+    locateFile: (path: string) => {
+      if (path.endsWith('.wasm')) {
+        return wasmBinaryUrl
+      }
+      return basePath + 'wasm/' + path
+    }
+  })
+}
+
 // 初始化 WASM
 async function initWasm(): Promise<void> {
   if (wasmModule) return
@@ -43,30 +230,18 @@ async function initWasm(): Promise<void> {
   initPromise = (async () => {
     try {
       const basePath = getBasePath()
-      const wasmJsUrl = basePath + 'wasm/sudoku_wasm.js'
-      const wasmBinaryUrl = basePath + 'wasm/sudoku_wasm.wasm'
-      
-      console.log('Loading WASM from:', wasmJsUrl)
-      
-      // 使用 importScripts 加载 WASM JS glue code
-      // @ts-ignore - importScripts 只在 Worker 环境中可用
-      importScripts(wasmJsUrl)
-      
-      // @ts-ignore - createSudokuModule 由上面的脚本定义
-      if (typeof createSudokuModule === 'function') {
-        // 配置 WASM 文件位置
-        wasmModule = await createSudokuModule({
-          locateFile: (path: string) => {
-            if (path.endsWith('.wasm')) {
-              return wasmBinaryUrl
-            }
-            return basePath + 'wasm/' + path
-          }
-        })
-        console.log('WASM module loaded successfully')
-      } else {
-        throw new Error('createSudokuModule not found after loading script')
+      if (canUseThreads()) {
+        try {
+          wasmModule = await loadModule(basePath, 'sudoku_wasm_mt')
+        } catch (err) {
+          // 未部署多线程模块时回退
+          console.warn('Threaded WASM unavailable, falling back:', err)
+        }
       }
+      if (!wasmModule) {
+        wasmModule = await loadModule(basePath, 'sudoku_wasm')
+      }
+      console.log('WASM module loaded successfully, threads:', wasmModule.getThreadCount())
     } catch (err) {
       console.error('WASM init error:', err)
       throw err
@@ -77,78 +252,199 @@ async function initWasm(): Promise<void> {
 }
 
 // 求解数独
-async function solvePuzzle(puzzleStr: string, checkUniqueness: boolean) {
+async function solvePuzzle(puzzle: SudokuPuzzle, checkUniqueness: boolean): Promise<SolveResult> {
   await initWasm()
   if (!wasmModule) throw new Error('WASM not initialized')
-  
-  const resultJson = wasmModule.solvePuzzle(puzzleStr, checkUniqueness)
-  return JSON.parse(resultJson)
+
+  writePuzzle(getBuffers(), puzzle)
+  const status: number = wasmModule.solveGrid(checkUniqueness)
+  if (status === STATUS_ERROR) {
+    return { solved: false, error: wasmModule.getLastError() }
+  }
+
+  const { solution, stats } = getBuffers()
+  const result: SolveResult = {
+    solved: status !== STATUS_UNSOLVED,
+    solveTimeMs: stats[STATS_SOLVE_MS],
+    variables: stats[STATS_VARIABLES],
+    clauses: stats[STATS_CLAUSES]
+  }
+  if (checkUniqueness) {
+    result.uniqueness = status === STATUS_UNIQUE ? 'unique' : status === STATUS_NOT_UNIQUE ? 'not_unique' : 'unknown'
+  }
+  if (result.solved) {
+    result.grid = readGrid(solution)
+  } else {
+    result.error = wasmModule.getLastError()
+  }
+  return result
 }
 
 // 生成数独
 async function generatePuzzle(
-  type: string,
-  minCages: number,
-  maxCages: number,
-  minInequalities: number,
-  maxInequalities: number,
-  seed: number,
-  includeSolution: boolean,
-  fillAllCells: boolean,
-  ensureUniqueSolution: boolean,
-  difficulty: number
-) {
+  options: GenerateOptions,
+  ticket: number,
+  onProgress: (progress: GenerationProgress) => void
+): Promise<GeneratedPuzzle> {
   await initWasm()
   if (!wasmModule) throw new Error('WASM not initialized')
-  
-  return wasmModule.generatePuzzle(
-    type,
-    minCages,
-    maxCages,
-    minInequalities,
-    maxInequalities,
-    seed,
-    includeSolution,
-    fillAllCells,
-    ensureUniqueSolution,
-    difficulty
-  )
+
+  // 在求解之间被调用；返回 false 即取消
+  wasmModule.setProgressCallback((phase: number, trialsDone: number, trialsRemaining: number) => {
+    onProgress({ phase: PHASES[phase] ?? 'fill', trialsDone, trialsRemaining })
+    return !(cancelSlots && ticket > 0 && Atomics.load(cancelSlots, SLOT_CANCEL_TICKET) === ticket)
+  })
+
+  let status: number
+  try {
+    status = wasmModule.generateGrid(
+      options.type,
+      options.minCages,
+      options.maxCages,
+      options.minInequalities,
+      options.maxInequalities,
+      options.seed,
+      options.fillAllCells,
+      options.ensureUniqueSolution,
+      options.difficulty
+    )
+  } finally {
+    wasmModule.setProgressCallback(null)
+  }
+  if (status === STATUS_CANCELLED) {
+    throw new Error('Generation cancelled')
+  }
+  if (status === STATUS_ERROR) {
+    throw new Error(wasmModule.getLastError())
+  }
+
+  const buffers = getBuffers()
+  return { puzzle: readPuzzle(buffers), solution: readGrid(buffers.solution) }
+}
+
+// 预取：每种随机生成参数 (seed 为 0) 在空闲时备好几道谜题，"新游戏"直接取用。
+// 每个任务只生成一批 (单线程模块一道，多线程模块每线程一道)，两批之间让出事件循环。
+// 有共享标志时，用户请求一到达进度回调就中止这一批 (已完成的谜题保留)，
+// 预取暂停到该请求处理完；否则用户请求最多等待一批
+const PREFETCH_DEPTH = 3
+const prefetchQueues = new Map<string, { options: GenerateOptions; puzzles: GeneratedPuzzle[] }>()
+let prefetchScheduled = false
+let prefetchPaused = false
+
+function prefetchKey(options: GenerateOptions): string {
+  return JSON.stringify({ ...options, seed: 0 })
+}
+
+function takePrefetched(options: GenerateOptions): GeneratedPuzzle | undefined {
+  return prefetchQueues.get(prefetchKey(options))?.puzzles.shift()
+}
+
+function schedulePrefetch(options: GenerateOptions) {
+  if (options.seed !== 0) return
+  const key = prefetchKey(options)
+  if (!prefetchQueues.has(key)) {
+    prefetchQueues.set(key, { options, puzzles: [] })
+  }
+  if (!prefetchScheduled) {
+    prefetchScheduled = true
+    setTimeout(prefetchStep, 0)
+  }
+}
+
+// 处理完一个用户请求后恢复被它打断的预取
+function resumePrefetch() {
+  if (prefetchPaused && !userRequestWaiting()) {
+    prefetchPaused = false
+    if (!prefetchScheduled) {
+      prefetchScheduled = true
+      setTimeout(prefetchStep, 0)
+    }
+  }
+}
+
+function prefetchStep() {
+  prefetchScheduled = false
+  if (!wasmModule) return
+  if (userRequestWaiting()) {
+    prefetchPaused = true
+    return
+  }
+  for (const [key, queue] of prefetchQueues) {
+    const missing = PREFETCH_DEPTH - queue.puzzles.length
+    if (missing <= 0) continue
+
+    // 进度回调让排队的用户请求抢占这一批
+    wasmModule.setProgressCallback(() => !userRequestWaiting())
+    let batch: PuzzleArrays[]
+    try {
+      batch = wasmModule.generateBatch(queue.options, Math.min(missing, wasmModule.getThreadCount()))
+    } finally {
+      wasmModule.setProgressCallback(null)
+    }
+    const preempted = userRequestWaiting()
+    if (batch.length === 0 && !preempted) {
+      console.warn('Prefetch failed:', wasmModule.getLastError())
+      prefetchQueues.delete(key)
+    } else {
+      for (const arrays of batch) {
+        queue.puzzles.push({ puzzle: readPuzzle(arrays), solution: readGrid(arrays.solution) })
+      }
+    }
+    if (preempted) {
+      prefetchPaused = true
+    } else {
+      prefetchScheduled = true
+      setTimeout(prefetchStep, 0)
+    }
+    return
+  }
 }
 
 // Worker 消息处理
 self.onmessage = async (event: MessageEvent<WorkerMessage>) => {
   const { id, type, payload } = event.data
   let response: WorkerResponse
+  if (type === 'solve' || type === 'generate') {
+    userRequestsSeen++
+  }
 
   try {
     switch (type) {
       case 'init':
+        if (payload?.cancelBuffer) {
+          cancelSlots = new Int32Array(payload.cancelBuffer)
+        }
         await initWasm()
         response = { id, success: true }
         break
 
       case 'solve':
         const solveResult = await solvePuzzle(
-          payload.puzzleStr,
+          payload.puzzle,
           payload.checkUniqueness || false
         )
         response = { id, success: true, data: solveResult }
         break
 
-      case 'generate':
-        const puzzleStr = await generatePuzzle(
-          payload.type || 'mixed',
-          payload.minCages || 12,
-          payload.maxCages || 18,
-          payload.minInequalities || 15,
-          payload.maxInequalities || 25,
-          payload.seed || 0,
-          payload.includeSolution || false,
-          payload.fillAllCells || false,
-          payload.ensureUniqueSolution || true,
-          payload.difficulty || 50
-        )
-        response = { id, success: true, data: puzzleStr }
+      case 'generate': {
+        const options = normalizeOptions(payload)
+        let generated = options.seed === 0 ? takePrefetched(options) : undefined
+        if (!generated) {
+          generated = await generatePuzzle(
+            options,
+            payload.ticket || 0,
+            (progress) => self.postMessage({ id, type: 'progress', success: true, data: progress } as WorkerResponse)
+          )
+        }
+        schedulePrefetch(options)
+        response = { id, success: true, data: generated }
+        break
+      }
+
+      case 'prefetch':
+        await initWasm()
+        schedulePrefetch(normalizeOptions(payload))
+        response = { id, success: true }
         break
 
       default:
@@ -163,4 +459,5 @@ self.onmessage = async (event: MessageEvent<WorkerMessage>) => {
   }
 
   self.postMessage(response)
+  resumePrefetch()
 }
@@ -0,0 +1,151 @@
+/**
+ * @file SudokuBatch.cpp
+ * @brief Implementation of the work-stealing thread pool
+ */
+
+#include "SudokuBatch.h"
+
+namespace sudoku
+{
+
+    WorkStealingPool::WorkStealingPool(int numThreads)
+    {
+        if (numThreads < 1)
+        {
+            numThreads = 1;
+        }
+        for (int i = 0; i < numThreads; i++)
+        {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (int i = 0; i < numThreads; i++)
+        {
+            threads.emplace_back(&WorkStealingPool::run, this, i);
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    void WorkStealingPool::submit(Task task)
+    {
+        size_t target;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            target = nextQueue;
+            nextQueue = (nextQueue + 1) % queues.size();
+            unfinished++;
+        }
+
+        // Distribute round-robin; idle workers rebalance by stealing
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            queued++;
+        }
+        workAvailable.notify_one();
+    }
+
+    void WorkStealingPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        allDone.wait(lock, [this]()
+                     { return unfinished == 0; });
+    }
+
+    size_t WorkStealingPool::getSteals() const
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return steals;
+    }
+
+    bool WorkStealingPool::tryTake(int worker, Task &task)
+    {
+        // Own deque: oldest first, so tasks start in the order they were
+        // submitted and results written in input order are not held back
+        {
+            Queue &own = *queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        // Steal the oldest task of the next non-empty deque
+        int numQueues = static_cast<int>(queues.size());
+        for (int offset = 1; offset < numQueues; offset++)
+        {
+            Queue &victim = *queues[(worker + offset) % numQueues];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                std::lock_guard<std::mutex> stateLock(stateMutex);
+                steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::run(int worker)
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(stateMutex);
+                workAvailable.wait(lock, [this]()
+                                   { return queued > 0 || stopping; });
+                if (queued == 0 && stopping)
+                {
+                    return;
+                }
+            }
+
+            Task task;
+            if (!tryTake(worker, task))
+            {
+                // Another worker got there first (queued is decremented after taking)
+                std::this_thread::yield();
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                queued--;
+            }
+
+            task(worker);
+
+            bool done;
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                done = --unfinished == 0;
+            }
+            if (done)
+            {
+                allDone.notify_all();
+            }
+        }
+    }
+
+} // namespace sudoku
@@ -0,0 +1,143 @@
+/**
+ * @file SudokuBatch.h
+ * @brief Work-stealing thread pool and in-order result release
+ *
+ * - WorkStealingPool: fixed worker threads, each with its own task deque.
+ *   Workers take their own oldest task first, so tasks start in submission
+ *   order, and steal the oldest task of another worker when idle, so a few
+ *   slow puzzles (killer and mixed puzzles vary in solve time by orders of
+ *   magnitude) never leave cores waiting.
+ * - ReorderBuffer: turns out-of-order results back into input order.
+ */
+
+#ifndef SUDOKU_BATCH_H
+#define SUDOKU_BATCH_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Thread pool with per-worker deques and work stealing
+     */
+    class WorkStealingPool
+    {
+    public:
+        using Task = std::function<void(int worker)>;
+
+        /**
+         * @brief Start the worker threads
+         * @param numThreads Number of workers (at least 1)
+         */
+        explicit WorkStealingPool(int numThreads);
+
+        /**
+         * @brief Finish all submitted tasks and join the workers
+         */
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        /**
+         * @brief Queue a task; it receives the index of the worker running it
+         */
+        void submit(Task task);
+
+        /**
+         * @brief Block until every submitted task has finished
+         */
+        void wait();
+
+        int size() const { return static_cast<int>(threads.size()); }
+
+        /**
+         * @brief Number of tasks taken from another worker's deque
+         */
+        size_t getSteals() const;
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+
+        mutable std::mutex stateMutex;
+        std::condition_variable workAvailable;
+        std::condition_variable allDone;
+        size_t queued = 0;     // Tasks sitting in deques
+        size_t unfinished = 0; // Tasks submitted but not yet finished
+        size_t steals = 0;
+        size_t nextQueue = 0;
+        bool stopping = false;
+
+        bool tryTake(int worker, Task &task);
+        void run(int worker);
+    };
+
+    /**
+     * @brief Releases results in index order
+     *
+     * Results are put in any order; each call emits the longest run of
+     * consecutive results starting at the next expected index. Thread-safe;
+     * emit is called with the internal lock held, so output stays ordered.
+     */
+    template <class T>
+    class ReorderBuffer
+    {
+    public:
+        using Emit = std::function<void(size_t index, const T &value)>;
+
+        /**
+         * @param first Index of the first value to emit (when resuming part way)
+         */
+        explicit ReorderBuffer(Emit emit, size_t first = 0) : emit(std::move(emit)), next(first) {}
+
+        void put(size_t index, T value)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (index != next)
+            {
+                pending.emplace(index, std::move(value));
+                return;
+            }
+
+            emit(next++, value);
+            for (auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.erase(it))
+            {
+                emit(next++, it->second);
+            }
+        }
+
+        /**
+         * @brief Number of results waiting for an earlier index
+         */
+        size_t waiting() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return pending.size();
+        }
+
+    private:
+        Emit emit;
+        mutable std::mutex mutex;
+        std::map<size_t, T> pending;
+        size_t next;
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_BATCH_H
@@ -0,0 +1,295 @@
+/**
+ * @file SudokuBinary.cpp
+ * @brief Implementation of the compact binary format
+ */
+
+#include "SudokuBinary.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        constexpr char kMagic[4] = {'S', 'D', 'K', 'B'};
+        constexpr uint8_t kHasSolution = 1;
+
+        /**
+         * @brief Appends values LSB-first to a byte string
+         */
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::string &out) : out(out) {}
+
+            void put(uint32_t value, int bits)
+            {
+                for (int i = 0; i < bits; i++)
+                {
+                    if (used == 0)
+                    {
+                        out += '\0';
+                    }
+                    if ((value >> i) & 1)
+                    {
+                        out.back() = static_cast<char>(out.back() | (1 << used));
+                    }
+                    used = (used + 1) & 7;
+                }
+            }
+
+        private:
+            std::string &out;
+            int used = 0;
+        };
+
+        /**
+         * @brief Reads values written by BitWriter
+         */
+        class BitReader
+        {
+        public:
+            BitReader(std::string_view data, size_t offset) : data(data), bit(offset * 8) {}
+
+            uint32_t get(int bits)
+            {
+                if (bit + bits > data.size() * 8)
+                {
+                    throw std::runtime_error("Binary puzzle is truncated");
+                }
+                uint32_t value = 0;
+                for (int i = 0; i < bits; i++, bit++)
+                {
+                    value |= static_cast<uint32_t>((static_cast<unsigned char>(data[bit >> 3]) >> (bit & 7)) & 1) << i;
+                }
+                return value;
+            }
+
+            size_t bytesUsed() const { return (bit + 7) / 8; }
+
+        private:
+            std::string_view data;
+            size_t bit;
+        };
+
+        void putU16(std::string &out, size_t value)
+        {
+            if (value > 0xFFFF)
+            {
+                throw std::runtime_error("Too many constraints for the binary format");
+            }
+            out += static_cast<char>(value & 0xFF);
+            out += static_cast<char>(value >> 8);
+        }
+
+        int getU16(std::string_view data, size_t offset)
+        {
+            return static_cast<unsigned char>(data[offset]) | (static_cast<unsigned char>(data[offset + 1]) << 8);
+        }
+    } // namespace
+
+    template <class Geo>
+    bool BasicSudokuBinary<Geo>::isBinary(std::string_view data)
+    {
+        return data.size() >= sizeof(kMagic) && data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) == 0;
+    }
+
+    template <class Geo>
+    std::string BasicSudokuBinary<Geo>::write(const Puzzle &puzzle, const Solution *solution)
+    {
+        std::string out;
+        write(puzzle, solution, out);
+        return out;
+    }
+
+    template <class Geo>
+    void BasicSudokuBinary<Geo>::write(const Puzzle &puzzle, const Solution *solution, std::string &out)
+    {
+        bool withSolution = solution && solution->solved;
+        out.append(kMagic, sizeof(kMagic));
+        out += static_cast<char>(VERSION);
+        out += static_cast<char>(Geo::BOX_ROWS);
+        out += static_cast<char>(Geo::BOX_COLS);
+        out += static_cast<char>(withSolution ? kHasSolution : 0);
+        putU16(out, puzzle.cages.size());
+        putU16(out, puzzle.inequalities.size());
+
+        BitWriter bits(out);
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                bits.put(static_cast<uint32_t>(puzzle.grid[r][c]), CELL_BITS);
+            }
+        }
+
+        for (const Cage &cage : puzzle.cages)
+        {
+            if (cage.targetSum < 0 || cage.targetSum > MAX_CAGE_SUM)
+            {
+                throw std::runtime_error("Cage sum " + std::to_string(cage.targetSum) + " cannot be stored");
+            }
+            if (cage.cells.empty())
+            {
+                throw std::runtime_error("Empty cage cannot be stored");
+            }
+            typename Topology::CellMask mask;
+            int first = NUM_CELLS;
+            int last = 0;
+            for (const Cell &cell : cage.cells)
+            {
+                if (!cell.isValid(GRID_SIZE))
+                {
+                    throw std::runtime_error("Cage cell out of range");
+                }
+                int index = Topology::toIndex(cell);
+                mask.set(index);
+                first = std::min(first, index);
+                last = std::max(last, index);
+            }
+            bits.put(static_cast<uint32_t>(cage.targetSum), SUM_BITS);
+            bits.put(static_cast<uint32_t>(first), INDEX_BITS);
+            bits.put(static_cast<uint32_t>(last - first), INDEX_BITS);
+            for (int i = first + 1; i <= last; i++)
+            {
+                bits.put(mask.test(i), 1);
+            }
+        }
+
+        for (const InequalityConstraint &ineq : puzzle.inequalities)
+        {
+            int a = Topology::toIndex(ineq.cell1);
+            int b = Topology::toIndex(ineq.cell2);
+            int edge = ineq.isValid(GRID_SIZE) ? Topology::adjacentPairIndex(a, b) : -1;
+            if (edge < 0)
+            {
+                throw std::runtime_error("Only inequalities between adjacent cells can be stored");
+            }
+            // Direction relative to the pair's lower-indexed cell
+            bool firstGreater = (ineq.type == InequalityType::GREATER_THAN) == (a < b);
+            bits.put(static_cast<uint32_t>(edge), EDGE_BITS);
+            bits.put(firstGreater, 1);
+        }
+
+        if (withSolution)
+        {
+            bits.put(static_cast<uint32_t>(solution->uniqueness), 2);
+            for (int r = 0; r < GRID_SIZE; r++)
+            {
+                for (int c = 0; c < GRID_SIZE; c++)
+                {
+                    bits.put(static_cast<uint32_t>(solution->grid[r][c]), CELL_BITS);
+                }
+            }
+        }
+    }
+
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuBinary<Geo>::read(std::string_view data, Solution *solution, size_t *consumed)
+    {
+        if (!isBinary(data) || data.size() < HEADER_SIZE)
+        {
+            throw std::runtime_error("Not a binary puzzle");
+        }
+        if (static_cast<uint8_t>(data[4]) != VERSION)
+        {
+            throw std::runtime_error("Unsupported binary puzzle version " +
+                                     std::to_string(static_cast<unsigned char>(data[4])));
+        }
+        if (data[5] != Geo::BOX_ROWS || data[6] != Geo::BOX_COLS)
+        {
+            int size = data[5] * data[6];
+            throw std::runtime_error("Binary puzzle is for a " + std::to_string(size) + "x" + std::to_string(size) +
+                                     " grid");
+        }
+        bool withSolution = data[7] & kHasSolution;
+        int numCages = getU16(data, 8);
+        int numInequalities = getU16(data, 10);
+
+        Puzzle puzzle;
+        BitReader bits(data, HEADER_SIZE);
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                int value = static_cast<int>(bits.get(CELL_BITS));
+                if (value > Geo::MAX_VALUE)
+                {
+                    throw std::runtime_error("Binary puzzle has an invalid cell value");
+                }
+                puzzle.grid[r][c] = value;
+            }
+        }
+
+        for (int i = 0; i < numCages; i++)
+        {
+            Cage cage;
+            cage.targetSum = static_cast<int>(bits.get(SUM_BITS));
+            int first = static_cast<int>(bits.get(INDEX_BITS));
+            int last = first + static_cast<int>(bits.get(INDEX_BITS));
+            if (last >= NUM_CELLS)
+            {
+                throw std::runtime_error("Binary puzzle has an invalid cage");
+            }
+            cage.cells.push_back(Topology::toCell(first));
+            for (int cell = first + 1; cell <= last; cell++)
+            {
+                if (bits.get(1))
+                {
+                    cage.cells.push_back(Topology::toCell(cell));
+                }
+            }
+            puzzle.addCage(cage);
+        }
+
+        for (int i = 0; i < numInequalities; i++)
+        {
+            int edge = static_cast<int>(bits.get(EDGE_BITS));
+            if (edge >= Topology::NUM_ADJACENT_PAIRS)
+            {
+                throw std::runtime_error("Binary puzzle has an invalid inequality");
+            }
+            const auto &pair = Topology::ADJACENT_PAIRS[edge];
+            InequalityType type = bits.get(1) ? InequalityType::GREATER_THAN : InequalityType::LESS_THAN;
+            puzzle.addInequality(
+                InequalityConstraint(Topology::toCell(pair.first), Topology::toCell(pair.second), type));
+        }
+
+        if (withSolution)
+        {
+            uint32_t uniqueness = bits.get(2);
+            Solution stored;
+            stored.solved = true;
+            stored.uniqueness = uniqueness <= static_cast<uint32_t>(UniquenessStatus::NOT_UNIQUE)
+                                    ? static_cast<UniquenessStatus>(uniqueness)
+                                    : UniquenessStatus::NOT_CHECKED;
+            for (int r = 0; r < GRID_SIZE; r++)
+            {
+                for (int c = 0; c < GRID_SIZE; c++)
+                {
+                    stored.grid[r][c] = static_cast<int>(bits.get(CELL_BITS));
+                }
+            }
+            if (solution)
+            {
+                *solution = stored;
+            }
+        }
+        else if (solution)
+        {
+            *solution = Solution();
+        }
+
+        if (consumed)
+        {
+            *consumed = bits.bytesUsed();
+        }
+        return puzzle;
+    }
+
+#define SUDOKU_INSTANTIATE_BINARY(R, C) template class BasicSudokuBinary<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_BINARY)
+#undef SUDOKU_INSTANTIATE_BINARY
+
+} // namespace sudoku
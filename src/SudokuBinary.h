@@ -0,0 +1,113 @@
+/**
+ * @file SudokuBinary.h
+ * @brief Compact binary format for puzzles and solutions
+ *
+ * Record layout (version 1):
+ *
+ *   bytes 0-3   magic "SDKB"
+ *   byte  4     format version
+ *   bytes 5-6   box rows, box columns
+ *   byte  7     flags (bit 0: a solution follows)
+ *   bytes 8-11  cage count, inequality count (16-bit little-endian)
+ *
+ * followed by a little-endian bit stream, padded to a whole byte:
+ *
+ *   - the grid, one CELL_BITS value per cell (4 bits on 9x9)
+ *   - per cage: the sum in SUM_BITS, then its cell mask trimmed to the
+ *     cage's span: the first cell and the span length in INDEX_BITS each,
+ *     then one bit per cell after the first (about 30 bits for a typical
+ *     cage instead of NUM_CELLS)
+ *   - per inequality: the index of the cell pair in the topology's adjacent
+ *     pair table (EDGE_BITS), then one bit set if the first cell is greater
+ *   - if flagged: solved and uniqueness bits, then the solved grid
+ *
+ * Records are self-delimiting, so a file may hold any number of them back to
+ * back. Cage cells come back in row-major order and inequalities are
+ * normalized to point from the lower-indexed cell; the constraints themselves
+ * are unchanged.
+ */
+
+#ifndef SUDOKU_BINARY_H
+#define SUDOKU_BINARY_H
+
+#include "SudokuTypes.h"
+#include "SudokuTopology.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Binary conversion for one geometry
+     *
+     * Instantiated for every geometry in SUDOKU_FOR_EACH_GEOMETRY.
+     */
+    template <class Geo>
+    class BasicSudokuBinary
+    {
+    public:
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Solution = BasicSudokuSolution<Geo>;
+        using Topology = BasicTopology<Geo>;
+
+        static constexpr uint8_t VERSION = 1;
+        static constexpr int HEADER_SIZE = 12;
+
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int NUM_CELLS = Geo::NUM_CELLS;
+        static constexpr int MAX_CAGE_SUM = GRID_SIZE * (GRID_SIZE + 1) / 2;
+
+        /**
+         * @brief Number of bits needed to hold values 0..maxValue
+         */
+        static constexpr int bitsFor(int maxValue)
+        {
+            int bits = 1;
+            while ((1 << bits) <= maxValue)
+            {
+                bits++;
+            }
+            return bits;
+        }
+
+        static constexpr int CELL_BITS = bitsFor(Geo::MAX_VALUE);
+        static constexpr int SUM_BITS = bitsFor(MAX_CAGE_SUM);
+        static constexpr int INDEX_BITS = bitsFor(NUM_CELLS - 1);
+        static constexpr int EDGE_BITS = bitsFor(Topology::NUM_ADJACENT_PAIRS - 1);
+
+        /**
+         * @brief Check whether data starts with a binary record
+         */
+        static bool isBinary(std::string_view data);
+
+        /**
+         * @brief Encode a puzzle, optionally followed by its solution
+         * @throws std::runtime_error if a constraint cannot be represented
+         *         (non-adjacent inequality, empty cage, cage sum out of range)
+         */
+        static std::string write(const Puzzle &puzzle, const Solution *solution = nullptr);
+
+        /**
+         * @brief Append an encoded record to out
+         */
+        static void write(const Puzzle &puzzle, const Solution *solution, std::string &out);
+
+        /**
+         * @brief Decode one record
+         * @param data Bytes starting at a record
+         * @param solution If not null, receives the stored solution (left
+         *        unsolved if the record has none)
+         * @param consumed If not null, receives the record length in bytes
+         * @throws std::runtime_error on a bad header, another geometry or truncation
+         */
+        static Puzzle read(std::string_view data, Solution *solution = nullptr, size_t *consumed = nullptr);
+    };
+
+    // Classic 9x9 binary conversion
+    using SudokuBinary = BasicSudokuBinary<StandardGeometry>;
+
+} // namespace sudoku
+
+#endif // SUDOKU_BINARY_H
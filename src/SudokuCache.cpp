@@ -0,0 +1,233 @@
+/**
+ * @file SudokuCache.cpp
+ * @brief Implementation of the solution cache
+ */
+
+#include "SudokuCache.h"
+#include "SudokuDiskCache.h"
+
+namespace sudoku
+{
+
+    namespace
+    {
+        /**
+         * @brief Two independent 64-bit lanes over a stream of words
+         */
+        class HashStream
+        {
+        public:
+            void add(uint64_t word)
+            {
+                a = (a ^ word) * 0x100000001b3ULL;
+                b = rotate(b ^ (word * 0x9e3779b97f4a7c15ULL), 29) * 0xbf58476d1ce4e5b9ULL;
+                length++;
+            }
+
+            PuzzleHash finish() const
+            {
+                uint64_t high = finalize(a ^ length);
+                uint64_t low = finalize(b + high);
+                return PuzzleHash(high, low);
+            }
+
+        private:
+            uint64_t a = 0xcbf29ce484222325ULL;
+            uint64_t b = 0x6a09e667f3bcc909ULL;
+            uint64_t length = 0;
+
+            static uint64_t rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+            static uint64_t finalize(uint64_t x)
+            {
+                x ^= x >> 33;
+                x *= 0xff51afd7ed558ccdULL;
+                x ^= x >> 33;
+                x *= 0xc4ceb9fe1a85ec53ULL;
+                x ^= x >> 33;
+                return x;
+            }
+        };
+
+        // Section tags keep e.g. an empty cage list distinct from a trailing grid word
+        constexpr uint64_t kCageTag = 0xCA9E000000000000ULL;
+        constexpr uint64_t kInequalityTag = 0x1E90000000000000ULL;
+    } // namespace
+
+    template <class Geo>
+    PuzzleHash hashPuzzle(const BasicSudokuPuzzle<Geo> &puzzle)
+    {
+        HashStream stream;
+
+        // Grid values fit in a byte; pack 8 cells per word
+        const int *cells = &puzzle.grid[0][0];
+        uint64_t word = 0;
+        for (int i = 0; i < Geo::NUM_CELLS; i++)
+        {
+            word = (word << 8) | static_cast<uint8_t>(cells[i]);
+            if (i % 8 == 7)
+            {
+                stream.add(word);
+                word = 0;
+            }
+        }
+        stream.add(word);
+
+        stream.add(kCageTag | puzzle.cages.size());
+        for (const auto &cage : puzzle.cages)
+        {
+            stream.add((static_cast<uint64_t>(cage.targetSum) << 32) | cage.cells.size());
+            for (const auto &cell : cage.cells)
+            {
+                stream.add(static_cast<uint64_t>(cell.row * Geo::GRID_SIZE + cell.col));
+            }
+        }
+
+        stream.add(kInequalityTag | puzzle.inequalities.size());
+        for (const auto &ineq : puzzle.inequalities)
+        {
+            uint64_t a = static_cast<uint64_t>(ineq.cell1.row * Geo::GRID_SIZE + ineq.cell1.col);
+            uint64_t b = static_cast<uint64_t>(ineq.cell2.row * Geo::GRID_SIZE + ineq.cell2.col);
+            uint64_t greater = ineq.type == InequalityType::GREATER_THAN ? 1 : 0;
+            stream.add((a << 33) | (b << 1) | greater);
+        }
+
+        return stream.finish();
+    }
+
+    template <class Geo>
+    BasicSolutionCache<Geo>::BasicSolutionCache(size_t capacity) : capacity(capacity > 0 ? capacity : 1)
+    {
+        stats.capacity = this->capacity;
+    }
+
+    template <class Geo>
+    bool BasicSolutionCache<Geo>::lookup(const PuzzleHash &hash, bool checkUniqueness, Solution &solution)
+    {
+        std::shared_ptr<BasicDiskCache<Geo>> store;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = index.find(hash);
+            if (it != index.end() && !(checkUniqueness && it->second->solution.solved &&
+                                       !it->second->solution.uniquenessChecked()))
+            {
+                // Move to the front of the LRU list
+                entries.splice(entries.begin(), entries, it->second);
+                solution = it->second->solution;
+                stats.hits++;
+                if (!checkUniqueness)
+                {
+                    // Behave exactly like an uncached solve without a uniqueness check
+                    solution.uniqueness = UniquenessStatus::NOT_CHECKED;
+                }
+                return true;
+            }
+            store = diskStore;
+        }
+
+        // The store has its own lock; other threads keep using the memory entries meanwhile
+        bool found = store && store->lookup(hash, checkUniqueness, solution);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!found)
+            {
+                stats.misses++;
+                return false;
+            }
+            insert(hash, solution);
+            stats.storeHits++;
+            stats.hits++;
+        }
+
+        if (!checkUniqueness)
+        {
+            // Behave exactly like an uncached solve without a uniqueness check
+            solution.uniqueness = UniquenessStatus::NOT_CHECKED;
+        }
+        return true;
+    }
+
+    template <class Geo>
+    bool BasicSolutionCache<Geo>::insert(const PuzzleHash &hash, const Solution &solution)
+    {
+        auto it = index.find(hash);
+        if (it != index.end())
+        {
+            entries.splice(entries.begin(), entries, it->second);
+
+            // Never downgrade a checked entry to an unchecked one
+            if (!solution.uniquenessChecked() && it->second->solution.uniquenessChecked())
+            {
+                return false;
+            }
+            it->second->solution = solution;
+            return true;
+        }
+
+        if (entries.size() >= capacity)
+        {
+            index.erase(entries.back().hash);
+            entries.pop_back();
+            stats.evictions++;
+        }
+
+        entries.push_front(Entry{hash, solution});
+        index[hash] = entries.begin();
+        stats.insertions++;
+        return true;
+    }
+
+    template <class Geo>
+    void BasicSolutionCache<Geo>::store(const PuzzleHash &hash, const Solution &solution)
+    {
+        std::shared_ptr<BasicDiskCache<Geo>> store;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!insert(hash, solution))
+            {
+                return;
+            }
+            store = diskStore;
+        }
+        if (store)
+        {
+            store->store(hash, solution);
+        }
+    }
+
+    template <class Geo>
+    void BasicSolutionCache<Geo>::attachStore(std::shared_ptr<BasicDiskCache<Geo>> diskCache)
+    {
+        // Index the file before the first lookup, and outside the lock
+        if (diskCache)
+        {
+            diskCache->open();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        diskStore = std::move(diskCache);
+    }
+
+    template <class Geo>
+    void BasicSolutionCache<Geo>::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        index.clear();
+    }
+
+    template <class Geo>
+    CacheStats BasicSolutionCache<Geo>::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CacheStats result = stats;
+        result.size = entries.size();
+        return result;
+    }
+
+#define SUDOKU_INSTANTIATE_CACHE(R, C)                                                 \
+    template PuzzleHash hashPuzzle<Geometry<R, C>>(const BasicSudokuPuzzle<Geometry<R, C>> &); \
+    template class BasicSolutionCache<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_CACHE)
+#undef SUDOKU_INSTANTIATE_CACHE
+
+} // namespace sudoku
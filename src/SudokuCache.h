@@ -0,0 +1,162 @@
+/**
+ * @file SudokuCache.h
+ * @brief Bounded LRU cache of solved puzzles
+ *
+ * Puzzles are identified by a 128-bit hash of their grid, cages and
+ * inequalities. Each entry stores the solution together with its uniqueness
+ * status, so repeated requests for the same puzzle skip the SAT solver.
+ *
+ * The cache is internally synchronized and may be shared (through a
+ * std::shared_ptr) by several solvers running on different threads.
+ * A BasicDiskCache can be attached to keep solutions across restarts.
+ */
+
+#ifndef SUDOKU_CACHE_H
+#define SUDOKU_CACHE_H
+
+#include "SudokuTypes.h"
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace sudoku
+{
+
+    /**
+     * @brief 128-bit puzzle identity
+     */
+    struct PuzzleHash
+    {
+        uint64_t high;
+        uint64_t low;
+
+        PuzzleHash() : high(0), low(0) {}
+        PuzzleHash(uint64_t h, uint64_t l) : high(h), low(l) {}
+
+        bool operator==(const PuzzleHash &other) const
+        {
+            return high == other.high && low == other.low;
+        }
+        bool operator!=(const PuzzleHash &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @brief std::unordered_map hasher for PuzzleHash
+     */
+    struct PuzzleHashHasher
+    {
+        size_t operator()(const PuzzleHash &hash) const { return static_cast<size_t>(hash.low); }
+    };
+
+    /**
+     * @brief Hash a puzzle's grid and constraints
+     *
+     * Cages and inequalities are hashed in the order they are stored.
+     */
+    template <class Geo>
+    PuzzleHash hashPuzzle(const BasicSudokuPuzzle<Geo> &puzzle);
+
+    template <class Geo>
+    class BasicDiskCache;
+
+    /**
+     * @brief Cache hit/miss counters
+     */
+    struct CacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        uint64_t storeHits = 0; // Hits answered by the attached disk cache (included in hits)
+        size_t size = 0;
+        size_t capacity = 0;
+
+        double hitRate() const
+        {
+            uint64_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+
+    /**
+     * @brief Thread-safe bounded LRU cache of solutions
+     *
+     * A solution stored without a uniqueness check only answers requests that
+     * do not ask for one; storing a checked solution for the same puzzle
+     * replaces it.
+     */
+    template <class Geo>
+    class BasicSolutionCache
+    {
+    public:
+        using Solution = BasicSudokuSolution<Geo>;
+
+        static constexpr size_t DEFAULT_CAPACITY = 10000;
+
+        explicit BasicSolutionCache(size_t capacity = DEFAULT_CAPACITY);
+
+        /**
+         * @brief Look up a solution
+         * @param hash Hash of the puzzle
+         * @param checkUniqueness If true, only entries with a uniqueness status match
+         * @param solution Receives the cached solution on a hit
+         * @return true on a hit
+         */
+        bool lookup(const PuzzleHash &hash, bool checkUniqueness, Solution &solution);
+
+        /**
+         * @brief Store a solution, evicting the least recently used entry if full
+         */
+        void store(const PuzzleHash &hash, const Solution &solution);
+
+        /**
+         * @brief Attach a persistent store behind the in-memory entries
+         *
+         * Memory misses fall through to the store, and new solutions are
+         * appended to it. The store is opened and indexed here; its reads
+         * and writes happen outside this cache's lock.
+         * @throws std::runtime_error if the store's file is not a cache for this geometry
+         */
+        void attachStore(std::shared_ptr<BasicDiskCache<Geo>> diskCache);
+
+        /**
+         * @brief Remove all entries (statistics are kept)
+         */
+        void clear();
+
+        CacheStats getStats() const;
+        size_t getCapacity() const { return capacity; }
+
+    private:
+        struct Entry
+        {
+            PuzzleHash hash;
+            Solution solution;
+        };
+
+        using EntryList = std::list<Entry>;
+
+        // Insert or update an entry; returns false if nothing changed. Caller holds the lock.
+        bool insert(const PuzzleHash &hash, const Solution &solution);
+
+        const size_t capacity;
+        mutable std::mutex mutex;
+        EntryList entries; // Most recently used first
+        std::unordered_map<PuzzleHash, typename EntryList::iterator, PuzzleHashHasher> index;
+        CacheStats stats;
+        std::shared_ptr<BasicDiskCache<Geo>> diskStore;
+    };
+
+    // Classic 9x9 cache
+    using SolutionCache = BasicSolutionCache<StandardGeometry>;
+
+} // namespace sudoku
+
+#endif // SUDOKU_CACHE_H
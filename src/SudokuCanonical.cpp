@@ -0,0 +1,552 @@
+/**
+ * @file SudokuCanonical.cpp
+ * @brief Implementation of puzzle canonicalization
+ */
+
+#include "SudokuCanonical.h"
+#include "SudokuTopology.h"
+#include <algorithm>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        constexpr int NUM_CELLS = topology::NUM_CELLS;
+
+        /**
+         * @brief All 1296 row orders that keep bands together
+         *
+         * Band permutations (3!) times row permutations within each band (3!^3).
+         * The same list describes the valid column orders.
+         */
+        std::vector<std::array<int, GRID_SIZE>> buildLineOrders()
+        {
+            std::vector<std::array<int, GRID_SIZE>> orders;
+            std::array<int, BOX_SIZE> bands = {0, 1, 2};
+            do
+            {
+                std::array<int, BOX_SIZE> r0 = {0, 1, 2};
+                do
+                {
+                    std::array<int, BOX_SIZE> r1 = {0, 1, 2};
+                    do
+                    {
+                        std::array<int, BOX_SIZE> r2 = {0, 1, 2};
+                        do
+                        {
+                            std::array<int, GRID_SIZE> order;
+                            const std::array<int, BOX_SIZE> *within[BOX_SIZE] = {&r0, &r1, &r2};
+                            for (int b = 0; b < BOX_SIZE; b++)
+                            {
+                                for (int k = 0; k < BOX_SIZE; k++)
+                                {
+                                    order[b * BOX_SIZE + k] = bands[b] * BOX_SIZE + (*within[b])[k];
+                                }
+                            }
+                            orders.push_back(order);
+                        } while (std::next_permutation(r2.begin(), r2.end()));
+                    } while (std::next_permutation(r1.begin(), r1.end()));
+                } while (std::next_permutation(r0.begin(), r0.end()));
+            } while (std::next_permutation(bands.begin(), bands.end()));
+            return orders;
+        }
+
+        const std::vector<std::array<int, GRID_SIZE>> &lineOrders()
+        {
+            static const std::vector<std::array<int, GRID_SIZE>> orders = buildLineOrders();
+            return orders;
+        }
+
+        /**
+         * @brief Branch-and-bound search for the minlex image of a standard grid
+         *
+         * Rows are enumerated exhaustively; columns are chosen position by position
+         * (stack first, then a column within it) and pruned as soon as the first
+         * canonical row exceeds the best one found. Complete candidates are compared
+         * cell by cell with early exit.
+         */
+        class MinlexSearch
+        {
+        public:
+            explicit MinlexSearch(const SudokuPuzzle &puzzle)
+            {
+                for (int r = 0; r < GRID_SIZE; r++)
+                {
+                    for (int c = 0; c < GRID_SIZE; c++)
+                    {
+                        source[0][r * GRID_SIZE + c] = puzzle.grid[r][c];
+                        source[1][c * GRID_SIZE + r] = puzzle.grid[r][c];
+                    }
+                }
+            }
+
+            void run()
+            {
+                for (int t = 0; t < 2; t++)
+                {
+                    grid = source[t];
+                    transpose = (t == 1);
+                    for (const auto &order : lineOrders())
+                    {
+                        rowOrder = order;
+                        std::array<int, MAX_VALUE + 1> map = {};
+                        std::fill(usedCol, usedCol + GRID_SIZE, false);
+                        std::fill(usedStack, usedStack + BOX_SIZE, false);
+                        searchColumns(0, map, 1, false);
+                    }
+                }
+            }
+
+            std::array<int, NUM_CELLS> best = {};
+            SymmetryTransform bestTransform;
+
+        private:
+            int source[2][NUM_CELLS];
+            const int *grid = nullptr;
+            bool transpose = false;
+            bool haveBest = false;
+            std::array<int, GRID_SIZE> rowOrder = {};
+            std::array<int, GRID_SIZE> colOrder = {};
+            bool usedCol[GRID_SIZE] = {};
+            bool usedStack[BOX_SIZE] = {};
+            int currentStack[BOX_SIZE] = {};
+
+            static int relabel(int value, std::array<int, MAX_VALUE + 1> &map, int &nextLabel)
+            {
+                if (value == EMPTY_CELL)
+                    return EMPTY_CELL;
+                if (map[value] == 0)
+                    map[value] = nextLabel++;
+                return map[value];
+            }
+
+            // less: the first row is already known to be smaller than the best one
+            void searchColumns(int pos, const std::array<int, MAX_VALUE + 1> &map, int nextLabel, bool less)
+            {
+                if (pos == GRID_SIZE)
+                {
+                    evaluate(map, nextLabel, less);
+                    return;
+                }
+
+                int slot = pos / BOX_SIZE;
+                if (pos % BOX_SIZE == 0)
+                {
+                    // Start a new stack
+                    for (int s = 0; s < BOX_SIZE; s++)
+                    {
+                        if (usedStack[s])
+                            continue;
+                        usedStack[s] = true;
+                        currentStack[slot] = s;
+                        placeColumn(pos, map, nextLabel, less);
+                        usedStack[s] = false;
+                    }
+                }
+                else
+                {
+                    placeColumn(pos, map, nextLabel, less);
+                }
+            }
+
+            void placeColumn(int pos, const std::array<int, MAX_VALUE + 1> &map, int nextLabel, bool less)
+            {
+                int stack = currentStack[pos / BOX_SIZE];
+                for (int k = 0; k < BOX_SIZE; k++)
+                {
+                    int col = stack * BOX_SIZE + k;
+                    if (usedCol[col])
+                        continue;
+
+                    std::array<int, MAX_VALUE + 1> nextMap = map;
+                    int label = nextLabel;
+                    int value = relabel(grid[rowOrder[0] * GRID_SIZE + col], nextMap, label);
+                    bool nextLess = less;
+                    if (haveBest && !less)
+                    {
+                        if (value > best[pos])
+                            continue;
+                        nextLess = value < best[pos];
+                    }
+
+                    usedCol[col] = true;
+                    colOrder[pos] = col;
+                    searchColumns(pos + 1, nextMap, label, nextLess);
+                    usedCol[col] = false;
+                }
+            }
+
+            void evaluate(std::array<int, MAX_VALUE + 1> map, int nextLabel, bool less)
+            {
+                std::array<int, NUM_CELLS> candidate;
+                for (int c = 0; c < GRID_SIZE; c++)
+                {
+                    candidate[c] = map[grid[rowOrder[0] * GRID_SIZE + colOrder[c]]];
+                }
+
+                for (int i = GRID_SIZE; i < NUM_CELLS; i++)
+                {
+                    int value = relabel(grid[rowOrder[i / GRID_SIZE] * GRID_SIZE + colOrder[i % GRID_SIZE]],
+                                        map, nextLabel);
+                    if (haveBest && !less)
+                    {
+                        if (value > best[i])
+                            return;
+                        less = value < best[i];
+                    }
+                    candidate[i] = value;
+                }
+
+                if (haveBest && !less)
+                    return; // Tie: keep the first transform found
+
+                haveBest = true;
+                best = candidate;
+                bestTransform.transpose = transpose;
+                bestTransform.rowOrder = rowOrder;
+                bestTransform.colOrder = colOrder;
+
+                // Complete the relabeling with digits that do not occur in the puzzle
+                for (int v = MIN_VALUE; v <= MAX_VALUE; v++)
+                {
+                    if (map[v] == 0)
+                        map[v] = nextLabel++;
+                }
+                bestTransform.digitMap = map;
+            }
+        };
+    } // namespace
+
+    SymmetryTransform::SymmetryTransform() : transpose(false)
+    {
+        for (int i = 0; i < GRID_SIZE; i++)
+        {
+            rowOrder[i] = i;
+            colOrder[i] = i;
+        }
+        for (int v = 0; v <= MAX_VALUE; v++)
+        {
+            digitMap[v] = v;
+        }
+    }
+
+    Cell SymmetryTransform::toCanonical(const Cell &cell) const
+    {
+        int r = transpose ? cell.col : cell.row;
+        int c = transpose ? cell.row : cell.col;
+        Cell result;
+        for (int i = 0; i < GRID_SIZE; i++)
+        {
+            if (rowOrder[i] == r)
+                result.row = i;
+            if (colOrder[i] == c)
+                result.col = i;
+        }
+        return result;
+    }
+
+    Cell SymmetryTransform::fromCanonical(const Cell &cell) const
+    {
+        int r = rowOrder[cell.row];
+        int c = colOrder[cell.col];
+        return transpose ? Cell(c, r) : Cell(r, c);
+    }
+
+    int SymmetryTransform::toCanonicalValue(int value) const
+    {
+        return (value >= EMPTY_CELL && value <= MAX_VALUE) ? digitMap[value] : value;
+    }
+
+    int SymmetryTransform::fromCanonicalValue(int value) const
+    {
+        for (int v = 0; v <= MAX_VALUE; v++)
+        {
+            if (digitMap[v] == value)
+                return v;
+        }
+        return value;
+    }
+
+    SudokuPuzzle SymmetryTransform::apply(const SudokuPuzzle &puzzle) const
+    {
+        SudokuPuzzle result;
+        result.type = puzzle.type;
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                Cell src = fromCanonical(Cell(r, c));
+                result.grid[r][c] = toCanonicalValue(puzzle.grid[src.row][src.col]);
+            }
+        }
+
+        for (const auto &cage : puzzle.cages)
+        {
+            Cage moved;
+            moved.targetSum = cage.targetSum;
+            for (const auto &cell : cage.cells)
+            {
+                moved.cells.push_back(toCanonical(cell));
+            }
+            result.cages.push_back(moved);
+        }
+
+        for (const auto &ineq : puzzle.inequalities)
+        {
+            result.inequalities.push_back(InequalityConstraint(
+                toCanonical(ineq.cell1), toCanonical(ineq.cell2), ineq.type));
+        }
+
+        return result;
+    }
+
+    SudokuSolution SymmetryTransform::apply(const SudokuSolution &solution) const
+    {
+        SudokuSolution result = solution;
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                Cell src = fromCanonical(Cell(r, c));
+                result.grid[r][c] = toCanonicalValue(solution.grid[src.row][src.col]);
+            }
+        }
+        return result;
+    }
+
+    SudokuSolution SymmetryTransform::invert(const SudokuSolution &solution) const
+    {
+        SudokuSolution result = solution;
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                Cell src = fromCanonical(Cell(r, c));
+                result.grid[src.row][src.col] = fromCanonicalValue(solution.grid[r][c]);
+            }
+        }
+        return result;
+    }
+
+    bool SymmetryTransform::isIdentity() const
+    {
+        SymmetryTransform identity;
+        return !transpose && rowOrder == identity.rowOrder && colOrder == identity.colOrder &&
+               digitMap == identity.digitMap;
+    }
+
+    void SudokuCanonicalizer::sortConstraints(SudokuPuzzle &puzzle)
+    {
+        for (auto &cage : puzzle.cages)
+        {
+            std::sort(cage.cells.begin(), cage.cells.end());
+        }
+        std::sort(puzzle.cages.begin(), puzzle.cages.end(),
+                  [](const Cage &a, const Cage &b)
+                  {
+                      if (a.cells != b.cells)
+                          return a.cells < b.cells;
+                      return a.targetSum < b.targetSum;
+                  });
+
+        for (auto &ineq : puzzle.inequalities)
+        {
+            // Normalize so that cell1 precedes cell2
+            if (ineq.cell2 < ineq.cell1)
+            {
+                std::swap(ineq.cell1, ineq.cell2);
+                ineq.type = ineq.type == InequalityType::GREATER_THAN ? InequalityType::LESS_THAN
+                                                                      : InequalityType::GREATER_THAN;
+            }
+        }
+        std::sort(puzzle.inequalities.begin(), puzzle.inequalities.end(),
+                  [](const InequalityConstraint &a, const InequalityConstraint &b)
+                  {
+                      if (!(a.cell1 == b.cell1))
+                          return a.cell1 < b.cell1;
+                      if (!(a.cell2 == b.cell2))
+                          return a.cell2 < b.cell2;
+                      return a.type < b.type;
+                  });
+    }
+
+    std::string SudokuCanonicalizer::makeKey(const SudokuPuzzle &canonical)
+    {
+        std::string key;
+        key.reserve(NUM_CELLS + 5 + 8 * canonical.cages.size() + 3 * canonical.inequalities.size());
+
+        switch (canonical.type)
+        {
+        case SudokuType::STANDARD:
+            key += 'S';
+            break;
+        case SudokuType::KILLER:
+            key += 'K';
+            break;
+        case SudokuType::INEQUALITY:
+            key += 'I';
+            break;
+        case SudokuType::KILLER_INEQUALITY:
+            key += 'M';
+            break;
+        }
+
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                key += static_cast<char>('0' + canonical.grid[r][c]);
+            }
+        }
+
+        // Constraints as fixed-width binary fields, each list prefixed by its
+        // length, so no two different constraint sets share a key
+        auto appendU16 = [&key](size_t value)
+        {
+            key += static_cast<char>((value >> 8) & 0xFF);
+            key += static_cast<char>(value & 0xFF);
+        };
+        appendU16(canonical.cages.size());
+        for (const auto &cage : canonical.cages)
+        {
+            appendU16(static_cast<size_t>(cage.targetSum));
+            key += static_cast<char>(cage.cells.size());
+            for (const auto &cell : cage.cells)
+            {
+                key += static_cast<char>(topology::toIndex(cell));
+            }
+        }
+        appendU16(canonical.inequalities.size());
+        for (const auto &ineq : canonical.inequalities)
+        {
+            key += ineq.type == InequalityType::GREATER_THAN ? '>' : '<';
+            key += static_cast<char>(topology::toIndex(ineq.cell1));
+            key += static_cast<char>(topology::toIndex(ineq.cell2));
+        }
+        return key;
+    }
+
+    CanonicalForm SudokuCanonicalizer::canonicalizeStandard(const SudokuPuzzle &puzzle)
+    {
+        MinlexSearch search(puzzle);
+        search.run();
+
+        CanonicalForm form;
+        form.transform = search.bestTransform;
+        form.puzzle = form.transform.apply(puzzle);
+        form.key = makeKey(form.puzzle);
+        return form;
+    }
+
+    CanonicalForm SudokuCanonicalizer::canonicalizeGeometric(const SudokuPuzzle &puzzle)
+    {
+        CanonicalForm best;
+        bool haveBest = false;
+
+        // The 8 rotations and reflections: optional transpose, then optional
+        // reversal of the row and/or column order
+        for (int t = 0; t < 2; t++)
+        {
+            for (int flipRows = 0; flipRows < 2; flipRows++)
+            {
+                for (int flipCols = 0; flipCols < 2; flipCols++)
+                {
+                    CanonicalForm form;
+                    form.transform.transpose = (t == 1);
+                    for (int i = 0; i < GRID_SIZE; i++)
+                    {
+                        form.transform.rowOrder[i] = flipRows ? GRID_SIZE - 1 - i : i;
+                        form.transform.colOrder[i] = flipCols ? GRID_SIZE - 1 - i : i;
+                    }
+                    form.puzzle = form.transform.apply(puzzle);
+                    sortConstraints(form.puzzle);
+                    form.key = makeKey(form.puzzle);
+
+                    if (!haveBest || form.key < best.key)
+                    {
+                        best = form;
+                        haveBest = true;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    CanonicalForm SudokuCanonicalizer::canonicalize(const SudokuPuzzle &puzzle)
+    {
+        if (!puzzle.hasKillerConstraints() && !puzzle.hasInequalityConstraints())
+        {
+            return canonicalizeStandard(puzzle);
+        }
+        return canonicalizeGeometric(puzzle);
+    }
+
+    std::string SudokuCanonicalizer::canonicalKey(const SudokuPuzzle &puzzle)
+    {
+        return canonicalize(puzzle).key;
+    }
+
+    EquivalenceClasses SudokuCanonicalizer::group(const std::vector<SudokuPuzzle> &puzzles)
+    {
+        EquivalenceClasses classes;
+        classes.classOf.reserve(puzzles.size());
+        classes.forms.reserve(puzzles.size());
+
+        std::unordered_map<std::string, size_t> classByKey;
+        for (size_t i = 0; i < puzzles.size(); i++)
+        {
+            classes.forms.push_back(canonicalize(puzzles[i]));
+            auto inserted = classByKey.emplace(classes.forms.back().key, classes.representatives.size());
+            if (inserted.second)
+            {
+                classes.representatives.push_back(i);
+            }
+            classes.classOf.push_back(inserted.first->second);
+        }
+        return classes;
+    }
+
+    std::vector<SudokuSolution> SudokuCanonicalizer::solveDeduplicated(SudokuSolver &solver,
+                                                                       const std::vector<SudokuPuzzle> &puzzles,
+                                                                       bool checkUniqueness)
+    {
+        EquivalenceClasses classes = group(puzzles);
+
+        // Solve the canonical puzzle of each class once
+        std::vector<SudokuSolution> canonicalSolutions;
+        canonicalSolutions.reserve(classes.representatives.size());
+        for (size_t rep : classes.representatives)
+        {
+            canonicalSolutions.push_back(solver.solve(classes.forms[rep].puzzle, checkUniqueness));
+        }
+
+        // Map each class solution back through the member's own transform
+        std::vector<SudokuSolution> solutions;
+        solutions.reserve(puzzles.size());
+        for (size_t i = 0; i < puzzles.size(); i++)
+        {
+            const SudokuSolution &canonical = canonicalSolutions[classes.classOf[i]];
+            solutions.push_back(canonical.solved ? classes.forms[i].transform.invert(canonical) : canonical);
+        }
+        return solutions;
+    }
+
+    bool PuzzleBank::add(const SudokuPuzzle &puzzle)
+    {
+        auto inserted = index.emplace(SudokuCanonicalizer::canonicalKey(puzzle), puzzles.size());
+        if (!inserted.second)
+        {
+            return false;
+        }
+        puzzles.push_back(puzzle);
+        return true;
+    }
+
+    bool PuzzleBank::contains(const SudokuPuzzle &puzzle) const
+    {
+        return index.count(SudokuCanonicalizer::canonicalKey(puzzle)) > 0;
+    }
+
+} // namespace sudoku
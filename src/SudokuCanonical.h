@@ -0,0 +1,174 @@
+/**
+ * @file SudokuCanonical.h
+ * @brief Canonical forms of puzzles under Sudoku symmetries
+ *
+ * Two puzzles that differ only by a validity-preserving symmetry have the
+ * same solutions up to that symmetry, so they can be solved once and stored
+ * once. This module maps a puzzle to a canonical representative:
+ *
+ * - Standard puzzles: minlex form under the full symmetry group
+ *   (transposition, band/row and stack/column permutations, digit relabeling).
+ *   Digits are relabeled in order of first appearance, so the canonical grid is
+ *   the lexicographically smallest 81-character string in the equivalence class.
+ *
+ * - Killer and inequality puzzles: smallest form under the 8 rotations and
+ *   reflections of the grid. Band/row permutations would break cage
+ *   connectivity and inequality adjacency, and digit relabeling would change
+ *   cage sums and inequality directions, so only these geometric symmetries apply.
+ *   Cages and inequalities are rewritten and sorted into a canonical order.
+ *
+ * The returned SymmetryTransform maps a solution of the canonical puzzle back
+ * to a solution of the original puzzle.
+ */
+
+#ifndef SUDOKU_CANONICAL_H
+#define SUDOKU_CANONICAL_H
+
+#include "SudokuTypes.h"
+#include "SudokuSolver.h"
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace sudoku
+{
+
+    /**
+     * @brief A grid symmetry combined with a digit relabeling
+     *
+     * Canonical cell (i, j) takes its value from cell (rowOrder[i], colOrder[j])
+     * of the source grid (of its transpose when transpose is set), relabeled
+     * through digitMap.
+     */
+    struct SymmetryTransform
+    {
+        bool transpose;
+        std::array<int, GRID_SIZE> rowOrder;
+        std::array<int, GRID_SIZE> colOrder;
+        std::array<int, MAX_VALUE + 1> digitMap; // source value -> canonical value, digitMap[0] = 0
+
+        SymmetryTransform();
+
+        // Map a source cell / value to its canonical counterpart
+        Cell toCanonical(const Cell &cell) const;
+        int toCanonicalValue(int value) const;
+
+        // Map a canonical cell / value back to the source
+        Cell fromCanonical(const Cell &cell) const;
+        int fromCanonicalValue(int value) const;
+
+        /**
+         * @brief Apply the transform to a puzzle
+         *
+         * Cages and inequalities are moved with their cells. Their sums and
+         * directions are only meaningful when digitMap is the identity.
+         */
+        SudokuPuzzle apply(const SudokuPuzzle &puzzle) const;
+
+        /**
+         * @brief Apply the transform to a solution of the source puzzle
+         */
+        SudokuSolution apply(const SudokuSolution &solution) const;
+
+        /**
+         * @brief Map a solution of the canonical puzzle back to the source puzzle
+         */
+        SudokuSolution invert(const SudokuSolution &solution) const;
+
+        bool isIdentity() const;
+    };
+
+    /**
+     * @brief A canonical puzzle, the transform producing it, and a comparable key
+     */
+    struct CanonicalForm
+    {
+        SudokuPuzzle puzzle;
+        SymmetryTransform transform;
+        std::string key; // Equal for (and only for) puzzles in the same class
+    };
+
+    /**
+     * @brief Grouping of a puzzle list into symmetry classes
+     */
+    struct EquivalenceClasses
+    {
+        std::vector<size_t> representatives; // Index of the first puzzle of each class
+        std::vector<size_t> classOf;         // Class number of every input puzzle
+        std::vector<CanonicalForm> forms;    // Canonical form of every input puzzle
+    };
+
+    /**
+     * @brief Computes canonical forms and groups puzzles by symmetry
+     */
+    class SudokuCanonicalizer
+    {
+    public:
+        /**
+         * @brief Canonicalize a puzzle
+         * @param puzzle The puzzle to canonicalize
+         * @return Canonical puzzle, its transform and key
+         */
+        static CanonicalForm canonicalize(const SudokuPuzzle &puzzle);
+
+        /**
+         * @brief Canonical key of a puzzle (shortcut for canonicalize().key)
+         */
+        static std::string canonicalKey(const SudokuPuzzle &puzzle);
+
+        /**
+         * @brief Group puzzles into symmetry classes
+         * @param puzzles The puzzles to group
+         * @return Class assignment and canonical forms
+         */
+        static EquivalenceClasses group(const std::vector<SudokuPuzzle> &puzzles);
+
+        /**
+         * @brief Solve a list of puzzles, solving each symmetry class once
+         * @param solver The solver to use
+         * @param puzzles The puzzles to solve
+         * @param checkUniqueness If true, verify that each solution is unique
+         * @return Solutions in input order, mapped back to each original puzzle
+         */
+        static std::vector<SudokuSolution> solveDeduplicated(SudokuSolver &solver,
+                                                             const std::vector<SudokuPuzzle> &puzzles,
+                                                             bool checkUniqueness = false);
+
+    private:
+        static CanonicalForm canonicalizeStandard(const SudokuPuzzle &puzzle);
+        static CanonicalForm canonicalizeGeometric(const SudokuPuzzle &puzzle);
+        static std::string makeKey(const SudokuPuzzle &canonical);
+        static void sortConstraints(SudokuPuzzle &puzzle);
+    };
+
+    /**
+     * @brief A set of puzzles unique up to symmetry
+     *
+     * Used by --generate --count --dedup to reject puzzles already in the bank.
+     */
+    class PuzzleBank
+    {
+    public:
+        /**
+         * @brief Add a puzzle unless an equivalent one is already present
+         * @return true if the puzzle was added, false if it is a duplicate
+         */
+        bool add(const SudokuPuzzle &puzzle);
+
+        /**
+         * @brief Check whether an equivalent puzzle is already present
+         */
+        bool contains(const SudokuPuzzle &puzzle) const;
+
+        size_t size() const { return puzzles.size(); }
+        const std::vector<SudokuPuzzle> &getPuzzles() const { return puzzles; }
+
+    private:
+        std::vector<SudokuPuzzle> puzzles;
+        std::unordered_map<std::string, size_t> index;
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_CANONICAL_H
@@ -0,0 +1,180 @@
+/**
+ * @file SudokuCheckpoint.cpp
+ * @brief Implementation of job checkpoints
+ */
+
+#include "SudokuCheckpoint.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        const char *const kCheckpointHeader = "# sudoku checkpoint";
+        const int kCheckpointVersion = 1;
+    } // namespace
+
+    JobCheckpoint::JobCheckpoint(std::string job)
+        : job(std::move(job))
+    {
+    }
+
+    void JobCheckpoint::markCompleted(uint64_t begin, uint64_t end)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        // Insert in order, then merge overlapping or touching neighbours
+        auto it = std::lower_bound(completed.begin(), completed.end(), begin,
+                                   [](const IndexRange &range, uint64_t value)
+                                   { return range.begin < value; });
+        it = completed.insert(it, IndexRange{begin, end});
+        if (it != completed.begin() && std::prev(it)->end >= it->begin)
+        {
+            it = std::prev(it);
+            it->end = std::max(it->end, std::next(it)->end);
+            completed.erase(std::next(it));
+        }
+        while (std::next(it) != completed.end() && std::next(it)->begin <= it->end)
+        {
+            it->end = std::max(it->end, std::next(it)->end);
+            completed.erase(std::next(it));
+        }
+    }
+
+    bool JobCheckpoint::isCompleted(uint64_t index) const
+    {
+        auto it = std::upper_bound(completed.begin(), completed.end(), index,
+                                   [](uint64_t value, const IndexRange &range)
+                                   { return value < range.begin; });
+        return it != completed.begin() && index < std::prev(it)->end;
+    }
+
+    uint64_t JobCheckpoint::completedPrefix() const
+    {
+        return !completed.empty() && completed.front().begin == 0 ? completed.front().end : 0;
+    }
+
+    void JobCheckpoint::setRng(const std::mt19937 &rng)
+    {
+        std::ostringstream state;
+        state << rng;
+        rngState = state.str();
+    }
+
+    void JobCheckpoint::restoreRng(std::mt19937 &rng) const
+    {
+        std::istringstream state(rngState);
+        if (!(state >> rng))
+        {
+            throw std::runtime_error("Checkpoint holds no generator state");
+        }
+    }
+
+    void JobCheckpoint::save(const std::string &path) const
+    {
+        std::ostringstream text;
+        text << kCheckpointHeader << "\n";
+        text << "version " << kCheckpointVersion << "\n";
+        text << "job " << job << "\n";
+        text << "output " << outputBytes << "\n";
+        text << "rng " << rngState << "\n";
+        text << "completed " << completed.size() << "\n";
+        for (const IndexRange &range : completed)
+        {
+            text << range.begin << ' ' << range.end << "\n";
+        }
+
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary);
+            if (!file.is_open() || !(file << text.str()) || !file.flush())
+            {
+                throw std::runtime_error("Cannot write checkpoint: " + temp);
+            }
+        }
+        if (std::rename(temp.c_str(), path.c_str()) != 0)
+        {
+            throw std::runtime_error("Cannot write checkpoint: " + path);
+        }
+    }
+
+    JobCheckpoint JobCheckpoint::load(const std::string &path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Cannot open checkpoint: " + path);
+        }
+
+        auto malformed = [&path]()
+        {
+            return std::runtime_error("Malformed checkpoint: " + path);
+        };
+
+        // Every line is "key value", the value running to the end of the line
+        auto readLine = [&](const char *key) -> std::string
+        {
+            std::string line;
+            std::string prefix = std::string(key) + ' ';
+            if (!std::getline(file, line) || line.compare(0, prefix.size(), prefix) != 0)
+            {
+                throw malformed();
+            }
+            return line.substr(prefix.size());
+        };
+
+        std::string line;
+        if (!std::getline(file, line) || line != kCheckpointHeader ||
+            readLine("version") != std::to_string(kCheckpointVersion))
+        {
+            throw malformed();
+        }
+
+        JobCheckpoint checkpoint(readLine("job"));
+        try
+        {
+            checkpoint.outputBytes = std::stoull(readLine("output"));
+            checkpoint.rngState = readLine("rng");
+            size_t numRanges = std::stoull(readLine("completed"));
+            for (size_t i = 0; i < numRanges; i++)
+            {
+                IndexRange range{};
+                if (!(file >> range.begin >> range.end) || range.begin >= range.end)
+                {
+                    throw malformed();
+                }
+                checkpoint.markCompleted(range.begin, range.end);
+            }
+        }
+        catch (const std::logic_error &)
+        {
+            throw malformed();
+        }
+        return checkpoint;
+    }
+
+    void truncateOutput(const std::string &path, uint64_t bytes)
+    {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        if (error || size < bytes)
+        {
+            throw std::runtime_error("Output " + path + " is shorter than its checkpoint; cannot resume");
+        }
+        std::filesystem::resize_file(path, bytes, error);
+        if (error)
+        {
+            throw std::runtime_error("Cannot truncate " + path + ": " + error.message());
+        }
+    }
+
+} // namespace sudoku
@@ -0,0 +1,133 @@
+/**
+ * @file SudokuCheckpoint.h
+ * @brief Progress files for resumable long-running jobs
+ *
+ * A checkpoint records which record indices of a job are finished and
+ * safely in its output file, how many bytes of the output they account for,
+ * and, for generation, the state of the job's random number generator.
+ * A job restarted with --resume truncates its output to the recorded size,
+ * restores the generator and skips the finished records, so the final
+ * output is byte-identical to that of an uninterrupted run.
+ *
+ * Checkpoints are text files replaced atomically (write, then rename), so
+ * a job killed while saving leaves the previous checkpoint intact.
+ */
+
+#ifndef SUDOKU_CHECKPOINT_H
+#define SUDOKU_CHECKPOINT_H
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Progress of one job
+     */
+    class JobCheckpoint
+    {
+    public:
+        /**
+         * @brief Record indices [begin, end)
+         */
+        struct IndexRange
+        {
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        /**
+         * @param job Describes the job (mode, input, options); resuming a
+         *        checkpoint written for a different job is refused
+         */
+        explicit JobCheckpoint(std::string job = {});
+
+        /**
+         * @brief Mark records [begin, end) finished, merging adjacent ranges
+         */
+        void markCompleted(uint64_t begin, uint64_t end);
+
+        bool isCompleted(uint64_t index) const;
+
+        /**
+         * @brief Number of records finished from index 0 without a gap
+         */
+        uint64_t completedPrefix() const;
+
+        const std::vector<IndexRange> &getCompleted() const { return completed; }
+
+        /**
+         * @brief Output bytes written by the finished records
+         */
+        void setOutputBytes(uint64_t bytes) { outputBytes = bytes; }
+        uint64_t getOutputBytes() const { return outputBytes; }
+
+        /**
+         * @brief Save or restore a generator's state
+         */
+        void setRng(const std::mt19937 &rng);
+        void restoreRng(std::mt19937 &rng) const;
+        bool hasRng() const { return !rngState.empty(); }
+
+        const std::string &getJob() const { return job; }
+
+        /**
+         * @brief Write the checkpoint, replacing the file atomically
+         * @throws std::runtime_error if the file cannot be written
+         */
+        void save(const std::string &path) const;
+
+        /**
+         * @brief Read a checkpoint written by save()
+         * @throws std::runtime_error if the file is missing or malformed
+         */
+        static JobCheckpoint load(const std::string &path);
+
+    private:
+        std::string job;
+        std::vector<IndexRange> completed; // Sorted, disjoint, not adjacent
+        uint64_t outputBytes = 0;
+        std::string rngState;
+    };
+
+    /**
+     * @brief Says when a periodic checkpoint is due
+     */
+    class CheckpointTimer
+    {
+    public:
+        explicit CheckpointTimer(double intervalSeconds)
+            : interval(intervalSeconds), last(std::chrono::steady_clock::now()) {}
+
+        /**
+         * @brief True once per interval
+         */
+        bool due()
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (std::chrono::duration<double>(now - last).count() < interval)
+            {
+                return false;
+            }
+            last = now;
+            return true;
+        }
+
+    private:
+        double interval;
+        std::chrono::steady_clock::time_point last;
+    };
+
+    /**
+     * @brief Cut a file back to a checkpoint's output size
+     * @throws std::runtime_error if the file is shorter or cannot be truncated
+     */
+    void truncateOutput(const std::string &path, uint64_t bytes);
+
+} // namespace sudoku
+
+#endif // SUDOKU_CHECKPOINT_H
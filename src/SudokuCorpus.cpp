@@ -0,0 +1,239 @@
+/**
+ * @file SudokuCorpus.cpp
+ * @brief Implementation of the memory-mapped corpus reader
+ */
+
+#include "SudokuCorpus.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SUDOKU_HAVE_MMAP 1
+#endif
+
+namespace sudoku
+{
+
+    MappedFile::MappedFile(const std::string &path)
+    {
+#ifdef SUDOKU_HAVE_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        struct stat info;
+        bool haveInfo = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+        if (haveInfo && info.st_size > 0)
+        {
+            void *region = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (region != MAP_FAILED)
+            {
+                // Corpora are read front to back
+                madvise(region, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                data = static_cast<const char *>(region);
+                length = static_cast<size_t>(info.st_size);
+                isMapped = true;
+            }
+        }
+        close(fd);
+        if (isMapped || (haveInfo && info.st_size == 0))
+        {
+            return;
+        }
+#endif
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = fallback.data();
+        length = fallback.size();
+    }
+
+    MappedFile::~MappedFile()
+    {
+#ifdef SUDOKU_HAVE_MMAP
+        if (isMapped)
+        {
+            munmap(const_cast<char *>(data), length);
+        }
+#endif
+    }
+
+    CorpusReader::CorpusReader(std::string_view text, CorpusFormat format)
+        : text(text), pos(0), end(text.size()),
+          format(format == CorpusFormat::AUTO ? detectFormat(text) : format)
+    {
+    }
+
+    CorpusReader::CorpusReader(std::string_view text, Range range, CorpusFormat format)
+        : text(text), pos(range.begin), end(range.end),
+          format(format == CorpusFormat::AUTO ? detectFormat(text) : format)
+    {
+    }
+
+    bool CorpusReader::nextLine(size_t &lineBegin, size_t &lineEnd, size_t &nextPos) const
+    {
+        if (pos >= end)
+        {
+            return false;
+        }
+        lineBegin = pos;
+        size_t newline = text.find('\n', pos);
+        if (newline == std::string_view::npos)
+        {
+            newline = text.size();
+        }
+        nextPos = newline + 1;
+        lineEnd = newline;
+        while (lineEnd > lineBegin && (text[lineEnd - 1] == '\r' || text[lineEnd - 1] == ' ' ||
+                                       text[lineEnd - 1] == '\t'))
+        {
+            lineEnd--;
+        }
+        return true;
+    }
+
+    bool CorpusReader::isGridHeader(std::string_view line)
+    {
+        while (!line.empty() && (line.front() == ' ' || line.front() == '\t'))
+        {
+            line.remove_prefix(1);
+        }
+        return line == "GRID";
+    }
+
+    bool CorpusReader::next(std::string_view &record)
+    {
+        size_t lineBegin, lineEnd, nextPos;
+
+        if (format == CorpusFormat::LINES)
+        {
+            while (nextLine(lineBegin, lineEnd, nextPos))
+            {
+                pos = nextPos;
+                if (lineEnd > lineBegin && text[lineBegin] != '#')
+                {
+                    record = text.substr(lineBegin, lineEnd - lineBegin);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Blocks: skip to a GRID header, then extend to the next header
+        size_t recordBegin = std::string_view::npos;
+        size_t recordEnd = 0;
+        while (nextLine(lineBegin, lineEnd, nextPos))
+        {
+            pos = nextPos;
+            if (isGridHeader(text.substr(lineBegin, lineEnd - lineBegin)))
+            {
+                recordBegin = lineBegin;
+                recordEnd = lineEnd;
+                break;
+            }
+        }
+        if (recordBegin == std::string_view::npos)
+        {
+            return false;
+        }
+
+        while (nextLine(lineBegin, lineEnd, nextPos))
+        {
+            if (isGridHeader(text.substr(lineBegin, lineEnd - lineBegin)))
+            {
+                break; // Leave pos at the next record
+            }
+            pos = nextPos;
+            if (lineEnd > lineBegin)
+            {
+                recordEnd = lineEnd;
+            }
+        }
+
+        record = text.substr(recordBegin, recordEnd - recordBegin);
+        return true;
+    }
+
+    CorpusFormat CorpusReader::detectFormat(std::string_view text)
+    {
+        CorpusReader reader(text, CorpusFormat::LINES);
+        std::string_view first;
+        if (reader.next(first) && isGridHeader(first))
+        {
+            return CorpusFormat::BLOCKS;
+        }
+        return CorpusFormat::LINES;
+    }
+
+    size_t CorpusReader::alignToRecord(std::string_view text, size_t offset, CorpusFormat format)
+    {
+        if (offset == 0 || offset >= text.size())
+        {
+            return std::min(offset, text.size());
+        }
+
+        // Move to the start of the next line
+        if (text[offset - 1] != '\n')
+        {
+            size_t newline = text.find('\n', offset);
+            offset = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+        if (format == CorpusFormat::LINES)
+        {
+            return offset;
+        }
+
+        // Blocks: move to the next GRID header line
+        CorpusReader reader(text, Range{offset, text.size()}, CorpusFormat::LINES);
+        size_t lineBegin, lineEnd, nextPos;
+        while (reader.nextLine(lineBegin, lineEnd, nextPos))
+        {
+            if (isGridHeader(text.substr(lineBegin, lineEnd - lineBegin)))
+            {
+                return lineBegin;
+            }
+            reader.pos = nextPos;
+        }
+        return text.size();
+    }
+
+    std::vector<CorpusReader::Range> CorpusReader::split(std::string_view text, int parts, CorpusFormat format)
+    {
+        if (format == CorpusFormat::AUTO)
+        {
+            format = detectFormat(text);
+        }
+        if (parts < 1)
+        {
+            parts = 1;
+        }
+
+        std::vector<Range> ranges;
+        size_t begin = 0;
+        for (int i = 1; i <= parts && begin < text.size(); i++)
+        {
+            size_t target = text.size() / parts * i;
+            size_t end = i == parts ? text.size() : alignToRecord(text, target, format);
+            if (end > begin)
+            {
+                ranges.push_back(Range{begin, end});
+                begin = end;
+            }
+        }
+        if (ranges.empty())
+        {
+            ranges.push_back(Range{0, text.size()});
+        }
+        return ranges;
+    }
+
+} // namespace sudoku
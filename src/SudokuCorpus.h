@@ -0,0 +1,131 @@
+/**
+ * @file SudokuCorpus.h
+ * @brief Zero-copy reader for large puzzle corpora
+ *
+ * The corpus file is memory-mapped and puzzle records are returned as
+ * std::string_view slices of the mapping. Two layouts are recognized:
+ *
+ * - Lines: one puzzle per line (e.g. 81-character grids). Blank lines and
+ *   lines starting with '#' are skipped; trailing whitespace is trimmed.
+ *
+ * - Blocks: custom text format records, each starting at a line that reads
+ *   "GRID" and extending to the next such line (CAGES and INEQUALITIES
+ *   sections included).
+ *
+ * A corpus can be split into byte ranges aligned to record boundaries, so
+ * independent readers can process disjoint parts in parallel.
+ */
+
+#ifndef SUDOKU_CORPUS_H
+#define SUDOKU_CORPUS_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Read-only memory mapping of a whole file
+     *
+     * Falls back to reading the file into memory where mmap is unavailable.
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * @brief Map a file
+         * @throws std::runtime_error if the file cannot be opened
+         */
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        std::string_view contents() const { return std::string_view(data, length); }
+        size_t size() const { return length; }
+
+    private:
+        const char *data = nullptr;
+        size_t length = 0;
+        bool isMapped = false;
+        std::string fallback;
+    };
+
+    /**
+     * @brief Record layout of a corpus
+     */
+    enum class CorpusFormat
+    {
+        AUTO,  // Detect from the first meaningful line
+        LINES, // One puzzle per line
+        BLOCKS // GRID/CAGES/INEQUALITIES blocks
+    };
+
+    /**
+     * @brief Iterates the puzzle records of one byte range of a corpus
+     */
+    class CorpusReader
+    {
+    public:
+        /**
+         * @brief A byte range [begin, end) starting at a record boundary
+         */
+        struct Range
+        {
+            size_t begin;
+            size_t end;
+        };
+
+        /**
+         * @brief Read all records of a text
+         * @param text Corpus contents; must outlive the reader
+         * @param format Record layout (AUTO detects it)
+         */
+        explicit CorpusReader(std::string_view text, CorpusFormat format = CorpusFormat::AUTO);
+
+        /**
+         * @brief Read the records of one range produced by split()
+         */
+        CorpusReader(std::string_view text, Range range, CorpusFormat format);
+
+        /**
+         * @brief Get the next record
+         * @param record Receives a slice of the corpus text
+         * @return false at the end of the range
+         */
+        bool next(std::string_view &record);
+
+        CorpusFormat getFormat() const { return format; }
+
+        /**
+         * @brief Detect the layout of a corpus
+         */
+        static CorpusFormat detectFormat(std::string_view text);
+
+        /**
+         * @brief Split a corpus into up to parts ranges of similar byte size
+         *
+         * Every range starts at a record boundary, so each record belongs to
+         * exactly one range. Fewer ranges are returned for small inputs.
+         */
+        static std::vector<Range> split(std::string_view text, int parts, CorpusFormat format = CorpusFormat::AUTO);
+
+    private:
+        std::string_view text;
+        size_t pos;
+        size_t end;
+        CorpusFormat format;
+
+        // Line [lineBegin, lineEnd) without the newline and trailing whitespace
+        bool nextLine(size_t &lineBegin, size_t &lineEnd, size_t &nextPos) const;
+        static bool isGridHeader(std::string_view line);
+        static size_t alignToRecord(std::string_view text, size_t offset, CorpusFormat format);
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_CORPUS_H
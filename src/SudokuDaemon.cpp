@@ -0,0 +1,755 @@
+/**
+ * @file SudokuDaemon.cpp
+ * @brief Implementation of the local socket daemon
+ */
+
+#include "SudokuDaemon.h"
+#include "SudokuWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        constexpr int kPollIntervalMs = 100;       // How often run() notices stop()
+        constexpr size_t kReadChunk = 64 * 1024;
+        constexpr size_t kMaxLineBytes = 1 << 20; // A request line beyond this closes the connection
+
+        std::runtime_error socketError(const std::string &what)
+        {
+            return std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        bool isBlank(std::string_view line)
+        {
+            return line.find_first_not_of(" \t\r") == std::string_view::npos;
+        }
+
+        // Standard solves are cheap enough to be worth running back to back
+        bool isBatchable(const ServerRequest &request)
+        {
+            return request.isSolve() && request.puzzle.type == SudokuType::STANDARD;
+        }
+
+        bool isHttpRequest(std::string_view buffer)
+        {
+            return buffer.compare(0, 4, "GET ") == 0;
+        }
+
+        // Offset just past the blank line that ends the HTTP headers, or npos
+        size_t httpHeadersEnd(std::string_view buffer)
+        {
+            size_t end = buffer.find("\r\n\r\n");
+            if (end != std::string_view::npos)
+                return end + 4;
+            end = buffer.find("\n\n");
+            return end == std::string_view::npos ? end : end + 2;
+        }
+    } // namespace
+
+    SudokuDaemon::Connection::~Connection()
+    {
+        ::close(fd);
+    }
+
+    void SudokuDaemon::Connection::send(const std::string &data)
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        size_t sent = 0;
+        while (sent < data.size())
+        {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return; // The client went away; nobody is left to tell
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+    SudokuDaemon::SudokuDaemon(DaemonConfig config) : config(std::move(config))
+    {
+        const DaemonConfig &cfg = this->config;
+        if (cfg.socketPath.empty() && cfg.tcpPort < 0)
+        {
+            throw std::runtime_error("daemon needs a socket path or a TCP port");
+        }
+
+        try
+        {
+            if (!cfg.socketPath.empty())
+            {
+                sockaddr_un address{};
+                address.sun_family = AF_UNIX;
+                if (cfg.socketPath.size() >= sizeof(address.sun_path))
+                {
+                    throw std::runtime_error("socket path too long: " + cfg.socketPath);
+                }
+                std::memcpy(address.sun_path, cfg.socketPath.c_str(), cfg.socketPath.size() + 1);
+
+                unixFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                if (unixFd < 0)
+                {
+                    throw socketError("socket");
+                }
+                ::unlink(cfg.socketPath.c_str()); // Left behind by a previous run
+                if (::bind(unixFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+                    ::listen(unixFd, SOMAXCONN) < 0)
+                {
+                    throw socketError("cannot listen on " + cfg.socketPath);
+                }
+            }
+
+            if (cfg.tcpPort >= 0)
+            {
+                sockaddr_in address{};
+                address.sin_family = AF_INET;
+                address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                address.sin_port = htons(static_cast<uint16_t>(cfg.tcpPort));
+
+                tcpFd = ::socket(AF_INET, SOCK_STREAM, 0);
+                if (tcpFd < 0)
+                {
+                    throw socketError("socket");
+                }
+                int reuse = 1;
+                ::setsockopt(tcpFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+                if (::bind(tcpFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+                    ::listen(tcpFd, SOMAXCONN) < 0)
+                {
+                    throw socketError("cannot listen on 127.0.0.1:" + std::to_string(cfg.tcpPort));
+                }
+
+                socklen_t length = sizeof(address);
+                ::getsockname(tcpFd, reinterpret_cast<sockaddr *>(&address), &length);
+                tcpPort = ntohs(address.sin_port);
+            }
+        }
+        catch (...)
+        {
+            if (unixFd >= 0)
+                ::close(unixFd);
+            if (tcpFd >= 0)
+                ::close(tcpFd);
+            throw;
+        }
+
+        auto startWorkers = [this](Queue &queue, int count)
+        {
+            for (int i = 0; i < std::max(1, count); i++)
+            {
+                handlers.push_back(std::make_unique<RequestHandler>());
+                RequestHandler &handler = *handlers.back();
+                queue.threads.emplace_back([this, &queue, &handler]()
+                                           { work(queue, handler); });
+            }
+        };
+        startWorkers(interactive, cfg.interactiveThreads);
+        startWorkers(bulk, cfg.bulkThreads);
+        sweeper = std::thread([this]()
+                              { sweepDeadlines(); });
+    }
+
+    SudokuDaemon::~SudokuDaemon()
+    {
+        stop();
+        shutdown();
+    }
+
+    void SudokuDaemon::setCache(std::shared_ptr<SolutionCache> cache)
+    {
+        for (auto &handler : handlers)
+        {
+            handler->setCache(cache);
+        }
+    }
+
+    void SudokuDaemon::setMetrics(std::shared_ptr<ServiceMetrics> serviceMetrics)
+    {
+        metrics = std::move(serviceMetrics);
+        for (auto &handler : handlers)
+        {
+            handler->setMetrics(metrics);
+        }
+
+        for (auto [queue, name] : {std::make_pair(&interactive, "interactive"), std::make_pair(&bulk, "bulk")})
+        {
+            metrics->watchQueue(name, [queue]()
+                                {
+                                    std::lock_guard<std::mutex> lock(queue->mutex);
+                                    return static_cast<double>(queue->jobs.size()); });
+        }
+
+        MetricsRegistry &registry = metrics->getRegistry();
+        registry.describe("sudoku_daemon_connections_total", "Client connections accepted", MetricType::COUNTER);
+        registry.describe("sudoku_daemon_coalesced_total", "Solves answered from an identical in-flight solve",
+                          MetricType::COUNTER);
+        registry.describe("sudoku_daemon_micro_batches_total", "Worker wakeups that took several solves",
+                          MetricType::COUNTER);
+        registry.watch("sudoku_daemon_connections_total", {}, [this]()
+                       { return static_cast<double>(connections.load()); });
+        registry.watch("sudoku_daemon_coalesced_total", {}, [this]()
+                       { return static_cast<double>(coalesced.load()); });
+        registry.watch("sudoku_daemon_micro_batches_total", {}, [this]()
+                       { return static_cast<double>(batches.load()); });
+    }
+
+    void SudokuDaemon::recordRequest(RequestOp op, const char *outcome)
+    {
+        if (metrics)
+        {
+            metrics->recordRequest(RequestHandler::opName(op), outcome);
+        }
+    }
+
+    DaemonStats SudokuDaemon::getStats() const
+    {
+        DaemonStats stats;
+        stats.connections = connections.load();
+        stats.requests = requests.load();
+        stats.rejected = rejected.load();
+        stats.coalesced = coalesced.load();
+        stats.expired = expired.load();
+        stats.batches = batches.load();
+        return stats;
+    }
+
+    void SudokuDaemon::run()
+    {
+        std::vector<pollfd> listeners;
+        for (int fd : {unixFd, tcpFd})
+        {
+            if (fd >= 0)
+            {
+                listeners.push_back(pollfd{fd, POLLIN, 0});
+            }
+        }
+
+        while (!stopping.load())
+        {
+            int ready = ::poll(listeners.data(), listeners.size(), kPollIntervalMs);
+            if (ready < 0 && errno != EINTR)
+            {
+                throw socketError("poll");
+            }
+            for (const pollfd &listener : listeners)
+            {
+                if (ready > 0 && (listener.revents & POLLIN))
+                {
+                    acceptClient(listener.fd);
+                }
+            }
+
+            // Join the readers of clients that have hung up
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            for (auto it = clients.begin(); it != clients.end();)
+            {
+                if ((*it)->done.load())
+                {
+                    (*it)->reader.join();
+                    it = clients.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    void SudokuDaemon::acceptClient(int listenFd)
+    {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            return;
+        }
+        if (listenFd == tcpFd)
+        {
+            // Responses are small and latency-bound
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        connections++;
+
+        auto client = std::make_unique<Client>();
+        client->connection = std::make_shared<Connection>(fd);
+        Client &ref = *client;
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        clients.push_back(std::move(client));
+        ref.reader = std::thread([this, &ref]()
+                                 { readClient(ref); });
+    }
+
+    void SudokuDaemon::readClient(Client &client)
+    {
+        std::shared_ptr<Connection> connection = client.connection;
+        std::string buffer;
+        std::vector<char> chunk(kReadChunk);
+        bool firstLine = true;
+
+        for (;;)
+        {
+            ssize_t n = ::recv(connection->fd, chunk.data(), chunk.size(), 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            buffer.append(chunk.data(), static_cast<size_t>(n));
+
+            if (firstLine && isHttpRequest(buffer))
+            {
+                // Answer once all headers are in, so closing does not reset unread data
+                if (httpHeadersEnd(buffer) == std::string::npos && buffer.size() <= kMaxLineBytes)
+                {
+                    continue;
+                }
+                serveHttp(*connection, std::string_view(buffer).substr(0, buffer.find_first_of("\r\n")));
+                buffer.clear();
+                break;
+            }
+
+            size_t start = 0;
+            size_t end;
+            while ((end = buffer.find('\n', start)) != std::string::npos)
+            {
+                std::string_view line(buffer.data() + start, end - start);
+                if (!isBlank(line))
+                {
+                    dispatch(connection, line);
+                    firstLine = false;
+                }
+                start = end + 1;
+            }
+            buffer.erase(0, start);
+
+            if (buffer.size() > kMaxLineBytes)
+            {
+                std::string response;
+                RequestHandler::appendError(response, {}, "request line too long");
+                response += '\n';
+                connection->send(response);
+                buffer.clear();
+                break;
+            }
+        }
+
+        // A final request without a newline still counts
+        if (!isBlank(buffer) && !stopping.load())
+        {
+            dispatch(connection, buffer);
+        }
+        client.done.store(true);
+    }
+
+    void SudokuDaemon::serveHttp(Connection &connection, std::string_view requestLine)
+    {
+        // "GET /metrics HTTP/1.1"
+        std::string_view path = requestLine.substr(4);
+        path = path.substr(0, path.find(' '));
+
+        std::string body;
+        const char *status = "200 OK";
+        if (path != "/metrics")
+        {
+            status = "404 Not Found";
+            body = "Not found; metrics are at /metrics\n";
+        }
+        else if (!metrics)
+        {
+            status = "404 Not Found";
+            body = "Metrics are not enabled\n";
+        }
+        else
+        {
+            body = metrics->renderPrometheus();
+        }
+
+        std::string response = "HTTP/1.0 ";
+        response += status;
+        response += "\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: ";
+        response += std::to_string(body.size());
+        response += "\r\nConnection: close\r\n\r\n";
+        response += body;
+        connection.send(response);
+        ::shutdown(connection.fd, SHUT_WR);
+    }
+
+    void SudokuDaemon::dispatch(const std::shared_ptr<Connection> &connection, std::string_view line)
+    {
+        requests++;
+
+        auto job = std::make_shared<Job>();
+        std::string response;
+        try
+        {
+            RequestHandler::parse(line, job->request);
+        }
+        catch (const std::exception &e)
+        {
+            RequestHandler::appendError(response, job->request.id, e.what());
+            response += '\n';
+            connection->send(response);
+            if (metrics)
+                metrics->recordRequest("invalid", "error");
+            return;
+        }
+
+        Waiter waiter;
+        waiter.connection = connection;
+        waiter.id = job->request.id;
+        double deadlineMs = job->request.deadlineMs > 0 ? job->request.deadlineMs : config.defaultDeadlineMs;
+        if (deadlineMs > 0)
+        {
+            waiter.hasDeadline = true;
+            waiter.deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                                 std::chrono::duration<double, std::milli>(deadlineMs));
+        }
+
+        if (job->request.isSolve())
+        {
+            job->key = job->request.checkUniqueness ? "u" : "s";
+            SudokuWriter::appendCustomFormat(job->key, job->request.puzzle);
+        }
+
+        Queue &queue = job->request.op == RequestOp::GENERATE ? bulk : interactive;
+        bool admitted = false;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!job->key.empty())
+            {
+                auto it = queue.pending.find(job->key);
+                if (it != queue.pending.end())
+                {
+                    bool hasDeadline = waiter.hasDeadline;
+                    it->second->waiters.push_back(std::move(waiter));
+                    coalesced++;
+                    if (hasDeadline)
+                    {
+                        std::lock_guard<std::mutex> sweepLock(sweepMutex);
+                        deadlineAdded = true;
+                        sweepWake.notify_one();
+                    }
+                    return;
+                }
+            }
+
+            admitted = queue.jobs.size() < config.maxQueued;
+            if (admitted)
+            {
+                job->waiters.push_back(waiter);
+                if (!job->key.empty())
+                {
+                    queue.pending.emplace(job->key, job);
+                }
+                queue.jobs.push_back(std::move(job));
+            }
+        }
+
+        if (!admitted)
+        {
+            rejected++;
+            recordRequest(job->request.op, "overloaded");
+            RequestHandler::appendError(response, waiter.id, "overloaded");
+            response += '\n';
+            connection->send(response);
+            return;
+        }
+        queue.available.notify_one();
+        if (waiter.hasDeadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sweepMutex);
+                deadlineAdded = true;
+            }
+            sweepWake.notify_one();
+        }
+    }
+
+    void SudokuDaemon::work(Queue &queue, RequestHandler &handler)
+    {
+        std::vector<std::shared_ptr<Job>> batch;
+        std::vector<std::pair<std::shared_ptr<Connection>, std::string>> outputs;
+
+        auto outputFor = [&outputs](const std::shared_ptr<Connection> &connection) -> std::string &
+        {
+            for (auto &output : outputs)
+            {
+                if (output.first == connection)
+                    return output.second;
+            }
+            outputs.emplace_back(connection, std::string());
+            return outputs.back().second;
+        };
+
+        for (;;)
+        {
+            batch.clear();
+            {
+                std::unique_lock<std::mutex> lock(queue.mutex);
+                queue.available.wait(lock, [this, &queue]()
+                                     { return workersStopping || !queue.jobs.empty(); });
+                if (workersStopping)
+                {
+                    return;
+                }
+
+                batch.push_back(std::move(queue.jobs.front()));
+                queue.jobs.pop_front();
+                if (isBatchable(batch.front()->request))
+                {
+                    while (batch.size() < config.microBatch && !queue.jobs.empty() &&
+                           isBatchable(queue.jobs.front()->request))
+                    {
+                        batch.push_back(std::move(queue.jobs.front()));
+                        queue.jobs.pop_front();
+                    }
+                }
+            }
+            if (batch.size() > 1)
+            {
+                batches++;
+            }
+
+            for (const auto &job : batch)
+            {
+                std::vector<Waiter> waiters;
+
+                // Skip the work if everyone waiting for it has given up
+                bool wanted = false;
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    Clock::time_point now = Clock::now();
+                    for (const Waiter &waiter : job->waiters)
+                    {
+                        wanted = wanted || !waiter.hasDeadline || waiter.deadline > now;
+                    }
+                    if (!wanted)
+                    {
+                        queue.pending.erase(job->key);
+                        waiters = std::move(job->waiters);
+                    }
+                }
+
+                SudokuSolution solution;
+                std::string response;
+                std::string error;
+                if (wanted)
+                {
+                    try
+                    {
+                        if (job->request.isSolve())
+                            solution = handler.solve(job->request);
+                        else
+                            handler.answer(job->request, response);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        error = e.what();
+                    }
+
+                    // Identical requests may have joined while this one ran
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (!job->key.empty())
+                    {
+                        queue.pending.erase(job->key);
+                    }
+                    waiters = std::move(job->waiters);
+                }
+
+                for (const Waiter &waiter : waiters)
+                {
+                    std::string &out = outputFor(waiter.connection);
+                    if (!wanted)
+                    {
+                        expired++;
+                        recordRequest(job->request.op, "expired");
+                        RequestHandler::appendError(out, waiter.id, "deadline exceeded");
+                    }
+                    else if (!error.empty())
+                    {
+                        recordRequest(job->request.op, "error");
+                        RequestHandler::appendError(out, waiter.id, error);
+                    }
+                    else if (job->request.isSolve())
+                    {
+                        recordRequest(job->request.op, "ok");
+                        SudokuWriter::appendSolutionJson(out, solution, waiter.id);
+                    }
+                    else
+                    {
+                        recordRequest(job->request.op, "ok");
+                        out += response; // Only solves coalesce, so this is the requester
+                    }
+                    out += '\n';
+                }
+
+                // Answer this job now rather than after the rest of the batch;
+                // coalesced requests from one connection still share a write
+                for (auto &output : outputs)
+                {
+                    output.first->send(output.second);
+                }
+                outputs.clear();
+            }
+        }
+    }
+
+    SudokuDaemon::Clock::time_point SudokuDaemon::expireQueued(Queue &queue, Clock::time_point now,
+                                                               std::vector<std::pair<Waiter, RequestOp>> &late)
+    {
+        Clock::time_point next = Clock::time_point::max();
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (auto it = queue.jobs.begin(); it != queue.jobs.end();)
+        {
+            Job &job = **it;
+            size_t kept = 0;
+            for (size_t i = 0; i < job.waiters.size(); i++)
+            {
+                Waiter &waiter = job.waiters[i];
+                if (waiter.hasDeadline && waiter.deadline <= now)
+                {
+                    late.emplace_back(std::move(waiter), job.request.op);
+                    continue;
+                }
+                if (waiter.hasDeadline)
+                {
+                    next = std::min(next, waiter.deadline);
+                }
+                if (kept != i)
+                {
+                    job.waiters[kept] = std::move(waiter);
+                }
+                kept++;
+            }
+            job.waiters.resize(kept);
+
+            // Nobody is left waiting for it, so it never reaches a worker
+            if (job.waiters.empty())
+            {
+                if (!job.key.empty())
+                {
+                    queue.pending.erase(job.key);
+                }
+                it = queue.jobs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        return next;
+    }
+
+    void SudokuDaemon::sweepDeadlines()
+    {
+        std::vector<std::pair<Waiter, RequestOp>> late;
+        for (;;)
+        {
+            Clock::time_point now = Clock::now();
+            Clock::time_point next = std::min(expireQueued(interactive, now, late), expireQueued(bulk, now, late));
+            for (const auto &[waiter, op] : late)
+            {
+                expired++;
+                recordRequest(op, "expired");
+                std::string response;
+                RequestHandler::appendError(response, waiter.id, "deadline exceeded");
+                response += '\n';
+                waiter.connection->send(response);
+            }
+            late.clear();
+
+            std::unique_lock<std::mutex> lock(sweepMutex);
+            auto woken = [this]()
+            { return deadlineAdded || workersStopping; };
+            if (next == Clock::time_point::max())
+            {
+                sweepWake.wait(lock, woken);
+            }
+            else
+            {
+                sweepWake.wait_until(lock, next, woken);
+            }
+            if (workersStopping)
+            {
+                return;
+            }
+            deadlineAdded = false;
+        }
+    }
+
+    void SudokuDaemon::shutdown()
+    {
+        if (unixFd >= 0)
+        {
+            ::close(unixFd);
+            ::unlink(config.socketPath.c_str());
+            unixFd = -1;
+        }
+        if (tcpFd >= 0)
+        {
+            ::close(tcpFd);
+            tcpFd = -1;
+        }
+
+        // Wake readers blocked in recv(); the sockets close with their last job
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            for (auto &client : clients)
+            {
+                ::shutdown(client->connection->fd, SHUT_RDWR);
+            }
+        }
+        for (auto &client : clients)
+        {
+            client->reader.join();
+        }
+        clients.clear();
+
+        for (Queue *queue : {&interactive, &bulk})
+        {
+            {
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                workersStopping = true;
+            }
+            queue->available.notify_all();
+        }
+        for (Queue *queue : {&interactive, &bulk})
+        {
+            for (auto &thread : queue->threads)
+            {
+                thread.join();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(sweepMutex);
+        }
+        sweepWake.notify_all();
+        if (sweeper.joinable())
+        {
+            sweeper.join();
+        }
+    }
+
+} // namespace sudoku
@@ -0,0 +1,216 @@
+/**
+ * @file SudokuDaemon.h
+ * @brief Local socket daemon (sudoku_solve --daemon)
+ *
+ * Listens on a Unix domain socket and/or 127.0.0.1 TCP and speaks the same
+ * newline-delimited JSON protocol as --serve (see SudokuServer.h) to any
+ * number of concurrent clients. Each connection may pipeline requests;
+ * responses come back in completion order and carry the request's id.
+ *
+ * - Two queues with their own worker threads: interactive (solve, unique,
+ *   verify) and bulk (generate), so long generations never hold up solves.
+ * - Admission control: a request arriving at a full queue is answered at
+ *   once with {"error": "overloaded"} instead of waiting.
+ * - Micro-batching: an interactive worker takes up to microBatch queued
+ *   standard solves per wakeup and runs them back to back on its warm
+ *   solver. Each solve is answered as soon as it finishes, with one send per
+ *   connection waiting for it.
+ * - Coalescing: a solve identical to one already queued or running (same
+ *   puzzle and uniqueness check) is attached to it and answered from the
+ *   same result.
+ * - Deadlines: "deadlineMs" (or the default) bounds how long a request may
+ *   wait in its queue. A sweeper thread sleeps until the earliest queued
+ *   deadline and answers each request still waiting then with
+ *   {"error": "deadline exceeded"}, even while every worker is busy. A solve
+ *   that has started runs to the end.
+ * - Metrics: with setMetrics(), a connection whose first line is
+ *   "GET /metrics HTTP/1.x" gets the Prometheus text over HTTP and is
+ *   closed, so the same socket serves scrapers and curl.
+ */
+
+#ifndef SUDOKU_DAEMON_H
+#define SUDOKU_DAEMON_H
+
+#include "SudokuServer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Daemon settings
+     */
+    struct DaemonConfig
+    {
+        std::string socketPath;        // Unix domain socket (empty = none)
+        int tcpPort = -1;              // Port on 127.0.0.1 (-1 = none, 0 = any free port)
+        int interactiveThreads = 1;    // Workers for solve, unique and verify
+        int bulkThreads = 1;           // Workers for generate
+        size_t maxQueued = 1024;       // Per queue; further requests are rejected
+        size_t microBatch = 16;        // Standard solves taken per wakeup
+        double defaultDeadlineMs = 0;  // Applies when a request has none (0 = none)
+    };
+
+    /**
+     * @brief Counters since the daemon started
+     */
+    struct DaemonStats
+    {
+        size_t connections = 0;
+        size_t requests = 0;
+        size_t rejected = 0;  // Answered "overloaded"
+        size_t coalesced = 0; // Attached to an identical solve
+        size_t expired = 0;   // Answered "deadline exceeded"
+        size_t batches = 0;   // Wakeups that took more than one solve
+    };
+
+    /**
+     * @brief Multi-client request daemon
+     */
+    class SudokuDaemon
+    {
+    public:
+        /**
+         * @brief Open the listening sockets and start the workers
+         * @throws std::runtime_error if no socket is configured or one cannot be opened
+         */
+        explicit SudokuDaemon(DaemonConfig config);
+
+        /**
+         * @brief Close every connection and join all threads
+         *
+         * Queued requests that have not started are dropped. run() must have
+         * returned.
+         */
+        ~SudokuDaemon();
+
+        SudokuDaemon(const SudokuDaemon &) = delete;
+        SudokuDaemon &operator=(const SudokuDaemon &) = delete;
+
+        /**
+         * @brief Share a solution cache between the workers
+         */
+        void setCache(std::shared_ptr<SolutionCache> cache);
+
+        /**
+         * @brief Record metrics from all workers and serve them over HTTP
+         *
+         * Call before run().
+         */
+        void setMetrics(std::shared_ptr<ServiceMetrics> serviceMetrics);
+
+        /**
+         * @brief Accept clients until stop() is called
+         */
+        void run();
+
+        /**
+         * @brief Make run() return; safe to call from a signal handler
+         */
+        void stop() { stopping.store(true); }
+
+        /**
+         * @brief The bound TCP port (useful with tcpPort = 0), or -1
+         */
+        int getTcpPort() const { return tcpPort; }
+
+        DaemonStats getStats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Connection
+        {
+            int fd = -1;
+            std::mutex writeMutex;
+
+            explicit Connection(int fd) : fd(fd) {}
+            ~Connection(); // Closes the socket once no job still holds it
+
+            void send(const std::string &data);
+        };
+
+        struct Waiter
+        {
+            std::shared_ptr<Connection> connection;
+            std::string id;
+            Clock::time_point deadline;
+            bool hasDeadline = false;
+        };
+
+        struct Job
+        {
+            ServerRequest request;
+            std::string key; // Coalescing key; empty if not coalescable
+            std::vector<Waiter> waiters;
+        };
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::condition_variable available;
+            std::deque<std::shared_ptr<Job>> jobs;
+            std::unordered_map<std::string, std::shared_ptr<Job>> pending; // By key, until answered
+            std::vector<std::thread> threads;
+        };
+
+        struct Client
+        {
+            std::shared_ptr<Connection> connection;
+            std::thread reader;
+            std::atomic<bool> done{false};
+        };
+
+        DaemonConfig config;
+        int unixFd = -1;
+        int tcpFd = -1;
+        int tcpPort = -1;
+        std::atomic<bool> stopping{false};
+        std::atomic<bool> workersStopping{false};
+
+        Queue interactive;
+        Queue bulk;
+        std::vector<std::unique_ptr<RequestHandler>> handlers; // One per worker thread
+        std::shared_ptr<ServiceMetrics> metrics;
+
+        std::mutex clientsMutex;
+        std::list<std::unique_ptr<Client>> clients;
+
+        // Deadline sweeper; woken early when a request with a deadline is queued
+        std::thread sweeper;
+        std::mutex sweepMutex;
+        std::condition_variable sweepWake;
+        bool deadlineAdded = false;
+
+        std::atomic<size_t> connections{0};
+        std::atomic<size_t> requests{0};
+        std::atomic<size_t> rejected{0};
+        std::atomic<size_t> coalesced{0};
+        std::atomic<size_t> expired{0};
+        std::atomic<size_t> batches{0};
+
+        void acceptClient(int listenFd);
+        void readClient(Client &client);
+        void dispatch(const std::shared_ptr<Connection> &connection, std::string_view line);
+        void serveHttp(Connection &connection, std::string_view requestLine);
+        void recordRequest(RequestOp op, const char *outcome);
+        void work(Queue &queue, RequestHandler &handler);
+        void sweepDeadlines();
+        Clock::time_point expireQueued(Queue &queue, Clock::time_point now,
+                                       std::vector<std::pair<Waiter, RequestOp>> &late);
+        void shutdown();
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_DAEMON_H
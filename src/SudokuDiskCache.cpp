@@ -0,0 +1,462 @@
+/**
+ * @file SudokuDiskCache.cpp
+ * @brief Implementation of the persistent solution cache
+ */
+
+#include "SudokuDiskCache.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SUDOKU_HAVE_MMAP 1
+#endif
+
+namespace sudoku
+{
+
+    namespace
+    {
+        constexpr char kMagic[8] = {'S', 'U', 'D', 'O', 'K', 'U', 'D', 'C'};
+        constexpr uint32_t kVersion = 1;
+
+        /**
+         * @brief File header (24 bytes, native byte order)
+         */
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t boxRows;
+            uint32_t boxCols;
+            uint32_t recordSize;
+        };
+        static_assert(sizeof(FileHeader) == 24, "Unexpected header padding");
+
+        constexpr uint8_t kSolvedFlag = 1;
+        constexpr int kUniquenessShift = 1;
+
+        /**
+         * @brief Holds an exclusive advisory lock on an open file
+         *
+         * Every process appending to the same cache file takes it, so the
+         * file size seen under the lock only changes by whole records.
+         */
+        class FileLock
+        {
+        public:
+            explicit FileLock(std::FILE *file) : file(file)
+            {
+#ifdef SUDOKU_HAVE_MMAP
+                while (flock(fileno(file), LOCK_EX) != 0 && errno == EINTR)
+                {
+                }
+#endif
+            }
+
+            ~FileLock()
+            {
+#ifdef SUDOKU_HAVE_MMAP
+                flock(fileno(file), LOCK_UN);
+#endif
+            }
+
+            FileLock(const FileLock &) = delete;
+            FileLock &operator=(const FileLock &) = delete;
+
+        private:
+            std::FILE *file;
+        };
+    } // namespace
+
+    template <class Geo>
+    BasicDiskCache<Geo>::BasicDiskCache(const std::string &path) : path(path)
+    {
+    }
+
+    template <class Geo>
+    BasicDiskCache<Geo>::~BasicDiskCache()
+    {
+        if (file)
+        {
+            std::fclose(file);
+        }
+#ifdef SUDOKU_HAVE_MMAP
+        if (mapped && mappedBytes > 0 && fallbackData.empty())
+        {
+            munmap(const_cast<unsigned char *>(mapped), mappedBytes);
+        }
+#endif
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::load()
+    {
+        loaded = true;
+        slots.assign(1024, NO_RECORD);
+
+        std::error_code ec;
+        auto fileSize = std::filesystem::file_size(path, ec);
+        if (ec || fileSize == 0)
+        {
+            return; // Created on first store
+        }
+        if (fileSize < sizeof(FileHeader))
+        {
+            throw std::runtime_error("Cache file is truncated: " + path);
+        }
+
+#ifdef SUDOKU_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            void *region = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (region != MAP_FAILED)
+            {
+                mapped = static_cast<const unsigned char *>(region);
+                mappedBytes = fileSize;
+            }
+        }
+#endif
+        if (!mapped)
+        {
+            std::ifstream in(path, std::ios::binary);
+            fallbackData.resize(fileSize);
+            if (!in.read(reinterpret_cast<char *>(fallbackData.data()), fileSize))
+            {
+                throw std::runtime_error("Cannot read cache file: " + path);
+            }
+            mapped = fallbackData.data();
+            mappedBytes = fileSize;
+        }
+
+        checkHeader(mapped);
+        mappedRecords = (mappedBytes - sizeof(FileHeader)) / RECORD_SIZE;
+        for (size_t record = 0; record < mappedRecords; record++)
+        {
+            indexRecord(static_cast<uint32_t>(record));
+        }
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::checkHeader(const unsigned char *data)
+    {
+        FileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion)
+        {
+            throw std::runtime_error("Not a solution cache file: " + path);
+        }
+        if (header.boxRows != Geo::BOX_ROWS || header.boxCols != Geo::BOX_COLS || header.recordSize != RECORD_SIZE)
+        {
+            throw std::runtime_error("Cache file was written for a different grid geometry: " + path);
+        }
+        headerChecked = true;
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::openForAppend()
+    {
+        file = std::fopen(path.c_str(), "ab");
+        if (!file)
+        {
+            throw std::runtime_error("Cannot open cache file for writing: " + path);
+        }
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::syncWithFile()
+    {
+        std::error_code ec;
+        size_t fileSize = static_cast<size_t>(std::filesystem::file_size(path, ec));
+        if (ec)
+        {
+            throw std::runtime_error("Cannot read cache file: " + path);
+        }
+
+        // A new file, or one whose creator died before the header was complete
+        if (fileSize < sizeof(FileHeader))
+        {
+            if (totalRecords() > 0)
+            {
+                throw std::runtime_error("Cache file was truncated by another process: " + path);
+            }
+            std::filesystem::resize_file(path, 0, ec);
+            FileHeader header;
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.boxRows = Geo::BOX_ROWS;
+            header.boxCols = Geo::BOX_COLS;
+            header.recordSize = RECORD_SIZE;
+            if (ec || std::fwrite(&header, sizeof(header), 1, file) != 1 || std::fflush(file) != 0)
+            {
+                throw std::runtime_error("Cannot write cache file: " + path);
+            }
+            headerChecked = true;
+            return;
+        }
+
+        // Under the lock, a partial record can only be left by a writer that died
+        size_t known = sizeof(FileHeader) + totalRecords() * RECORD_SIZE;
+        size_t aligned = sizeof(FileHeader) + (fileSize - sizeof(FileHeader)) / RECORD_SIZE * RECORD_SIZE;
+        if (aligned < known)
+        {
+            throw std::runtime_error("Cache file was truncated by another process: " + path);
+        }
+        if (aligned < fileSize)
+        {
+            std::filesystem::resize_file(path, aligned, ec);
+            if (ec)
+            {
+                throw std::runtime_error("Cannot write cache file: " + path);
+            }
+        }
+        if (aligned == known && headerChecked)
+        {
+            return;
+        }
+
+        // Index the records other processes appended since this one last looked
+        std::ifstream in(path, std::ios::binary);
+        if (!headerChecked)
+        {
+            unsigned char header[sizeof(FileHeader)];
+            if (!in.read(reinterpret_cast<char *>(header), sizeof(header)))
+            {
+                throw std::runtime_error("Cannot read cache file: " + path);
+            }
+            checkHeader(header);
+        }
+        size_t first = totalRecords();
+        size_t oldBytes = appended.size();
+        appended.resize(oldBytes + (aligned - known));
+        in.seekg(static_cast<std::streamoff>(known));
+        if (!in.read(reinterpret_cast<char *>(appended.data() + oldBytes),
+                     static_cast<std::streamsize>(aligned - known)))
+        {
+            appended.resize(oldBytes);
+            throw std::runtime_error("Cannot read cache file: " + path);
+        }
+        for (size_t record = first; record < totalRecords(); record++)
+        {
+            indexRecord(static_cast<uint32_t>(record));
+        }
+    }
+
+    template <class Geo>
+    const unsigned char *BasicDiskCache<Geo>::recordAt(uint32_t record) const
+    {
+        if (record < mappedRecords)
+        {
+            return mapped + sizeof(FileHeader) + record * RECORD_SIZE;
+        }
+        return appended.data() + (record - mappedRecords) * RECORD_SIZE;
+    }
+
+    template <class Geo>
+    PuzzleHash BasicDiskCache<Geo>::recordHash(const unsigned char *record)
+    {
+        PuzzleHash hash;
+        std::memcpy(&hash.high, record, 8);
+        std::memcpy(&hash.low, record + 8, 8);
+        return hash;
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::indexRecord(uint32_t record)
+    {
+        if ((numEntries + 1) * 2 > slots.size())
+        {
+            growIndex();
+        }
+
+        PuzzleHash hash = recordHash(recordAt(record));
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash.low & mask;; slot = (slot + 1) & mask)
+        {
+            if (slots[slot] == NO_RECORD)
+            {
+                slots[slot] = record;
+                numEntries++;
+                return;
+            }
+            if (recordHash(recordAt(slots[slot])) == hash)
+            {
+                slots[slot] = record; // Later records win
+                return;
+            }
+        }
+    }
+
+    template <class Geo>
+    bool BasicDiskCache<Geo>::hasCheckedRecord(const PuzzleHash &hash) const
+    {
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash.low & mask; slots[slot] != NO_RECORD; slot = (slot + 1) & mask)
+        {
+            const unsigned char *record = recordAt(slots[slot]);
+            if (recordHash(record) == hash)
+            {
+                auto uniqueness = static_cast<UniquenessStatus>((record[20] >> kUniquenessShift) & 3);
+                return uniqueness != UniquenessStatus::NOT_CHECKED;
+            }
+        }
+        return false;
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::growIndex()
+    {
+        std::vector<uint32_t> old;
+        old.swap(slots);
+        slots.assign(old.size() * 2, NO_RECORD);
+        numEntries = 0;
+        for (uint32_t record : old)
+        {
+            if (record != NO_RECORD)
+            {
+                indexRecord(record);
+            }
+        }
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::encodeRecord(const PuzzleHash &hash, const Solution &solution, unsigned char *record)
+    {
+        std::memset(record, 0, RECORD_SIZE);
+        std::memcpy(record, &hash.high, 8);
+        std::memcpy(record + 8, &hash.low, 8);
+        float timeMs = static_cast<float>(solution.solveTimeMs);
+        std::memcpy(record + 16, &timeMs, 4);
+        record[20] = static_cast<unsigned char>((solution.solved ? kSolvedFlag : 0) |
+                                                (static_cast<int>(solution.uniqueness) << kUniquenessShift));
+
+        unsigned char *cells = record + 21;
+        const int *values = &solution.grid[0][0];
+        for (int i = 0; i < Geo::NUM_CELLS; i++)
+        {
+            if (CELL_BITS == 4)
+            {
+                cells[i / 2] |= static_cast<unsigned char>(values[i] << ((i % 2) * 4));
+            }
+            else
+            {
+                cells[i] = static_cast<unsigned char>(values[i]);
+            }
+        }
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::decodeRecord(const unsigned char *record, Solution &solution)
+    {
+        float timeMs;
+        std::memcpy(&timeMs, record + 16, 4);
+        solution.solveTimeMs = timeMs;
+        solution.solved = (record[20] & kSolvedFlag) != 0;
+        solution.uniqueness = static_cast<UniquenessStatus>((record[20] >> kUniquenessShift) & 3);
+        solution.errorMessage = solution.solved ? "" : "No solution exists for the given puzzle.";
+
+        const unsigned char *cells = record + 21;
+        int *values = &solution.grid[0][0];
+        for (int i = 0; i < Geo::NUM_CELLS; i++)
+        {
+            values[i] = CELL_BITS == 4 ? (cells[i / 2] >> ((i % 2) * 4)) & 0xF : cells[i];
+        }
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::open()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!loaded)
+        {
+            load();
+        }
+    }
+
+    template <class Geo>
+    bool BasicDiskCache<Geo>::lookup(const PuzzleHash &hash, bool checkUniqueness, Solution &solution)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!loaded)
+        {
+            load();
+        }
+
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash.low & mask; slots[slot] != NO_RECORD; slot = (slot + 1) & mask)
+        {
+            const unsigned char *record = recordAt(slots[slot]);
+            if (recordHash(record) == hash)
+            {
+                // Decode aside so a miss leaves the caller's solution untouched
+                Solution decoded;
+                decodeRecord(record, decoded);
+                if (checkUniqueness && decoded.solved && !decoded.uniquenessChecked())
+                {
+                    return false;
+                }
+                solution = std::move(decoded);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <class Geo>
+    void BasicDiskCache<Geo>::store(const PuzzleHash &hash, const Solution &solution)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!loaded)
+        {
+            load();
+        }
+        if (!file)
+        {
+            openForAppend();
+        }
+
+        unsigned char record[RECORD_SIZE];
+        encodeRecord(hash, solution, record);
+        {
+            FileLock fileLock(file);
+            syncWithFile();
+            if (!solution.uniquenessChecked() && hasCheckedRecord(hash))
+            {
+                return;
+            }
+            if (std::fwrite(record, RECORD_SIZE, 1, file) != 1 || std::fflush(file) != 0)
+            {
+                throw std::runtime_error("Cannot write cache file: " + path);
+            }
+        }
+
+        appended.insert(appended.end(), record, record + RECORD_SIZE);
+        indexRecord(static_cast<uint32_t>(totalRecords() - 1));
+    }
+
+    template <class Geo>
+    size_t BasicDiskCache<Geo>::size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!loaded)
+        {
+            load();
+        }
+        return numEntries;
+    }
+
+#define SUDOKU_INSTANTIATE_DISK_CACHE(R, C) template class BasicDiskCache<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_DISK_CACHE)
+#undef SUDOKU_INSTANTIATE_DISK_CACHE
+
+} // namespace sudoku
@@ -0,0 +1,139 @@
+/**
+ * @file SudokuDiskCache.h
+ * @brief Persistent append-only solution cache
+ *
+ * File layout: a fixed header followed by fixed-size records
+ *
+ *   record = hash.high (8) | hash.low (8) | solve time ms (float, 4) |
+ *            flags (1: bit 0 solved, bits 1-2 uniqueness) | packed cells
+ *
+ * Cells are packed two per byte (4 bits each) when values fit, otherwise one
+ * per byte, so a 9x9 record is 62 bytes. Records are only ever appended; when
+ * a puzzle appears more than once the last record wins. A truncated trailing
+ * record (e.g. after a crash) is ignored.
+ *
+ * Several processes may append to one file. Each append holds an exclusive
+ * flock() on it, drops a torn trailing record left by a writer that died,
+ * and first indexes the records other processes appended since.
+ *
+ * The file is memory-mapped and indexed by open() (or the first lookup);
+ * records are read in place, so opening a large cache costs one pass over
+ * the hashes. BasicSolutionCache::attachStore() opens it before any lookup.
+ */
+
+#ifndef SUDOKU_DISK_CACHE_H
+#define SUDOKU_DISK_CACHE_H
+
+#include "SudokuTypes.h"
+#include "SudokuCache.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Memory-mapped append-only store of solutions
+     *
+     * Thread-safe. Usually attached behind an in-memory BasicSolutionCache
+     * with BasicSolutionCache::attachStore().
+     */
+    template <class Geo>
+    class BasicDiskCache
+    {
+    public:
+        using Solution = BasicSudokuSolution<Geo>;
+
+        static constexpr int CELL_BITS = Geo::MAX_VALUE < 16 ? 4 : 8;
+        static constexpr size_t CELL_BYTES = (Geo::NUM_CELLS * CELL_BITS + 7) / 8;
+        static constexpr size_t RECORD_SIZE = 8 + 8 + 4 + 1 + CELL_BYTES;
+
+        /**
+         * @brief Create a cache backed by a file (created on first write if missing)
+         * @param path Path of the cache file; nothing is read until first use
+         */
+        explicit BasicDiskCache(const std::string &path);
+        ~BasicDiskCache();
+
+        BasicDiskCache(const BasicDiskCache &) = delete;
+        BasicDiskCache &operator=(const BasicDiskCache &) = delete;
+
+        /**
+         * @brief Map and index the file now rather than on the first lookup
+         * @throws std::runtime_error if the file exists but is not a cache for this geometry
+         */
+        void open();
+
+        /**
+         * @brief Look up a solution
+         * @param hash Hash of the puzzle
+         * @param checkUniqueness If true, only records with a uniqueness status match
+         * @param solution Receives the stored solution on a hit
+         * @return true on a hit
+         * @throws std::runtime_error if the file exists but is not a cache for this geometry
+         */
+        bool lookup(const PuzzleHash &hash, bool checkUniqueness, Solution &solution);
+
+        /**
+         * @brief Append a solution to the file
+         *
+         * Nothing is written if the file already holds a solution for the
+         * puzzle whose uniqueness was checked and this one's was not.
+         * @throws std::runtime_error if the file cannot be written
+         */
+        void store(const PuzzleHash &hash, const Solution &solution);
+
+        /**
+         * @brief Number of distinct puzzles in the cache
+         */
+        size_t size();
+
+        const std::string &getPath() const { return path; }
+
+    private:
+        static constexpr uint32_t NO_RECORD = 0xFFFFFFFFu;
+
+        std::string path;
+        std::mutex mutex;
+        bool loaded = false;
+        bool headerChecked = false;
+
+        // Records already in the file when it was opened (mapped read-only)
+        const unsigned char *mapped = nullptr;
+        size_t mappedBytes = 0;
+        size_t mappedRecords = 0;
+        std::vector<unsigned char> fallbackData; // Used when mmap is unavailable
+
+        // Records appended since the file was mapped, by this or other processes
+        std::vector<unsigned char> appended;
+        std::FILE *file = nullptr;
+
+        // Open-addressing index: slot -> record number
+        std::vector<uint32_t> slots;
+        size_t numEntries = 0;
+
+        void load();
+        void checkHeader(const unsigned char *data);
+        void openForAppend();
+        void syncWithFile();
+        const unsigned char *recordAt(uint32_t record) const;
+        size_t totalRecords() const { return mappedRecords + appended.size() / RECORD_SIZE; }
+        static PuzzleHash recordHash(const unsigned char *record);
+        void indexRecord(uint32_t record);
+        bool hasCheckedRecord(const PuzzleHash &hash) const;
+        void growIndex();
+
+        static void encodeRecord(const PuzzleHash &hash, const Solution &solution, unsigned char *record);
+        static void decodeRecord(const unsigned char *record, Solution &solution);
+    };
+
+    // Classic 9x9 disk cache
+    using DiskCache = BasicDiskCache<StandardGeometry>;
+
+} // namespace sudoku
+
+#endif // SUDOKU_DISK_CACHE_H
@@ -4,6 +4,7 @@
  */
 
 #include "SudokuEncoder.h"
+#include "SudokuTopology.h"
 #include <chrono>
 #include <algorithm>
 #include <set>
@@ -11,12 +12,14 @@
 namespace sudoku
 {
 
-    SudokuEncoder::SudokuEncoder()
+    template <class Geo>
+    BasicSudokuEncoder<Geo>::BasicSudokuEncoder()
         : solver(nullptr), numVariables(0), numClauses(0)
     {
     }
 
-    SudokuEncoder::~SudokuEncoder()
+    template <class Geo>
+    BasicSudokuEncoder<Geo>::~BasicSudokuEncoder()
     {
         if (solver)
         {
@@ -24,18 +27,26 @@ namespace sudoku
         }
     }
 
-    void SudokuEncoder::reset()
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::reset()
     {
-        if (solver)
         {
-            delete solver;
+            std::lock_guard<std::mutex> lock(solverMutex);
+            if (solver)
+            {
+                delete solver;
+            }
+            solver = new Minisat::Solver();
+            if (interrupted.load())
+            {
+                solver->interrupt();
+            }
         }
-        solver = new Minisat::Solver();
         numVariables = 0;
         numClauses = 0;
 
         // Create variables for all cells and values
-        // Variable index: row * 81 + col * 9 + (value - 1)
+        // Variable index: row * N^2 + col * N + (value - 1)
         for (int i = 0; i < GRID_SIZE * GRID_SIZE * GRID_SIZE; i++)
         {
             solver->newVar();
@@ -43,18 +54,39 @@ namespace sudoku
         }
     }
 
-    Minisat::Var SudokuEncoder::getVar(int row, int col, int value)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::interrupt()
     {
-        // value is 1-9, convert to 0-8 for indexing
+        interrupted.store(true);
+        std::lock_guard<std::mutex> lock(solverMutex);
+        if (solver)
+        {
+            solver->interrupt();
+        }
+    }
+
+    template <class Geo>
+    Minisat::Var BasicSudokuEncoder<Geo>::getVar(int row, int col, int value)
+    {
+        // value is 1-N, convert to 0-(N-1) for indexing
         return row * GRID_SIZE * GRID_SIZE + col * GRID_SIZE + (value - 1);
     }
 
-    Minisat::Lit SudokuEncoder::getLit(int row, int col, int value, bool positive)
+    template <class Geo>
+    Minisat::Lit BasicSudokuEncoder<Geo>::getLit(int row, int col, int value, bool positive)
     {
         return Minisat::mkLit(getVar(row, col, value), !positive);
     }
 
-    void SudokuEncoder::addClause(const std::vector<Minisat::Lit> &lits)
+    template <class Geo>
+    Minisat::Lit BasicSudokuEncoder<Geo>::getCellLit(int cell, int value)
+    {
+        // Flat cell index: row * N + col, so the variable is cell * N + (value - 1)
+        return Minisat::mkLit(cell * GRID_SIZE + (value - 1));
+    }
+
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::addClause(const std::vector<Minisat::Lit> &lits)
     {
         Minisat::vec<Minisat::Lit> clause;
         for (const auto &lit : lits)
@@ -65,26 +97,38 @@ namespace sudoku
         numClauses++;
     }
 
-    void SudokuEncoder::addClause(Minisat::Lit a)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::addClause(Minisat::Lit a)
     {
         solver->addClause(a);
         numClauses++;
     }
 
-    void SudokuEncoder::addClause(Minisat::Lit a, Minisat::Lit b)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::addClause(Minisat::Lit a, Minisat::Lit b)
     {
         solver->addClause(a, b);
         numClauses++;
     }
 
-    void SudokuEncoder::addClause(Minisat::Lit a, Minisat::Lit b, Minisat::Lit c)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::addClause(Minisat::Lit a, Minisat::Lit b, Minisat::Lit c)
     {
         solver->addClause(a, b, c);
         numClauses++;
     }
 
-    void SudokuEncoder::addAtMostOne(const std::vector<Minisat::Lit> &lits)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::addAtMostOne(const std::vector<Minisat::Lit> &lits)
     {
+        // Large grids: pairwise clauses grow quadratically (300 per 25-literal group),
+        // so switch to the linear sequential encoding. 9x9 and smaller stay pairwise.
+        if (GRID_SIZE > PAIRWISE_GRID_LIMIT && lits.size() > PAIRWISE_GROUP_LIMIT)
+        {
+            addAtMostOneSequential(lits);
+            return;
+        }
+
         // Pairwise encoding: for each pair (i, j), add clause (~li OR ~lj)
         for (size_t i = 0; i < lits.size(); i++)
         {
@@ -95,7 +139,30 @@ namespace sudoku
         }
     }
 
-    void SudokuEncoder::addExactlyOne(const std::vector<Minisat::Lit> &lits)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::addAtMostOneSequential(const std::vector<Minisat::Lit> &lits)
+    {
+        // Sequential counter (Sinz 2005): s_i means "some literal among l_0..l_i is true"
+        //   l_i -> s_i,  s_(i-1) -> s_i,  s_(i-1) -> ~l_i
+        // 3n - 4 clauses and n - 1 auxiliary variables
+        size_t n = lits.size();
+        Minisat::Lit prev = Minisat::mkLit(solver->newVar());
+        numVariables++;
+        addClause(~lits[0], prev);
+        for (size_t i = 1; i + 1 < n; i++)
+        {
+            Minisat::Lit curr = Minisat::mkLit(solver->newVar());
+            numVariables++;
+            addClause(~lits[i], curr);
+            addClause(~prev, curr);
+            addClause(~prev, ~lits[i]);
+            prev = curr;
+        }
+        addClause(~prev, ~lits[n - 1]);
+    }
+
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::addExactlyOne(const std::vector<Minisat::Lit> &lits)
     {
         // At least one: OR of all literals
         addClause(lits);
@@ -103,83 +170,64 @@ namespace sudoku
         addAtMostOne(lits);
     }
 
-    void SudokuEncoder::encodeCellConstraints()
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeCellConstraints()
     {
-        // Each cell must have exactly one value (1-9)
-        for (int row = 0; row < GRID_SIZE; row++)
+        // Each cell must have exactly one value (1-N)
+        for (int cell = 0; cell < Topology::NUM_CELLS; cell++)
         {
-            for (int col = 0; col < GRID_SIZE; col++)
+            std::vector<Minisat::Lit> lits;
+            lits.reserve(MAX_VALUE);
+            for (int val = MIN_VALUE; val <= MAX_VALUE; val++)
             {
-                std::vector<Minisat::Lit> lits;
-                for (int val = MIN_VALUE; val <= MAX_VALUE; val++)
-                {
-                    lits.push_back(getLit(row, col, val));
-                }
-                addExactlyOne(lits);
+                lits.push_back(getCellLit(cell, val));
             }
+            addExactlyOne(lits);
         }
     }
 
-    void SudokuEncoder::encodeRowConstraints()
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeUnitConstraints(int firstUnit)
     {
-        // Each row must have each value exactly once
-        for (int row = 0; row < GRID_SIZE; row++)
+        // Each value appears exactly once in each of the GRID_SIZE units starting at firstUnit
+        for (int unit = firstUnit; unit < firstUnit + GRID_SIZE; unit++)
         {
             for (int val = MIN_VALUE; val <= MAX_VALUE; val++)
             {
                 std::vector<Minisat::Lit> lits;
-                for (int col = 0; col < GRID_SIZE; col++)
+                lits.reserve(Topology::UNIT_SIZE);
+                for (int cell : Topology::UNITS[unit])
                 {
-                    lits.push_back(getLit(row, col, val));
+                    lits.push_back(getCellLit(cell, val));
                 }
                 addExactlyOne(lits);
             }
         }
     }
 
-    void SudokuEncoder::encodeColumnConstraints()
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeRowConstraints()
+    {
+        // Each row must have each value exactly once
+        encodeUnitConstraints(Topology::FIRST_ROW_UNIT);
+    }
+
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeColumnConstraints()
     {
         // Each column must have each value exactly once
-        for (int col = 0; col < GRID_SIZE; col++)
-        {
-            for (int val = MIN_VALUE; val <= MAX_VALUE; val++)
-            {
-                std::vector<Minisat::Lit> lits;
-                for (int row = 0; row < GRID_SIZE; row++)
-                {
-                    lits.push_back(getLit(row, col, val));
-                }
-                addExactlyOne(lits);
-            }
-        }
+        encodeUnitConstraints(Topology::FIRST_COL_UNIT);
     }
 
-    void SudokuEncoder::encodeBoxConstraints()
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeBoxConstraints()
     {
-        // Each 3x3 box must have each value exactly once
-        for (int boxRow = 0; boxRow < BOX_SIZE; boxRow++)
-        {
-            for (int boxCol = 0; boxCol < BOX_SIZE; boxCol++)
-            {
-                for (int val = MIN_VALUE; val <= MAX_VALUE; val++)
-                {
-                    std::vector<Minisat::Lit> lits;
-                    for (int r = 0; r < BOX_SIZE; r++)
-                    {
-                        for (int c = 0; c < BOX_SIZE; c++)
-                        {
-                            int row = boxRow * BOX_SIZE + r;
-                            int col = boxCol * BOX_SIZE + c;
-                            lits.push_back(getLit(row, col, val));
-                        }
-                    }
-                    addExactlyOne(lits);
-                }
-            }
-        }
+        // Each box must have each value exactly once
+        encodeUnitConstraints(Topology::FIRST_BOX_UNIT);
     }
 
-    void SudokuEncoder::encodeGivenValues(const SudokuPuzzle &puzzle)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeGivenValues(const Puzzle &puzzle)
     {
         // Add unit clauses for given values
         for (int row = 0; row < GRID_SIZE; row++)
@@ -195,11 +243,12 @@ namespace sudoku
         }
     }
 
-    void SudokuEncoder::encodeCageConstraints(const std::vector<Cage> &cages)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeCageConstraints(const std::vector<Cage> &cages)
     {
         for (const auto &cage : cages)
         {
-            if (cage.isValid())
+            if (cage.isValid(MAX_VALUE))
             {
                 encodeCageSum(cage);
                 encodeCageUniqueness(cage);
@@ -207,7 +256,8 @@ namespace sudoku
         }
     }
 
-    void SudokuEncoder::generateSumCombinationsHelper(
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::generateSumCombinationsHelper(
         int numCells, int targetSum, int minVal,
         std::vector<int> &current,
         std::vector<std::vector<int>> &result)
@@ -251,7 +301,8 @@ namespace sudoku
         }
     }
 
-    void SudokuEncoder::generateSumCombinations(
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::generateSumCombinations(
         int numCells, int targetSum,
         std::vector<std::vector<int>> &result)
     {
@@ -260,7 +311,8 @@ namespace sudoku
         generateSumCombinationsHelper(numCells, targetSum, MIN_VALUE, current, result);
     }
 
-    void SudokuEncoder::encodeCageSum(const Cage &cage)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeCageSum(const Cage &cage)
     {
         // Generate all valid combinations of values that sum to target
         std::vector<std::vector<int>> combinations;
@@ -415,7 +467,8 @@ namespace sudoku
         }
     }
 
-    void SudokuEncoder::encodeCageUniqueness(const Cage &cage)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeCageUniqueness(const Cage &cage)
     {
         // All cells in a cage must have different values
         // For each value v, at most one cell in the cage can have v
@@ -430,19 +483,21 @@ namespace sudoku
         }
     }
 
-    void SudokuEncoder::encodeInequalityConstraints(
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeInequalityConstraints(
         const std::vector<InequalityConstraint> &inequalities)
     {
         for (const auto &ineq : inequalities)
         {
-            if (ineq.isValid())
+            if (ineq.isValid(GRID_SIZE))
             {
                 encodeInequality(ineq);
             }
         }
     }
 
-    void SudokuEncoder::encodeInequality(const InequalityConstraint &ineq)
+    template <class Geo>
+    void BasicSudokuEncoder<Geo>::encodeInequality(const InequalityConstraint &ineq)
     {
         // cell1 > cell2 or cell1 < cell2
         // For cell1 > cell2: for all (v1, v2) where v1 <= v2,
@@ -478,9 +533,10 @@ namespace sudoku
         }
     }
 
-    SudokuSolution SudokuEncoder::solve(const SudokuPuzzle &puzzle, bool checkUniqueness)
+    template <class Geo>
+    BasicSudokuSolution<Geo> BasicSudokuEncoder<Geo>::solve(const Puzzle &puzzle, bool checkUniqueness)
     {
-        SudokuSolution solution;
+        Solution solution;
 
         auto startTime = std::chrono::high_resolution_clock::now();
 
@@ -506,11 +562,19 @@ namespace sudoku
             encodeInequalityConstraints(puzzle.inequalities);
         }
 
-        // Solve
-        bool sat = solver->solve();
+        auto encodedTime = std::chrono::high_resolution_clock::now();
+
+        // Solve; l_Undef means interrupt() stopped the search
+        Minisat::vec<Minisat::Lit> noAssumptions;
+        solver->budgetOff();
+        Minisat::lbool status = solver->solveLimited(noAssumptions);
+        bool sat = status == Minisat::l_True;
 
         auto endTime = std::chrono::high_resolution_clock::now();
         solution.solveTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        lastStats = SolveStats();
+        lastStats.encodeMs = std::chrono::duration<double, std::milli>(encodedTime - startTime).count();
+        lastStats.searchMs = std::chrono::duration<double, std::milli>(endTime - encodedTime).count();
 
         if (sat)
         {
@@ -536,7 +600,7 @@ namespace sudoku
             {
                 // Block the current solution by adding a clause that says
                 // at least one cell must have a different value.
-                // This creates a single 81-literal clause, which modern SAT solvers
+                // This creates a single N^2-literal clause, which modern SAT solvers
                 // handle efficiently. The alternative of adding auxiliary variables
                 // would increase overhead without significant benefit for this use case.
                 Minisat::vec<Minisat::Lit> blockingClause;
@@ -554,21 +618,48 @@ namespace sudoku
 
                 // Try to find another solution
                 auto uniqueStartTime = std::chrono::high_resolution_clock::now();
-                bool hasSecondSolution = solver->solve();
+                Minisat::lbool secondStatus = solver->solveLimited(noAssumptions);
                 auto uniqueEndTime = std::chrono::high_resolution_clock::now();
                 double uniqueTimeMs = std::chrono::duration<double, std::milli>(uniqueEndTime - uniqueStartTime).count();
                 solution.solveTimeMs += uniqueTimeMs;
+                lastStats.uniqueMs = uniqueTimeMs;
 
-                solution.uniqueness = hasSecondSolution ? UniquenessStatus::NOT_UNIQUE : UniquenessStatus::UNIQUE;
+                if (secondStatus == Minisat::l_True)
+                {
+                    solution.uniqueness = UniquenessStatus::NOT_UNIQUE;
+                }
+                else if (secondStatus == Minisat::l_Undef)
+                {
+                    lastStats.interrupted = true; // Not proven unique
+                }
+                else
+                {
+                    solution.uniqueness = UniquenessStatus::UNIQUE;
+                }
             }
         }
+        else if (status == Minisat::l_Undef)
+        {
+            solution.solved = false;
+            solution.errorMessage = "Solve interrupted.";
+            lastStats.interrupted = true;
+        }
         else
         {
             solution.solved = false;
             solution.errorMessage = "No solution exists for the given puzzle.";
         }
 
+        // The solver is rebuilt by reset(), so its counters cover this puzzle only
+        lastStats.conflicts = solver->conflicts;
+        lastStats.decisions = solver->decisions;
+        lastStats.propagations = solver->propagations;
+
         return solution;
     }
 
+#define SUDOKU_INSTANTIATE_ENCODER(R, C) template class BasicSudokuEncoder<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_ENCODER)
+#undef SUDOKU_INSTANTIATE_ENCODER
+
 } // namespace sudoku
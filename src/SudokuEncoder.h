@@ -10,24 +10,49 @@
 #define SUDOKU_ENCODER_H
 
 #include "SudokuTypes.h"
+#include "SudokuTopology.h"
 #include "minisat/core/Solver.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 #include <map>
 
 namespace sudoku
 {
 
+    /**
+     * @brief Measurements from one solve
+     */
+    struct SolveStats
+    {
+        double encodeMs = 0.0; // Building the clauses
+        double searchMs = 0.0; // Finding the first solution
+        double uniqueMs = 0.0; // Searching for a second solution (0 if not checked)
+        uint64_t conflicts = 0;
+        uint64_t decisions = 0;
+        uint64_t propagations = 0;
+        bool cached = false;      // Answered from a solution cache; the other fields are 0
+        bool interrupted = false; // Stopped by interrupt(); the result is incomplete
+    };
+
     /**
      * @brief Encodes Sudoku puzzles as SAT formulas
      *
      * Variable encoding: x(r, c, v) means cell (r, c) has value v
-     * Variable index: r * 81 + c * 9 + (v - 1)
+     * Variable index: r * N^2 + c * N + (v - 1), N = Geo::GRID_SIZE
+     *
+     * Instantiated for every geometry in SUDOKU_FOR_EACH_GEOMETRY.
      */
-    class SudokuEncoder
+    template <class Geo>
+    class BasicSudokuEncoder
     {
     public:
-        SudokuEncoder();
-        ~SudokuEncoder();
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Solution = BasicSudokuSolution<Geo>;
+
+        BasicSudokuEncoder();
+        ~BasicSudokuEncoder();
 
         /**
          * @brief Encode a Sudoku puzzle as SAT and solve it
@@ -35,7 +60,7 @@ namespace sudoku
          * @param checkUniqueness If true, verify that the solution is unique
          * @return The solution (check solved field for success)
          */
-        SudokuSolution solve(const SudokuPuzzle &puzzle, bool checkUniqueness = false);
+        Solution solve(const Puzzle &puzzle, bool checkUniqueness = false);
 
         /**
          * @brief Get statistics about the encoding
@@ -43,14 +68,43 @@ namespace sudoku
         int getNumVariables() const { return numVariables; }
         int getNumClauses() const { return numClauses; }
 
+        /**
+         * @brief Timings and SAT counters of the last solve
+         */
+        const SolveStats &getLastStats() const { return lastStats; }
+
+        /**
+         * @brief Stop the running search; callable from any thread
+         *
+         * The solve returns unsolved (or with uniqueness NOT_CHECKED) and
+         * getLastStats().interrupted set. Later solves stop at once until
+         * clearInterrupt().
+         */
+        void interrupt();
+        void clearInterrupt() { interrupted.store(false); }
+
     private:
+        using Topology = BasicTopology<Geo>;
+
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int MIN_VALUE = Geo::MIN_VALUE;
+        static constexpr int MAX_VALUE = Geo::MAX_VALUE;
+
+        // At-most-one groups switch from pairwise to sequential encoding above these sizes
+        static constexpr int PAIRWISE_GRID_LIMIT = 9;
+        static constexpr size_t PAIRWISE_GROUP_LIMIT = 6;
+
         Minisat::Solver *solver;
+        std::mutex solverMutex; // Guards replacing solver against interrupt()
+        std::atomic<bool> interrupted{false};
         int numVariables;
         int numClauses;
+        SolveStats lastStats;
 
         // Variable mapping: (row, col, value) -> SAT variable
         Minisat::Var getVar(int row, int col, int value);
         Minisat::Lit getLit(int row, int col, int value, bool positive = true);
+        Minisat::Lit getCellLit(int cell, int value); // cell is a flat topology index
 
         // Reset solver for new puzzle
         void reset();
@@ -59,8 +113,9 @@ namespace sudoku
         void encodeCellConstraints();                       // Each cell has exactly one value
         void encodeRowConstraints();                        // Each row has each value exactly once
         void encodeColumnConstraints();                     // Each column has each value exactly once
-        void encodeBoxConstraints();                        // Each 3x3 box has each value exactly once
-        void encodeGivenValues(const SudokuPuzzle &puzzle); // Given clues
+        void encodeBoxConstraints();                        // Each box has each value exactly once
+        void encodeUnitConstraints(int firstUnit);          // Shared row/column/box encoding
+        void encodeGivenValues(const Puzzle &puzzle);       // Given clues
 
         // Killer Sudoku constraints
         void encodeCageConstraints(const std::vector<Cage> &cages);
@@ -73,6 +128,7 @@ namespace sudoku
 
         // Helper: At-most-one encoding
         void addAtMostOne(const std::vector<Minisat::Lit> &lits);
+        void addAtMostOneSequential(const std::vector<Minisat::Lit> &lits);
 
         // Helper: Exactly-one encoding
         void addExactlyOne(const std::vector<Minisat::Lit> &lits);
@@ -91,6 +147,9 @@ namespace sudoku
                                            std::vector<std::vector<int>> &result);
     };
 
+    // Classic 9x9 encoder
+    using SudokuEncoder = BasicSudokuEncoder<StandardGeometry>;
+
 } // namespace sudoku
 
 #endif // SUDOKU_ENCODER_H
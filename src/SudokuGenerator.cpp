@@ -5,39 +5,57 @@
 
 #include "SudokuGenerator.h"
 #include "SudokuParser.h"
+#include "SudokuTopology.h"
+#include "SudokuWriter.h"
 #include <algorithm>
-#include <sstream>
 #include <chrono>
 #include <queue>
+#include <stdexcept>
+#include <thread>
 
 namespace sudoku
 {
 
-    SudokuGenerator::SudokuGenerator()
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        double millisecondsSince(Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+    } // namespace
+
+    template <class Geo>
+    BasicSudokuGenerator<Geo>::BasicSudokuGenerator()
     {
         // Initialize RNG with random seed
         auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
         rng.seed(static_cast<unsigned int>(seed));
     }
 
-    SudokuGenerator::~SudokuGenerator()
+    template <class Geo>
+    BasicSudokuGenerator<Geo>::~BasicSudokuGenerator()
     {
     }
 
-    SudokuPuzzle SudokuGenerator::generate()
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuGenerator<Geo>::generate()
     {
         GeneratorConfig config;
         return generate(config);
     }
 
-    SudokuPuzzle SudokuGenerator::generate(const GeneratorConfig &config)
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuGenerator<Geo>::generate(const GeneratorConfig &config)
     {
-        SudokuSolution solution;
+        Solution solution;
         return generateWithSolution(config, solution);
     }
 
-    SudokuPuzzle SudokuGenerator::generateWithSolution(const GeneratorConfig &config,
-                                                       SudokuSolution &solution)
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuGenerator<Geo>::generateWithSolution(const GeneratorConfig &config,
+                                                       Solution &solution)
     {
         // Set seed if specified
         if (config.seed != 0)
@@ -45,15 +63,39 @@ namespace sudoku
             rng.seed(config.seed);
         }
 
-        SudokuPuzzle puzzle;
+        {
+            std::lock_guard<std::mutex> lock(solversMutex);
+            cancelled.store(false);
+            solver.clearInterrupt();
+            helperSolvers.resize(static_cast<size_t>(std::max(1, config.minimizeThreads) - 1));
+            for (auto &helper : helperSolvers)
+            {
+                if (!helper)
+                {
+                    helper = std::make_unique<BasicSudokuSolver<Geo>>();
+                }
+                helper->clearInterrupt();
+            }
+        }
+
+        Puzzle puzzle;
+        lastStats = GenerationStats();
+        auto phaseStart = Clock::now();
 
         // Step 1: Generate a complete valid solution
+        progress = GenerationProgress();
+        progress.trialsRemaining = 1;
         if (!generateCompleteSolution(solution))
         {
             // Fallback: use solver to generate any valid grid
-            SudokuPuzzle empty;
+            Puzzle empty;
             solution = solver.solve(empty);
         }
+        progress.trialsDone = 1;
+        progress.trialsRemaining = 0;
+        reportProgress();
+        lastStats.fillMs = millisecondsSince(phaseStart);
+        phaseStart = Clock::now();
 
         // Step 2: Generate constraints based on puzzle type
         if (config.type == SudokuType::KILLER || config.type == SudokuType::KILLER_INEQUALITY)
@@ -85,19 +127,33 @@ namespace sudoku
             int numGivens = givenDist(rng);
             addGivens(puzzle, solution, numGivens);
         }
+        lastStats.constraintsMs = millisecondsSince(phaseStart);
 
         // Step 4: Verify unique solution if required
         if (config.ensureUniqueSolution)
         {
-            // Check if the puzzle has a unique solution
-            auto testSolution = solver.solve(puzzle, true); // Check uniqueness
+            phaseStart = Clock::now();
 
             // Maximum attempts to achieve uniqueness through constraints
             const int kMaxConstraintAttempts = 10;
             // Maximum given values to add (failsafe to prevent infinite loop)
-            const int kMaxGivensToAdd = 81; // Can't add more than 81 givens
+            const int kMaxGivensToAdd = NUM_CELLS; // Can't add more givens than cells
 
             int attempts = 0;
+            int givensAdded = 0;
+            progress.phase = GenerationPhase::UNIQUENESS;
+            auto solveForUniqueness = [&]()
+            {
+                auto result = solver.solve(puzzle, true);
+                lastStats.uniquenessSolves++;
+                progress.trialsDone = lastStats.uniquenessSolves;
+                progress.trialsRemaining = (kMaxConstraintAttempts - attempts) + (kMaxGivensToAdd - givensAdded);
+                reportProgress();
+                return result;
+            };
+
+            // Check if the puzzle has a unique solution
+            auto testSolution = solveForUniqueness();
             while (testSolution.solved && !testSolution.isUnique() && attempts < kMaxConstraintAttempts)
             {
                 // Add more constraints to ensure uniqueness
@@ -112,32 +168,35 @@ namespace sudoku
                     addGivens(puzzle, solution, 3);
                 }
 
-                testSolution = solver.solve(puzzle, true);
                 attempts++;
+                testSolution = solveForUniqueness();
             }
 
             // If still not unique after max constraint attempts, add givens one at a time
-            int givensAdded = 0;
             while (testSolution.solved && !testSolution.isUnique() && givensAdded < kMaxGivensToAdd)
             {
                 addGivens(puzzle, solution, 1);
-                testSolution = solver.solve(puzzle, true);
                 givensAdded++;
+                testSolution = solveForUniqueness();
             }
+            lastStats.uniquenessMs = millisecondsSince(phaseStart);
+            phaseStart = Clock::now();
 
             // Step 5: Minimize constraints while maintaining uniqueness
             // The difficulty parameter controls how many constraints to remove
             minimizeConstraints(puzzle, solution, config.difficulty);
+            lastStats.minimizeMs = millisecondsSince(phaseStart);
         }
 
         return puzzle;
     }
 
-    bool SudokuGenerator::generateCompleteSolution(SudokuSolution &solution)
+    template <class Geo>
+    bool BasicSudokuGenerator<Geo>::generateCompleteSolution(Solution &solution)
     {
         // Use SAT solver to generate a random valid solution
         // We do this by solving an empty grid with random variable ordering
-        SudokuPuzzle empty;
+        Puzzle empty;
 
         // Add some random initial values to diversify solutions
         std::vector<std::pair<Cell, int>> candidates;
@@ -158,39 +217,22 @@ namespace sudoku
         int set = 0;
         for (const auto &[cell, val] : candidates)
         {
-            if (set >= 11)
-                break; // Set about 11 random values
+            if (set >= GRID_SIZE + 2)
+                break; // Set about GRID_SIZE + 2 random values (11 on 9x9)
 
             // Check if this cell is already set
             if (empty.grid[cell.row][cell.col] != EMPTY_CELL)
                 continue;
 
             // Check if this value is valid (not already in row/col/box)
+            const int *cells = &empty.grid[0][0];
             bool valid = true;
-
-            // Check row
-            for (int c = 0; c < GRID_SIZE && valid; c++)
+            for (int peer : Topology::PEERS[Topology::toIndex(cell)])
             {
-                if (empty.grid[cell.row][c] == val)
-                    valid = false;
-            }
-
-            // Check column
-            for (int r = 0; r < GRID_SIZE && valid; r++)
-            {
-                if (empty.grid[r][cell.col] == val)
-                    valid = false;
-            }
-
-            // Check box
-            int boxR = (cell.row / BOX_SIZE) * BOX_SIZE;
-            int boxC = (cell.col / BOX_SIZE) * BOX_SIZE;
-            for (int r = boxR; r < boxR + BOX_SIZE && valid; r++)
-            {
-                for (int c = boxC; c < boxC + BOX_SIZE && valid; c++)
+                if (cells[peer] == val)
                 {
-                    if (empty.grid[r][c] == val)
-                        valid = false;
+                    valid = false;
+                    break;
                 }
             }
 
@@ -206,29 +248,9 @@ namespace sudoku
         return solution.solved;
     }
 
-    std::vector<Cell> SudokuGenerator::getAdjacentCells(const Cell &cell)
-    {
-        std::vector<Cell> adjacent;
-
-        // 4-connected neighbors
-        const int dr[] = {-1, 1, 0, 0};
-        const int dc[] = {0, 0, -1, 1};
-
-        for (int i = 0; i < 4; i++)
-        {
-            int nr = cell.row + dr[i];
-            int nc = cell.col + dc[i];
-            if (nr >= 0 && nr < GRID_SIZE && nc >= 0 && nc < GRID_SIZE)
-            {
-                adjacent.push_back({nr, nc});
-            }
-        }
-
-        return adjacent;
-    }
-
-    std::vector<Cell> SudokuGenerator::generateConnectedCage(
-        const SudokuSolution &solution,
+    template <class Geo>
+    std::vector<Cell> BasicSudokuGenerator<Geo>::generateConnectedCage(
+        const Solution &solution,
         std::set<Cell> &usedCells,
         int targetSize)
     {
@@ -270,8 +292,9 @@ namespace sudoku
             std::vector<Cell> neighbors;
             for (const auto &cell : cage)
             {
-                for (const auto &adj : getAdjacentCells(cell))
+                for (int adjIndex : Topology::NEIGHBOURS[Topology::toIndex(cell)])
                 {
+                    Cell adj = Topology::toCell(adjIndex);
                     if (usedCells.find(adj) == usedCells.end())
                     {
                         // Check if this neighbor is not already in neighbors list
@@ -321,8 +344,9 @@ namespace sudoku
         return cage;
     }
 
-    int SudokuGenerator::calculateCageSum(const std::vector<Cell> &cells,
-                                          const SudokuSolution &solution)
+    template <class Geo>
+    int BasicSudokuGenerator<Geo>::calculateCageSum(const std::vector<Cell> &cells,
+                                          const Solution &solution)
     {
         int sum = 0;
         for (const auto &cell : cells)
@@ -332,8 +356,9 @@ namespace sudoku
         return sum;
     }
 
-    void SudokuGenerator::generateCages(SudokuPuzzle &puzzle,
-                                        const SudokuSolution &solution,
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::generateCages(Puzzle &puzzle,
+                                        const Solution &solution,
                                         int numCages, int minSize, int maxSize)
     {
         std::set<Cell> usedCells;
@@ -353,20 +378,21 @@ namespace sudoku
         }
     }
 
-    void SudokuGenerator::generateCagesFillingAll(SudokuPuzzle &puzzle,
-                                                  const SudokuSolution &solution,
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::generateCagesFillingAll(Puzzle &puzzle,
+                                                  const Solution &solution,
                                                   int minSize, int maxSize)
     {
         std::set<Cell> usedCells;
         std::uniform_int_distribution<int> sizeDist(minSize, maxSize);
 
         // Keep generating cages until all cells are covered
-        while (usedCells.size() < GRID_SIZE * GRID_SIZE)
+        while (usedCells.size() < NUM_CELLS)
         {
             int targetSize = sizeDist(rng);
 
             // Adjust target size if not enough cells remaining
-            int remainingCells = GRID_SIZE * GRID_SIZE - static_cast<int>(usedCells.size());
+            int remainingCells = NUM_CELLS - static_cast<int>(usedCells.size());
             if (targetSize > remainingCells)
             {
                 targetSize = remainingCells;
@@ -397,28 +423,17 @@ namespace sudoku
         }
     }
 
-    void SudokuGenerator::generateInequalities(SudokuPuzzle &puzzle,
-                                               const SudokuSolution &solution,
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::generateInequalities(Puzzle &puzzle,
+                                               const Solution &solution,
                                                int numInequalities)
     {
         // Collect all possible adjacent pairs
         std::vector<std::pair<Cell, Cell>> pairs;
-
-        for (int r = 0; r < GRID_SIZE; r++)
+        pairs.reserve(Topology::NUM_ADJACENT_PAIRS);
+        for (const auto &pair : Topology::ADJACENT_PAIRS)
         {
-            for (int c = 0; c < GRID_SIZE; c++)
-            {
-                // Horizontal pair
-                if (c + 1 < GRID_SIZE)
-                {
-                    pairs.push_back({{r, c}, {r, c + 1}});
-                }
-                // Vertical pair
-                if (r + 1 < GRID_SIZE)
-                {
-                    pairs.push_back({{r, c}, {r + 1, c}});
-                }
-            }
+            pairs.push_back({Topology::toCell(pair.first), Topology::toCell(pair.second)});
         }
 
         // Shuffle and pick
@@ -443,8 +458,9 @@ namespace sudoku
         }
     }
 
-    void SudokuGenerator::addGivens(SudokuPuzzle &puzzle,
-                                    const SudokuSolution &solution,
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::addGivens(Puzzle &puzzle,
+                                    const Solution &solution,
                                     int numGivens)
     {
         // Collect all cells
@@ -472,7 +488,8 @@ namespace sudoku
         }
     }
 
-    bool SudokuGenerator::hasUniqueSolution(const SudokuPuzzle &puzzle)
+    template <class Geo>
+    bool BasicSudokuGenerator<Geo>::hasUniqueSolution(const Puzzle &puzzle)
     {
         // For now, just check if it has at least one solution
         // A full uniqueness check would require enumeration
@@ -480,7 +497,8 @@ namespace sudoku
         return solution.solved;
     }
 
-    void SudokuGenerator::minimizeConstraints(SudokuPuzzle &puzzle, const SudokuSolution &solution, int difficulty)
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::minimizeConstraints(Puzzle &puzzle, const Solution &solution, int difficulty)
     {
         // Difficulty controls how many constraints to attempt to remove
         // 0 = easiest (keep most constraints, try to remove 0%)
@@ -488,116 +506,72 @@ namespace sudoku
         // We'll calculate a removal target based on difficulty
         float removalRatio = static_cast<float>(difficulty) / 100.0f;
 
+        // Every constraint and given is a candidate for one trial
+        progress.phase = GenerationPhase::MINIMIZE;
+        progress.trialsDone = 0;
+        progress.trialsRemaining = static_cast<int>(puzzle.inequalities.size() + puzzle.cages.size());
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                progress.trialsRemaining += puzzle.grid[r][c] != EMPTY_CELL;
+            }
+        }
+
         // First, try removing inequalities (they tend to be more redundant)
         if (!puzzle.inequalities.empty())
         {
-            std::vector<InequalityConstraint> originalInequalities = puzzle.inequalities;
+            const std::vector<InequalityConstraint> originalInequalities = puzzle.inequalities;
             int totalInequalities = static_cast<int>(originalInequalities.size());
             int targetRemovals = static_cast<int>(totalInequalities * removalRatio);
 
-            std::vector<size_t> indices(originalInequalities.size());
-            for (size_t i = 0; i < indices.size(); i++)
-            {
-                indices[i] = i;
-            }
-            std::shuffle(indices.begin(), indices.end(), rng);
-
-            std::vector<bool> removed(originalInequalities.size(), false);
-            int removedCount = 0;
-
-            for (size_t idx : indices)
+            std::vector<size_t> order(originalInequalities.size());
+            for (size_t i = 0; i < order.size(); i++)
             {
-                // Stop if we've reached our target removal count
-                if (removedCount >= targetRemovals)
-                    break;
-
-                // Try removing this inequality
-                puzzle.inequalities.clear();
-                for (size_t i = 0; i < originalInequalities.size(); i++)
-                {
-                    if (!removed[i] && i != idx)
-                    {
-                        puzzle.inequalities.push_back(originalInequalities[i]);
-                    }
-                }
-
-                // Check if still unique
-                auto testSolution = solver.solve(puzzle, true);
-                if (testSolution.solved && testSolution.isUnique())
-                {
-                    // Can remove this inequality
-                    removed[idx] = true;
-                    removedCount++;
-                }
-                else
-                {
-                    // Must keep this inequality - restore it
-                    puzzle.inequalities.clear();
-                    for (size_t i = 0; i < originalInequalities.size(); i++)
-                    {
-                        if (!removed[i])
-                        {
-                            puzzle.inequalities.push_back(originalInequalities[i]);
-                        }
-                    }
-                }
-            }
+                order[i] = i;
+            }
+            std::shuffle(order.begin(), order.end(), rng);
+
+            removeWhileUnique(puzzle, order, targetRemovals,
+                              [&](Puzzle &target, const std::vector<bool> &removed)
+                              {
+                                  target.inequalities.clear();
+                                  for (size_t i = 0; i < originalInequalities.size(); i++)
+                                  {
+                                      if (!removed[i])
+                                      {
+                                          target.inequalities.push_back(originalInequalities[i]);
+                                      }
+                                  }
+                              });
         }
 
         // Then, try removing cages (more important constraints)
         if (!puzzle.cages.empty())
         {
-            std::vector<Cage> originalCages = puzzle.cages;
+            const std::vector<Cage> originalCages = puzzle.cages;
             int totalCages = static_cast<int>(originalCages.size());
             int targetRemovals = static_cast<int>(totalCages * removalRatio);
 
-            std::vector<size_t> indices(originalCages.size());
-            for (size_t i = 0; i < indices.size(); i++)
-            {
-                indices[i] = i;
-            }
-            std::shuffle(indices.begin(), indices.end(), rng);
-
-            std::vector<bool> removed(originalCages.size(), false);
-            int removedCount = 0;
-
-            for (size_t idx : indices)
+            std::vector<size_t> order(originalCages.size());
+            for (size_t i = 0; i < order.size(); i++)
             {
-                // Stop if we've reached our target removal count
-                if (removedCount >= targetRemovals)
-                    break;
-
-                // Try removing this cage
-                puzzle.cages.clear();
-                for (size_t i = 0; i < originalCages.size(); i++)
-                {
-                    if (!removed[i] && i != idx)
-                    {
-                        puzzle.cages.push_back(originalCages[i]);
-                    }
-                }
-
-                // Check if still unique
-                auto testSolution = solver.solve(puzzle, true);
-                if (testSolution.solved && testSolution.isUnique())
-                {
-                    // Can remove this cage
-                    removed[idx] = true;
-                    removedCount++;
-                }
-                else
-                {
-                    // Must keep this cage - restore it
-                    puzzle.cages.clear();
-                    for (size_t i = 0; i < originalCages.size(); i++)
-                    {
-                        if (!removed[i])
-                        {
-                            puzzle.cages.push_back(originalCages[i]);
-                        }
-                    }
-                }
-            }
+                order[i] = i;
+            }
+            std::shuffle(order.begin(), order.end(), rng);
+
+            removeWhileUnique(puzzle, order, targetRemovals,
+                              [&](Puzzle &target, const std::vector<bool> &removed)
+                              {
+                                  target.cages.clear();
+                                  for (size_t i = 0; i < originalCages.size(); i++)
+                                  {
+                                      if (!removed[i])
+                                      {
+                                          target.cages.push_back(originalCages[i]);
+                                      }
+                                  }
+                              });
         }
 
         // Finally, try removing given values
@@ -619,108 +593,174 @@ namespace sudoku
             int targetRemovals = static_cast<int>(totalGivens * removalRatio);
 
             std::shuffle(givenCells.begin(), givenCells.end(), rng);
-            int removedCount = 0;
-
-            for (const auto &cell : givenCells)
+            std::vector<size_t> order(givenCells.size());
+            for (size_t i = 0; i < order.size(); i++)
             {
-                // Stop if we've reached our target removal count
-                if (removedCount >= targetRemovals)
-                    break;
-
-                int originalValue = puzzle.grid[cell.row][cell.col];
+                order[i] = i;
+            }
+
+            removeWhileUnique(puzzle, order, targetRemovals,
+                              [&](Puzzle &target, const std::vector<bool> &removed)
+                              {
+                                  for (size_t i = 0; i < givenCells.size(); i++)
+                                  {
+                                      const Cell &cell = givenCells[i];
+                                      target.grid[cell.row][cell.col] =
+                                          removed[i] ? EMPTY_CELL : solution.grid[cell.row][cell.col];
+                                  }
+                              });
+        }
+    }
 
-                // Try removing this given
-                puzzle.grid[cell.row][cell.col] = EMPTY_CELL;
+    template <class Geo>
+    int BasicSudokuGenerator<Geo>::removeWhileUnique(Puzzle &puzzle, const std::vector<size_t> &order,
+                                                     int targetRemovals, const RemovalApplier &apply)
+    {
+        std::vector<bool> removed(order.size(), false);
+        const size_t window = helperSolvers.size() + 1;
+        std::vector<Puzzle> trials;
+        std::vector<char> unique;
+
+        int removedCount = 0;
+        size_t next = 0;
+        while (next < order.size() && removedCount < targetRemovals)
+        {
+            // Each trial removes one more candidate from the current puzzle
+            size_t count = std::min(window, order.size() - next);
+            trials.assign(count, puzzle);
+            for (size_t i = 0; i < count; i++)
+            {
+                removed[order[next + i]] = true;
+                apply(trials[i], removed);
+                removed[order[next + i]] = false;
+            }
+            testUniqueness(trials, unique);
 
-                // Check if still unique
-                auto testSolution = solver.solve(puzzle, true);
-                if (testSolution.solved && testSolution.isUnique())
+            // A sequential pass would reject every trial before the first unique
+            // one without changing the puzzle, so those results stand; the
+            // trials after it were made against a stale puzzle and are retried
+            size_t first = next;
+            for (size_t i = 0; i < count; i++)
+            {
+                next++;
+                if (unique[i])
                 {
-                    // Successfully removed
+                    removed[order[next - 1]] = true;
                     removedCount++;
-                }
-                else
-                {
-                    // Must keep this given - restore it
-                    puzzle.grid[cell.row][cell.col] = originalValue;
+                    break;
                 }
             }
+            progress.trialsDone += static_cast<int>(next - first);
+            progress.trialsRemaining -= static_cast<int>(next - first);
+            reportProgress();
         }
+
+        // Candidates past the removal target are never tried
+        progress.trialsRemaining -= static_cast<int>(order.size() - next);
+        apply(puzzle, removed);
+        return removedCount;
     }
 
-    std::string SudokuGenerator::toCustomFormat(const SudokuPuzzle &puzzle)
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::reportProgress()
     {
-        std::ostringstream oss;
+        if (progressCallback && !progressCallback(progress))
+        {
+            cancel();
+        }
+        if (cancelled.load())
+        {
+            throw std::runtime_error("Generation cancelled");
+        }
+    }
 
-        // Grid section
-        oss << "GRID\n";
-        for (int r = 0; r < GRID_SIZE; r++)
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::cancel()
+    {
+        cancelled.store(true);
+        std::lock_guard<std::mutex> lock(solversMutex);
+        solver.interrupt();
+        for (auto &helper : helperSolvers)
         {
-            for (int c = 0; c < GRID_SIZE; c++)
-            {
-                if (c > 0)
-                    oss << " ";
-                oss << puzzle.grid[r][c];
-            }
-            oss << "\n";
+            helper->interrupt();
         }
+    }
 
-        // Cages section
-        if (!puzzle.cages.empty())
+    template <class Geo>
+    void BasicSudokuGenerator<Geo>::testUniqueness(const std::vector<Puzzle> &trials, std::vector<char> &unique)
+    {
+        unique.assign(trials.size(), 0);
+        auto test = [&](BasicSudokuSolver<Geo> &trialSolver, size_t i)
         {
-            oss << "\nCAGES\n";
-            for (const auto &cage : puzzle.cages)
-            {
-                oss << cage.targetSum;
-                for (const auto &cell : cage.cells)
+            auto testSolution = trialSolver.solve(trials[i], true);
+            unique[i] = testSolution.solved && testSolution.isUnique();
+        };
+
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> failures(trials.size());
+        for (size_t i = 1; i < trials.size(); i++)
+        {
+            threads.emplace_back([&, i]()
+                                 {
+                try
                 {
-                    oss << " " << cell.row << " " << cell.col;
+                    test(*helperSolvers[i - 1], i);
                 }
-                oss << "\n";
-            }
+                catch (...)
+                {
+                    failures[i] = std::current_exception();
+                } });
+        }
+        try
+        {
+            test(solver, 0);
+        }
+        catch (...)
+        {
+            failures[0] = std::current_exception();
         }
 
-        // Inequalities section
-        if (!puzzle.inequalities.empty())
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        for (const auto &failure : failures)
         {
-            oss << "\nINEQUALITIES\n";
-            for (const auto &ineq : puzzle.inequalities)
+            if (failure)
             {
-                oss << ineq.cell1.row << " " << ineq.cell1.col << " ";
-                oss << (ineq.type == InequalityType::GREATER_THAN ? ">" : "<");
-                oss << " " << ineq.cell2.row << " " << ineq.cell2.col << "\n";
+                std::rethrow_exception(failure);
             }
         }
-
-        return oss.str();
     }
 
-    std::string SudokuGenerator::toCustomFormatWithSolution(const SudokuPuzzle &puzzle,
-                                                            const SudokuSolution &solution)
+    template <class Geo>
+    std::string BasicSudokuGenerator<Geo>::toCustomFormat(const Puzzle &puzzle)
     {
-        std::ostringstream oss;
-
-        // Puzzle
-        oss << toCustomFormat(puzzle);
+        std::string out;
+        BasicSudokuWriter<Geo>::appendCustomFormat(out, puzzle);
+        return out;
+    }
 
-        // Solution
-        oss << "\nSOLUTION\n";
-        for (int r = 0; r < GRID_SIZE; r++)
-        {
-            for (int c = 0; c < GRID_SIZE; c++)
-            {
-                if (c > 0)
-                    oss << " ";
-                oss << solution.grid[r][c];
-            }
-            oss << "\n";
-        }
+    template <class Geo>
+    std::string BasicSudokuGenerator<Geo>::toCustomFormatWithSolution(const Puzzle &puzzle,
+                                                            const Solution &solution)
+    {
+        std::string out;
+        BasicSudokuWriter<Geo>::appendCustomFormat(out, puzzle, &solution);
+        return out;
+    }
 
-        return oss.str();
+    template <class Geo>
+    std::string BasicSudokuGenerator<Geo>::toBinaryFormat(const Puzzle &puzzle, const Solution *solution)
+    {
+        std::string out;
+        BasicSudokuWriter<Geo>::appendBinary(out, puzzle, solution);
+        return out;
     }
 
+    template <class Geo>
     template <typename T>
-    std::vector<T> SudokuGenerator::shuffleAndPick(std::vector<T> items, int count)
+    std::vector<T> BasicSudokuGenerator<Geo>::shuffleAndPick(std::vector<T> items, int count)
     {
         std::shuffle(items.begin(), items.end(), rng);
         if (count >= static_cast<int>(items.size()))
@@ -730,4 +770,8 @@ namespace sudoku
         return std::vector<T>(items.begin(), items.begin() + count);
     }
 
+#define SUDOKU_INSTANTIATE_GENERATOR(R, C) template class BasicSudokuGenerator<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_GENERATOR)
+#undef SUDOKU_INSTANTIATE_GENERATOR
+
 } // namespace sudoku
@@ -14,8 +14,13 @@
 
 #include "SudokuTypes.h"
 #include "SudokuSolver.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <string>
+#include <vector>
 
 namespace sudoku
 {
@@ -56,29 +61,71 @@ namespace sudoku
         // Difficulty level (0-100): controls constraint removal ratio
         // 0 = easiest (keep most constraints), 100 = hardest (remove most constraints)
         int difficulty = 50;
+
+        // Solvers testing constraint removals in parallel while minimizing.
+        // The puzzle produced for a seed does not depend on this.
+        int minimizeThreads = 1;
+    };
+
+    /**
+     * @brief Time spent in each phase of the last generation
+     */
+    struct GenerationStats
+    {
+        double fillMs = 0.0;        // Building the complete solution grid
+        double constraintsMs = 0.0; // Adding cages, inequalities and givens
+        double uniquenessMs = 0.0;  // Checking and forcing a unique solution
+        double minimizeMs = 0.0;    // Removing redundant constraints
+        int uniquenessSolves = 0;   // Solver calls made while forcing uniqueness
+    };
+
+    /**
+     * @brief Stage of a running generation
+     */
+    enum class GenerationPhase
+    {
+        FILL,       // Building the complete solution grid
+        UNIQUENESS, // Adding constraints until the solution is unique
+        MINIMIZE    // Removing constraints the solution does not need
+    };
+
+    /**
+     * @brief Progress of a running generation, reported between solver calls
+     */
+    struct GenerationProgress
+    {
+        GenerationPhase phase = GenerationPhase::FILL;
+        int trialsDone = 0;      // Solver calls finished in this phase
+        int trialsRemaining = 0; // Most solver calls still to come in this phase
     };
 
     /**
      * @brief Generates Sudoku puzzles using SAT solver
+     *
+     * Instantiated for every geometry in SUDOKU_FOR_EACH_GEOMETRY.
      */
-    class SudokuGenerator
+    template <class Geo>
+    class BasicSudokuGenerator
     {
     public:
-        SudokuGenerator();
-        ~SudokuGenerator();
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Solution = BasicSudokuSolution<Geo>;
+
+        BasicSudokuGenerator();
+        ~BasicSudokuGenerator();
 
         /**
          * @brief Generate a puzzle with default configuration
          * @return Generated puzzle
          */
-        SudokuPuzzle generate();
+        Puzzle generate();
 
         /**
          * @brief Generate a puzzle with custom configuration
          * @param config Generation configuration
          * @return Generated puzzle
          */
-        SudokuPuzzle generate(const GeneratorConfig &config);
+        Puzzle generate(const GeneratorConfig &config);
 
         /**
          * @brief Generate and return the puzzle along with its solution
@@ -86,14 +133,14 @@ namespace sudoku
          * @param solution Output parameter for the solution
          * @return Generated puzzle
          */
-        SudokuPuzzle generateWithSolution(const GeneratorConfig &config, SudokuSolution &solution);
+        Puzzle generateWithSolution(const GeneratorConfig &config, Solution &solution);
 
         /**
          * @brief Convert puzzle to custom text format
          * @param puzzle The puzzle to convert
          * @return String in custom format
          */
-        static std::string toCustomFormat(const SudokuPuzzle &puzzle);
+        static std::string toCustomFormat(const Puzzle &puzzle);
 
         /**
          * @brief Convert puzzle and solution to custom format
@@ -101,53 +148,115 @@ namespace sudoku
          * @param solution The solution
          * @return String with puzzle and solution
          */
-        static std::string toCustomFormatWithSolution(const SudokuPuzzle &puzzle,
-                                                      const SudokuSolution &solution);
+        static std::string toCustomFormatWithSolution(const Puzzle &puzzle,
+                                                      const Solution &solution);
+
+        /**
+         * @brief Convert puzzle to the compact binary format (see SudokuBinary.h)
+         * @param puzzle The puzzle to convert
+         * @param solution Optional solution to store with it
+         * @return Binary record
+         */
+        static std::string toBinaryFormat(const Puzzle &puzzle, const Solution *solution = nullptr);
+
+        /**
+         * @brief Phase timings of the last generation
+         */
+        const GenerationStats &getLastStats() const { return lastStats; }
+
+        /**
+         * @brief Called on the generating thread between solver calls
+         *
+         * Returning false cancels the generation, as cancel() does.
+         */
+        using ProgressCallback = std::function<bool(const GenerationProgress &progress)>;
+        void setProgressCallback(ProgressCallback callback) { progressCallback = std::move(callback); }
+
+        /**
+         * @brief Stop the generation in progress; callable from any thread
+         *
+         * Interrupts the SAT search that is running, and the generation throws
+         * std::runtime_error. The next generation starts normally.
+         */
+        void cancel();
+
+        /**
+         * @brief Whether the last generation was cancelled
+         */
+        bool wasCancelled() const { return cancelled.load(); }
 
     private:
-        SudokuSolver solver;
+        using Topology = BasicTopology<Geo>;
+
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int NUM_CELLS = Geo::NUM_CELLS;
+        static constexpr int MIN_VALUE = Geo::MIN_VALUE;
+        static constexpr int MAX_VALUE = Geo::MAX_VALUE;
+
+        BasicSudokuSolver<Geo> solver;
+        std::vector<std::unique_ptr<BasicSudokuSolver<Geo>>> helperSolvers; // minimizeThreads - 1
+        std::mutex solversMutex; // Guards helperSolvers against cancel()
         std::mt19937 rng;
+        GenerationStats lastStats;
+
+        ProgressCallback progressCallback;
+        GenerationProgress progress;
+        std::atomic<bool> cancelled{false};
+
+        // Pass progress to the callback; throws if the generation was cancelled
+        void reportProgress();
 
         // Generate a complete valid Sudoku grid
-        bool generateCompleteSolution(SudokuSolution &solution);
+        bool generateCompleteSolution(Solution &solution);
 
         // Generate cage constraints based on solution
-        void generateCages(SudokuPuzzle &puzzle, const SudokuSolution &solution,
+        void generateCages(Puzzle &puzzle, const Solution &solution,
                            int numCages, int minSize, int maxSize);
 
         // Generate cages that cover all cells
-        void generateCagesFillingAll(SudokuPuzzle &puzzle, const SudokuSolution &solution,
+        void generateCagesFillingAll(Puzzle &puzzle, const Solution &solution,
                                      int minSize, int maxSize);
 
         // Generate inequality constraints based on solution
-        void generateInequalities(SudokuPuzzle &puzzle, const SudokuSolution &solution,
+        void generateInequalities(Puzzle &puzzle, const Solution &solution,
                                   int numInequalities);
 
         // Add given cells to puzzle
-        void addGivens(SudokuPuzzle &puzzle, const SudokuSolution &solution, int numGivens);
+        void addGivens(Puzzle &puzzle, const Solution &solution, int numGivens);
 
         // Check if puzzle has unique solution
-        bool hasUniqueSolution(const SudokuPuzzle &puzzle);
+        bool hasUniqueSolution(const Puzzle &puzzle);
 
         // Minimize constraints while maintaining uniqueness, controlled by difficulty
-        void minimizeConstraints(SudokuPuzzle &puzzle, const SudokuSolution &solution, int difficulty);
+        void minimizeConstraints(Puzzle &puzzle, const Solution &solution, int difficulty);
+
+        // Rebuilds one kind of constraint in a puzzle, leaving out the removed candidates
+        using RemovalApplier = std::function<void(Puzzle &, const std::vector<bool> &)>;
 
-        // Helper: Get adjacent cells
-        std::vector<Cell> getAdjacentCells(const Cell &cell);
+        // Remove candidates in the given order while the puzzle stays unique, up to
+        // targetRemovals; with helper solvers, the next few candidates are tested at once
+        int removeWhileUnique(Puzzle &puzzle, const std::vector<size_t> &order, int targetRemovals,
+                              const RemovalApplier &apply);
+
+        // Uniqueness of each trial puzzle, one solver per trial
+        void testUniqueness(const std::vector<Puzzle> &trials, std::vector<char> &unique);
 
         // Helper: Generate a connected cage starting from a cell
-        std::vector<Cell> generateConnectedCage(const SudokuSolution &solution,
+        std::vector<Cell> generateConnectedCage(const Solution &solution,
                                                 std::set<Cell> &usedCells,
                                                 int targetSize);
 
         // Helper: Calculate cage sum
-        int calculateCageSum(const std::vector<Cell> &cells, const SudokuSolution &solution);
+        int calculateCageSum(const std::vector<Cell> &cells, const Solution &solution);
 
         // Helper: Shuffle and pick random elements
         template <typename T>
         std::vector<T> shuffleAndPick(std::vector<T> items, int count);
     };
 
+    // Classic 9x9 generator
+    using SudokuGenerator = BasicSudokuGenerator<StandardGeometry>;
+
 } // namespace sudoku
 
 #endif // SUDOKU_GENERATOR_H
@@ -0,0 +1,139 @@
+/**
+ * @file SudokuGridScan.cpp
+ * @brief SSE2 / AVX2 / scalar kernels for 81-character grids
+ *
+ * SSE2 is part of the x86-64 baseline; AVX2 is compiled with a function
+ * target attribute and only used after a runtime CPU check.
+ */
+
+#include "SudokuGridScan.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SUDOKU_GRID_SCAN_X86 1
+#if defined(__GNUC__) || defined(__clang__)
+#define SUDOKU_GRID_SCAN_AVX2 1
+#endif
+#endif
+
+namespace sudoku
+{
+    namespace gridscan
+    {
+
+        namespace
+        {
+            inline bool scanChar(char c, uint8_t &value)
+            {
+                unsigned digit = static_cast<unsigned char>(c) - '0';
+                if (digit <= 9)
+                {
+                    value = static_cast<uint8_t>(digit);
+                    return true;
+                }
+                value = 0;
+                return c == '.' || c == '_' || c == '*';
+            }
+
+#ifdef SUDOKU_GRID_SCAN_X86
+            /**
+             * @brief Classify 16 characters; returns a 16-bit mask of valid bytes
+             */
+            inline int scan16(const char *text, uint8_t *cells)
+            {
+                const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+                const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+                // Unsigned digits <= 9  <=>  min(d, 9) == d
+                const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+                const __m128i isEmpty = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('.')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'))),
+                    _mm_cmpeq_epi8(chars, _mm_set1_epi8('*')));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(cells), _mm_and_si128(digits, isDigit));
+                return _mm_movemask_epi8(_mm_or_si128(isDigit, isEmpty));
+            }
+
+            bool scanGrid81Sse2(const char *text, uint8_t cells[GRID_CHARS])
+            {
+                // 5 x 16 bytes, then the last cell
+                int valid = 0xFFFF;
+                for (int i = 0; i < 80; i += 16)
+                {
+                    valid &= scan16(text + i, cells + i);
+                }
+                return valid == 0xFFFF && scanChar(text[80], cells[80]);
+            }
+#endif
+
+#ifdef SUDOKU_GRID_SCAN_AVX2
+            __attribute__((target("avx2"))) inline uint32_t scan32(const char *text, uint8_t *cells)
+            {
+                const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text));
+                const __m256i digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+                const __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+                const __m256i isEmpty = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('.')),
+                                    _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_'))),
+                    _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('*')));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(cells), _mm256_and_si256(digits, isDigit));
+                return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(isDigit, isEmpty)));
+            }
+
+            __attribute__((target("avx2"))) bool scanGrid81Avx2(const char *text, uint8_t cells[GRID_CHARS])
+            {
+                // 2 x 32 bytes, 16 bytes, then the last cell
+                uint32_t valid = scan32(text, cells) & scan32(text + 32, cells + 32);
+                return valid == 0xFFFFFFFFu && scan16(text + 64, cells + 64) == 0xFFFF &&
+                       scanChar(text[80], cells[80]);
+            }
+#endif
+
+            struct Kernel
+            {
+                bool (*scan)(const char *, uint8_t *);
+                const char *name;
+            };
+
+            Kernel selectKernel()
+            {
+#ifdef SUDOKU_GRID_SCAN_AVX2
+                if (__builtin_cpu_supports("avx2"))
+                {
+                    return {scanGrid81Avx2, "avx2"};
+                }
+#endif
+#ifdef SUDOKU_GRID_SCAN_X86
+                return {scanGrid81Sse2, "sse2"};
+#else
+                return {scanGrid81Scalar, "scalar"};
+#endif
+            }
+
+            const Kernel &kernel()
+            {
+                static const Kernel selected = selectKernel();
+                return selected;
+            }
+        } // namespace
+
+        bool scanGrid81Scalar(const char *text, uint8_t cells[GRID_CHARS])
+        {
+            bool valid = true;
+            for (int i = 0; i < GRID_CHARS; i++)
+            {
+                valid &= scanChar(text[i], cells[i]);
+            }
+            return valid;
+        }
+
+        bool scanGrid81(const char *text, uint8_t cells[GRID_CHARS])
+        {
+            return kernel().scan(text, cells);
+        }
+
+        const char *kernelName()
+        {
+            return kernel().name;
+        }
+
+    } // namespace gridscan
+} // namespace sudoku
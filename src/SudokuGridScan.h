@@ -0,0 +1,44 @@
+/**
+ * @file SudokuGridScan.h
+ * @brief Vectorized scanning of 81-character grids
+ *
+ * Classifies 16 (SSE2) or 32 (AVX2) characters per step: digits '0'-'9'
+ * map to their value, '.', '_' and '*' map to 0 (empty), and any other
+ * byte rejects the line. The widest kernel supported by the running CPU is
+ * picked once at start-up; other platforms use the scalar kernel.
+ */
+
+#ifndef SUDOKU_GRID_SCAN_H
+#define SUDOKU_GRID_SCAN_H
+
+#include <cstdint>
+
+namespace sudoku
+{
+    namespace gridscan
+    {
+
+        constexpr int GRID_CHARS = 81;
+
+        /**
+         * @brief Decode exactly 81 grid characters
+         * @param text At least 81 readable bytes
+         * @param cells Receives 81 values (0 = empty); unspecified on failure
+         * @return false if any character is not a digit, '.', '_' or '*'
+         */
+        bool scanGrid81(const char *text, uint8_t cells[GRID_CHARS]);
+
+        /**
+         * @brief Portable reference kernel with the same contract
+         */
+        bool scanGrid81Scalar(const char *text, uint8_t cells[GRID_CHARS]);
+
+        /**
+         * @brief Name of the kernel used by scanGrid81 ("avx2", "sse2" or "scalar")
+         */
+        const char *kernelName();
+
+    } // namespace gridscan
+} // namespace sudoku
+
+#endif // SUDOKU_GRID_SCAN_H
@@ -0,0 +1,361 @@
+/**
+ * @file SudokuGzip.cpp
+ * @brief Implementation of the gzip corpus reader and output stream
+ */
+
+#include "SudokuGzip.h"
+#include <fstream>
+#include <stdexcept>
+
+#ifdef SUDOKU_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace sudoku
+{
+
+    namespace
+    {
+        // Decompressed chunks waiting for the parser
+        const size_t kQueuedChunks = 4;
+
+        const char *const kNoZlib = "gzip support needs zlib, which was not found at build time";
+
+        bool isBlank(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        /**
+         * @brief Start of the last record that may still be incomplete
+         *
+         * Everything before the returned offset is whole records. Lines end
+         * at the last newline; blocks end where the last GRID line starts.
+         */
+        size_t recordBoundary(const std::string &text, CorpusFormat format)
+        {
+            size_t lastNewline = text.rfind('\n');
+            if (lastNewline == std::string::npos)
+            {
+                return 0;
+            }
+            if (format == CorpusFormat::LINES)
+            {
+                return lastNewline + 1;
+            }
+
+            size_t from = lastNewline;
+            while (from > 0)
+            {
+                size_t found = text.rfind("GRID", from - 1);
+                if (found == std::string::npos)
+                {
+                    return 0;
+                }
+                from = found;
+
+                size_t lineStart = found;
+                while (lineStart > 0 && isBlank(text[lineStart - 1]))
+                {
+                    lineStart--;
+                }
+                size_t lineEnd = found + 4;
+                while (lineEnd < text.size() && isBlank(text[lineEnd]))
+                {
+                    lineEnd++;
+                }
+                if ((lineStart == 0 || text[lineStart - 1] == '\n') && lineEnd < text.size() && text[lineEnd] == '\n')
+                {
+                    return lineStart;
+                }
+            }
+            return 0;
+        }
+    } // namespace
+
+    bool isGzipFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        unsigned char magic[2] = {0, 0};
+        file.read(reinterpret_cast<char *>(magic), 2);
+        return file.gcount() == 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+    }
+
+    bool hasGzipSuffix(const std::string &path)
+    {
+        return path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+    }
+
+#ifdef SUDOKU_HAVE_ZLIB
+
+    GzipCorpusReader::GzipCorpusReader(const std::string &path, CorpusFormat format)
+        : format(format)
+    {
+        gzFile gz = gzopen(path.c_str(), "rb");
+        if (!gz)
+        {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        gzbuffer(gz, 1 << 18);
+        file = gz;
+
+        // The first chunk is read here so the layout is known before next()
+        std::string head(CHUNK_BYTES, '\0');
+        int n = gzread(gz, &head[0], static_cast<unsigned>(head.size()));
+        if (n < 0)
+        {
+            int code = 0;
+            std::string message = gzerror(gz, &code);
+            gzclose(gz);
+            throw std::runtime_error("Cannot decompress " + path + ": " + message);
+        }
+        head.resize(static_cast<size_t>(n));
+        if (this->format == CorpusFormat::AUTO)
+        {
+            this->format = CorpusReader::detectFormat(head);
+        }
+
+        thread = std::thread([this, head = std::move(head)]() mutable
+                             { decompress(std::move(head)); });
+    }
+
+    GzipCorpusReader::~GzipCorpusReader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        thread.join();
+        gzclose(static_cast<gzFile>(file));
+    }
+
+    void GzipCorpusReader::decompress(std::string carry)
+    {
+        std::string block(CHUNK_BYTES, '\0');
+        std::string failure;
+
+        auto push = [this](std::string chunk)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this]()
+                         { return chunks.size() < kQueuedChunks || stopping; });
+            if (stopping)
+            {
+                return false;
+            }
+            chunks.push_back(std::move(chunk));
+            changed.notify_all();
+            return true;
+        };
+
+        for (;;)
+        {
+            size_t cut = recordBoundary(carry, format);
+            if (cut >= CHUNK_BYTES / 2)
+            {
+                std::string chunk = std::move(carry);
+                carry.assign(chunk, cut, std::string::npos);
+                chunk.resize(cut);
+                if (!push(std::move(chunk)))
+                {
+                    return;
+                }
+            }
+
+            int n = gzread(static_cast<gzFile>(file), &block[0], static_cast<unsigned>(block.size()));
+            if (n < 0)
+            {
+                int code = 0;
+                failure = gzerror(static_cast<gzFile>(file), &code);
+                break;
+            }
+            if (n == 0)
+            {
+                if (!carry.empty() && !push(std::move(carry)))
+                {
+                    return;
+                }
+                break;
+            }
+            carry.append(block, 0, static_cast<size_t>(n));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        if (!failure.empty())
+        {
+            error = "gzip stream error: " + failure;
+        }
+        changed.notify_all();
+    }
+
+    bool GzipCorpusReader::next(std::string_view &record)
+    {
+        for (;;)
+        {
+            if (reader && reader->next(record))
+            {
+                return true;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this]()
+                         { return !chunks.empty() || finished; });
+            if (chunks.empty())
+            {
+                if (!error.empty())
+                {
+                    throw std::runtime_error(error);
+                }
+                return false;
+            }
+            current = std::move(chunks.front());
+            chunks.pop_front();
+            changed.notify_all();
+            lock.unlock();
+            reader = std::make_unique<CorpusReader>(current, format);
+        }
+    }
+
+    GzipOutputStream::Buffer::Buffer(void *file)
+        : file(file)
+    {
+        setp(buffer, buffer + sizeof(buffer));
+    }
+
+    bool GzipOutputStream::Buffer::drain()
+    {
+        int pending = static_cast<int>(pptr() - pbase());
+        if (pending > 0 && gzwrite(static_cast<gzFile>(file), pbase(), static_cast<unsigned>(pending)) != pending)
+        {
+            return false;
+        }
+        setp(buffer, buffer + sizeof(buffer));
+        return true;
+    }
+
+    GzipOutputStream::Buffer::int_type GzipOutputStream::Buffer::overflow(int_type ch)
+    {
+        if (!drain())
+        {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    int GzipOutputStream::Buffer::sync()
+    {
+        // Hands data to zlib only: a zlib flush would cost compression ratio
+        return drain() ? 0 : -1;
+    }
+
+    bool GzipOutputStream::Buffer::finish()
+    {
+        bool drained = drain();
+        bool closed = gzclose(static_cast<gzFile>(file)) == Z_OK;
+        file = nullptr;
+        return drained && closed;
+    }
+
+    GzipOutputStream::GzipOutputStream(const std::string &path)
+        : std::ostream(nullptr)
+    {
+        gzFile gz = gzopen(path.c_str(), "wb");
+        if (!gz)
+        {
+            throw std::runtime_error("Cannot write to file " + path);
+        }
+        gzbuffer(gz, 1 << 18);
+        file = gz;
+        buffer = std::make_unique<Buffer>(file);
+        rdbuf(buffer.get());
+    }
+
+    GzipOutputStream::~GzipOutputStream()
+    {
+        if (file)
+        {
+            buffer->finish();
+        }
+    }
+
+    void GzipOutputStream::close()
+    {
+        if (!file)
+        {
+            return;
+        }
+        file = nullptr;
+        bool ok = buffer->finish();
+        setstate(std::ios::badbit);
+        if (!ok)
+        {
+            throw std::runtime_error("Cannot write compressed output");
+        }
+    }
+
+#else
+
+    GzipCorpusReader::GzipCorpusReader(const std::string &, CorpusFormat format)
+        : format(format)
+    {
+        throw std::runtime_error(kNoZlib);
+    }
+
+    GzipCorpusReader::~GzipCorpusReader() = default;
+
+    void GzipCorpusReader::decompress(std::string)
+    {
+    }
+
+    bool GzipCorpusReader::next(std::string_view &)
+    {
+        return false;
+    }
+
+    GzipOutputStream::Buffer::Buffer(void *file)
+        : file(file)
+    {
+    }
+
+    bool GzipOutputStream::Buffer::finish()
+    {
+        return false;
+    }
+
+    bool GzipOutputStream::Buffer::drain()
+    {
+        return false;
+    }
+
+    GzipOutputStream::Buffer::int_type GzipOutputStream::Buffer::overflow(int_type)
+    {
+        return traits_type::eof();
+    }
+
+    int GzipOutputStream::Buffer::sync()
+    {
+        return -1;
+    }
+
+    GzipOutputStream::GzipOutputStream(const std::string &)
+        : std::ostream(nullptr)
+    {
+        throw std::runtime_error(kNoZlib);
+    }
+
+    GzipOutputStream::~GzipOutputStream() = default;
+
+    void GzipOutputStream::close()
+    {
+    }
+
+#endif
+
+} // namespace sudoku
@@ -0,0 +1,145 @@
+/**
+ * @file SudokuGzip.h
+ * @brief Streaming gzip input and output for puzzle corpora
+ *
+ * - GzipCorpusReader: reads the records of a .gz corpus. A dedicated thread
+ *   decompresses the file and hands whole-record chunks to the parsing
+ *   thread through a small bounded queue, so decompression overlaps
+ *   parsing and solving and nothing is written to disk.
+ *
+ * - GzipOutputStream: a std::ostream that compresses what is written to it.
+ *
+ * Both need zlib (SUDOKU_HAVE_ZLIB, defined when CMake finds it); without
+ * it their constructors throw.
+ */
+
+#ifndef SUDOKU_GZIP_H
+#define SUDOKU_GZIP_H
+
+#include "SudokuCorpus.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace sudoku
+{
+
+    /**
+     * @brief True if the file starts with the gzip magic bytes
+     */
+    bool isGzipFile(const std::string &path);
+
+    /**
+     * @brief True if a path names a gzip file by its ".gz" suffix
+     */
+    bool hasGzipSuffix(const std::string &path);
+
+    /**
+     * @brief Iterates the records of a gzip-compressed corpus
+     *
+     * Records follow the same rules as CorpusReader (lines or GRID blocks).
+     */
+    class GzipCorpusReader
+    {
+    public:
+        /**
+         * @brief Open a file and start decompressing it
+         * @throws std::runtime_error if the file cannot be opened
+         */
+        explicit GzipCorpusReader(const std::string &path, CorpusFormat format = CorpusFormat::AUTO);
+        ~GzipCorpusReader();
+
+        GzipCorpusReader(const GzipCorpusReader &) = delete;
+        GzipCorpusReader &operator=(const GzipCorpusReader &) = delete;
+
+        /**
+         * @brief Get the next record
+         * @param record Valid until the following call
+         * @return false at the end of the file
+         * @throws std::runtime_error if the stream is corrupt
+         */
+        bool next(std::string_view &record);
+
+        /**
+         * @brief Record layout; detected from the first chunk when AUTO
+         */
+        CorpusFormat getFormat() const { return format; }
+
+        /**
+         * @brief Uncompressed bytes per chunk handed to the parser
+         */
+        static constexpr size_t CHUNK_BYTES = 1 << 20;
+
+    private:
+        void *file = nullptr; // gzFile
+        CorpusFormat format;
+
+        // Filled by the decompression thread
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::string> chunks;
+        bool finished = false;
+        bool stopping = false;
+        std::string error;
+        std::thread thread;
+
+        // Consumed by next()
+        std::string current;
+        std::unique_ptr<CorpusReader> reader;
+
+        /**
+         * @brief Decompression thread: cut the stream at record boundaries and queue it
+         * @param carry Data read but not yet queued
+         */
+        void decompress(std::string carry);
+    };
+
+    /**
+     * @brief Writes gzip-compressed output to a file
+     */
+    class GzipOutputStream : public std::ostream
+    {
+    public:
+        /**
+         * @throws std::runtime_error if the file cannot be created
+         */
+        explicit GzipOutputStream(const std::string &path);
+        ~GzipOutputStream() override;
+
+        /**
+         * @brief Flush and finish the stream; further writes fail
+         * @throws std::runtime_error if compressed data cannot be written
+         */
+        void close();
+
+    private:
+        class Buffer : public std::streambuf
+        {
+        public:
+            explicit Buffer(void *file);
+            bool finish();
+
+        protected:
+            int_type overflow(int_type ch) override;
+            int sync() override;
+
+        private:
+            void *file; // gzFile
+            char buffer[1 << 16];
+
+            bool drain();
+        };
+
+        void *file = nullptr;
+        std::unique_ptr<Buffer> buffer;
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_GZIP_H
@@ -0,0 +1,541 @@
+/**
+ * @file SudokuJson.cpp
+ * @brief Implementation of the JSON reader and writer
+ */
+
+#include "SudokuJson.h"
+#include "SudokuParser.h"
+#include "SudokuWriter.h"
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        /**
+         * @brief Forward-only JSON tokenizer over a string_view
+         */
+        class JsonCursor
+        {
+        public:
+            /// Deepest object/array nesting accepted; bounds the recursion on hostile input
+            static constexpr int MAX_DEPTH = 64;
+
+            explicit JsonCursor(std::string_view text) : text(text) {}
+
+            [[noreturn]] void fail(const std::string &message) const
+            {
+                throw std::runtime_error("JSON error at offset " + std::to_string(pos) + ": " + message);
+            }
+
+            void skipWhitespace()
+            {
+                while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' ||
+                                             text[pos] == '\r'))
+                {
+                    pos++;
+                }
+            }
+
+            char peek()
+            {
+                skipWhitespace();
+                return pos < text.size() ? text[pos] : '\0';
+            }
+
+            void expect(char c)
+            {
+                if (peek() != c)
+                {
+                    fail(std::string("expected '") + c + "'");
+                }
+                pos++;
+            }
+
+            // Consume c if it is the next token
+            bool accept(char c)
+            {
+                if (peek() == c)
+                {
+                    pos++;
+                    return true;
+                }
+                return false;
+            }
+
+            /**
+             * @brief Read a string; escapes are kept raw (keys and values in
+             *        this schema never need them)
+             */
+            std::string_view readString()
+            {
+                expect('"');
+                size_t start = pos;
+                while (pos < text.size() && text[pos] != '"')
+                {
+                    if (text[pos] == '\\')
+                    {
+                        pos++;
+                    }
+                    pos++;
+                }
+                if (pos >= text.size())
+                {
+                    fail("unterminated string");
+                }
+                return text.substr(start, pos++ - start);
+            }
+
+            int readInt()
+            {
+                skipWhitespace();
+                bool negative = pos < text.size() && text[pos] == '-';
+                if (negative)
+                {
+                    pos++;
+                }
+                if (pos >= text.size() || text[pos] < '0' || text[pos] > '9')
+                {
+                    fail("expected an integer");
+                }
+                long value = 0;
+                while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+                {
+                    value = value * 10 + (text[pos++] - '0');
+                    if (value > 1000000)
+                    {
+                        fail("integer out of range");
+                    }
+                }
+                if (pos < text.size() && (text[pos] == '.' || text[pos] == 'e' || text[pos] == 'E'))
+                {
+                    fail("expected an integer");
+                }
+                return static_cast<int>(negative ? -value : value);
+            }
+
+            /**
+             * @brief Skip any value and return its raw text
+             */
+            std::string_view skipValue()
+            {
+                char c = peek();
+                size_t start = pos;
+                if (c == '"')
+                {
+                    readString();
+                }
+                else if (c == '{' || c == '[')
+                {
+                    char close = c == '{' ? '}' : ']';
+                    DepthGuard guard(*this);
+                    pos++;
+                    if (!accept(close))
+                    {
+                        do
+                        {
+                            if (c == '{')
+                            {
+                                readString();
+                                expect(':');
+                            }
+                            skipValue();
+                        } while (accept(','));
+                        expect(close);
+                    }
+                }
+                else
+                {
+                    // Number, true, false or null
+                    while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) ||
+                                                 text[pos] == '-' || text[pos] == '+' || text[pos] == '.'))
+                    {
+                        pos++;
+                    }
+                    if (pos == start)
+                    {
+                        fail("unexpected character");
+                    }
+                }
+                return text.substr(start, pos - start);
+            }
+
+            /**
+             * @brief Iterate the members of an object
+             * @param onMember Called with each key; must consume the value
+             */
+            template <class Fn>
+            void readObject(Fn &&onMember)
+            {
+                DepthGuard guard(*this);
+                expect('{');
+                if (accept('}'))
+                {
+                    return;
+                }
+                do
+                {
+                    std::string_view key = readString();
+                    expect(':');
+                    onMember(key);
+                } while (accept(','));
+                expect('}');
+            }
+
+            /**
+             * @brief Iterate the elements of an array
+             * @param onElement Called once per element; must consume it
+             */
+            template <class Fn>
+            void readArray(Fn &&onElement)
+            {
+                DepthGuard guard(*this);
+                expect('[');
+                if (accept(']'))
+                {
+                    return;
+                }
+                do
+                {
+                    onElement();
+                } while (accept(','));
+                expect(']');
+            }
+
+            bool atEnd()
+            {
+                skipWhitespace();
+                return pos >= text.size();
+            }
+
+        private:
+            // Counts one level of nesting for the lifetime of a container read
+            class DepthGuard
+            {
+            public:
+                explicit DepthGuard(JsonCursor &cursor) : cursor(cursor)
+                {
+                    if (++cursor.depth > MAX_DEPTH)
+                    {
+                        cursor.fail("nesting too deep");
+                    }
+                }
+                ~DepthGuard() { cursor.depth--; }
+                DepthGuard(const DepthGuard &) = delete;
+                DepthGuard &operator=(const DepthGuard &) = delete;
+
+            private:
+                JsonCursor &cursor;
+            };
+
+            std::string_view text;
+            size_t pos = 0;
+            int depth = 0;
+        };
+
+        template <class Geo>
+        Cell readCell(JsonCursor &cursor)
+        {
+            int values[2];
+            int n = 0;
+            cursor.readArray([&]()
+                             {
+                                 int value = cursor.readInt();
+                                 if (n < 2)
+                                     values[n] = value;
+                                 n++; });
+            if (n != 2)
+            {
+                cursor.fail("a cell is a [row, col] pair");
+            }
+            Cell cell(values[0], values[1]);
+            if (!cell.isValid(Geo::GRID_SIZE))
+            {
+                cursor.fail("cell out of range");
+            }
+            return cell;
+        }
+    } // namespace
+
+    namespace json
+    {
+        void forEachMember(std::string_view object,
+                           const std::function<void(std::string_view key, std::string_view value)> &fn)
+        {
+            JsonCursor cursor(object);
+            cursor.readObject([&](std::string_view key)
+                              { fn(key, cursor.skipValue()); });
+            if (!cursor.atEnd())
+            {
+                cursor.fail("trailing characters after the object");
+            }
+        }
+
+        std::string decodeString(std::string_view literal)
+        {
+            if (literal.size() < 2 || literal.front() != '"' || literal.back() != '"')
+            {
+                throw std::runtime_error("JSON error: expected a string");
+            }
+            std::string out;
+            out.reserve(literal.size() - 2);
+            for (size_t i = 1; i + 1 < literal.size(); i++)
+            {
+                char c = literal[i];
+                if (c != '\\')
+                {
+                    out += c;
+                    continue;
+                }
+                if (++i + 1 >= literal.size())
+                {
+                    throw std::runtime_error("JSON error: bad escape");
+                }
+                switch (literal[i])
+                {
+                case 'n':
+                    out += '\n';
+                    break;
+                case 't':
+                    out += '\t';
+                    break;
+                case 'r':
+                    out += '\r';
+                    break;
+                case 'b':
+                    out += '\b';
+                    break;
+                case 'f':
+                    out += '\f';
+                    break;
+                case 'u':
+                {
+                    unsigned code = 0;
+                    if (i + 4 >= literal.size() ||
+                        std::from_chars(literal.data() + i + 1, literal.data() + i + 5, code, 16).ptr !=
+                            literal.data() + i + 5)
+                    {
+                        throw std::runtime_error("JSON error: bad \\u escape");
+                    }
+                    i += 4;
+                    // UTF-8 encode (surrogate pairs are not combined)
+                    if (code < 0x80)
+                    {
+                        out += static_cast<char>(code);
+                    }
+                    else if (code < 0x800)
+                    {
+                        out += static_cast<char>(0xC0 | (code >> 6));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    else
+                    {
+                        out += static_cast<char>(0xE0 | (code >> 12));
+                        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    // \" \\ and \/
+                    out += literal[i];
+                }
+            }
+            return out;
+        }
+
+        long long parseInt(std::string_view literal)
+        {
+            long long value = 0;
+            const char *end = literal.data() + literal.size();
+            auto result = std::from_chars(literal.data(), end, value);
+            if (result.ec != std::errc() || result.ptr != end)
+            {
+                throw std::runtime_error("JSON error: expected an integer, got " + std::string(literal));
+            }
+            return value;
+        }
+
+        bool parseBool(std::string_view literal)
+        {
+            if (literal == "true")
+                return true;
+            if (literal == "false")
+                return false;
+            throw std::runtime_error("JSON error: expected true or false, got " + std::string(literal));
+        }
+    } // namespace json
+
+    template <class Geo>
+    bool BasicSudokuJson<Geo>::isJson(std::string_view text)
+    {
+        size_t start = text.find_first_not_of(" \t\r\n");
+        return start != std::string_view::npos && text[start] == '{';
+    }
+
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuJson<Geo>::parsePuzzle(std::string_view text, std::string *id)
+    {
+        Puzzle puzzle;
+        JsonCursor cursor(text);
+        std::string_view declaredName;
+        SudokuType declaredType = SudokuType::STANDARD;
+        if (id)
+        {
+            id->clear();
+        }
+
+        cursor.readObject([&](std::string_view key)
+                          {
+            if (key == "grid")
+            {
+                if (cursor.peek() == '"')
+                {
+                    if (!BasicSudokuParser<Geo>::parseCompactGrid(cursor.readString(), puzzle))
+                        cursor.fail("grid string must have " + std::to_string(NUM_CELLS) + " cells");
+                    return;
+                }
+
+                // Rows of values, or one flat array
+                int cell = 0;
+                int *cells = &puzzle.grid[0][0];
+                auto readValue = [&]()
+                {
+                    int value = cursor.readInt();
+                    if (value < EMPTY_CELL || value > Geo::MAX_VALUE)
+                        cursor.fail("grid value out of range");
+                    if (cell >= NUM_CELLS)
+                        cursor.fail("too many grid cells");
+                    cells[cell++] = value;
+                };
+                cursor.readArray([&]()
+                                 {
+                                     if (cursor.peek() == '[')
+                                         cursor.readArray(readValue);
+                                     else
+                                         readValue(); });
+                if (cell != NUM_CELLS)
+                    cursor.fail("grid must have " + std::to_string(NUM_CELLS) + " cells");
+            }
+            else if (key == "cages")
+            {
+                cursor.readArray([&]()
+                                 {
+                    Cage cage;
+                    bool haveSum = false;
+                    cursor.readObject([&](std::string_view field)
+                                      {
+                        if (field == "cells")
+                            cursor.readArray([&]() { cage.cells.push_back(readCell<Geo>(cursor)); });
+                        else if (field == "sum")
+                        {
+                            cage.targetSum = cursor.readInt();
+                            haveSum = true;
+                        }
+                        else
+                            cursor.skipValue(); });
+                    if (!haveSum || cage.cells.empty())
+                        cursor.fail("a cage needs \"cells\" and \"sum\"");
+                    puzzle.addCage(cage); });
+            }
+            else if (key == "inequalities")
+            {
+                cursor.readArray([&]()
+                                 {
+                    InequalityConstraint ineq;
+                    int fields = 0;
+                    cursor.readObject([&](std::string_view field)
+                                      {
+                        if (field == "cell1")
+                        {
+                            ineq.cell1 = readCell<Geo>(cursor);
+                            fields |= 1;
+                        }
+                        else if (field == "cell2")
+                        {
+                            ineq.cell2 = readCell<Geo>(cursor);
+                            fields |= 2;
+                        }
+                        else if (field == "type")
+                        {
+                            std::string_view op = cursor.readString();
+                            if (op == ">")
+                                ineq.type = InequalityType::GREATER_THAN;
+                            else if (op == "<")
+                                ineq.type = InequalityType::LESS_THAN;
+                            else
+                                cursor.fail("inequality type must be \">\" or \"<\"");
+                            fields |= 4;
+                        }
+                        else
+                            cursor.skipValue(); });
+                    if (fields != 7)
+                        cursor.fail("an inequality needs \"cell1\", \"cell2\" and \"type\"");
+                    puzzle.addInequality(ineq); });
+            }
+            else if (key == "type")
+            {
+                declaredName = cursor.readString();
+                if (declaredName == "standard")
+                    declaredType = SudokuType::STANDARD;
+                else if (declaredName == "killer")
+                    declaredType = SudokuType::KILLER;
+                else if (declaredName == "inequality")
+                    declaredType = SudokuType::INEQUALITY;
+                else if (declaredName == "mixed")
+                    declaredType = SudokuType::KILLER_INEQUALITY;
+                else
+                    cursor.fail("unknown puzzle type");
+            }
+            else if (key == "id" && id)
+            {
+                *id = std::string(cursor.skipValue());
+            }
+            else
+            {
+                cursor.skipValue();
+            } });
+
+        if (!cursor.atEnd())
+        {
+            cursor.fail("trailing characters after the puzzle object");
+        }
+
+        // As in the text format, the type follows from the constraints present;
+        // a declared type must agree with it
+        if (!declaredName.empty() && declaredType != puzzle.type)
+        {
+            cursor.fail("declared type \"" + std::string(declaredName) + "\" does not match the constraints");
+        }
+        return puzzle;
+    }
+
+    template <class Geo>
+    std::string BasicSudokuJson<Geo>::writePuzzle(const Puzzle &puzzle)
+    {
+        std::string out;
+        out.reserve(NUM_CELLS * 2 + 32 + puzzle.cages.size() * 40 + puzzle.inequalities.size() * 40);
+        BasicSudokuWriter<Geo>::appendPuzzleJson(out, puzzle);
+        return out;
+    }
+
+    template <class Geo>
+    void BasicSudokuJson<Geo>::writeSolution(const Solution &solution, std::string &out, std::string_view id)
+    {
+        BasicSudokuWriter<Geo>::appendSolutionJson(out, solution, id);
+    }
+
+    template <class Geo>
+    void BasicSudokuJson<Geo>::appendString(std::string &out, std::string_view text)
+    {
+        BasicSudokuWriter<Geo>::appendJsonString(out, text);
+    }
+
+#define SUDOKU_INSTANTIATE_JSON(R, C) template class BasicSudokuJson<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_JSON)
+#undef SUDOKU_INSTANTIATE_JSON
+
+} // namespace sudoku
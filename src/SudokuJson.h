@@ -0,0 +1,123 @@
+/**
+ * @file SudokuJson.h
+ * @brief JSON reader and writer for puzzles and solutions
+ *
+ * Puzzle schema (see SudokuParser.h):
+ *
+ *   {
+ *     "id": "optional, echoed back in results",
+ *     "type": "standard" | "killer" | "inequality" | "mixed",
+ *     "grid": [[0,0,...], ...] | [0,0,...] | "530070000...",
+ *     "cages": [{"cells": [[0,0],[0,1]], "sum": 10}, ...],
+ *     "inequalities": [{"cell1": [0,0], "cell2": [0,1], "type": ">"}, ...]
+ *   }
+ *
+ * Solution schema (the same fields the WASM module returns):
+ *
+ *   {"id": ..., "solved": true, "uniqueness": "unique", "solveTimeMs": 1.25,
+ *    "grid": [[5,3,4,...], ...]}
+ *   {"id": ..., "solved": false, "error": "..."}
+ *
+ * The reader is a single forward pass over the text with no intermediate
+ * document tree; unknown keys are skipped and nesting deeper than 64 levels
+ * is rejected. "type" is optional because the constraints present determine
+ * it, but when given it must agree with them. Writers emit one line, so
+ * their output can be used directly as JSON Lines.
+ */
+
+#ifndef SUDOKU_JSON_H
+#define SUDOKU_JSON_H
+
+#include "SudokuTypes.h"
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace sudoku
+{
+
+    /**
+     * @brief JSON conversion for one geometry
+     *
+     * Instantiated for every geometry in SUDOKU_FOR_EACH_GEOMETRY.
+     */
+    template <class Geo>
+    class BasicSudokuJson
+    {
+    public:
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Solution = BasicSudokuSolution<Geo>;
+
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int NUM_CELLS = Geo::NUM_CELLS;
+
+        /**
+         * @brief Check whether text looks like a JSON object
+         */
+        static bool isJson(std::string_view text);
+
+        /**
+         * @brief Parse a puzzle object
+         * @param text The JSON text
+         * @param id If not null, receives the raw JSON text of the "id" value (empty if absent)
+         * @return The parsed puzzle
+         * @throws std::runtime_error with the byte offset of the first error
+         */
+        static Puzzle parsePuzzle(std::string_view text, std::string *id = nullptr);
+
+        /**
+         * @brief Write a puzzle as a single-line JSON object
+         */
+        static std::string writePuzzle(const Puzzle &puzzle);
+
+        /**
+         * @brief Append a solution as a single-line JSON object
+         * @param solution The solution to write
+         * @param out String to append to
+         * @param id Raw JSON value to write as "id" (omitted if empty)
+         */
+        static void writeSolution(const Solution &solution, std::string &out, std::string_view id = {});
+
+        /**
+         * @brief Append a JSON string literal with escaping
+         */
+        static void appendString(std::string &out, std::string_view text);
+    };
+
+    // Classic 9x9 JSON conversion
+    using SudokuJson = BasicSudokuJson<StandardGeometry>;
+
+    /**
+     * @brief Helpers for reading other JSON messages (e.g. --serve requests)
+     *
+     * Values are handed out as raw JSON text, so a member holding a puzzle
+     * can be passed straight to BasicSudokuJson::parsePuzzle. All functions
+     * throw std::runtime_error on malformed input.
+     */
+    namespace json
+    {
+        /**
+         * @brief Call fn(key, rawValue) for every member of a JSON object
+         */
+        void forEachMember(std::string_view object,
+                           const std::function<void(std::string_view key, std::string_view value)> &fn);
+
+        /**
+         * @brief Decode a JSON string literal, quotes included, resolving escapes
+         */
+        std::string decodeString(std::string_view literal);
+
+        /**
+         * @brief Parse a JSON integer
+         */
+        long long parseInt(std::string_view literal);
+
+        /**
+         * @brief Parse true or false
+         */
+        bool parseBool(std::string_view literal);
+    } // namespace json
+
+} // namespace sudoku
+
+#endif // SUDOKU_JSON_H
@@ -0,0 +1,313 @@
+/**
+ * @file SudokuLatency.cpp
+ * @brief Implementation of the latency histograms and report
+ */
+
+#include "SudokuLatency.h"
+#include "SudokuWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        // Values below kSubBuckets us are exact; above, each power of two has kHalf buckets
+        const int kSubBucketBits = 8;
+        const uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+        const uint64_t kHalf = kSubBuckets / 2;
+
+        const double kPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+        const char *const kPercentileNames[] = {"p50", "p90", "p99", "p99.9"};
+
+        const LatencyPhase kPhases[] = {LatencyPhase::ENCODE, LatencyPhase::SOLVE, LatencyPhase::UNIQUENESS,
+                                        LatencyPhase::VERIFY, LatencyPhase::TOTAL};
+        const SudokuType kTypes[] = {SudokuType::STANDARD, SudokuType::KILLER, SudokuType::INEQUALITY,
+                                     SudokuType::KILLER_INEQUALITY};
+
+        bool slowerFirst(const LatencyReport::SlowPuzzle &a, const LatencyReport::SlowPuzzle &b)
+        {
+            return a.totalMs > b.totalMs;
+        }
+    } // namespace
+
+    size_t LatencyHistogram::bucketOf(uint64_t micros)
+    {
+        if (micros < kSubBuckets)
+        {
+            return static_cast<size_t>(micros);
+        }
+        int shift = 1;
+        while ((micros >> shift) >= kSubBuckets)
+        {
+            shift++;
+        }
+        return static_cast<size_t>(kSubBuckets + (shift - 1) * kHalf + ((micros >> shift) - kHalf));
+    }
+
+    uint64_t LatencyHistogram::bucketTop(size_t bucket)
+    {
+        if (bucket < kSubBuckets)
+        {
+            return bucket;
+        }
+        uint64_t offset = bucket - kSubBuckets;
+        int shift = static_cast<int>(offset / kHalf) + 1;
+        uint64_t sub = offset % kHalf + kHalf;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(double ms)
+    {
+        ms = std::max(0.0, ms);
+        size_t bucket = bucketOf(static_cast<uint64_t>(std::llround(ms * 1000.0)));
+        if (bucket >= counts.size())
+        {
+            counts.resize(bucket + 1, 0);
+        }
+        counts[bucket]++;
+        count++;
+        sumMs += ms;
+        maxMs = std::max(maxMs, ms);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram &other)
+    {
+        if (other.counts.size() > counts.size())
+        {
+            counts.resize(other.counts.size(), 0);
+        }
+        for (size_t i = 0; i < other.counts.size(); i++)
+        {
+            counts[i] += other.counts[i];
+        }
+        count += other.count;
+        sumMs += other.sumMs;
+        maxMs = std::max(maxMs, other.maxMs);
+    }
+
+    double LatencyHistogram::percentile(double percent) const
+    {
+        if (count == 0)
+        {
+            return 0.0;
+        }
+        double rank = std::ceil(std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(count));
+        uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(rank));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++)
+        {
+            seen += counts[i];
+            if (seen >= target)
+            {
+                return std::min(maxMs, static_cast<double>(bucketTop(i)) / 1000.0);
+            }
+        }
+        return maxMs;
+    }
+
+    LatencyReport::LatencyReport(size_t slowestKept)
+        : slowestKept(slowestKept)
+    {
+    }
+
+    void LatencyReport::record(SudokuType type, std::string_view id, const PuzzleTiming &timing)
+    {
+        LatencyHistogram *phases = histograms[static_cast<int>(type)];
+        const double values[] = {timing.encodeMs, timing.solveMs, timing.uniqueMs, timing.verifyMs, timing.totalMs};
+        for (int phase = 0; phase < NUM_PHASES; phase++)
+        {
+            if (values[phase] >= 0.0)
+            {
+                phases[phase].record(values[phase]);
+            }
+        }
+
+        if (slowestKept == 0)
+        {
+            return;
+        }
+        if (slowest.size() == slowestKept)
+        {
+            if (timing.totalMs <= slowest.front().totalMs)
+            {
+                return;
+            }
+            std::pop_heap(slowest.begin(), slowest.end(), slowerFirst);
+            slowest.pop_back();
+        }
+        slowest.push_back({timing.totalMs, type, std::string(id)});
+        std::push_heap(slowest.begin(), slowest.end(), slowerFirst);
+    }
+
+    const LatencyHistogram &LatencyReport::get(SudokuType type, LatencyPhase phase) const
+    {
+        return histograms[static_cast<int>(type)][static_cast<int>(phase)];
+    }
+
+    std::vector<LatencyReport::SlowPuzzle> LatencyReport::getSlowest() const
+    {
+        std::vector<SlowPuzzle> sorted = slowest;
+        std::sort(sorted.begin(), sorted.end(), slowerFirst);
+        return sorted;
+    }
+
+    std::string LatencyReport::formatText() const
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "  Latency (ms)     " << std::setw(9) << "count";
+        for (const char *name : kPercentileNames)
+        {
+            out << std::setw(10) << name;
+        }
+        out << std::setw(10) << "max" << "\n";
+
+        for (SudokuType type : kTypes)
+        {
+            if (get(type, LatencyPhase::TOTAL).getCount() == 0)
+            {
+                continue;
+            }
+            out << "    " << typeName(type) << "\n";
+            for (LatencyPhase phase : kPhases)
+            {
+                const LatencyHistogram &histogram = get(type, phase);
+                if (histogram.getCount() == 0)
+                {
+                    continue;
+                }
+                out << "      " << std::left << std::setw(11) << phaseName(phase) << std::right
+                    << std::setw(9) << histogram.getCount();
+                for (double percent : kPercentiles)
+                {
+                    out << std::setw(10) << histogram.percentile(percent);
+                }
+                out << std::setw(10) << histogram.getMax() << "\n";
+            }
+        }
+
+        std::vector<SlowPuzzle> sorted = getSlowest();
+        if (!sorted.empty())
+        {
+            out << "  Slowest:";
+            for (size_t i = 0; i < sorted.size(); i++)
+            {
+                out << (i ? ", " : " ") << sorted[i].id << " (" << sorted[i].totalMs << " ms)";
+            }
+            out << "\n";
+        }
+        return out.str();
+    }
+
+    std::string LatencyReport::toJson(double wallSeconds) const
+    {
+        uint64_t puzzles = 0;
+        for (SudokuType type : kTypes)
+        {
+            puzzles += get(type, LatencyPhase::TOTAL).getCount();
+        }
+
+        std::string out = "{\"puzzles\":";
+        SudokuWriter::appendInt(out, static_cast<long long>(puzzles));
+        out += ",\"wallSeconds\":";
+        SudokuWriter::appendFixed(out, wallSeconds, 3);
+        out += ",\"throughput\":";
+        SudokuWriter::appendFixed(out, wallSeconds > 0.0 ? static_cast<double>(puzzles) / wallSeconds : 0.0, 1);
+        out += ",\"types\":{";
+
+        bool firstType = true;
+        for (SudokuType type : kTypes)
+        {
+            if (get(type, LatencyPhase::TOTAL).getCount() == 0)
+            {
+                continue;
+            }
+            out += firstType ? "\"" : ",\"";
+            firstType = false;
+            out += typeName(type);
+            out += "\":{";
+
+            bool firstPhase = true;
+            for (LatencyPhase phase : kPhases)
+            {
+                const LatencyHistogram &histogram = get(type, phase);
+                if (histogram.getCount() == 0)
+                {
+                    continue;
+                }
+                out += firstPhase ? "\"" : ",\"";
+                firstPhase = false;
+                out += phaseName(phase);
+                out += "\":{\"count\":";
+                SudokuWriter::appendInt(out, static_cast<long long>(histogram.getCount()));
+                out += ",\"mean\":";
+                SudokuWriter::appendFixed(out, histogram.getMean(), 3);
+                for (size_t i = 0; i < std::size(kPercentiles); i++)
+                {
+                    out += ",\"";
+                    out += kPercentileNames[i];
+                    out += "\":";
+                    SudokuWriter::appendFixed(out, histogram.percentile(kPercentiles[i]), 3);
+                }
+                out += ",\"max\":";
+                SudokuWriter::appendFixed(out, histogram.getMax(), 3);
+                out += '}';
+            }
+            out += '}';
+        }
+
+        out += "},\"slowest\":[";
+        std::vector<SlowPuzzle> sorted = getSlowest();
+        for (size_t i = 0; i < sorted.size(); i++)
+        {
+            out += i ? ",{\"id\":" : "{\"id\":";
+            SudokuWriter::appendJsonString(out, sorted[i].id);
+            out += ",\"type\":\"";
+            out += typeName(sorted[i].type);
+            out += "\",\"totalMs\":";
+            SudokuWriter::appendFixed(out, sorted[i].totalMs, 3);
+            out += '}';
+        }
+        out += "]}";
+        return out;
+    }
+
+    const char *LatencyReport::typeName(SudokuType type)
+    {
+        switch (type)
+        {
+        case SudokuType::KILLER:
+            return "killer";
+        case SudokuType::INEQUALITY:
+            return "inequality";
+        case SudokuType::KILLER_INEQUALITY:
+            return "mixed";
+        default:
+            return "standard";
+        }
+    }
+
+    const char *LatencyReport::phaseName(LatencyPhase phase)
+    {
+        switch (phase)
+        {
+        case LatencyPhase::ENCODE:
+            return "encode";
+        case LatencyPhase::SOLVE:
+            return "solve";
+        case LatencyPhase::UNIQUENESS:
+            return "uniqueness";
+        case LatencyPhase::VERIFY:
+            return "verify";
+        default:
+            return "total";
+        }
+    }
+
+} // namespace sudoku
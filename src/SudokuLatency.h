@@ -0,0 +1,149 @@
+/**
+ * @file SudokuLatency.h
+ * @brief Per-puzzle latency histograms and the batch latency report
+ *
+ * - LatencyHistogram: an HDR-style log-linear histogram of durations.
+ *   Every power of two is split into 128 linear sub-buckets, so any
+ *   recorded value, and any percentile read back, is within 1% of the
+ *   true value from 1 us up to hours, in a few KB of counters.
+ *
+ * - LatencyReport: one histogram per puzzle type and phase (encode, solve,
+ *   uniqueness, verify, total) plus the slowest puzzles, rendered as a
+ *   text table or as a JSON document for comparing runs across releases.
+ *
+ * Neither class locks; record from one thread (the batch writer stage).
+ */
+
+#ifndef SUDOKU_LATENCY_H
+#define SUDOKU_LATENCY_H
+
+#include "SudokuTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Log-linear histogram of durations with 1% precision
+     */
+    class LatencyHistogram
+    {
+    public:
+        /**
+         * @brief Add one duration
+         */
+        void record(double ms);
+
+        /**
+         * @brief Add every sample of another histogram
+         */
+        void merge(const LatencyHistogram &other);
+
+        /**
+         * @brief Smallest recorded value that at least percent% of samples do not exceed
+         * @param percent 0 to 100
+         * @return Milliseconds, 0 if empty
+         */
+        double percentile(double percent) const;
+
+        uint64_t getCount() const { return count; }
+        double getMax() const { return maxMs; }
+        double getMean() const { return count ? sumMs / static_cast<double>(count) : 0.0; }
+
+    private:
+        std::vector<uint64_t> counts; // Grown to the largest bucket seen
+        uint64_t count = 0;
+        double sumMs = 0.0;
+        double maxMs = 0.0;
+
+        static size_t bucketOf(uint64_t micros);
+        static uint64_t bucketTop(size_t bucket); // Largest value in microseconds
+    };
+
+    /**
+     * @brief Stages timed for each puzzle
+     */
+    enum class LatencyPhase
+    {
+        ENCODE,     // Building the clauses
+        SOLVE,      // Finding the first solution
+        UNIQUENESS, // Searching for a second solution
+        VERIFY,     // Checking the solution against the puzzle
+        TOTAL       // Everything above (cache hits: the lookup)
+    };
+
+    /**
+     * @brief Durations of one puzzle; negative means the phase did not run
+     */
+    struct PuzzleTiming
+    {
+        double encodeMs = -1.0;
+        double solveMs = -1.0;
+        double uniqueMs = -1.0;
+        double verifyMs = -1.0;
+        double totalMs = 0.0;
+    };
+
+    /**
+     * @brief Latency of a batch run by puzzle type and phase
+     */
+    class LatencyReport
+    {
+    public:
+        static constexpr int NUM_TYPES = 4;
+        static constexpr int NUM_PHASES = 5;
+
+        /**
+         * @param slowestKept How many of the slowest puzzles to name
+         */
+        explicit LatencyReport(size_t slowestKept = 10);
+
+        /**
+         * @brief Add one puzzle's timings
+         * @param id Puzzle id or index, kept only if it is among the slowest
+         */
+        void record(SudokuType type, std::string_view id, const PuzzleTiming &timing);
+
+        const LatencyHistogram &get(SudokuType type, LatencyPhase phase) const;
+
+        /**
+         * @brief Slowest puzzles by total time, slowest first
+         */
+        struct SlowPuzzle
+        {
+            double totalMs;
+            SudokuType type;
+            std::string id;
+        };
+        std::vector<SlowPuzzle> getSlowest() const;
+
+        /**
+         * @brief Table of p50/p90/p99/p99.9/max per type and phase, then the slowest puzzles
+         */
+        std::string formatText() const;
+
+        /**
+         * @brief The same figures as one JSON object
+         * @param wallSeconds Duration of the whole run, for throughput
+         */
+        std::string toJson(double wallSeconds) const;
+
+        /**
+         * @brief Short type name used in reports: standard, killer, inequality, mixed
+         */
+        static const char *typeName(SudokuType type);
+        static const char *phaseName(LatencyPhase phase);
+
+    private:
+        LatencyHistogram histograms[NUM_TYPES][NUM_PHASES];
+        size_t slowestKept;
+        std::vector<SlowPuzzle> slowest; // Min-heap on totalMs
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_LATENCY_H
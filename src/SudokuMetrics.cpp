@@ -0,0 +1,292 @@
+/**
+ * @file SudokuMetrics.cpp
+ * @brief Implementation of the metrics registry
+ */
+
+#include "SudokuMetrics.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        // 100 us to 10 s
+        const std::vector<double> kSecondsBuckets = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+                                                     0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+        const std::vector<double> kConflictBuckets = {0, 1, 10, 100, 1000, 10000, 100000, 1000000};
+
+        const char *typeLabel(SudokuType type)
+        {
+            switch (type)
+            {
+            case SudokuType::KILLER:
+                return "type=\"killer\"";
+            case SudokuType::INEQUALITY:
+                return "type=\"inequality\"";
+            case SudokuType::KILLER_INEQUALITY:
+                return "type=\"mixed\"";
+            default:
+                return "type=\"standard\"";
+            }
+        }
+
+        // Shortest representation that reads back exactly
+        void appendNumber(std::string &out, double value)
+        {
+            if (std::isnan(value))
+            {
+                out += "NaN";
+                return;
+            }
+            if (std::isinf(value))
+            {
+                out += value > 0 ? "+Inf" : "-Inf";
+                return;
+            }
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr);
+        }
+
+        void appendSample(std::string &out, const std::string &name, std::string_view suffix,
+                          std::string_view labels, std::string_view extraLabel, double value)
+        {
+            out += name;
+            out += suffix;
+            if (!labels.empty() || !extraLabel.empty())
+            {
+                out += '{';
+                out += labels;
+                if (!labels.empty() && !extraLabel.empty())
+                    out += ',';
+                out += extraLabel;
+                out += '}';
+            }
+            out += ' ';
+            appendNumber(out, value);
+            out += '\n';
+        }
+
+        double residentBytes()
+        {
+            std::ifstream statm("/proc/self/statm");
+            long pages = 0;
+            long resident = 0;
+            if (!(statm >> pages >> resident))
+                return 0.0;
+            return static_cast<double>(resident) * static_cast<double>(::sysconf(_SC_PAGESIZE));
+        }
+    } // namespace
+
+    MetricsRegistry::Family &MetricsRegistry::family(const std::string &name)
+    {
+        auto it = families.find(name);
+        if (it == families.end())
+        {
+            throw std::runtime_error("undeclared metric: " + name);
+        }
+        return it->second;
+    }
+
+    void MetricsRegistry::describe(const std::string &name, const std::string &help, MetricType type,
+                                   std::vector<double> buckets)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (families.count(name))
+        {
+            return;
+        }
+        Family &added = families[name];
+        added.help = help;
+        added.type = type;
+        added.buckets = std::move(buckets);
+        order.push_back(name);
+    }
+
+    void MetricsRegistry::increment(const std::string &name, std::string_view labels, double amount)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Family &target = family(name);
+        auto it = target.series.find(labels);
+        if (it == target.series.end())
+            it = target.series.emplace(std::string(labels), Series()).first;
+        it->second.value += amount;
+    }
+
+    void MetricsRegistry::set(const std::string &name, std::string_view labels, double value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Family &target = family(name);
+        auto it = target.series.find(labels);
+        if (it == target.series.end())
+            it = target.series.emplace(std::string(labels), Series()).first;
+        it->second.value = value;
+    }
+
+    void MetricsRegistry::observe(const std::string &name, std::string_view labels, double value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Family &target = family(name);
+        auto it = target.series.find(labels);
+        if (it == target.series.end())
+        {
+            it = target.series.emplace(std::string(labels), Series()).first;
+            it->second.counts.assign(target.buckets.size(), 0);
+        }
+
+        Series &series = it->second;
+        auto bucket = std::lower_bound(target.buckets.begin(), target.buckets.end(), value);
+        if (bucket != target.buckets.end())
+        {
+            series.counts[bucket - target.buckets.begin()]++;
+        }
+        series.count++;
+        series.sum += value;
+    }
+
+    void MetricsRegistry::watch(const std::string &name, std::string_view labels, std::function<double()> read)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        family(name).callbacks[std::string(labels)] = std::move(read);
+    }
+
+    std::string MetricsRegistry::renderPrometheus() const
+    {
+        // Read callbacks first, outside the lock: they may take other locks
+        std::vector<std::pair<std::string, std::function<double()>>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &[name, fam] : families)
+            {
+                for (const auto &[labels, read] : fam.callbacks)
+                {
+                    pending.emplace_back(name + '\0' + labels, read);
+                }
+            }
+        }
+        std::map<std::string, double, std::less<>> watched;
+        for (auto &[key, read] : pending)
+        {
+            watched[key] = read();
+        }
+
+        std::string out;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::string &name : order)
+        {
+            const Family &fam = families.find(name)->second;
+            out += "# HELP " + name + ' ' + fam.help + '\n';
+            out += "# TYPE " + name + ' ';
+            out += fam.type == MetricType::COUNTER ? "counter\n" : fam.type == MetricType::GAUGE ? "gauge\n" : "histogram\n";
+
+            for (const auto &[labels, series] : fam.series)
+            {
+                if (fam.type != MetricType::HISTOGRAM)
+                {
+                    appendSample(out, name, {}, labels, {}, series.value);
+                    continue;
+                }
+
+                uint64_t cumulative = 0;
+                std::string le;
+                for (size_t i = 0; i < fam.buckets.size(); i++)
+                {
+                    cumulative += series.counts[i];
+                    le = "le=\"";
+                    appendNumber(le, fam.buckets[i]);
+                    le += '"';
+                    appendSample(out, name, "_bucket", labels, le, static_cast<double>(cumulative));
+                }
+                appendSample(out, name, "_bucket", labels, "le=\"+Inf\"", static_cast<double>(series.count));
+                appendSample(out, name, "_sum", labels, {}, series.sum);
+                appendSample(out, name, "_count", labels, {}, static_cast<double>(series.count));
+            }
+
+            for (const auto &[labels, read] : fam.callbacks)
+            {
+                appendSample(out, name, {}, labels, {}, watched[name + '\0' + labels]);
+            }
+        }
+        return out;
+    }
+
+    ServiceMetrics::ServiceMetrics()
+    {
+        registry.describe("sudoku_requests_total", "Requests answered, by op and outcome", MetricType::COUNTER);
+        registry.describe("sudoku_solve_seconds", "Solve latency including any uniqueness check",
+                          MetricType::HISTOGRAM, kSecondsBuckets);
+        registry.describe("sudoku_uniqueness_check_seconds", "Time spent searching for a second solution",
+                          MetricType::HISTOGRAM, kSecondsBuckets);
+        registry.describe("sudoku_solve_conflicts", "SAT conflicts per solve", MetricType::HISTOGRAM,
+                          kConflictBuckets);
+        registry.describe("sudoku_generate_seconds", "Generation latency", MetricType::HISTOGRAM, kSecondsBuckets);
+        registry.describe("sudoku_generate_phase_seconds", "Generation time by phase", MetricType::HISTOGRAM,
+                          kSecondsBuckets);
+        registry.describe("sudoku_queue_depth", "Requests waiting for a worker", MetricType::GAUGE);
+        registry.describe("sudoku_cache_hits_total", "Solution cache hits", MetricType::COUNTER);
+        registry.describe("sudoku_cache_misses_total", "Solution cache misses", MetricType::COUNTER);
+        registry.describe("sudoku_cache_entries", "Solutions held in the cache", MetricType::GAUGE);
+        registry.describe("process_resident_memory_bytes", "Resident memory size in bytes", MetricType::GAUGE);
+        registry.watch("process_resident_memory_bytes", {}, residentBytes);
+    }
+
+    void ServiceMetrics::recordRequest(std::string_view op, std::string_view outcome)
+    {
+        std::string labels = "op=\"";
+        labels += op;
+        labels += "\",outcome=\"";
+        labels += outcome;
+        labels += '"';
+        registry.increment("sudoku_requests_total", labels);
+    }
+
+    void ServiceMetrics::recordSolve(SudokuType type, const SolveStats &stats, double totalMs)
+    {
+        std::string labels = stats.cached ? "engine=\"cache\"," : "engine=\"sat\",";
+        labels += typeLabel(type);
+        registry.observe("sudoku_solve_seconds", labels, totalMs / 1000.0);
+        if (stats.cached)
+        {
+            return;
+        }
+        if (stats.uniqueMs > 0.0)
+        {
+            registry.observe("sudoku_uniqueness_check_seconds", typeLabel(type), stats.uniqueMs / 1000.0);
+        }
+        registry.observe("sudoku_solve_conflicts", typeLabel(type), static_cast<double>(stats.conflicts));
+    }
+
+    void ServiceMetrics::recordGeneration(SudokuType type, const GenerationStats &stats, double totalMs)
+    {
+        registry.observe("sudoku_generate_seconds", typeLabel(type), totalMs / 1000.0);
+        registry.observe("sudoku_generate_phase_seconds", "phase=\"fill\"", stats.fillMs / 1000.0);
+        registry.observe("sudoku_generate_phase_seconds", "phase=\"constraints\"", stats.constraintsMs / 1000.0);
+        if (stats.uniquenessSolves > 0)
+        {
+            registry.observe("sudoku_generate_phase_seconds", "phase=\"uniqueness\"", stats.uniquenessMs / 1000.0);
+            registry.observe("sudoku_generate_phase_seconds", "phase=\"minimize\"", stats.minimizeMs / 1000.0);
+        }
+    }
+
+    void ServiceMetrics::watchQueue(const std::string &name, std::function<double()> depth)
+    {
+        registry.watch("sudoku_queue_depth", "queue=\"" + name + "\"", std::move(depth));
+    }
+
+    void ServiceMetrics::watchCache(std::shared_ptr<SolutionCache> cache)
+    {
+        registry.watch("sudoku_cache_hits_total", {}, [cache]()
+                       { return static_cast<double>(cache->getStats().hits); });
+        registry.watch("sudoku_cache_misses_total", {}, [cache]()
+                       { return static_cast<double>(cache->getStats().misses); });
+        registry.watch("sudoku_cache_entries", {}, [cache]()
+                       { return static_cast<double>(cache->getStats().size); });
+    }
+
+} // namespace sudoku
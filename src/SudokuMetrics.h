@@ -0,0 +1,142 @@
+/**
+ * @file SudokuMetrics.h
+ * @brief Live counters and histograms in Prometheus text format
+ *
+ * - MetricsRegistry: generic counters, gauges and histograms keyed by name
+ *   and label set, plus gauges read through a callback at export time.
+ * - ServiceMetrics: the metrics of the --serve and --daemon front ends,
+ *   recorded from SolveStats and GenerationStats.
+ *
+ * Exported families (seconds, Prometheus conventions):
+ *
+ *   sudoku_requests_total{op,outcome}
+ *   sudoku_solve_seconds{engine,type}            engine is "sat" or "cache"
+ *   sudoku_uniqueness_check_seconds{type}
+ *   sudoku_solve_conflicts{type}
+ *   sudoku_generate_seconds{type}
+ *   sudoku_generate_phase_seconds{phase}         fill, constraints, uniqueness, minimize
+ *   sudoku_queue_depth{queue}
+ *   sudoku_cache_hits_total, sudoku_cache_misses_total, sudoku_cache_entries
+ *   process_resident_memory_bytes
+ */
+
+#ifndef SUDOKU_METRICS_H
+#define SUDOKU_METRICS_H
+
+#include "SudokuCache.h"
+#include "SudokuEncoder.h"
+#include "SudokuGenerator.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sudoku
+{
+
+    enum class MetricType
+    {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+    /**
+     * @brief Thread-safe store of metric families
+     *
+     * Labels are passed preformatted, e.g. type="killer",engine="sat".
+     */
+    class MetricsRegistry
+    {
+    public:
+        /**
+         * @brief Declare a family; must precede its first use
+         * @param buckets Upper bounds for a histogram, ascending
+         */
+        void describe(const std::string &name, const std::string &help, MetricType type,
+                      std::vector<double> buckets = {});
+
+        /**
+         * @brief Add to a counter, or set a gauge
+         */
+        void increment(const std::string &name, std::string_view labels = {}, double amount = 1.0);
+        void set(const std::string &name, std::string_view labels, double value);
+
+        /**
+         * @brief Record one histogram sample
+         */
+        void observe(const std::string &name, std::string_view labels, double value);
+
+        /**
+         * @brief Read a series from a callback at export time
+         *
+         * The callback runs without the registry lock held.
+         */
+        void watch(const std::string &name, std::string_view labels, std::function<double()> read);
+
+        /**
+         * @brief Render every family in the Prometheus text exposition format
+         */
+        std::string renderPrometheus() const;
+
+    private:
+        struct Series
+        {
+            double value = 0.0;          // Counter or gauge
+            std::vector<uint64_t> counts; // Histogram, per bucket (not cumulative)
+            uint64_t count = 0;
+            double sum = 0.0;
+        };
+
+        struct Family
+        {
+            std::string help;
+            MetricType type = MetricType::COUNTER;
+            std::vector<double> buckets;
+            std::map<std::string, Series, std::less<>> series;                     // By labels
+            std::map<std::string, std::function<double()>, std::less<>> callbacks; // By labels
+        };
+
+        mutable std::mutex mutex;
+        std::vector<std::string> order; // Families in declaration order
+        std::map<std::string, Family, std::less<>> families;
+
+        Family &family(const std::string &name);
+    };
+
+    /**
+     * @brief Metrics of the request-serving front ends
+     */
+    class ServiceMetrics
+    {
+    public:
+        ServiceMetrics();
+
+        void recordRequest(std::string_view op, std::string_view outcome);
+        void recordSolve(SudokuType type, const SolveStats &stats, double totalMs);
+        void recordGeneration(SudokuType type, const GenerationStats &stats, double totalMs);
+
+        /**
+         * @brief Export a queue's depth as sudoku_queue_depth{queue="name"}
+         */
+        void watchQueue(const std::string &name, std::function<double()> depth);
+
+        /**
+         * @brief Export hit, miss and size counts of a solution cache
+         */
+        void watchCache(std::shared_ptr<SolutionCache> cache);
+
+        MetricsRegistry &getRegistry() { return registry; }
+
+        std::string renderPrometheus() const { return registry.renderPrometheus(); }
+
+    private:
+        MetricsRegistry registry;
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_METRICS_H
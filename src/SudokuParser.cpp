@@ -4,380 +4,640 @@
  */
 
 #include "SudokuParser.h"
-#include <sstream>
+#include "SudokuBinary.h"
+#include "SudokuCorpus.h"
+#include "SudokuGridScan.h"
+#include "SudokuJson.h"
+#include "SudokuWriter.h"
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <stdexcept>
 
 namespace sudoku
 {
 
-    std::string SudokuParser::trim(const std::string &str)
+    namespace
+    {
+        bool isBlank(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        /**
+         * @brief Next whitespace-separated token of a line
+         * @param line The line
+         * @param pos Scan position, advanced past the token
+         * @param token Receives the token
+         * @return false at the end of the line
+         */
+        bool nextToken(std::string_view line, size_t &pos, std::string_view &token)
+        {
+            while (pos < line.size() && isBlank(line[pos]))
+            {
+                pos++;
+            }
+            if (pos >= line.size())
+            {
+                return false;
+            }
+            size_t start = pos;
+            while (pos < line.size() && !isBlank(line[pos]))
+            {
+                pos++;
+            }
+            token = line.substr(start, pos - start);
+            return true;
+        }
+
+        bool isDigits(std::string_view token)
+        {
+            return std::all_of(token.begin(), token.end(), [](char c)
+                               { return c >= '0' && c <= '9'; });
+        }
+
+        bool toInt(std::string_view token, int &value)
+        {
+            const char *end = token.data() + token.size();
+            auto result = std::from_chars(token.data(), end, value);
+            return result.ec == std::errc() && result.ptr == end;
+        }
+
+        bool equalsIgnoreCase(std::string_view text, std::string_view upper)
+        {
+            if (text.size() != upper.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                if (std::toupper(static_cast<unsigned char>(text[i])) != upper[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    std::string ParseResult::toString() const
+    {
+        const char *message = "ok";
+        switch (status)
+        {
+        case ParseStatus::OK:
+            break;
+        case ParseStatus::INVALID_NUMBER:
+            message = "expected an integer";
+            break;
+        case ParseStatus::INVALID_CAGE:
+            message = "a cage is a sum followed by row/column pairs";
+            break;
+        case ParseStatus::INVALID_INEQUALITY:
+            message = "an inequality is \"r1 c1 > r2 c2\" or \"r1 c1 < r2 c2\"";
+            break;
+        case ParseStatus::CELL_OUT_OF_RANGE:
+            message = "cell out of range";
+            break;
+        }
+        return "line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message;
+    }
+
+    template <class Geo>
+    std::string_view BasicSudokuParser<Geo>::trim(std::string_view str)
     {
         size_t start = str.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos)
-            return "";
+        if (start == std::string_view::npos)
+            return {};
         size_t end = str.find_last_not_of(" \t\r\n");
         return str.substr(start, end - start + 1);
     }
 
-    std::vector<std::string> SudokuParser::splitLines(const std::string &input)
+    template <class Geo>
+    int BasicSudokuParser<Geo>::symbolValue(char c)
     {
-        std::vector<std::string> lines;
-        std::istringstream stream(input);
-        std::string line;
-        while (std::getline(stream, line))
+        if (c == '.' || c == '0' || c == '_' || c == '*')
+            return EMPTY_CELL;
+        int value = -1;
+        if (c >= '1' && c <= '9')
+            value = c - '0';
+        else if (MAX_VALUE > 9 && c >= 'A' && c <= 'Z')
+            value = 10 + (c - 'A');
+        else if (MAX_VALUE > 9 && c >= 'a' && c <= 'z')
+            value = 10 + (c - 'a');
+        return value <= MAX_VALUE ? value : -1;
+    }
+
+    template <class Geo>
+    char BasicSudokuParser<Geo>::valueSymbol(int value)
+    {
+        if (value < MIN_VALUE || value > MAX_VALUE)
+            return '.';
+        return value <= 9 ? static_cast<char>('0' + value) : static_cast<char>('A' + value - 10);
+    }
+
+    template <class Geo>
+    bool BasicSudokuParser<Geo>::isTokenizedLine(std::string_view line)
+    {
+        // Grids larger than 9x9 write multi-digit values separated by whitespace
+        return GRID_SIZE > 9 && line.find_first_of(" \t") != std::string_view::npos;
+    }
+
+    template <class Geo>
+    int BasicSudokuParser<Geo>::tokenValue(std::string_view token)
+    {
+        int value = -1;
+        if (!isDigits(token) || !toInt(token, value))
         {
-            line = trim(line);
-            if (!line.empty())
-            {
-                lines.push_back(line);
-            }
+            return symbolValue(token[0]);
         }
-        return lines;
+        return value;
     }
 
-    std::vector<std::string> SudokuParser::split(const std::string &str, char delimiter)
+    template <class Geo>
+    int BasicSudokuParser<Geo>::countCells(std::string_view line)
     {
-        std::vector<std::string> tokens;
-        std::istringstream stream(str);
-        std::string token;
-        while (std::getline(stream, token, delimiter))
+        int count = 0;
+        if (isTokenizedLine(line))
         {
-            token = trim(token);
-            if (!token.empty())
+            size_t pos = 0;
+            std::string_view token;
+            while (nextToken(line, pos, token))
             {
-                tokens.push_back(token);
+                if (isDigits(token) || symbolValue(token[0]) >= 0)
+                    count++;
             }
+            return count;
         }
-        return tokens;
+        for (char c : line)
+        {
+            if (symbolValue(c) >= 0)
+                count++;
+        }
+        return count;
     }
 
-    void SudokuParser::parseLine(const std::string &line, int row, SudokuPuzzle &puzzle)
+    template <class Geo>
+    void BasicSudokuParser<Geo>::parseLine(std::string_view line, int row, Puzzle &puzzle)
     {
         int col = 0;
+        if (isTokenizedLine(line))
+        {
+            size_t pos = 0;
+            std::string_view token;
+            while (col < GRID_SIZE && nextToken(line, pos, token))
+            {
+                int value = tokenValue(token);
+                if (value >= EMPTY_CELL && value <= MAX_VALUE)
+                {
+                    puzzle.grid[row][col++] = value;
+                }
+            }
+            return;
+        }
+
         for (char c : line)
         {
             if (col >= GRID_SIZE)
                 break;
-            if (c == '.' || c == '0' || c == '_' || c == '*')
+            int value = symbolValue(c);
+            if (value >= 0)
             {
-                puzzle.grid[row][col] = EMPTY_CELL;
+                puzzle.grid[row][col] = value;
                 col++;
             }
-            else if (c >= '1' && c <= '9')
+            // Skip spaces and other characters
+        }
+    }
+
+    template <class Geo>
+    bool BasicSudokuParser<Geo>::parseCompactGrid(std::string_view text, Puzzle &puzzle)
+    {
+        if (static_cast<int>(text.size()) != NUM_CELLS)
+        {
+            return false;
+        }
+
+        if constexpr (NUM_CELLS == gridscan::GRID_CHARS && MAX_VALUE == 9)
+        {
+            uint8_t cells[gridscan::GRID_CHARS];
+            if (!gridscan::scanGrid81(text.data(), cells))
             {
-                puzzle.grid[row][col] = c - '0';
-                col++;
+                return false;
             }
-            // Skip spaces and other characters
+            int *grid = &puzzle.grid[0][0];
+            for (int i = 0; i < NUM_CELLS; i++)
+            {
+                grid[i] = cells[i];
+            }
+            return true;
+        }
+        else
+        {
+            int *grid = &puzzle.grid[0][0];
+            for (int i = 0; i < NUM_CELLS; i++)
+            {
+                int value = symbolValue(text[i]);
+                if (value < 0)
+                {
+                    return false;
+                }
+                grid[i] = value;
+            }
+            return true;
         }
     }
 
-    SudokuPuzzle SudokuParser::parseSimpleGrid(const std::string &grid)
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuParser<Geo>::parseSimpleGrid(const std::string &grid)
     {
-        SudokuPuzzle puzzle;
+        Puzzle puzzle;
+        if (parseCompactGrid(grid, puzzle))
+        {
+            return puzzle;
+        }
+
+        // Scalar fallback for grids with separators or surrounding text
         std::string cleaned;
 
         // Extract only valid characters
         for (char c : grid)
         {
-            if (c == '.' || c == '0' || c == '_' || c == '*' ||
-                (c >= '1' && c <= '9'))
+            if (symbolValue(c) >= 0)
             {
                 cleaned += c;
             }
         }
 
-        // Should have exactly 81 characters
-        if (cleaned.length() < 81)
+        // Should have exactly NUM_CELLS characters
+        if (static_cast<int>(cleaned.length()) < NUM_CELLS)
         {
-            throw std::runtime_error("Grid must have at least 81 cells");
+            throw std::runtime_error("Grid must have at least " + std::to_string(NUM_CELLS) + " cells");
         }
 
-        for (int i = 0; i < 81; i++)
+        for (int i = 0; i < NUM_CELLS; i++)
         {
             int row = i / GRID_SIZE;
             int col = i % GRID_SIZE;
-            char c = cleaned[i];
-
-            if (c >= '1' && c <= '9')
-            {
-                puzzle.grid[row][col] = c - '0';
-            }
-            else
-            {
-                puzzle.grid[row][col] = EMPTY_CELL;
-            }
+            puzzle.grid[row][col] = symbolValue(cleaned[i]);
         }
 
         return puzzle;
     }
 
-    SudokuPuzzle SudokuParser::parseCustomFormat(const std::string &input)
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuParser<Geo>::parseCustomFormat(const std::string &input)
     {
-        SudokuPuzzle puzzle;
-        auto lines = splitLines(input);
+        Puzzle puzzle;
+        ParseResult result = parseCustomFormat(std::string_view(input), puzzle);
+        if (!result)
+        {
+            throw std::runtime_error("Parse error at " + result.toString());
+        }
+        return puzzle;
+    }
+
+    template <class Geo>
+    ParseResult BasicSudokuParser<Geo>::parseCustomFormat(std::string_view input, Puzzle &puzzle)
+    {
+        int *cells = &puzzle.grid[0][0];
+        std::fill(cells, cells + NUM_CELLS, EMPTY_CELL);
+        // Cage objects (and their cell vectors) are reused; the list is trimmed at the end
+        size_t numCages = 0;
+        puzzle.inequalities.clear();
 
         enum Section
         {
             NONE,
             GRID,
             CAGES,
-            INEQUALITIES
+            INEQUALITIES,
+            SOLUTION
         };
         Section currentSection = NONE;
         int gridRow = 0;
 
-        for (const auto &line : lines)
+        ParseResult result;
+        size_t lineStart = 0;
+        std::string_view line;
+        size_t pos = 0;
+        std::string_view token;
+
+        auto fail = [&](ParseStatus status, size_t offset)
+        {
+            result.status = status;
+            result.column = static_cast<int>(line.data() - input.data() - lineStart + offset) + 1;
+            return result;
+        };
+        // Read an integer token; returns false (and records the error) on failure
+        auto readInt = [&](int &value, ParseStatus missing)
+        {
+            if (!nextToken(line, pos, token))
+            {
+                fail(missing, pos);
+                return false;
+            }
+            if (!toInt(token, value))
+            {
+                fail(ParseStatus::INVALID_NUMBER, pos - token.size());
+                return false;
+            }
+            return true;
+        };
+        auto readCell = [&](Cell &cell, ParseStatus missing)
+        {
+            if (!readInt(cell.row, missing))
+                return false;
+            size_t rowOffset = pos - token.size();
+            if (!readInt(cell.col, missing))
+                return false;
+            if (!cell.isValid(GRID_SIZE))
+            {
+                fail(ParseStatus::CELL_OUT_OF_RANGE, rowOffset);
+                return false;
+            }
+            return true;
+        };
+
+        while (lineStart < input.size())
         {
-            std::string upper = line;
-            std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+            size_t lineEnd = input.find('\n', lineStart);
+            if (lineEnd == std::string_view::npos)
+            {
+                lineEnd = input.size();
+            }
+            result.line++;
+            line = trim(input.substr(lineStart, lineEnd - lineStart));
+            pos = 0;
+
+            if (line.empty())
+            {
+                lineStart = lineEnd + 1;
+                continue;
+            }
 
-            if (upper == "GRID")
+            if (equalsIgnoreCase(line, "GRID"))
             {
                 currentSection = GRID;
                 gridRow = 0;
-                continue;
             }
-            else if (upper == "CAGES")
+            else if (equalsIgnoreCase(line, "CAGES"))
             {
                 currentSection = CAGES;
-                continue;
             }
-            else if (upper == "INEQUALITIES")
+            else if (equalsIgnoreCase(line, "INEQUALITIES"))
             {
                 currentSection = INEQUALITIES;
-                continue;
             }
-
-            switch (currentSection)
-            {
-            case GRID:
+            else if (equalsIgnoreCase(line, "SOLUTION"))
             {
-                if (gridRow < GRID_SIZE)
-                {
-                    parseLine(line, gridRow, puzzle);
-                    gridRow++;
-                }
-                break;
+                // Written by toCustomFormatWithSolution; not part of the puzzle
+                currentSection = SOLUTION;
             }
-            case CAGES:
+            else
             {
-                // Format: sum r1 c1 r2 c2 ...
-                auto tokens = split(line, ' ');
-                if (tokens.size() >= 3 && (tokens.size() - 1) % 2 == 0)
+                switch (currentSection)
                 {
-                    int sum = std::stoi(tokens[0]);
-                    std::vector<Cell> cells;
-                    for (size_t i = 1; i < tokens.size(); i += 2)
+                case GRID:
+                    if (gridRow < GRID_SIZE)
                     {
-                        int r = std::stoi(tokens[i]);
-                        int c = std::stoi(tokens[i + 1]);
-                        cells.push_back(Cell(r, c));
+                        parseLine(line, gridRow, puzzle);
+                        gridRow++;
                     }
-                    puzzle.addCage(Cage(cells, sum));
-                }
-                break;
-            }
-            case INEQUALITIES:
-            {
-                // Format: r1 c1 > r2 c2 or r1 c1 < r2 c2
-                auto tokens = split(line, ' ');
-                if (tokens.size() == 5)
+                    break;
+
+                case CAGES:
                 {
-                    int r1 = std::stoi(tokens[0]);
-                    int c1 = std::stoi(tokens[1]);
-                    std::string op = tokens[2];
-                    int r2 = std::stoi(tokens[3]);
-                    int c2 = std::stoi(tokens[4]);
-
-                    InequalityType type;
-                    if (op == ">" || op == "gt")
+                    // Format: sum r1 c1 r2 c2 ...
+                    if (numCages == puzzle.cages.size())
                     {
-                        type = InequalityType::GREATER_THAN;
+                        puzzle.cages.emplace_back();
                     }
-                    else if (op == "<" || op == "lt")
+                    Cage &cage = puzzle.cages[numCages++];
+                    cage.cells.clear();
+                    if (!readInt(cage.targetSum, ParseStatus::INVALID_CAGE))
+                        return result;
+                    Cell cell;
+                    while (pos < line.size())
                     {
-                        type = InequalityType::LESS_THAN;
+                        if (!readCell(cell, ParseStatus::INVALID_CAGE))
+                            return result;
+                        cage.cells.push_back(cell);
+                        while (pos < line.size() && isBlank(line[pos]))
+                            pos++;
                     }
-                    else
-                    {
-                        continue;
-                    }
-
-                    puzzle.addInequality(InequalityConstraint(
-                        Cell(r1, c1), Cell(r2, c2), type));
+                    if (cage.cells.empty())
+                        return fail(ParseStatus::INVALID_CAGE, pos);
+                    break;
                 }
-                break;
-            }
-            default:
-                // Try to parse as simple grid line
-                if (line.length() >= GRID_SIZE)
+
+                case INEQUALITIES:
                 {
-                    bool isGridLine = true;
-                    int validChars = 0;
-                    for (char c : line)
-                    {
-                        if (c == '.' || c == '0' || c == '_' || c == '*' ||
-                            (c >= '1' && c <= '9') || c == ' ')
-                        {
-                            if (c != ' ')
-                                validChars++;
-                        }
-                    }
-                    if (validChars >= GRID_SIZE && gridRow < GRID_SIZE)
+                    // Format: r1 c1 > r2 c2 or r1 c1 < r2 c2
+                    InequalityConstraint ineq;
+                    if (!readCell(ineq.cell1, ParseStatus::INVALID_INEQUALITY))
+                        return result;
+                    if (!nextToken(line, pos, token))
+                        return fail(ParseStatus::INVALID_INEQUALITY, pos);
+                    if (token == ">" || token == "gt")
+                        ineq.type = InequalityType::GREATER_THAN;
+                    else if (token == "<" || token == "lt")
+                        ineq.type = InequalityType::LESS_THAN;
+                    else
+                        return fail(ParseStatus::INVALID_INEQUALITY, pos - token.size());
+                    if (!readCell(ineq.cell2, ParseStatus::INVALID_INEQUALITY))
+                        return result;
+                    if (nextToken(line, pos, token))
+                        return fail(ParseStatus::INVALID_INEQUALITY, pos - token.size());
+                    puzzle.inequalities.push_back(ineq);
+                    break;
+                }
+
+                case SOLUTION:
+                    break;
+
+                case NONE:
+                    // Try to parse as simple grid line
+                    if (static_cast<int>(line.length()) >= GRID_SIZE && gridRow < GRID_SIZE &&
+                        countCells(line) >= GRID_SIZE)
                     {
                         currentSection = GRID;
                         parseLine(line, gridRow, puzzle);
                         gridRow++;
                     }
+                    break;
                 }
-                break;
             }
+            lineStart = lineEnd + 1;
         }
 
-        return puzzle;
+        puzzle.cages.resize(numCages);
+        bool killer = numCages > 0;
+        bool inequality = !puzzle.inequalities.empty();
+        puzzle.type = killer && inequality ? SudokuType::KILLER_INEQUALITY
+                      : killer             ? SudokuType::KILLER
+                      : inequality         ? SudokuType::INEQUALITY
+                                           : SudokuType::STANDARD;
+        return ParseResult();
     }
 
-    SudokuPuzzle SudokuParser::parseFromString(const std::string &input)
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuParser<Geo>::parseFromString(const std::string &input)
     {
-        std::string trimmed = trim(input);
-
-        // Try to detect format
-        if (trimmed.find("GRID") != std::string::npos ||
-            trimmed.find("CAGES") != std::string::npos ||
-            trimmed.find("INEQUALITIES") != std::string::npos)
+        if (BasicSudokuBinary<Geo>::isBinary(input))
         {
-            return parseCustomFormat(input);
+            return parseBinary(input);
         }
 
-        // Count valid grid characters
-        int validChars = 0;
-        for (char c : trimmed)
+        // Fast path: a bare grid line, possibly followed by a line break
+        std::string_view line = input;
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
         {
-            if (c == '.' || c == '0' || c == '_' || c == '*' ||
-                (c >= '1' && c <= '9'))
-            {
-                validChars++;
-            }
+            line.remove_suffix(1);
+        }
+        Puzzle puzzle;
+        if (parseCompactGrid(line, puzzle))
+        {
+            return puzzle;
         }
 
-        if (validChars >= 81)
+        if (BasicSudokuJson<Geo>::isJson(input))
         {
-            return parseSimpleGrid(trimmed);
+            return BasicSudokuJson<Geo>::parsePuzzle(input);
         }
 
-        // Try custom format
-        return parseCustomFormat(input);
-    }
+        std::string_view trimmed = trim(input);
 
-    SudokuPuzzle SudokuParser::parseFromFile(const std::string &filename)
-    {
-        std::ifstream file(filename);
-        if (!file.is_open())
+        // Try to detect format
+        bool custom = trimmed.find("GRID") != std::string_view::npos ||
+                      trimmed.find("CAGES") != std::string_view::npos ||
+                      trimmed.find("INEQUALITIES") != std::string_view::npos;
+
+        // Space-separated grids larger than 9x9 go through the line-based parser
+        bool tokenized = GRID_SIZE > 9 && trimmed.find_first_of(" \t") != std::string_view::npos;
+        if (!custom && !tokenized && countCells(trimmed) >= NUM_CELLS)
         {
-            throw std::runtime_error("Cannot open file: " + filename);
+            return parseSimpleGrid(std::string(trimmed));
         }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        return parseFromString(buffer.str());
+        ParseResult result = parseCustomFormat(std::string_view(input), puzzle);
+        if (!result)
+        {
+            throw std::runtime_error("Parse error at " + result.toString());
+        }
+        return puzzle;
     }
 
-    std::string SudokuParser::toPrettyGrid(const int grid[GRID_SIZE][GRID_SIZE])
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuParser<Geo>::parseBinary(std::string_view data, Solution *solution)
     {
-        std::ostringstream oss;
+        return BasicSudokuBinary<Geo>::read(data, solution);
+    }
 
-        oss << "+-------+-------+-------+\n";
-        for (int row = 0; row < GRID_SIZE; row++)
-        {
-            if (row > 0 && row % BOX_SIZE == 0)
-            {
-                oss << "+-------+-------+-------+\n";
-            }
-            oss << "|";
-            for (int col = 0; col < GRID_SIZE; col++)
-            {
-                if (col > 0 && col % BOX_SIZE == 0)
-                {
-                    oss << " |";
-                }
-                int val = grid[row][col];
-                if (val >= MIN_VALUE && val <= MAX_VALUE)
-                {
-                    oss << " " << val;
-                }
-                else
-                {
-                    oss << " .";
-                }
-            }
-            oss << " |\n";
-        }
-        oss << "+-------+-------+-------+\n";
+    template <class Geo>
+    BasicSudokuPuzzle<Geo> BasicSudokuParser<Geo>::parseFromFile(const std::string &filename)
+    {
+        MappedFile file(filename);
+        return parseFromString(std::string(file.contents()));
+    }
 
-        return oss.str();
+    template <class Geo>
+    std::string BasicSudokuParser<Geo>::toPrettyGrid(const int grid[GRID_SIZE][GRID_SIZE])
+    {
+        std::string out;
+        BasicSudokuWriter<Geo>::appendPrettyGrid(out, grid);
+        return out;
     }
 
-    std::string SudokuParser::toString(const SudokuPuzzle &puzzle)
+    template <class Geo>
+    std::string BasicSudokuParser<Geo>::toString(const Puzzle &puzzle)
     {
-        std::ostringstream oss;
+        using Writer = BasicSudokuWriter<Geo>;
+        std::string out;
 
-        oss << "Type: " << puzzle.getTypeString() << "\n\n";
-        oss << "Grid:\n";
-        oss << toPrettyGrid(puzzle.grid);
+        out += "Type: ";
+        out += puzzle.getTypeString();
+        out += "\n\nGrid:\n";
+        Writer::appendPrettyGrid(out, puzzle.grid);
+
+        auto appendCell = [&](const Cell &cell)
+        {
+            out += '(';
+            Writer::appendInt(out, cell.row);
+            out += ',';
+            Writer::appendInt(out, cell.col);
+            out += ')';
+        };
 
         if (puzzle.hasKillerConstraints())
         {
-            oss << "\nCages (" << puzzle.cages.size() << "):\n";
+            out += "\nCages (";
+            Writer::appendInt(out, static_cast<long long>(puzzle.cages.size()));
+            out += "):\n";
             for (size_t i = 0; i < puzzle.cages.size(); i++)
             {
                 const auto &cage = puzzle.cages[i];
-                oss << "  Cage " << (i + 1) << ": sum=" << cage.targetSum << ", cells=[";
+                out += "  Cage ";
+                Writer::appendInt(out, static_cast<long long>(i + 1));
+                out += ": sum=";
+                Writer::appendInt(out, cage.targetSum);
+                out += ", cells=[";
                 for (size_t j = 0; j < cage.cells.size(); j++)
                 {
                     if (j > 0)
-                        oss << ", ";
-                    oss << "(" << cage.cells[j].row << "," << cage.cells[j].col << ")";
+                        out += ", ";
+                    appendCell(cage.cells[j]);
                 }
-                oss << "]\n";
+                out += "]\n";
             }
         }
 
         if (puzzle.hasInequalityConstraints())
         {
-            oss << "\nInequalities (" << puzzle.inequalities.size() << "):\n";
+            out += "\nInequalities (";
+            Writer::appendInt(out, static_cast<long long>(puzzle.inequalities.size()));
+            out += "):\n";
             for (const auto &ineq : puzzle.inequalities)
             {
-                oss << "  (" << ineq.cell1.row << "," << ineq.cell1.col << ") ";
-                oss << (ineq.type == InequalityType::GREATER_THAN ? ">" : "<");
-                oss << " (" << ineq.cell2.row << "," << ineq.cell2.col << ")\n";
+                out += "  ";
+                appendCell(ineq.cell1);
+                out += ineq.type == InequalityType::GREATER_THAN ? " > " : " < ";
+                appendCell(ineq.cell2);
+                out += '\n';
             }
         }
 
-        return oss.str();
+        return out;
     }
 
-    std::string SudokuParser::toString(const SudokuSolution &solution)
+    template <class Geo>
+    std::string BasicSudokuParser<Geo>::toString(const Solution &solution)
     {
-        std::ostringstream oss;
+        std::string out;
 
         if (solution.solved)
         {
-            oss << "Solution found in " << solution.solveTimeMs << " ms:\n\n";
-            oss << toPrettyGrid(solution.grid);
+            out += "Solution found in ";
+            BasicSudokuWriter<Geo>::appendGeneral(out, solution.solveTimeMs);
+            out += " ms:\n\n";
+            BasicSudokuWriter<Geo>::appendPrettyGrid(out, solution.grid);
         }
         else
         {
-            oss << "No solution found.\n";
+            out += "No solution found.\n";
             if (!solution.errorMessage.empty())
             {
-                oss << "Error: " << solution.errorMessage << "\n";
+                out += "Error: ";
+                out += solution.errorMessage;
+                out += '\n';
             }
         }
 
-        return oss.str();
+        return out;
     }
 
+#define SUDOKU_INSTANTIATE_PARSER(R, C) template class BasicSudokuParser<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_PARSER)
+#undef SUDOKU_INSTANTIATE_PARSER
+
 } // namespace sudoku
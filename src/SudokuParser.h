@@ -8,12 +8,43 @@
 
 #include "SudokuTypes.h"
 #include <string>
+#include <string_view>
 #include <istream>
 #include <fstream>
 
 namespace sudoku
 {
 
+    /**
+     * @brief Outcome of a non-throwing parse
+     */
+    enum class ParseStatus
+    {
+        OK,
+        INVALID_NUMBER,     // A token that must be an integer is not one
+        INVALID_CAGE,       // Cage line is not "sum r1 c1 r2 c2 ..."
+        INVALID_INEQUALITY, // Inequality line is not "r1 c1 > r2 c2" or "r1 c1 < r2 c2"
+        CELL_OUT_OF_RANGE   // Constraint refers to a cell outside the grid
+    };
+
+    /**
+     * @brief Parse status with the 1-based position of the first error
+     */
+    struct ParseResult
+    {
+        ParseStatus status = ParseStatus::OK;
+        int line = 0;
+        int column = 0;
+
+        bool ok() const { return status == ParseStatus::OK; }
+        explicit operator bool() const { return ok(); }
+
+        /**
+         * @brief Human-readable description, e.g. "line 12, column 4: expected an integer"
+         */
+        std::string toString() const;
+    };
+
     /**
      * @brief Parser for Sudoku puzzles
      *
@@ -23,8 +54,9 @@ namespace sudoku
      *    - 9 lines of 9 characters
      *    - Digits 1-9 for given values
      *    - 0 or . for empty cells
+     *    - Larger grids use letters for values above 9 (A = 10, B = 11, ...)
      *
-     * 2. JSON-like format (for all variants):
+     * 2. JSON format (for all variants, see SudokuJson.h):
      *    {
      *      "type": "killer" | "inequality" | "mixed" | "standard",
      *      "grid": [
@@ -41,7 +73,9 @@ namespace sudoku
      *      ]
      *    }
      *
-     * 3. Custom text format:
+     * 3. Compact binary format (SudokuBinary.h), detected by its magic bytes
+     *
+     * 4. Custom text format:
      *    GRID
      *    0 0 0 0 0 0 0 0 0
      *    ... (9 lines)
@@ -51,66 +85,127 @@ namespace sudoku
      *    INEQUALITIES
      *    r1 c1 > r2 c2
      *    ...
+     *
+     *    Grids larger than 9x9 separate GRID values with spaces (e.g. "0 12 0 7").
+     *
+     * Instantiated for every geometry in SUDOKU_FOR_EACH_GEOMETRY.
      */
-    class SudokuParser
+    template <class Geo>
+    class BasicSudokuParser
     {
     public:
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Solution = BasicSudokuSolution<Geo>;
+
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int NUM_CELLS = Geo::NUM_CELLS;
+        static constexpr int MIN_VALUE = Geo::MIN_VALUE;
+        static constexpr int MAX_VALUE = Geo::MAX_VALUE;
+
         /**
          * @brief Parse a puzzle from a string
          * @param input The input string
          * @return The parsed puzzle
          */
-        static SudokuPuzzle parseFromString(const std::string &input);
+        static Puzzle parseFromString(const std::string &input);
 
         /**
          * @brief Parse a puzzle from a file
          * @param filename Path to the file
          * @return The parsed puzzle
          */
-        static SudokuPuzzle parseFromFile(const std::string &filename);
+        static Puzzle parseFromFile(const std::string &filename);
 
         /**
-         * @brief Parse a simple grid string (81 characters)
+         * @brief Parse a simple grid string (81 characters on a 9x9 grid)
          * @param grid The grid string
          * @return The parsed puzzle
          */
-        static SudokuPuzzle parseSimpleGrid(const std::string &grid);
+        static Puzzle parseSimpleGrid(const std::string &grid);
+
+        /**
+         * @brief Parse exactly NUM_CELLS grid characters without allocating
+         *
+         * The fast path for line-per-puzzle input. On 9x9 grids the characters
+         * are classified with SIMD (see SudokuGridScan.h).
+         * @param text The grid characters, with no separators
+         * @param puzzle Receives the grid (constraints are left unchanged)
+         * @return false if text has the wrong length or an invalid character
+         */
+        static bool parseCompactGrid(std::string_view text, Puzzle &puzzle);
 
         /**
          * @brief Parse custom text format
          * @param input The input string
          * @return The parsed puzzle
+         * @throws std::runtime_error with the line and column of the first error
+         */
+        static Puzzle parseCustomFormat(const std::string &input);
+
+        /**
+         * @brief Parse custom text format without allocating or throwing
+         *
+         * A single pass over the text. The puzzle is overwritten in place and
+         * its cage storage reused, so parsing many puzzles into the same
+         * object allocates only while it grows. On error the puzzle holds
+         * whatever was read before the error.
+         * @param input The input text
+         * @param puzzle Receives the puzzle
+         * @return OK, or the status and position of the first error
+         */
+        static ParseResult parseCustomFormat(std::string_view input, Puzzle &puzzle);
+
+        /**
+         * @brief Parse one record of the compact binary format (see SudokuBinary.h)
+         * @param data The record bytes
+         * @param solution If not null, receives the stored solution, if any
+         * @return The parsed puzzle
          */
-        static SudokuPuzzle parseCustomFormat(const std::string &input);
+        static Puzzle parseBinary(std::string_view data, Solution *solution = nullptr);
 
         /**
          * @brief Convert a puzzle to a printable string
          * @param puzzle The puzzle to convert
          * @return String representation
          */
-        static std::string toString(const SudokuPuzzle &puzzle);
+        static std::string toString(const Puzzle &puzzle);
 
         /**
          * @brief Convert a solution to a printable string
          * @param solution The solution to convert
          * @return String representation
          */
-        static std::string toString(const SudokuSolution &solution);
+        static std::string toString(const Solution &solution);
 
         /**
          * @brief Convert to a pretty-printed grid
-         * @param grid 9x9 array of values
+         * @param grid GRID_SIZE x GRID_SIZE array of values
          * @return Pretty string with box separators
          */
         static std::string toPrettyGrid(const int grid[GRID_SIZE][GRID_SIZE]);
 
+        /**
+         * @brief Value of a grid character
+         * @return 1..MAX_VALUE for a value, 0 for an empty cell, -1 for anything else
+         */
+        static int symbolValue(char c);
+
+        /**
+         * @brief Grid character for a value ('.' for empty or out of range)
+         */
+        static char valueSymbol(int value);
+
     private:
-        static void parseLine(const std::string &line, int row, SudokuPuzzle &puzzle);
-        static std::vector<std::string> splitLines(const std::string &input);
-        static std::string trim(const std::string &str);
-        static std::vector<std::string> split(const std::string &str, char delimiter);
+        static void parseLine(std::string_view line, int row, Puzzle &puzzle);
+        static bool isTokenizedLine(std::string_view line);
+        static int countCells(std::string_view line);
+        static int tokenValue(std::string_view token);
+        static std::string_view trim(std::string_view str);
     };
 
+    // Classic 9x9 parser
+    using SudokuParser = BasicSudokuParser<StandardGeometry>;
+
 } // namespace sudoku
 
 #endif // SUDOKU_PARSER_H
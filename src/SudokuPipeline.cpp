@@ -0,0 +1,435 @@
+/**
+ * @file SudokuPipeline.cpp
+ * @brief Implementation of the staged batch pipeline
+ */
+
+#include "SudokuPipeline.h"
+#include "SudokuBatch.h"
+#include "SudokuCanonical.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        /**
+         * @brief Waiting strategy for a stage blocked on a queue
+         *
+         * Spins briefly (the other side is usually about to move), then
+         * yields; after that the stage should block on a Signal.
+         * @return false once spinning is no longer worth it
+         */
+        class Backoff
+        {
+        public:
+            bool spin()
+            {
+                if (rounds < 16)
+                {
+                    rounds++;
+                    return true;
+                }
+                if (rounds < 64)
+                {
+                    rounds++;
+                    std::this_thread::yield();
+                    return true;
+                }
+                return false;
+            }
+
+        private:
+            int rounds = 0;
+        };
+
+        /**
+         * @brief Where a stage sleeps until another stage makes progress
+         *
+         * notify() only takes the mutex while someone sleeps, so pushes and
+         * pops on the lock-free queues stay lock-free when nobody is blocked.
+         */
+        class Signal
+        {
+        public:
+            /**
+             * @brief Block until ready() holds; ready is evaluated under the lock
+             */
+            template <class Ready>
+            void wait(Ready ready)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                sleepers.fetch_add(1);
+                // Pairs with the fence in notify(): either it sees the sleeper or ready() sees its progress
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                condition.wait(lock, ready);
+                sleepers.fetch_sub(1);
+            }
+
+            /**
+             * @brief Wake the sleepers, if any, after making progress
+             */
+            void notify()
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (sleepers.load(std::memory_order_relaxed) > 0)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                    }
+                    condition.notify_all();
+                }
+            }
+
+        private:
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::atomic<int> sleepers{0};
+        };
+
+        /**
+         * @brief Solve a puzzle through its canonical form
+         *
+         * Symmetry classes are only defined for the classic grid; other
+         * geometries are solved as they are.
+         */
+        template <class Geo>
+        BasicSudokuSolution<Geo> solveCanonical(BasicSudokuSolver<Geo> &solver, const BasicSudokuPuzzle<Geo> &puzzle,
+                                                bool checkUniqueness)
+        {
+            return solver.solve(puzzle, checkUniqueness);
+        }
+
+        template <>
+        SudokuSolution solveCanonical<StandardGeometry>(SudokuSolver &solver, const SudokuPuzzle &puzzle,
+                                                        bool checkUniqueness)
+        {
+            CanonicalForm form = SudokuCanonicalizer::canonicalize(puzzle);
+            SudokuSolution solution = solver.solve(form.puzzle, checkUniqueness);
+            return solution.solved ? form.transform.invert(solution) : solution;
+        }
+    } // namespace
+
+    template <class Geo>
+    BasicBatchPipeline<Geo>::BasicBatchPipeline(PipelineConfig config, Parser parser, Sink sink)
+        : config(config), parser(std::move(parser)), sink(std::move(sink))
+    {
+        this->config.parseThreads = std::max(1, this->config.parseThreads);
+        this->config.solveThreads = std::max(1, this->config.solveThreads);
+        if (this->config.maxInFlight == 0)
+        {
+            this->config.maxInFlight = 256 * static_cast<size_t>(this->config.solveThreads);
+        }
+    }
+
+    template <class Geo>
+    PipelineStats BasicBatchPipeline<Geo>::run(Source source)
+    {
+        using Item = std::unique_ptr<Result>;
+
+        // A queue with the signals for its empty -> non-empty and full -> not-full transitions
+        struct Queue
+        {
+            explicit Queue(size_t capacity) : items(capacity) {}
+
+            BoundedQueue<Item> items;
+            Signal notEmpty;
+            Signal notFull;
+
+            void close()
+            {
+                items.close();
+                notEmpty.notify();
+            }
+        };
+
+        const size_t budget = config.maxInFlight;
+        Queue parseQueue(budget);
+        Queue solveQueue(budget);
+        Queue writeQueue(budget);
+        Signal budgetFreed; // The writer reported a record
+
+        std::atomic<size_t> reported{0};
+        std::atomic<size_t> readerStalls{0};
+        std::atomic<size_t> parserStalls{0};
+        std::atomic<size_t> solverStalls{0};
+
+        // The first exception from any stage stops every stage
+        std::atomic<bool> aborted{false};
+        std::mutex failureMutex;
+        std::exception_ptr failure;
+        auto fail = [&]()
+        {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure)
+            {
+                failure = std::current_exception();
+            }
+            aborted.store(true);
+            for (Queue *queue : {&parseQueue, &solveQueue, &writeQueue})
+            {
+                queue->notEmpty.notify();
+                queue->notFull.notify();
+            }
+            budgetFreed.notify();
+        };
+
+        // Wait while the queue is full; false if the pipeline was aborted
+        auto push = [&](Queue &queue, Item &item, std::atomic<size_t> &stalls)
+        {
+            Backoff backoff;
+            bool stalled = false;
+            bool pushed = queue.items.tryPush(item);
+            while (!pushed)
+            {
+                if (aborted.load(std::memory_order_relaxed))
+                {
+                    return false;
+                }
+                if (!stalled)
+                {
+                    stalls.fetch_add(1, std::memory_order_relaxed);
+                    stalled = true;
+                }
+                if (backoff.spin())
+                {
+                    pushed = queue.items.tryPush(item);
+                }
+                else
+                {
+                    queue.notFull.wait([&]()
+                                       { return (pushed = queue.items.tryPush(item)) || aborted.load(); });
+                }
+            }
+            queue.notEmpty.notify();
+            return true;
+        };
+
+        // Wait while the queue is empty; false once it is closed and drained
+        auto pop = [&](Queue &queue, Item &item)
+        {
+            Backoff backoff;
+            bool popped = queue.items.tryPop(item);
+            while (!popped)
+            {
+                if (aborted.load(std::memory_order_relaxed))
+                {
+                    return false;
+                }
+                if (queue.items.isClosed())
+                {
+                    // Everything pushed before close() is visible now
+                    popped = queue.items.tryPop(item);
+                    break;
+                }
+                if (backoff.spin())
+                {
+                    popped = queue.items.tryPop(item);
+                }
+                else
+                {
+                    queue.notEmpty.wait([&]()
+                                        { return (popped = queue.items.tryPop(item)) || aborted.load() ||
+                                                 queue.items.isClosed(); });
+                }
+            }
+            if (popped)
+            {
+                queue.notFull.notify();
+            }
+            return popped;
+        };
+
+        // Equivalent puzzles share a canonical form, so the cache finds them
+        std::shared_ptr<BasicSolutionCache<Geo>> solveCache = cache;
+        if (config.deduplicate && !solveCache)
+        {
+            solveCache = std::make_shared<BasicSolutionCache<Geo>>();
+        }
+
+        std::vector<std::thread> threads;
+
+        // Reader: stays at most budget records ahead of the writer
+        threads.emplace_back([&]()
+                             {
+            try
+            {
+                size_t read = 0;
+                std::string_view record;
+                for (;;)
+                {
+                    Backoff backoff;
+                    bool stalled = false;
+                    auto withinBudget = [&]()
+                    {
+                        return read - reported.load(std::memory_order_acquire) < budget || aborted.load();
+                    };
+                    while (!withinBudget())
+                    {
+                        if (!stalled)
+                        {
+                            readerStalls.fetch_add(1, std::memory_order_relaxed);
+                            stalled = true;
+                        }
+                        if (!backoff.spin())
+                        {
+                            budgetFreed.wait(withinBudget);
+                        }
+                    }
+                    if (aborted.load(std::memory_order_relaxed) || !source(record))
+                    {
+                        break;
+                    }
+
+                    auto item = std::make_unique<Result>();
+                    item->index = config.firstIndex + read++;
+                    if (config.stableRecords)
+                    {
+                        item->record = record;
+                    }
+                    else
+                    {
+                        item->owned.assign(record);
+                        item->record = item->owned;
+                    }
+                    if (!push(parseQueue, item, readerStalls))
+                    {
+                        break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                fail();
+            }
+            parseQueue.close(); });
+
+        // Parsers: records that fail to parse go straight to the writer
+        std::atomic<int> parsersLeft{config.parseThreads};
+        for (int i = 0; i < config.parseThreads; i++)
+        {
+            threads.emplace_back([&]()
+                                 {
+                try
+                {
+                    Item item;
+                    while (pop(parseQueue, item))
+                    {
+                        item->parsed = parser(item->record, item->puzzle, item->id, item->error);
+                        if (!push(item->parsed ? solveQueue : writeQueue, item, parserStalls))
+                        {
+                            break;
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    fail();
+                }
+                if (parsersLeft.fetch_sub(1) == 1)
+                {
+                    solveQueue.close();
+                } });
+        }
+
+        // Solvers: one SAT solver per thread; the last one out closes the write queue
+        std::atomic<int> solversLeft{config.solveThreads};
+        for (int i = 0; i < config.solveThreads; i++)
+        {
+            threads.emplace_back([&]()
+                                 {
+                try
+                {
+                    BasicSudokuSolver<Geo> solver;
+                    if (solveCache)
+                    {
+                        solver.setCache(solveCache);
+                    }
+                    Item item;
+                    while (pop(solveQueue, item))
+                    {
+                        item->solution = config.deduplicate
+                                             ? solveCanonical(solver, item->puzzle, config.checkUniqueness)
+                                             : solver.solve(item->puzzle, config.checkUniqueness);
+                        item->stats = solver.getLastStats();
+                        if (config.verify && item->solution.solved)
+                        {
+                            auto start = std::chrono::steady_clock::now();
+                            item->verified = BasicSudokuSolver<Geo>::verifySolution(item->puzzle, item->solution);
+                            item->verifyMs = std::chrono::duration<double, std::milli>(
+                                                 std::chrono::steady_clock::now() - start)
+                                                 .count();
+                        }
+                        if (!push(writeQueue, item, solverStalls))
+                        {
+                            break;
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    fail();
+                }
+                if (solversLeft.fetch_sub(1) == 1)
+                {
+                    writeQueue.close();
+                } });
+        }
+
+        // Writer: this thread, so the sink needs no locking
+        PipelineStats stats;
+        try
+        {
+            ReorderBuffer<Item> reorder([&](size_t, const Item &item)
+                                        {
+                                            sink(*item);
+                                            reported.fetch_add(1, std::memory_order_release);
+                                            budgetFreed.notify(); },
+                                        config.firstIndex);
+            Item item;
+            while (pop(writeQueue, item))
+            {
+                stats.records++;
+                if (config.ordered)
+                {
+                    size_t index = item->index;
+                    reorder.put(index, std::move(item));
+                }
+                else
+                {
+                    sink(*item);
+                    reported.fetch_add(1, std::memory_order_release);
+                    budgetFreed.notify();
+                }
+            }
+        }
+        catch (...)
+        {
+            fail();
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+
+        stats.readerStalls = readerStalls.load();
+        stats.parserStalls = parserStalls.load();
+        stats.solverStalls = solverStalls.load();
+        return stats;
+    }
+
+#define SUDOKU_INSTANTIATE_PIPELINE(R, C) template class BasicBatchPipeline<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_PIPELINE)
+#undef SUDOKU_INSTANTIATE_PIPELINE
+
+} // namespace sudoku
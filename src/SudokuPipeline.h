@@ -0,0 +1,261 @@
+/**
+ * @file SudokuPipeline.h
+ * @brief Staged batch pipeline: reader, parser pool, solver pool, writer
+ *
+ *   reader ──▶ [parse queue] ──▶ parsers ──▶ [solve queue] ──▶ solvers ──▶ [write queue] ──▶ writer
+ *
+ * - BoundedQueue: a fixed-capacity lock-free MPMC ring. A full queue makes
+ *   its producers back off (spin, yield, then block until a consumer frees
+ *   a slot), which is the backpressure that keeps every stage within its
+ *   budget. Consumers of an empty queue wait the same way, so an idle stage
+ *   sleeps instead of polling.
+ * - BasicBatchPipeline: runs the stages on their own threads so reading,
+ *   parsing and formatting overlap with solving. The reader stops taking
+ *   records while maxInFlight of them are between it and the writer, so
+ *   the memory held by the queues and the reorder window is fixed however
+ *   large the input is or however slow one puzzle turns out to be.
+ *
+ * Records that fail to parse skip the solver stage and go straight to the
+ * writer, which reports results in input order (or completion order).
+ *
+ * With PipelineConfig::deduplicate, 9x9 puzzles are solved in canonical
+ * form, so every puzzle of a symmetry class after the first is a cache hit
+ * (an in-memory cache is used when none was set).
+ */
+
+#ifndef SUDOKU_PIPELINE_H
+#define SUDOKU_PIPELINE_H
+
+#include "SudokuCache.h"
+#include "SudokuSolver.h"
+#include "SudokuTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Bounded lock-free multi-producer multi-consumer queue
+     *
+     * Each slot carries a sequence number telling producers and consumers
+     * whose turn it is, so neither side takes a lock.
+     */
+    template <class T>
+    class BoundedQueue
+    {
+    public:
+        /**
+         * @param capacity Rounded up to a power of two
+         */
+        explicit BoundedQueue(size_t capacity)
+        {
+            size_t size = 2;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            mask = size - 1;
+            slots = std::make_unique<Slot[]>(size);
+            for (size_t i = 0; i < size; i++)
+            {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Append unless full; value is moved from only on success
+         */
+        bool tryPush(T &value)
+        {
+            size_t pos = head.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot &slot = slots[pos & mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0)
+                {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        slot.value = std::move(value);
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Take the oldest value unless empty
+         */
+        bool tryPop(T &value)
+        {
+            size_t pos = tail.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot &slot = slots[pos & mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        value = std::move(slot.value);
+                        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Mark that no more values will be pushed
+         */
+        void close() { closed.store(true, std::memory_order_release); }
+        bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+        size_t capacity() const { return mask + 1; }
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence{0};
+            T value{};
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> head{0}; // Next slot to fill
+        alignas(64) std::atomic<size_t> tail{0}; // Next slot to drain
+        std::atomic<bool> closed{false};
+    };
+
+    /**
+     * @brief Pipeline settings
+     */
+    struct PipelineConfig
+    {
+        int parseThreads = 1;
+        int solveThreads = 1;
+        bool checkUniqueness = false;
+        bool verify = false;        // Check each solution against its puzzle, timed
+        bool ordered = true;       // Report in input order (false: completion order)
+        bool stableRecords = false; // Records stay valid for the whole run (memory-mapped input)
+        size_t maxInFlight = 0;    // Records read but not yet reported (0 = 256 per solver)
+        size_t firstIndex = 0;     // Index of the first record (when resuming part way)
+        bool deduplicate = false;  // Solve the canonical form of each 9x9 puzzle, through the cache
+    };
+
+    /**
+     * @brief Times a stage found the next queue full and had to wait
+     */
+    struct PipelineStats
+    {
+        size_t records = 0;
+        size_t readerStalls = 0; // Parse queue full, or the in-flight budget spent
+        size_t parserStalls = 0; // Solve queue full
+        size_t solverStalls = 0; // Write queue full
+    };
+
+    /**
+     * @brief One record on its way through the stages
+     */
+    template <class Geo>
+    struct BasicPipelineResult
+    {
+        size_t index = 0;
+        bool parsed = false;
+        std::string id;    // Optional id found by the parser (JSON input)
+        std::string error; // Why parsing failed
+        BasicSudokuSolution<Geo> solution;
+        SolveStats stats;       // Phase timings of the solve
+        bool verified = false;  // Passed verification (PipelineConfig::verify)
+        double verifyMs = -1.0; // -1 if not verified
+
+        // Filled and consumed by the stages
+        std::string_view record;
+        std::string owned; // Copy of the record when the source reuses its buffer
+        BasicSudokuPuzzle<Geo> puzzle;
+    };
+
+    /**
+     * @brief Runs a batch through reader, parser, solver and writer stages
+     */
+    template <class Geo>
+    class BasicBatchPipeline
+    {
+    public:
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Result = BasicPipelineResult<Geo>;
+
+        /**
+         * @brief Produces the next record; false at the end of the input
+         */
+        using Source = std::function<bool(std::string_view &record)>;
+
+        /**
+         * @brief Parses a record; called concurrently from the parser threads
+         * @return false with error set if the record is not a puzzle
+         */
+        using Parser = std::function<bool(std::string_view record, Puzzle &puzzle, std::string &id,
+                                          std::string &error)>;
+
+        /**
+         * @brief Receives every result, one at a time, on the thread calling run()
+         */
+        using Sink = std::function<void(const Result &result)>;
+
+        BasicBatchPipeline(PipelineConfig config, Parser parser, Sink sink);
+
+        /**
+         * @brief Share a solution cache between all solver threads
+         */
+        void setCache(std::shared_ptr<BasicSolutionCache<Geo>> cache) { this->cache = std::move(cache); }
+
+        /**
+         * @brief Run every record of the source through the pipeline
+         *
+         * Returns once the last result has been given to the sink. An
+         * exception thrown by any stage stops the pipeline and is rethrown.
+         */
+        PipelineStats run(Source source);
+
+        const PipelineConfig &getConfig() const { return config; }
+
+    private:
+        PipelineConfig config;
+        Parser parser;
+        Sink sink;
+        std::shared_ptr<BasicSolutionCache<Geo>> cache;
+    };
+
+    // Classic 9x9 pipeline
+    using PipelineResult = BasicPipelineResult<StandardGeometry>;
+    using BatchPipeline = BasicBatchPipeline<StandardGeometry>;
+
+} // namespace sudoku
+
+#endif // SUDOKU_PIPELINE_H
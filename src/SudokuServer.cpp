@@ -0,0 +1,384 @@
+/**
+ * @file SudokuServer.cpp
+ * @brief Implementation of the JSON request loop
+ */
+
+#include "SudokuServer.h"
+#include "SudokuJson.h"
+#include "SudokuParser.h"
+#include "SudokuWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        SudokuPuzzle parsePuzzleValue(std::string_view value)
+        {
+            if (!value.empty() && value.front() == '{')
+            {
+                return SudokuJson::parsePuzzle(value);
+            }
+            if (!value.empty() && value.front() == '"')
+            {
+                return SudokuParser::parseFromString(json::decodeString(value));
+            }
+            throw std::runtime_error("\"puzzle\" must be an object or a string");
+        }
+
+        // Reads [min, max] into the two bounds
+        void parseRange(std::string_view value, int &min, int &max)
+        {
+            size_t start = value.find('[');
+            size_t comma = value.find(',');
+            size_t end = value.rfind(']');
+            if (start == std::string_view::npos || comma == std::string_view::npos || end == std::string_view::npos ||
+                !(start < comma && comma < end))
+            {
+                throw std::runtime_error("expected a [min, max] pair");
+            }
+            auto trim = [](std::string_view text)
+            {
+                size_t first = text.find_first_not_of(" \t\r\n");
+                size_t last = text.find_last_not_of(" \t\r\n");
+                return first == std::string_view::npos ? text.substr(0, 0) : text.substr(first, last - first + 1);
+            };
+            min = static_cast<int>(json::parseInt(trim(value.substr(start + 1, comma - start - 1))));
+            max = static_cast<int>(json::parseInt(trim(value.substr(comma + 1, end - comma - 1))));
+        }
+
+        SudokuType parseType(std::string_view name)
+        {
+            if (name == "standard")
+                return SudokuType::STANDARD;
+            if (name == "killer")
+                return SudokuType::KILLER;
+            if (name == "inequality")
+                return SudokuType::INEQUALITY;
+            if (name == "mixed")
+                return SudokuType::KILLER_INEQUALITY;
+            throw std::runtime_error("unknown puzzle type: " + std::string(name));
+        }
+
+        void beginResponse(std::string &out, std::string_view id)
+        {
+            out += '{';
+            if (!id.empty())
+            {
+                out += "\"id\":";
+                out += id;
+                out += ',';
+            }
+        }
+
+        RequestOp parseOp(std::string_view name)
+        {
+            if (name == "solve")
+                return RequestOp::SOLVE;
+            if (name == "unique")
+                return RequestOp::UNIQUE;
+            if (name == "generate")
+                return RequestOp::GENERATE;
+            if (name == "verify")
+                return RequestOp::VERIFY;
+            if (name == "metrics")
+                return RequestOp::METRICS;
+            throw std::runtime_error("unknown op: " + std::string(name));
+        }
+
+        double parseNumber(std::string_view literal)
+        {
+            std::string text(literal);
+            size_t used = 0;
+            double value = std::stod(text, &used);
+            if (used != text.size())
+                throw std::runtime_error("expected a number, got " + text);
+            return value;
+        }
+    } // namespace
+
+    void RequestHandler::parse(std::string_view line, ServerRequest &request)
+    {
+        std::string_view op;
+        std::string_view puzzleValue;
+        std::string_view solutionValue;
+        bool unique = false;
+        bool uniqueGiven = false;
+        bool givensGiven = false;
+        GeneratorConfig &config = request.config;
+
+        json::forEachMember(line, [&](std::string_view key, std::string_view value)
+                            {
+            if (key == "id")
+                request.id = std::string(value);
+            else if (key == "op")
+                op = value;
+            else if (key == "puzzle")
+                puzzleValue = value;
+            else if (key == "solution")
+                solutionValue = value;
+            else if (key == "unique")
+            {
+                unique = json::parseBool(value);
+                uniqueGiven = true;
+            }
+            else if (key == "deadlineMs")
+                request.deadlineMs = parseNumber(value);
+            else if (key == "type")
+                config.type = parseType(json::decodeString(value));
+            else if (key == "seed")
+                config.seed = static_cast<unsigned int>(json::parseInt(value));
+            else if (key == "difficulty")
+                config.difficulty = static_cast<int>(json::parseInt(value));
+            else if (key == "cages")
+                parseRange(value, config.minCages, config.maxCages);
+            else if (key == "inequalities")
+                parseRange(value, config.minInequalities, config.maxInequalities);
+            else if (key == "givens")
+            {
+                parseRange(value, config.minGivens, config.maxGivens);
+                givensGiven = true;
+            }
+            else if (key == "fillAll")
+                config.fillAllCells = json::parseBool(value); });
+
+        if (op.empty())
+            throw std::runtime_error("missing \"op\"");
+        request.op = parseOp(json::decodeString(op));
+
+        switch (request.op)
+        {
+        case RequestOp::SOLVE:
+        case RequestOp::UNIQUE:
+            if (puzzleValue.empty())
+                throw std::runtime_error("missing \"puzzle\"");
+            request.puzzle = parsePuzzleValue(puzzleValue);
+            request.checkUniqueness = request.op == RequestOp::UNIQUE || unique;
+            break;
+
+        case RequestOp::GENERATE:
+            config.ensureUniqueSolution = uniqueGiven ? unique : true;
+            if (config.type == SudokuType::STANDARD)
+            {
+                config.minCages = config.maxCages = 0;
+                config.minInequalities = config.maxInequalities = 0;
+                if (!givensGiven)
+                {
+                    config.minGivens = 17; // Minimum for unique standard sudoku
+                    config.maxGivens = 30;
+                }
+            }
+            else if (config.type == SudokuType::KILLER)
+            {
+                config.minInequalities = config.maxInequalities = 0;
+            }
+            else if (config.type == SudokuType::INEQUALITY)
+            {
+                config.minCages = config.maxCages = 0;
+            }
+            break;
+
+        case RequestOp::VERIFY:
+        {
+            if (puzzleValue.empty() || solutionValue.empty())
+                throw std::runtime_error("verify needs \"puzzle\" and \"solution\"");
+            request.puzzle = parsePuzzleValue(puzzleValue);
+            // The solution grid uses the same layouts as a puzzle's "grid"
+            std::string wrapped = "{\"grid\":";
+            wrapped += solutionValue;
+            wrapped += '}';
+            SudokuPuzzle grid = SudokuJson::parsePuzzle(wrapped);
+            std::copy(&grid.grid[0][0], &grid.grid[0][0] + StandardGeometry::NUM_CELLS, &request.solution.grid[0][0]);
+            request.solution.solved = true;
+            break;
+        }
+
+        case RequestOp::METRICS:
+            break;
+        }
+    }
+
+    const char *RequestHandler::opName(RequestOp op)
+    {
+        switch (op)
+        {
+        case RequestOp::UNIQUE:
+            return "unique";
+        case RequestOp::GENERATE:
+            return "generate";
+        case RequestOp::VERIFY:
+            return "verify";
+        case RequestOp::METRICS:
+            return "metrics";
+        default:
+            return "solve";
+        }
+    }
+
+    void RequestHandler::appendError(std::string &out, std::string_view id, std::string_view message)
+    {
+        beginResponse(out, id);
+        out += "\"error\":";
+        SudokuWriter::appendJsonString(out, message);
+        out += '}';
+    }
+
+    SudokuSolution RequestHandler::solve(const ServerRequest &request)
+    {
+        SudokuSolution solution = solver.solve(request.puzzle, request.checkUniqueness);
+        if (metrics)
+        {
+            metrics->recordSolve(request.puzzle.type, solver.getLastStats(), solution.solveTimeMs);
+        }
+        return solution;
+    }
+
+    void RequestHandler::answer(const ServerRequest &request, std::string &out)
+    {
+        switch (request.op)
+        {
+        case RequestOp::SOLVE:
+        case RequestOp::UNIQUE:
+            SudokuWriter::appendSolutionJson(out, solve(request), request.id);
+            break;
+
+        case RequestOp::GENERATE:
+        {
+            auto start = std::chrono::steady_clock::now();
+            SudokuSolution solution;
+            SudokuPuzzle puzzle = generator.generateWithSolution(request.config, solution);
+            if (metrics)
+            {
+                double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                metrics->recordGeneration(request.config.type, generator.getLastStats(), totalMs);
+            }
+            beginResponse(out, request.id);
+            out += "\"puzzle\":";
+            SudokuWriter::appendPuzzleJson(out, puzzle);
+            out += ",\"solution\":";
+            SudokuWriter::appendGridJson(out, solution.grid);
+            out += '}';
+            break;
+        }
+
+        case RequestOp::VERIFY:
+            beginResponse(out, request.id);
+            out += SudokuSolver::verifySolution(request.puzzle, request.solution) ? "\"valid\":true}" : "\"valid\":false}";
+            break;
+
+        case RequestOp::METRICS:
+            if (!metrics)
+                throw std::runtime_error("metrics are not enabled");
+            beginResponse(out, request.id);
+            out += "\"metrics\":";
+            SudokuWriter::appendJsonString(out, metrics->renderPrometheus());
+            out += '}';
+            break;
+        }
+    }
+
+    std::string RequestHandler::handle(std::string_view line)
+    {
+        ServerRequest request;
+        std::string response;
+        const char *op = "invalid";
+        try
+        {
+            parse(line, request);
+            op = opName(request.op);
+            answer(request, response);
+        }
+        catch (const std::exception &e)
+        {
+            response.clear();
+            appendError(response, request.id, e.what());
+            if (metrics)
+                metrics->recordRequest(op, "error");
+            return response;
+        }
+        if (metrics)
+            metrics->recordRequest(op, "ok");
+        return response;
+    }
+
+    RequestServer::RequestServer(int numThreads, ResponseCallback respond, size_t maxInFlight)
+        : respond(std::move(respond))
+    {
+        if (numThreads < 1)
+        {
+            numThreads = 1;
+        }
+        this->maxInFlight = maxInFlight > 0 ? maxInFlight : 64 * static_cast<size_t>(numThreads);
+
+        for (int i = 0; i < numThreads; i++)
+        {
+            workers.push_back(std::make_unique<RequestHandler>());
+        }
+        // Even one worker runs on its own thread, so reading never waits for a solve
+        pool = std::make_unique<WorkStealingPool>(numThreads);
+    }
+
+    RequestServer::~RequestServer()
+    {
+        finish();
+    }
+
+    void RequestServer::setCache(std::shared_ptr<SolutionCache> cache)
+    {
+        for (auto &worker : workers)
+        {
+            worker->setCache(cache);
+        }
+    }
+
+    void RequestServer::setMetrics(std::shared_ptr<ServiceMetrics> metrics)
+    {
+        for (auto &worker : workers)
+        {
+            worker->setMetrics(metrics);
+        }
+        metrics->watchQueue("serve", [this]()
+                            {
+                                std::lock_guard<std::mutex> lock(flightMutex);
+                                return static_cast<double>(inFlight); });
+    }
+
+    void RequestServer::submit(std::string request)
+    {
+        {
+            std::unique_lock<std::mutex> lock(flightMutex);
+            flightAvailable.wait(lock, [this]()
+                                 { return inFlight < maxInFlight; });
+            inFlight++;
+            requests++;
+        }
+
+        pool->submit([this, request = std::move(request)](int worker)
+                     {
+                         std::string response = workers[worker]->handle(request);
+                         {
+                             std::lock_guard<std::mutex> lock(respondMutex);
+                             respond(response);
+                         }
+                         {
+                             std::lock_guard<std::mutex> lock(flightMutex);
+                             inFlight--;
+                         }
+                         flightAvailable.notify_one(); });
+    }
+
+    void RequestServer::finish()
+    {
+        pool->wait();
+    }
+
+    std::string RequestServer::handle(std::string_view request)
+    {
+        return workers[0]->handle(request);
+    }
+
+} // namespace sudoku
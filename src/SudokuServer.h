@@ -0,0 +1,196 @@
+/**
+ * @file SudokuServer.h
+ * @brief Newline-delimited JSON request loop (sudoku_solve --serve)
+ *
+ * Requests, one JSON object per line. "id" is any JSON value and is echoed
+ * back verbatim; <puzzle> is a puzzle object (see SudokuJson.h) or a string
+ * in any text format the parser accepts.
+ *
+ *   {"id": 1, "op": "solve", "puzzle": <puzzle>, "unique": false}
+ *   {"id": 2, "op": "unique", "puzzle": <puzzle>}
+ *   {"id": 3, "op": "generate", "type": "mixed", "seed": 42, "difficulty": 50,
+ *    "cages": [10, 20], "inequalities": [10, 20], "givens": [0, 10],
+ *    "fillAll": false, "unique": true}
+ *   {"id": 4, "op": "verify", "puzzle": <puzzle>, "solution": [[5,3,4,...], ...]}
+ *   {"id": 5, "op": "metrics"}
+ *
+ * Responses, one line each, in completion order:
+ *
+ *   solve, unique  the solution object from SudokuJson.h
+ *   generate       {"id": 3, "puzzle": {...}, "solution": [[...], ...]}
+ *   verify         {"id": 4, "valid": true}
+ *   metrics        {"id": 5, "metrics": "<Prometheus text, see SudokuMetrics.h>"}
+ *   any error      {"id": ..., "error": "..."}
+ *
+ * Any request may also carry "deadlineMs", honored by SudokuDaemon.
+ *
+ * Requests are handed to a pool of workers, each with its own warm solver
+ * and generator, so the reader keeps accepting requests while earlier ones
+ * are still running. Queued requests start in arrival order (each worker
+ * takes the oldest request of its own deque, or steals another's oldest),
+ * so a burst of later requests never starves an earlier one.
+ */
+
+#ifndef SUDOKU_SERVER_H
+#define SUDOKU_SERVER_H
+
+#include "SudokuBatch.h"
+#include "SudokuGenerator.h"
+#include "SudokuMetrics.h"
+#include "SudokuSolver.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sudoku
+{
+
+    enum class RequestOp
+    {
+        SOLVE,
+        UNIQUE,
+        GENERATE,
+        VERIFY,
+        METRICS
+    };
+
+    /**
+     * @brief A parsed request line
+     */
+    struct ServerRequest
+    {
+        std::string id; // Raw JSON value, empty if absent
+        RequestOp op = RequestOp::SOLVE;
+        SudokuPuzzle puzzle;      // solve, unique, verify
+        SudokuSolution solution;  // verify
+        GeneratorConfig config;   // generate
+        bool checkUniqueness = false;
+        double deadlineMs = 0.0;  // 0 = none
+
+        bool isSolve() const { return op == RequestOp::SOLVE || op == RequestOp::UNIQUE; }
+    };
+
+    /**
+     * @brief Parses and answers requests with one warm solver and generator
+     *
+     * Not thread-safe; give every worker thread its own handler.
+     */
+    class RequestHandler
+    {
+    public:
+        /**
+         * @brief Parse a request line
+         * @param line One JSON object
+         * @param request Filled in; request.id is set as soon as it is read,
+         *        so it is available for the error response if parsing throws
+         * @throws std::runtime_error on a malformed request
+         */
+        static void parse(std::string_view line, ServerRequest &request);
+
+        /**
+         * @brief Append {"id":...,"error":"..."}
+         */
+        static void appendError(std::string &out, std::string_view id, std::string_view message);
+
+        void setCache(std::shared_ptr<SolutionCache> cache) { solver.setCache(std::move(cache)); }
+
+        /**
+         * @brief Record solves and generations, and answer "metrics" requests
+         */
+        void setMetrics(std::shared_ptr<ServiceMetrics> serviceMetrics) { metrics = std::move(serviceMetrics); }
+
+        /**
+         * @brief The op's name as used in requests and metric labels
+         */
+        static const char *opName(RequestOp op);
+
+        /**
+         * @brief Solve a solve or unique request
+         */
+        SudokuSolution solve(const ServerRequest &request);
+
+        /**
+         * @brief Append the response to a parsed request
+         * @throws std::runtime_error if the request cannot be answered
+         */
+        void answer(const ServerRequest &request, std::string &out);
+
+        /**
+         * @brief Parse and answer one line; errors become error responses
+         */
+        std::string handle(std::string_view line);
+
+    private:
+        SudokuSolver solver;
+        SudokuGenerator generator;
+        std::shared_ptr<ServiceMetrics> metrics;
+    };
+
+    /**
+     * @brief Answers JSON requests on a worker pool
+     */
+    class RequestServer
+    {
+    public:
+        using ResponseCallback = std::function<void(const std::string &response)>;
+
+        /**
+         * @brief Start the workers
+         * @param numThreads Number of worker threads (at least 1)
+         * @param respond Receives each response line (without newline);
+         *        calls are serialized
+         * @param maxInFlight Queued-but-unanswered requests before submit()
+         *        blocks (0 = 64 per thread)
+         */
+        RequestServer(int numThreads, ResponseCallback respond, size_t maxInFlight = 0);
+        ~RequestServer();
+
+        /**
+         * @brief Share a solution cache between all workers
+         */
+        void setCache(std::shared_ptr<SolutionCache> cache);
+
+        /**
+         * @brief Collect metrics from all workers, including the in-flight count
+         */
+        void setMetrics(std::shared_ptr<ServiceMetrics> metrics);
+
+        /**
+         * @brief Queue one request line; blocks while too many are in flight
+         */
+        void submit(std::string request);
+
+        /**
+         * @brief Block until every submitted request has been answered
+         */
+        void finish();
+
+        /**
+         * @brief Answer a request on the calling thread with worker 0's handler
+         *
+         * Not safe to call while requests submitted with submit() are running.
+         */
+        std::string handle(std::string_view request);
+
+        size_t getRequests() const { return requests; }
+
+    private:
+        ResponseCallback respond;
+        size_t maxInFlight;
+        std::vector<std::unique_ptr<RequestHandler>> workers;
+        std::unique_ptr<WorkStealingPool> pool;
+
+        std::mutex respondMutex;
+        std::mutex flightMutex;
+        std::condition_variable flightAvailable;
+        size_t inFlight = 0;
+        size_t requests = 0;
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_SERVER_H
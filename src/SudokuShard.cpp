@@ -0,0 +1,508 @@
+/**
+ * @file SudokuShard.cpp
+ * @brief Implementation of the corpus manifest and forked shard workers
+ */
+
+#include "SudokuShard.h"
+#include "SudokuCheckpoint.h"
+#include "SudokuJson.h"
+#include "SudokuParser.h"
+#include "SudokuSolver.h"
+#include "SudokuWriter.h"
+#include <algorithm>
+#include <csignal>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace sudoku
+{
+
+    namespace
+    {
+        const char *const kManifestHeader = "# sudoku corpus manifest";
+        const int kManifestVersion = 1;
+
+        // Lives in an anonymous shared mapping, visible to every worker
+        struct SharedState
+        {
+            std::atomic<uint64_t> nextChunk{0};
+            std::atomic<uint64_t> solved{0};
+            std::atomic<uint64_t> notUnique{0};
+            std::atomic<uint64_t> invalid{0};
+        };
+        static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                      "shared-memory counters must not rely on a process-local lock");
+
+        bool parseRecord(std::string_view record, CorpusFormat format, SudokuPuzzle &puzzle)
+        {
+            if (SudokuParser::parseCompactGrid(record, puzzle))
+            {
+                return true;
+            }
+            try
+            {
+                if (SudokuJson::isJson(record))
+                {
+                    puzzle = SudokuJson::parsePuzzle(record);
+                    return true;
+                }
+                if (format == CorpusFormat::BLOCKS)
+                {
+                    puzzle = SudokuParser::parseFromString(std::string(record));
+                    return true;
+                }
+            }
+            catch (const std::exception &)
+            {
+            }
+            return false;
+        }
+
+        /**
+         * @brief Claim and solve chunks until none are left
+         * @param pending Chunks to solve, claimed in order through state.nextChunk
+         * @param out Mapping of the shard's output; record firstRecord is at offset 0
+         * @param done One flag per pending chunk, set once its results are written
+         */
+        void solveChunks(std::string_view text, const CorpusManifest &manifest, const std::vector<size_t> &pending,
+                         uint64_t firstRecord, char *out, SharedState &state, std::atomic<uint8_t> *done,
+                         bool checkUniqueness)
+        {
+            SudokuSolver solver;
+            for (;;)
+            {
+                uint64_t claimed = state.nextChunk.fetch_add(1, std::memory_order_relaxed);
+                if (claimed >= pending.size())
+                {
+                    return;
+                }
+
+                const CorpusManifest::Chunk &chunk = manifest.chunks[pending[claimed]];
+                CorpusReader reader(text, CorpusReader::Range{chunk.begin, chunk.end}, manifest.format);
+                char *line = out + (chunk.firstRecord - firstRecord) * ShardRunner::RECORD_BYTES;
+                uint64_t solved = 0;
+                uint64_t notUnique = 0;
+                uint64_t invalid = 0;
+
+                std::string_view record;
+                for (uint64_t i = 0; i < chunk.records && reader.next(record); i++, line += ShardRunner::RECORD_BYTES)
+                {
+                    SudokuPuzzle puzzle;
+                    if (!parseRecord(record, manifest.format, puzzle))
+                    {
+                        invalid++;
+                        continue;
+                    }
+                    SudokuSolution solution;
+                    try
+                    {
+                        solution = solver.solve(puzzle, checkUniqueness);
+                    }
+                    catch (const std::exception &)
+                    {
+                        invalid++;
+                        continue;
+                    }
+                    if (!solution.solved)
+                    {
+                        continue; // The line was prefilled with dots
+                    }
+                    SudokuWriter::writeGridLine(solution.grid, line);
+                    solved++;
+                    if (checkUniqueness && !solution.isUnique())
+                    {
+                        notUnique++;
+                    }
+                }
+
+                state.solved.fetch_add(solved, std::memory_order_relaxed);
+                state.notUnique.fetch_add(notUnique, std::memory_order_relaxed);
+                state.invalid.fetch_add(invalid, std::memory_order_relaxed);
+                done[claimed].store(1, std::memory_order_release);
+            }
+        }
+
+        const char *formatName(CorpusFormat format)
+        {
+            return format == CorpusFormat::BLOCKS ? "blocks" : "lines";
+        }
+    } // namespace
+
+    CorpusManifest CorpusManifest::build(std::string_view text, size_t recordsPerChunk, CorpusFormat format)
+    {
+        if (recordsPerChunk == 0)
+        {
+            recordsPerChunk = 1;
+        }
+
+        CorpusManifest manifest;
+        manifest.format = format == CorpusFormat::AUTO ? CorpusReader::detectFormat(text) : format;
+        manifest.corpusBytes = text.size();
+
+        CorpusReader reader(text, manifest.format);
+        std::string_view record;
+        while (reader.next(record))
+        {
+            if (manifest.totalRecords % recordsPerChunk == 0)
+            {
+                // A chunk starts at its first record; the first chunk also keeps any leading comments
+                uint64_t begin = manifest.chunks.empty() ? 0 : static_cast<uint64_t>(record.data() - text.data());
+                if (!manifest.chunks.empty())
+                {
+                    manifest.chunks.back().end = begin;
+                }
+                manifest.chunks.push_back(Chunk{begin, text.size(), manifest.totalRecords, 0});
+            }
+            manifest.chunks.back().records++;
+            manifest.totalRecords++;
+        }
+        return manifest;
+    }
+
+    CorpusManifest CorpusManifest::load(const std::string &path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Cannot open manifest: " + path);
+        }
+
+        auto malformed = [&path]()
+        {
+            return std::runtime_error("Malformed manifest: " + path);
+        };
+
+        std::string line;
+        if (!std::getline(file, line) || line != kManifestHeader)
+        {
+            throw malformed();
+        }
+
+        CorpusManifest manifest;
+        std::string key;
+        std::string format;
+        int version = 0;
+        size_t numChunks = 0;
+        if (!(file >> key >> version) || key != "version" || version != kManifestVersion ||
+            !(file >> key >> format) || key != "format" || (format != "lines" && format != "blocks") ||
+            !(file >> key >> manifest.corpusBytes) || key != "bytes" ||
+            !(file >> key >> manifest.totalRecords) || key != "records" ||
+            !(file >> key >> numChunks) || key != "chunks")
+        {
+            throw malformed();
+        }
+        manifest.format = format == "blocks" ? CorpusFormat::BLOCKS : CorpusFormat::LINES;
+
+        uint64_t expectedRecord = 0;
+        uint64_t expectedBegin = 0;
+        manifest.chunks.reserve(std::min<size_t>(numChunks, 1 << 20));
+        for (size_t i = 0; i < numChunks; i++)
+        {
+            Chunk chunk{};
+            if (!(file >> chunk.begin >> chunk.end >> chunk.firstRecord >> chunk.records) ||
+                chunk.begin != expectedBegin || chunk.end < chunk.begin || chunk.end > manifest.corpusBytes ||
+                chunk.firstRecord != expectedRecord)
+            {
+                throw malformed();
+            }
+            expectedBegin = chunk.end;
+            expectedRecord += chunk.records;
+            manifest.chunks.push_back(chunk);
+        }
+        if (expectedRecord != manifest.totalRecords)
+        {
+            throw malformed();
+        }
+        return manifest;
+    }
+
+    void CorpusManifest::save(const std::string &path) const
+    {
+        std::ostringstream text;
+        text << kManifestHeader << "\n";
+        text << "version " << kManifestVersion << "\n";
+        text << "format " << formatName(format) << "\n";
+        text << "bytes " << corpusBytes << "\n";
+        text << "records " << totalRecords << "\n";
+        text << "chunks " << chunks.size() << "\n";
+        for (const Chunk &chunk : chunks)
+        {
+            text << chunk.begin << ' ' << chunk.end << ' ' << chunk.firstRecord << ' ' << chunk.records << "\n";
+        }
+
+        std::ofstream file(path);
+        if (!file.is_open() || !(file << text.str()) || !file.flush())
+        {
+            throw std::runtime_error("Cannot write manifest: " + path);
+        }
+    }
+
+    std::pair<size_t, size_t> CorpusManifest::shardChunks(int shardId, int numShards) const
+    {
+        if (numShards < 1 || shardId < 0 || shardId >= numShards)
+        {
+            throw std::runtime_error("Invalid shard " + std::to_string(shardId) + " of " + std::to_string(numShards));
+        }
+        size_t first = chunks.size() * static_cast<size_t>(shardId) / static_cast<size_t>(numShards);
+        size_t last = chunks.size() * static_cast<size_t>(shardId + 1) / static_cast<size_t>(numShards);
+        return {first, last};
+    }
+
+    ShardRunner::ShardRunner(ShardConfig config)
+        : config(config)
+    {
+        if (this->config.workers < 1)
+        {
+            this->config.workers = 1;
+        }
+    }
+
+    ShardStats ShardRunner::run(const std::string &corpusPath, const CorpusManifest &manifest,
+                                const std::string &outputPath)
+    {
+        MappedFile corpus(corpusPath);
+        if (corpus.size() != manifest.corpusBytes)
+        {
+            throw std::runtime_error("Manifest was built for a different corpus: " + corpusPath);
+        }
+
+        auto [firstChunk, lastChunk] = manifest.shardChunks(config.shardId, config.numShards);
+        ShardStats stats;
+        uint64_t firstRecord = 0;
+        uint64_t shardRecords = 0;
+        if (lastChunk > firstChunk)
+        {
+            firstRecord = manifest.chunks[firstChunk].firstRecord;
+            shardRecords = manifest.chunks[lastChunk - 1].firstRecord + manifest.chunks[lastChunk - 1].records -
+                           firstRecord;
+        }
+        size_t outputBytes = static_cast<size_t>(shardRecords) * RECORD_BYTES;
+
+        // Chunks finished before the checkpoint keep their output and are not claimed again
+        bool checkpointing = !config.checkpointPath.empty();
+        std::string job = "shard " + corpusPath + ' ' + std::to_string(config.shardId) + '/' +
+                          std::to_string(config.numShards) + (config.checkUniqueness ? " unique" : "");
+        JobCheckpoint checkpoint(job);
+        bool resuming = false;
+        if (checkpointing && config.resume && std::ifstream(config.checkpointPath).good())
+        {
+            checkpoint = JobCheckpoint::load(config.checkpointPath);
+            if (checkpoint.getJob() != job)
+            {
+                throw std::runtime_error("Checkpoint " + config.checkpointPath + " is for another job (" +
+                                         checkpoint.getJob() + ")");
+            }
+            resuming = true;
+        }
+        std::vector<size_t> pending;
+        for (size_t c = firstChunk; c < lastChunk; c++)
+        {
+            if (resuming && checkpoint.isCompleted(manifest.chunks[c].firstRecord))
+            {
+                stats.resumed += manifest.chunks[c].records;
+            }
+            else
+            {
+                pending.push_back(c);
+            }
+        }
+        stats.records = shardRecords - stats.resumed;
+
+        // The output file is sized up front; workers write into a shared mapping of it
+        int fd = ::open(outputPath.c_str(), resuming ? O_RDWR | O_CREAT : O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot write to file " + outputPath);
+        }
+        struct stat info;
+        if (resuming && (::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) != outputBytes))
+        {
+            ::close(fd);
+            throw std::runtime_error("Output " + outputPath + " does not match its checkpoint; cannot resume");
+        }
+        if (outputBytes == 0)
+        {
+            ::close(fd);
+            return stats;
+        }
+        if (!resuming && ::ftruncate(fd, static_cast<off_t>(outputBytes)) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot size output file " + outputPath);
+        }
+        void *outputRegion = ::mmap(nullptr, outputBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (outputRegion == MAP_FAILED)
+        {
+            throw std::runtime_error("Cannot map output file " + outputPath);
+        }
+        char *out = static_cast<char *>(outputRegion);
+
+        // Every record reads as unsolved until a worker overwrites it
+        if (!resuming)
+        {
+            for (size_t offset = 0; offset < outputBytes; offset += RECORD_BYTES)
+            {
+                std::memset(out + offset, '.', RECORD_BYTES - 1);
+                out[offset + RECORD_BYTES - 1] = '\n';
+            }
+        }
+
+        // Counters, then one done flag per pending chunk
+        size_t stateBytes = sizeof(SharedState) + pending.size();
+        void *stateRegion = ::mmap(nullptr, stateBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (stateRegion == MAP_FAILED)
+        {
+            ::munmap(outputRegion, outputBytes);
+            throw std::runtime_error("Cannot map shared memory");
+        }
+        SharedState *state = new (stateRegion) SharedState();
+        auto *done = reinterpret_cast<std::atomic<uint8_t> *>(static_cast<char *>(stateRegion) + sizeof(SharedState));
+        for (size_t i = 0; i < pending.size(); i++)
+        {
+            new (&done[i]) std::atomic<uint8_t>(0);
+        }
+
+        // Results are flushed to disk before the chunks holding them are recorded
+        auto saveCheckpoint = [&]()
+        {
+            ::msync(outputRegion, outputBytes, MS_SYNC);
+            for (size_t i = 0; i < pending.size(); i++)
+            {
+                if (done[i].load(std::memory_order_acquire))
+                {
+                    const CorpusManifest::Chunk &chunk = manifest.chunks[pending[i]];
+                    checkpoint.markCompleted(chunk.firstRecord, chunk.firstRecord + chunk.records);
+                }
+            }
+            checkpoint.setOutputBytes(outputBytes);
+            checkpoint.save(config.checkpointPath);
+        };
+
+        std::vector<pid_t> workers;
+        int numWorkers = static_cast<int>(std::min<size_t>(static_cast<size_t>(config.workers), pending.size()));
+        for (int i = 0; i < numWorkers; i++)
+        {
+            pid_t pid = ::fork();
+            if (pid < 0)
+            {
+                break; // Run with the workers started so far
+            }
+            if (pid == 0)
+            {
+#ifdef __linux__
+                // Do not outlive a killed parent; its checkpoint would not record our chunks
+                ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+                int status = 0;
+                try
+                {
+                    solveChunks(corpus.contents(), manifest, pending, firstRecord, out, *state, done,
+                                config.checkUniqueness);
+                }
+                catch (...)
+                {
+                    status = 1;
+                }
+                ::_exit(status);
+            }
+            workers.push_back(pid);
+        }
+
+        if (workers.empty() && !pending.empty())
+        {
+            solveChunks(corpus.contents(), manifest, pending, firstRecord, out, *state, done,
+                        config.checkUniqueness);
+        }
+
+        // Poll while checkpointing, otherwise just wait
+        CheckpointTimer checkpointTimer(config.checkpointSeconds);
+        std::vector<bool> exited(workers.size(), false);
+        size_t running = workers.size();
+        while (running > 0)
+        {
+            for (size_t i = 0; i < workers.size(); i++)
+            {
+                if (exited[i])
+                {
+                    continue;
+                }
+                int status = 0;
+                pid_t result = ::waitpid(workers[i], &status, checkpointing ? WNOHANG : 0);
+                if (result == 0 || (result < 0 && errno == EINTR))
+                {
+                    continue;
+                }
+                exited[i] = true;
+                running--;
+                if (result < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                {
+                    stats.failedWorkers++;
+                }
+            }
+            if (running > 0 && checkpointing)
+            {
+                if (checkpointTimer.due())
+                {
+                    try
+                    {
+                        saveCheckpoint();
+                    }
+                    catch (const std::exception &)
+                    {
+                        // Retried at the next interval; the final save reports errors
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }
+
+        stats.solved = state->solved.load();
+        stats.notUnique = state->notUnique.load();
+        stats.invalid = state->invalid.load();
+        bool saved = true;
+        std::string saveError;
+        if (checkpointing)
+        {
+            try
+            {
+                saveCheckpoint();
+            }
+            catch (const std::exception &e)
+            {
+                saved = false;
+                saveError = e.what();
+            }
+        }
+        state->~SharedState();
+        ::munmap(stateRegion, stateBytes);
+
+        bool synced = ::msync(outputRegion, outputBytes, MS_SYNC) == 0;
+        ::munmap(outputRegion, outputBytes);
+        if (!synced)
+        {
+            throw std::runtime_error("Cannot write to file " + outputPath);
+        }
+        if (!saved)
+        {
+            throw std::runtime_error(saveError);
+        }
+        return stats;
+    }
+
+} // namespace sudoku
@@ -0,0 +1,135 @@
+/**
+ * @file SudokuShard.h
+ * @brief Multi-process sharded batch solving (sudoku_solve --batch --shard)
+ *
+ * A corpus manifest cuts a corpus into chunks of a fixed number of records
+ * and records, for each chunk, its byte range and the index of its first
+ * record. From it:
+ *
+ * - ShardRunner forks worker processes that claim chunks through an atomic
+ *   cursor in shared memory, read their records straight from the
+ *   memory-mapped corpus, and write each result as a fixed-size line at the
+ *   record's index in a shared mapping of the output file. Nothing passes
+ *   through pipes and results are never serialized or reordered.
+ *
+ * - Several hosts holding a copy of the corpus and the same manifest can
+ *   each solve one shard (a contiguous run of chunks); concatenating the
+ *   shard outputs in shard order gives the output of the whole corpus.
+ *
+ * Output lines are the same as those of an ordered --batch run: the solved
+ * grid as 81 characters, or 81 dots when a record is invalid or unsolvable.
+ *
+ * With a checkpoint path, the parent periodically syncs the output and
+ * records the finished chunks' index ranges; a resumed run keeps the output
+ * file and only claims the chunks still missing.
+ */
+
+#ifndef SUDOKU_SHARD_H
+#define SUDOKU_SHARD_H
+
+#include "SudokuCorpus.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Chunk table of a corpus, shared by every worker and host
+     */
+    struct CorpusManifest
+    {
+        struct Chunk
+        {
+            uint64_t begin;       // Byte range [begin, end) in the corpus
+            uint64_t end;
+            uint64_t firstRecord; // Index of the chunk's first record in the corpus
+            uint64_t records;
+        };
+
+        CorpusFormat format = CorpusFormat::LINES;
+        uint64_t corpusBytes = 0; // Size of the corpus the manifest was built from
+        uint64_t totalRecords = 0;
+        std::vector<Chunk> chunks;
+
+        /**
+         * @brief Scan a corpus and cut it into chunks
+         * @param recordsPerChunk Records per chunk; the last one may hold fewer
+         */
+        static CorpusManifest build(std::string_view text, size_t recordsPerChunk = 4096,
+                                    CorpusFormat format = CorpusFormat::AUTO);
+
+        /**
+         * @brief Read or write the manifest as text
+         * @throws std::runtime_error if the file cannot be accessed or is malformed
+         */
+        static CorpusManifest load(const std::string &path);
+        void save(const std::string &path) const;
+
+        /**
+         * @brief Chunks [first, last) making up one of numShards shards
+         */
+        std::pair<size_t, size_t> shardChunks(int shardId, int numShards) const;
+    };
+
+    /**
+     * @brief Sharded run settings
+     */
+    struct ShardConfig
+    {
+        int workers = 1;              // Worker processes
+        bool checkUniqueness = false;
+        int shardId = 0;              // This host's shard, in [0, numShards)
+        int numShards = 1;
+        std::string checkpointPath;   // Progress file (empty = none), see SudokuCheckpoint.h
+        double checkpointSeconds = 10.0;
+        bool resume = false;          // Skip the chunks the checkpoint records as finished
+    };
+
+    /**
+     * @brief Totals over the records of one shard
+     */
+    struct ShardStats
+    {
+        uint64_t records = 0;  // Solved in this run
+        uint64_t resumed = 0;  // Finished before the checkpoint and skipped
+        uint64_t solved = 0;
+        uint64_t notUnique = 0;
+        uint64_t invalid = 0;
+        int failedWorkers = 0; // Workers that crashed; their unfinished records read as dots
+    };
+
+    /**
+     * @brief Solves one shard of a corpus in forked worker processes
+     */
+    class ShardRunner
+    {
+    public:
+        explicit ShardRunner(ShardConfig config);
+
+        /**
+         * @brief Solve the shard and write its results
+         *
+         * Forks, so call it while the process has no other threads running.
+         * @param corpusPath Corpus file; its size must match the manifest
+         * @param outputPath Created or truncated to 82 bytes per record of the shard
+         * @throws std::runtime_error on I/O errors or a mismatched manifest
+         */
+        ShardStats run(const std::string &corpusPath, const CorpusManifest &manifest,
+                       const std::string &outputPath);
+
+        /**
+         * @brief Bytes written per record: the grid and a newline
+         */
+        static constexpr size_t RECORD_BYTES = 82;
+
+    private:
+        ShardConfig config;
+    };
+
+} // namespace sudoku
+
+#endif // SUDOKU_SHARD_H
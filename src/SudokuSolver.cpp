@@ -4,102 +4,102 @@
  */
 
 #include "SudokuSolver.h"
+#include "SudokuTopology.h"
 #include <set>
+#include <cstdint>
+#include <chrono>
 
 namespace sudoku
 {
 
-    SudokuSolver::SudokuSolver()
+    template <class Geo>
+    BasicSudokuSolver<Geo>::BasicSudokuSolver()
     {
     }
 
-    SudokuSolver::~SudokuSolver()
+    template <class Geo>
+    BasicSudokuSolver<Geo>::~BasicSudokuSolver()
     {
     }
 
-    SudokuSolution SudokuSolver::solve(const SudokuPuzzle &puzzle, bool checkUniqueness)
+    template <class Geo>
+    BasicSudokuSolution<Geo> BasicSudokuSolver<Geo>::solve(const Puzzle &puzzle, bool checkUniqueness)
     {
-        return encoder.solve(puzzle, checkUniqueness);
+        if (!cache)
+        {
+            Solution solution = encoder.solve(puzzle, checkUniqueness);
+            lastStats = encoder.getLastStats();
+            return solution;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        PuzzleHash hash = hashPuzzle(puzzle);
+
+        Solution solution;
+        if (cache->lookup(hash, checkUniqueness, solution))
+        {
+            auto endTime = std::chrono::high_resolution_clock::now();
+            solution.solveTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+            lastStats = SolveStats();
+            lastStats.cached = true;
+            return solution;
+        }
+
+        solution = encoder.solve(puzzle, checkUniqueness);
+        lastStats = encoder.getLastStats();
+        if (!lastStats.interrupted)
+        {
+            cache->store(hash, solution);
+        }
+        return solution;
     }
 
-    SudokuSolution SudokuSolver::solveFromString(const std::string &input, bool checkUniqueness)
+    template <class Geo>
+    BasicSudokuSolution<Geo> BasicSudokuSolver<Geo>::solveFromString(const std::string &input, bool checkUniqueness)
     {
-        SudokuPuzzle puzzle = SudokuParser::parseFromString(input);
+        Puzzle puzzle = BasicSudokuParser<Geo>::parseFromString(input);
         return solve(puzzle, checkUniqueness);
     }
 
-    SudokuSolution SudokuSolver::solveFromFile(const std::string &filename, bool checkUniqueness)
+    template <class Geo>
+    BasicSudokuSolution<Geo> BasicSudokuSolver<Geo>::solveFromFile(const std::string &filename, bool checkUniqueness)
     {
-        SudokuPuzzle puzzle = SudokuParser::parseFromFile(filename);
+        Puzzle puzzle = BasicSudokuParser<Geo>::parseFromFile(filename);
         return solve(puzzle, checkUniqueness);
     }
 
-    bool SudokuSolver::verifyBasicConstraints(const SudokuSolution &solution)
+    template <class Geo>
+    bool BasicSudokuSolver<Geo>::verifyBasicConstraints(const Solution &solution)
     {
-        // Check that all cells have valid values
-        for (int row = 0; row < GRID_SIZE; row++)
-        {
-            for (int col = 0; col < GRID_SIZE; col++)
-            {
-                int val = solution.grid[row][col];
-                if (val < MIN_VALUE || val > MAX_VALUE)
-                {
-                    return false;
-                }
-            }
-        }
+        const int *cells = &solution.grid[0][0];
 
-        // Check row constraints
-        for (int row = 0; row < GRID_SIZE; row++)
+        // Check that all cells have valid values
+        for (int cell = 0; cell < Topology::NUM_CELLS; cell++)
         {
-            std::set<int> seen;
-            for (int col = 0; col < GRID_SIZE; col++)
+            if (cells[cell] < MIN_VALUE || cells[cell] > MAX_VALUE)
             {
-                int val = solution.grid[row][col];
-                if (seen.count(val))
-                    return false;
-                seen.insert(val);
+                return false;
             }
         }
 
-        // Check column constraints
-        for (int col = 0; col < GRID_SIZE; col++)
+        // Check row, column and box constraints
+        for (const auto &unit : Topology::UNITS)
         {
-            std::set<int> seen;
-            for (int row = 0; row < GRID_SIZE; row++)
+            uint64_t seen = 0;
+            for (int cell : unit)
             {
-                int val = solution.grid[row][col];
-                if (seen.count(val))
+                uint64_t bit = uint64_t(1) << cells[cell];
+                if (seen & bit)
                     return false;
-                seen.insert(val);
-            }
-        }
-
-        // Check box constraints
-        for (int boxRow = 0; boxRow < BOX_SIZE; boxRow++)
-        {
-            for (int boxCol = 0; boxCol < BOX_SIZE; boxCol++)
-            {
-                std::set<int> seen;
-                for (int r = 0; r < BOX_SIZE; r++)
-                {
-                    for (int c = 0; c < BOX_SIZE; c++)
-                    {
-                        int row = boxRow * BOX_SIZE + r;
-                        int col = boxCol * BOX_SIZE + c;
-                        int val = solution.grid[row][col];
-                        if (seen.count(val))
-                            return false;
-                        seen.insert(val);
-                    }
-                }
+                seen |= bit;
             }
         }
 
         return true;
     }
 
-    bool SudokuSolver::verifyGivenValues(const SudokuPuzzle &puzzle, const SudokuSolution &solution)
+    template <class Geo>
+    bool BasicSudokuSolver<Geo>::verifyGivenValues(const Puzzle &puzzle, const Solution &solution)
     {
         for (int row = 0; row < GRID_SIZE; row++)
         {
@@ -118,7 +118,8 @@ namespace sudoku
         return true;
     }
 
-    bool SudokuSolver::verifyCageConstraints(const SudokuPuzzle &puzzle, const SudokuSolution &solution)
+    template <class Geo>
+    bool BasicSudokuSolver<Geo>::verifyCageConstraints(const Puzzle &puzzle, const Solution &solution)
     {
         for (const auto &cage : puzzle.cages)
         {
@@ -144,7 +145,8 @@ namespace sudoku
         return true;
     }
 
-    bool SudokuSolver::verifyInequalityConstraints(const SudokuPuzzle &puzzle, const SudokuSolution &solution)
+    template <class Geo>
+    bool BasicSudokuSolver<Geo>::verifyInequalityConstraints(const Puzzle &puzzle, const Solution &solution)
     {
         for (const auto &ineq : puzzle.inequalities)
         {
@@ -169,7 +171,8 @@ namespace sudoku
         return true;
     }
 
-    bool SudokuSolver::verifySolution(const SudokuPuzzle &puzzle, const SudokuSolution &solution)
+    template <class Geo>
+    bool BasicSudokuSolver<Geo>::verifySolution(const Puzzle &puzzle, const Solution &solution)
     {
         if (!solution.solved)
         {
@@ -205,4 +208,8 @@ namespace sudoku
         return true;
     }
 
+#define SUDOKU_INSTANTIATE_SOLVER(R, C) template class BasicSudokuSolver<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_SOLVER)
+#undef SUDOKU_INSTANTIATE_SOLVER
+
 } // namespace sudoku
@@ -9,6 +9,8 @@
 #include "SudokuTypes.h"
 #include "SudokuEncoder.h"
 #include "SudokuParser.h"
+#include "SudokuCache.h"
+#include <memory>
 
 namespace sudoku
 {
@@ -17,12 +19,17 @@ namespace sudoku
      * @brief High-level Sudoku solver class
      *
      * Provides a simple interface for solving all types of Sudoku puzzles.
+     * Instantiated for every geometry in SUDOKU_FOR_EACH_GEOMETRY.
      */
-    class SudokuSolver
+    template <class Geo>
+    class BasicSudokuSolver
     {
     public:
-        SudokuSolver();
-        ~SudokuSolver();
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Solution = BasicSudokuSolution<Geo>;
+
+        BasicSudokuSolver();
+        ~BasicSudokuSolver();
 
         /**
          * @brief Solve a Sudoku puzzle
@@ -30,7 +37,7 @@ namespace sudoku
          * @param checkUniqueness If true, verify that the solution is unique
          * @return The solution
          */
-        SudokuSolution solve(const SudokuPuzzle &puzzle, bool checkUniqueness = false);
+        Solution solve(const Puzzle &puzzle, bool checkUniqueness = false);
 
         /**
          * @brief Solve a Sudoku from a string
@@ -38,7 +45,7 @@ namespace sudoku
          * @param checkUniqueness If true, verify that the solution is unique
          * @return The solution
          */
-        SudokuSolution solveFromString(const std::string &input, bool checkUniqueness = false);
+        Solution solveFromString(const std::string &input, bool checkUniqueness = false);
 
         /**
          * @brief Solve a Sudoku from a file
@@ -46,7 +53,7 @@ namespace sudoku
          * @param checkUniqueness If true, verify that the solution is unique
          * @return The solution
          */
-        SudokuSolution solveFromFile(const std::string &filename, bool checkUniqueness = false);
+        Solution solveFromFile(const std::string &filename, bool checkUniqueness = false);
 
         /**
          * @brief Verify that a solution is valid
@@ -54,7 +61,24 @@ namespace sudoku
          * @param solution The solution to verify
          * @return true if the solution is valid
          */
-        static bool verifySolution(const SudokuPuzzle &puzzle, const SudokuSolution &solution);
+        static bool verifySolution(const Puzzle &puzzle, const Solution &solution);
+
+        /**
+         * @brief Attach a solution cache, or detach it with nullptr
+         *
+         * Caching is off by default. A cache may be shared between solvers.
+         */
+        void setCache(std::shared_ptr<BasicSolutionCache<Geo>> solutionCache) { cache = std::move(solutionCache); }
+
+        /**
+         * @brief Attach a new private cache holding up to capacity solutions
+         */
+        void enableCache(size_t capacity = BasicSolutionCache<Geo>::DEFAULT_CAPACITY)
+        {
+            cache = std::make_shared<BasicSolutionCache<Geo>>(capacity);
+        }
+
+        std::shared_ptr<BasicSolutionCache<Geo>> getCache() const { return cache; }
 
         /**
          * @brief Get statistics from the last solve
@@ -62,16 +86,38 @@ namespace sudoku
         int getNumVariables() const { return encoder.getNumVariables(); }
         int getNumClauses() const { return encoder.getNumClauses(); }
 
+        /**
+         * @brief Timings and SAT counters of the last solve
+         */
+        const SolveStats &getLastStats() const { return lastStats; }
+
+        /**
+         * @brief Stop the running solve from another thread (see BasicSudokuEncoder::interrupt)
+         */
+        void interrupt() { encoder.interrupt(); }
+        void clearInterrupt() { encoder.clearInterrupt(); }
+
     private:
-        SudokuEncoder encoder;
+        using Topology = BasicTopology<Geo>;
+
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int MIN_VALUE = Geo::MIN_VALUE;
+        static constexpr int MAX_VALUE = Geo::MAX_VALUE;
+
+        BasicSudokuEncoder<Geo> encoder;
+        std::shared_ptr<BasicSolutionCache<Geo>> cache;
+        SolveStats lastStats;
 
         // Verification helpers
-        static bool verifyBasicConstraints(const SudokuSolution &solution);
-        static bool verifyGivenValues(const SudokuPuzzle &puzzle, const SudokuSolution &solution);
-        static bool verifyCageConstraints(const SudokuPuzzle &puzzle, const SudokuSolution &solution);
-        static bool verifyInequalityConstraints(const SudokuPuzzle &puzzle, const SudokuSolution &solution);
+        static bool verifyBasicConstraints(const Solution &solution);
+        static bool verifyGivenValues(const Puzzle &puzzle, const Solution &solution);
+        static bool verifyCageConstraints(const Puzzle &puzzle, const Solution &solution);
+        static bool verifyInequalityConstraints(const Puzzle &puzzle, const Solution &solution);
     };
 
+    // Classic 9x9 solver
+    using SudokuSolver = BasicSudokuSolver<StandardGeometry>;
+
 } // namespace sudoku
 
 #endif // SUDOKU_SOLVER_H
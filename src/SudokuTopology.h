@@ -0,0 +1,320 @@
+/**
+ * @file SudokuTopology.h
+ * @brief Compile-time grid topology tables
+ *
+ * Provides flat, constexpr lookup tables describing the structure of the grid:
+ * - The 3N units (N rows, N columns, N boxes) as cell index lists
+ * - The 3 units and the peers of every cell (20 on a 9x9 grid)
+ * - The orthogonal neighbours of every cell
+ * - The 2N(N-1) orthogonally adjacent cell pairs (144 on a 9x9 grid)
+ * - Cell masks for every unit and peer set
+ *
+ * BasicTopology<Geo> exposes the tables for any Geometry; the topology
+ * namespace also provides the standard 9x9 tables directly.
+ *
+ * Cells are addressed by a flat index: row * GRID_SIZE + col.
+ */
+
+#ifndef SUDOKU_TOPOLOGY_H
+#define SUDOKU_TOPOLOGY_H
+
+#include "SudokuTypes.h"
+#include <array>
+#include <cstdint>
+
+namespace sudoku
+{
+    namespace topology
+    {
+
+        constexpr int UNITS_PER_CELL = 3;
+        constexpr int MAX_NEIGHBOURS = 4;
+
+        /**
+         * @brief A set of cells stored as a bit mask
+         */
+        template <int NumCells>
+        struct BasicCellMask
+        {
+            static constexpr int NUM_WORDS = (NumCells + 63) / 64;
+
+            uint64_t words[NUM_WORDS] = {};
+
+            constexpr void set(int index) { words[index >> 6] |= uint64_t(1) << (index & 63); }
+            constexpr void reset(int index) { words[index >> 6] &= ~(uint64_t(1) << (index & 63)); }
+            constexpr bool test(int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+            constexpr bool any() const
+            {
+                for (int i = 0; i < NUM_WORDS; i++)
+                {
+                    if (words[i])
+                        return true;
+                }
+                return false;
+            }
+            constexpr bool intersects(const BasicCellMask &other) const
+            {
+                for (int i = 0; i < NUM_WORDS; i++)
+                {
+                    if (words[i] & other.words[i])
+                        return true;
+                }
+                return false;
+            }
+            constexpr BasicCellMask &operator|=(const BasicCellMask &other)
+            {
+                for (int i = 0; i < NUM_WORDS; i++)
+                {
+                    words[i] |= other.words[i];
+                }
+                return *this;
+            }
+            constexpr bool operator==(const BasicCellMask &other) const
+            {
+                for (int i = 0; i < NUM_WORDS; i++)
+                {
+                    if (words[i] != other.words[i])
+                        return false;
+                }
+                return true;
+            }
+        };
+
+        /**
+         * @brief Orthogonal neighbours of a cell (2 to 4 entries)
+         */
+        struct Neighbours
+        {
+            int count = 0;
+            std::array<int, MAX_NEIGHBOURS> cells = {};
+
+            constexpr const int *begin() const { return cells.data(); }
+            constexpr const int *end() const { return cells.data() + count; }
+        };
+
+        /**
+         * @brief An orthogonally adjacent pair (first < second)
+         */
+        struct AdjacentPair
+        {
+            int first = 0;
+            int second = 0;
+        };
+
+        /**
+         * @brief All topology tables for one geometry
+         */
+        template <class Geo>
+        struct BasicTables
+        {
+            static constexpr int N = Geo::GRID_SIZE;
+            static constexpr int NUM_CELLS = Geo::NUM_CELLS;
+            static constexpr int NUM_PEERS = 2 * (N - 1) + (Geo::BOX_ROWS - 1) * (Geo::BOX_COLS - 1);
+            static constexpr int NUM_ADJACENT_PAIRS = 2 * N * (N - 1);
+
+            std::array<std::array<int, N>, 3 * N> units = {};
+            std::array<std::array<int, UNITS_PER_CELL>, NUM_CELLS> cellUnits = {};
+            std::array<std::array<int, NUM_PEERS>, NUM_CELLS> peers = {};
+            std::array<Neighbours, NUM_CELLS> neighbours = {};
+            std::array<AdjacentPair, NUM_ADJACENT_PAIRS> adjacentPairs = {};
+            std::array<BasicCellMask<NUM_CELLS>, 3 * N> unitMasks = {};
+            std::array<BasicCellMask<NUM_CELLS>, NUM_CELLS> peerMasks = {};
+        };
+
+        template <class Geo>
+        constexpr BasicTables<Geo> buildTables()
+        {
+            constexpr int N = Geo::GRID_SIZE;
+            constexpr int BR = Geo::BOX_ROWS;
+            constexpr int BC = Geo::BOX_COLS;
+            BasicTables<Geo> t{};
+
+            // Units: rows first, then columns, then boxes (row-major box order)
+            for (int i = 0; i < N; i++)
+            {
+                int boxTop = (i / BR) * BR;
+                int boxLeft = (i % BR) * BC;
+                for (int j = 0; j < N; j++)
+                {
+                    t.units[i][j] = i * N + j;
+                    t.units[N + i][j] = j * N + i;
+                    t.units[2 * N + i][j] = (boxTop + j / BC) * N + boxLeft + j % BC;
+                }
+            }
+
+            for (int u = 0; u < 3 * N; u++)
+            {
+                for (int j = 0; j < N; j++)
+                {
+                    t.unitMasks[u].set(t.units[u][j]);
+                }
+            }
+
+            for (int cell = 0; cell < Geo::NUM_CELLS; cell++)
+            {
+                int row = cell / N;
+                int col = cell % N;
+                t.cellUnits[cell][0] = row;
+                t.cellUnits[cell][1] = N + col;
+                t.cellUnits[cell][2] = 2 * N + (row / BR) * BR + col / BC;
+
+                BasicCellMask<Geo::NUM_CELLS> mask;
+                for (int k = 0; k < UNITS_PER_CELL; k++)
+                {
+                    mask |= t.unitMasks[t.cellUnits[cell][k]];
+                }
+                mask.reset(cell);
+                t.peerMasks[cell] = mask;
+
+                int n = 0;
+                for (int other = 0; other < Geo::NUM_CELLS; other++)
+                {
+                    if (mask.test(other))
+                    {
+                        t.peers[cell][n++] = other;
+                    }
+                }
+
+                // Neighbour order: up, down, left, right
+                Neighbours &nb = t.neighbours[cell];
+                if (row > 0)
+                    nb.cells[nb.count++] = cell - N;
+                if (row + 1 < N)
+                    nb.cells[nb.count++] = cell + N;
+                if (col > 0)
+                    nb.cells[nb.count++] = cell - 1;
+                if (col + 1 < N)
+                    nb.cells[nb.count++] = cell + 1;
+            }
+
+            // Pair order: row-major over cells, horizontal pair before vertical pair
+            int p = 0;
+            for (int cell = 0; cell < Geo::NUM_CELLS; cell++)
+            {
+                if (cell % N + 1 < N)
+                {
+                    t.adjacentPairs[p++] = {cell, cell + 1};
+                }
+                if (cell / N + 1 < N)
+                {
+                    t.adjacentPairs[p++] = {cell, cell + N};
+                }
+            }
+
+            return t;
+        }
+
+        template <class Geo>
+        inline constexpr BasicTables<Geo> TABLES_FOR = buildTables<Geo>();
+
+    } // namespace topology
+
+    /**
+     * @brief Topology constants, index helpers and tables for one geometry
+     */
+    template <class Geo>
+    struct BasicTopology
+    {
+        using Tables = topology::BasicTables<Geo>;
+        using CellMask = topology::BasicCellMask<Geo::NUM_CELLS>;
+
+        // Table dimensions
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int NUM_CELLS = Geo::NUM_CELLS;
+        static constexpr int UNIT_SIZE = GRID_SIZE;
+        static constexpr int NUM_UNITS = 3 * GRID_SIZE;
+        static constexpr int NUM_PEERS = Tables::NUM_PEERS;
+        static constexpr int NUM_ADJACENT_PAIRS = Tables::NUM_ADJACENT_PAIRS;
+
+        // Unit index ranges: rows first, then columns, then boxes
+        static constexpr int FIRST_ROW_UNIT = 0;
+        static constexpr int FIRST_COL_UNIT = GRID_SIZE;
+        static constexpr int FIRST_BOX_UNIT = 2 * GRID_SIZE;
+
+        static constexpr int cellIndex(int row, int col) { return row * GRID_SIZE + col; }
+        static constexpr int cellRow(int index) { return index / GRID_SIZE; }
+        static constexpr int cellCol(int index) { return index % GRID_SIZE; }
+        static constexpr int cellBox(int index)
+        {
+            return (cellRow(index) / Geo::BOX_ROWS) * Geo::BOX_ROWS + cellCol(index) / Geo::BOX_COLS;
+        }
+        static Cell toCell(int index) { return Cell(cellRow(index), cellCol(index)); }
+        static constexpr int toIndex(const Cell &cell) { return cellIndex(cell.row, cell.col); }
+
+        static constexpr const Tables &TABLES = topology::TABLES_FOR<Geo>;
+        static constexpr const auto &UNITS = TABLES.units;
+        static constexpr const auto &CELL_UNITS = TABLES.cellUnits;
+        static constexpr const auto &PEERS = TABLES.peers;
+        static constexpr const auto &NEIGHBOURS = TABLES.neighbours;
+        static constexpr const auto &ADJACENT_PAIRS = TABLES.adjacentPairs;
+        static constexpr const auto &UNIT_MASKS = TABLES.unitMasks;
+        static constexpr const auto &PEER_MASKS = TABLES.peerMasks;
+
+        /**
+         * @brief Index of the adjacent pair (a, b) in ADJACENT_PAIRS, or -1 if not adjacent
+         */
+        static constexpr int adjacentPairIndex(int a, int b)
+        {
+            if (a > b)
+            {
+                int tmp = a;
+                a = b;
+                b = tmp;
+            }
+            int row = cellRow(a);
+            int col = cellCol(a);
+            // Each full row contributes (GRID_SIZE - 1) horizontal + GRID_SIZE vertical pairs
+            int base = row * (2 * GRID_SIZE - 1);
+            bool lastRow = row + 1 >= GRID_SIZE;
+            if (b == a + 1 && cellRow(b) == row)
+            {
+                return lastRow ? base + col : base + 2 * col;
+            }
+            if (b == a + GRID_SIZE && !lastRow)
+            {
+                return col + 1 < GRID_SIZE ? base + 2 * col + 1 : base + 2 * col;
+            }
+            return -1;
+        }
+    };
+
+    namespace topology
+    {
+        // Standard 9x9 topology
+        using Standard = BasicTopology<StandardGeometry>;
+        using CellMask = Standard::CellMask;
+        using Tables = Standard::Tables;
+
+        constexpr int NUM_CELLS = Standard::NUM_CELLS;
+        constexpr int UNIT_SIZE = Standard::UNIT_SIZE;
+        constexpr int NUM_UNITS = Standard::NUM_UNITS;
+        constexpr int NUM_PEERS = Standard::NUM_PEERS;
+        constexpr int NUM_ADJACENT_PAIRS = Standard::NUM_ADJACENT_PAIRS;
+        constexpr int FIRST_ROW_UNIT = Standard::FIRST_ROW_UNIT;
+        constexpr int FIRST_COL_UNIT = Standard::FIRST_COL_UNIT;
+        constexpr int FIRST_BOX_UNIT = Standard::FIRST_BOX_UNIT;
+
+        constexpr int cellIndex(int row, int col) { return Standard::cellIndex(row, col); }
+        constexpr int cellRow(int index) { return Standard::cellRow(index); }
+        constexpr int cellCol(int index) { return Standard::cellCol(index); }
+        constexpr int cellBox(int index) { return Standard::cellBox(index); }
+        inline Cell toCell(int index) { return Standard::toCell(index); }
+        constexpr int toIndex(const Cell &cell) { return Standard::toIndex(cell); }
+        constexpr int adjacentPairIndex(int a, int b) { return Standard::adjacentPairIndex(a, b); }
+
+        inline constexpr const Tables &TABLES = Standard::TABLES;
+        inline constexpr const auto &UNITS = Standard::UNITS;
+        inline constexpr const auto &CELL_UNITS = Standard::CELL_UNITS;
+        inline constexpr const auto &PEERS = Standard::PEERS;
+        inline constexpr const auto &NEIGHBOURS = Standard::NEIGHBOURS;
+        inline constexpr const auto &ADJACENT_PAIRS = Standard::ADJACENT_PAIRS;
+        inline constexpr const auto &UNIT_MASKS = Standard::UNIT_MASKS;
+        inline constexpr const auto &PEER_MASKS = Standard::PEER_MASKS;
+
+        static_assert(NUM_PEERS == 20, "Standard grid has 20 peers per cell");
+        static_assert(NUM_ADJACENT_PAIRS == 144, "Standard grid has 144 adjacent pairs");
+
+    } // namespace topology
+} // namespace sudoku
+
+#endif // SUDOKU_TOPOLOGY_H
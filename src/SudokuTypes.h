@@ -7,6 +7,10 @@
  * - Killer Sudoku (cage constraints with sums)
  * - Inequality Sudoku (greater-than constraints between cells)
  * - Mixed variants (combinations of the above)
+ *
+ * Grid types are templates over the box dimensions (see Geometry), so the
+ * same code handles 4x4, 6x6 (2x3 boxes), 9x9, 16x16 and 25x25 grids.
+ * SudokuPuzzle and SudokuSolution are the classic 9x9 instantiations.
  */
 
 #ifndef SUDOKU_TYPES_H
@@ -21,11 +25,50 @@
 namespace sudoku
 {
 
-    // Constants
-    constexpr int GRID_SIZE = 9;
-    constexpr int BOX_SIZE = 3;
-    constexpr int MIN_VALUE = 1;
-    constexpr int MAX_VALUE = 9;
+    /**
+     * @brief Compile-time grid geometry
+     *
+     * A grid of (BoxRows * BoxCols) x (BoxRows * BoxCols) cells, divided into
+     * boxes of BoxRows rows by BoxCols columns, holding values 1..GRID_SIZE.
+     */
+    template <int BoxRows, int BoxCols>
+    struct Geometry
+    {
+        static_assert(BoxRows >= 1 && BoxCols >= 1, "Box dimensions must be positive");
+
+        static constexpr int BOX_ROWS = BoxRows;
+        static constexpr int BOX_COLS = BoxCols;
+        static constexpr int GRID_SIZE = BoxRows * BoxCols;
+        static constexpr int NUM_CELLS = GRID_SIZE * GRID_SIZE;
+        static constexpr int MIN_VALUE = 1;
+        static constexpr int MAX_VALUE = GRID_SIZE;
+    };
+
+    // Supported geometries
+    using Geometry4x4 = Geometry<2, 2>;
+    using Geometry6x6 = Geometry<2, 3>;
+    using Geometry8x8 = Geometry<2, 4>;
+    using Geometry9x9 = Geometry<3, 3>;
+    using Geometry12x12 = Geometry<3, 4>;
+    using Geometry16x16 = Geometry<4, 4>;
+    using Geometry25x25 = Geometry<5, 5>;
+    using StandardGeometry = Geometry9x9;
+
+// Expands X(BoxRows, BoxCols) for every geometry the library is instantiated for
+#define SUDOKU_FOR_EACH_GEOMETRY(X) \
+    X(2, 2)                         \
+    X(2, 3)                         \
+    X(2, 4)                         \
+    X(3, 3)                         \
+    X(3, 4)                         \
+    X(4, 4)                         \
+    X(5, 5)
+
+    // Constants (standard 9x9 geometry)
+    constexpr int GRID_SIZE = StandardGeometry::GRID_SIZE;
+    constexpr int BOX_SIZE = StandardGeometry::BOX_ROWS;
+    constexpr int MIN_VALUE = StandardGeometry::MIN_VALUE;
+    constexpr int MAX_VALUE = StandardGeometry::MAX_VALUE;
     constexpr int EMPTY_CELL = 0;
 
     /**
@@ -51,9 +94,9 @@ namespace sudoku
             return col < other.col;
         }
 
-        bool isValid() const
+        bool isValid(int gridSize = GRID_SIZE) const
         {
-            return row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE;
+            return row >= 0 && row < gridSize && col >= 0 && col < gridSize;
         }
     };
 
@@ -70,15 +113,15 @@ namespace sudoku
         Cage() : targetSum(0) {}
         Cage(const std::vector<Cell> &c, int sum) : cells(c), targetSum(sum) {}
 
-        bool isValid() const
+        bool isValid(int maxValue = MAX_VALUE) const
         {
             if (cells.empty() || targetSum < 1)
                 return false;
             // Minimum possible sum for n cells: 1+2+...+n = n*(n+1)/2
             int n = static_cast<int>(cells.size());
             int minSum = n * (n + 1) / 2;
-            // Maximum possible sum for n cells: (10-n)+(10-n+1)+...+9 = n*(19-n)/2
-            int maxSum = n * (19 - n) / 2;
+            // Maximum possible sum for n cells: (m+1-n)+...+m = n*(2m+1-n)/2
+            int maxSum = n * (2 * maxValue + 1 - n) / 2;
             return targetSum >= minSum && targetSum <= maxSum;
         }
     };
@@ -102,9 +145,9 @@ namespace sudoku
         InequalityConstraint(const Cell &c1, const Cell &c2, InequalityType t)
             : cell1(c1), cell2(c2), type(t) {}
 
-        bool isValid() const
+        bool isValid(int gridSize = GRID_SIZE) const
         {
-            return cell1.isValid() && cell2.isValid() && !(cell1 == cell2);
+            return cell1.isValid(gridSize) && cell2.isValid(gridSize) && !(cell1 == cell2);
         }
     };
 
@@ -122,9 +165,13 @@ namespace sudoku
     /**
      * @brief Represents a complete Sudoku puzzle with all constraints
      */
-    struct SudokuPuzzle
+    template <class Geo>
+    struct BasicSudokuPuzzle
     {
-        // Basic grid (0 = empty, 1-9 = given values)
+        using GeometryType = Geo;
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+
+        // Basic grid (0 = empty, 1-GRID_SIZE = given values)
         int grid[GRID_SIZE][GRID_SIZE];
 
         // Puzzle type
@@ -136,7 +183,7 @@ namespace sudoku
         // Inequality constraints
         std::vector<InequalityConstraint> inequalities;
 
-        SudokuPuzzle() : type(SudokuType::STANDARD)
+        BasicSudokuPuzzle() : type(SudokuType::STANDARD)
         {
             for (int i = 0; i < GRID_SIZE; i++)
             {
@@ -238,15 +285,19 @@ namespace sudoku
     /**
      * @brief Represents the solution to a Sudoku puzzle
      */
-    struct SudokuSolution
+    template <class Geo>
+    struct BasicSudokuSolution
     {
+        using GeometryType = Geo;
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+
         int grid[GRID_SIZE][GRID_SIZE];
         bool solved;
         UniquenessStatus uniqueness;  // Uniqueness status of the solution
         std::string errorMessage;
         double solveTimeMs;
 
-        SudokuSolution() : solved(false), uniqueness(UniquenessStatus::NOT_CHECKED), solveTimeMs(0.0)
+        BasicSudokuSolution() : solved(false), uniqueness(UniquenessStatus::NOT_CHECKED), solveTimeMs(0.0)
         {
             for (int i = 0; i < GRID_SIZE; i++)
             {
@@ -279,6 +330,10 @@ namespace sudoku
         }
     };
 
+    // Classic 9x9 puzzle and solution
+    using SudokuPuzzle = BasicSudokuPuzzle<StandardGeometry>;
+    using SudokuSolution = BasicSudokuSolution<StandardGeometry>;
+
 } // namespace sudoku
 
 #endif // SUDOKU_TYPES_H
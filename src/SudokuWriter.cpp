@@ -0,0 +1,338 @@
+/**
+ * @file SudokuWriter.cpp
+ * @brief Implementation of the buffer-based writers
+ */
+
+#include "SudokuWriter.h"
+#include "SudokuBinary.h"
+#include <charconv>
+
+namespace sudoku
+{
+
+    namespace
+    {
+        inline char symbolFor(int value, int maxValue)
+        {
+            if (value < MIN_VALUE || value > maxValue)
+                return '.';
+            return value <= 9 ? static_cast<char>('0' + value) : static_cast<char>('A' + value - 10);
+        }
+
+        const char *typeName(SudokuType type)
+        {
+            switch (type)
+            {
+            case SudokuType::KILLER:
+                return "killer";
+            case SudokuType::INEQUALITY:
+                return "inequality";
+            case SudokuType::KILLER_INEQUALITY:
+                return "mixed";
+            default:
+                return "standard";
+            }
+        }
+    } // namespace
+
+    template <class Geo>
+    char *BasicSudokuWriter<Geo>::writeGridLine(const int grid[GRID_SIZE][GRID_SIZE], char *out)
+    {
+        const int *cells = &grid[0][0];
+        for (int i = 0; i < NUM_CELLS; i++)
+        {
+            out[i] = symbolFor(cells[i], Geo::MAX_VALUE);
+        }
+        return out + NUM_CELLS;
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendGridLine(std::string &out, const int grid[GRID_SIZE][GRID_SIZE])
+    {
+        size_t start = out.size();
+        out.resize(start + NUM_CELLS);
+        writeGridLine(grid, &out[start]);
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendPrettyGrid(std::string &out, const int grid[GRID_SIZE][GRID_SIZE])
+    {
+        constexpr int NUM_BOX_COLS = GRID_SIZE / Geo::BOX_COLS;
+        constexpr int SEGMENT = 2 * Geo::BOX_COLS + 2;
+
+        auto separator = [&]()
+        {
+            for (int box = 0; box < NUM_BOX_COLS; box++)
+            {
+                out += '+';
+                out.append(SEGMENT - 1, '-');
+            }
+            out += "+\n";
+        };
+
+        separator();
+        for (int row = 0; row < GRID_SIZE; row++)
+        {
+            if (row > 0 && row % Geo::BOX_ROWS == 0)
+            {
+                separator();
+            }
+            out += '|';
+            for (int col = 0; col < GRID_SIZE; col++)
+            {
+                if (col > 0 && col % Geo::BOX_COLS == 0)
+                {
+                    out += " |";
+                }
+                out += ' ';
+                out += symbolFor(grid[row][col], Geo::MAX_VALUE);
+            }
+            out += " |\n";
+        }
+        separator();
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendCustomFormat(std::string &out, const Puzzle &puzzle, const Solution *solution)
+    {
+        auto appendRows = [&](const int grid[GRID_SIZE][GRID_SIZE])
+        {
+            for (int r = 0; r < GRID_SIZE; r++)
+            {
+                for (int c = 0; c < GRID_SIZE; c++)
+                {
+                    if (c > 0)
+                        out += ' ';
+                    appendInt(out, grid[r][c]);
+                }
+                out += '\n';
+            }
+        };
+
+        // Grid section
+        out += "GRID\n";
+        appendRows(puzzle.grid);
+
+        // Cages section
+        if (!puzzle.cages.empty())
+        {
+            out += "\nCAGES\n";
+            for (const auto &cage : puzzle.cages)
+            {
+                appendInt(out, cage.targetSum);
+                for (const auto &cell : cage.cells)
+                {
+                    out += ' ';
+                    appendInt(out, cell.row);
+                    out += ' ';
+                    appendInt(out, cell.col);
+                }
+                out += '\n';
+            }
+        }
+
+        // Inequalities section
+        if (!puzzle.inequalities.empty())
+        {
+            out += "\nINEQUALITIES\n";
+            for (const auto &ineq : puzzle.inequalities)
+            {
+                appendInt(out, ineq.cell1.row);
+                out += ' ';
+                appendInt(out, ineq.cell1.col);
+                out += ineq.type == InequalityType::GREATER_THAN ? " > " : " < ";
+                appendInt(out, ineq.cell2.row);
+                out += ' ';
+                appendInt(out, ineq.cell2.col);
+                out += '\n';
+            }
+        }
+
+        if (solution)
+        {
+            out += "\nSOLUTION\n";
+            appendRows(solution->grid);
+        }
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendGridJson(std::string &out, const int grid[GRID_SIZE][GRID_SIZE])
+    {
+        out += '[';
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            out += r > 0 ? ",[" : "[";
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                if (c > 0)
+                    out += ',';
+                appendInt(out, grid[r][c]);
+            }
+            out += ']';
+        }
+        out += ']';
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendPuzzleJson(std::string &out, const Puzzle &puzzle)
+    {
+        auto appendCell = [&](const Cell &cell)
+        {
+            out += '[';
+            appendInt(out, cell.row);
+            out += ',';
+            appendInt(out, cell.col);
+            out += ']';
+        };
+
+        out += "{\"type\":\"";
+        out += typeName(puzzle.type);
+        out += "\",\"grid\":";
+        appendGridJson(out, puzzle.grid);
+
+        if (!puzzle.cages.empty())
+        {
+            out += ",\"cages\":[";
+            for (size_t i = 0; i < puzzle.cages.size(); i++)
+            {
+                const Cage &cage = puzzle.cages[i];
+                out += i > 0 ? ",{\"cells\":[" : "{\"cells\":[";
+                for (size_t j = 0; j < cage.cells.size(); j++)
+                {
+                    if (j > 0)
+                        out += ',';
+                    appendCell(cage.cells[j]);
+                }
+                out += "],\"sum\":";
+                appendInt(out, cage.targetSum);
+                out += '}';
+            }
+            out += ']';
+        }
+
+        if (!puzzle.inequalities.empty())
+        {
+            out += ",\"inequalities\":[";
+            for (size_t i = 0; i < puzzle.inequalities.size(); i++)
+            {
+                const InequalityConstraint &ineq = puzzle.inequalities[i];
+                out += i > 0 ? ",{\"cell1\":" : "{\"cell1\":";
+                appendCell(ineq.cell1);
+                out += ",\"cell2\":";
+                appendCell(ineq.cell2);
+                out += ineq.type == InequalityType::GREATER_THAN ? ",\"type\":\">\"}" : ",\"type\":\"<\"}";
+            }
+            out += ']';
+        }
+
+        out += '}';
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendSolutionJson(std::string &out, const Solution &solution, std::string_view id)
+    {
+        out += '{';
+        if (!id.empty())
+        {
+            out += "\"id\":";
+            out += id;
+            out += ',';
+        }
+        out += solution.solved ? "\"solved\":true" : "\"solved\":false";
+
+        if (solution.uniqueness == UniquenessStatus::UNIQUE)
+            out += ",\"uniqueness\":\"unique\"";
+        else if (solution.uniqueness == UniquenessStatus::NOT_UNIQUE)
+            out += ",\"uniqueness\":\"not_unique\"";
+
+        out += ",\"solveTimeMs\":";
+        appendFixed(out, solution.solveTimeMs, 3);
+
+        if (solution.solved)
+        {
+            out += ",\"grid\":";
+            appendGridJson(out, solution.grid);
+        }
+        else
+        {
+            out += ",\"error\":";
+            appendJsonString(out, solution.errorMessage);
+        }
+        out += '}';
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendBinary(std::string &out, const Puzzle &puzzle, const Solution *solution)
+    {
+        BasicSudokuBinary<Geo>::write(puzzle, solution, out);
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendInt(std::string &out, long long value)
+    {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendFixed(std::string &out, double value, int decimals)
+    {
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, decimals);
+        out.append(buffer, result.ptr);
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendGeneral(std::string &out, double value)
+    {
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+        out.append(buffer, result.ptr);
+    }
+
+    template <class Geo>
+    void BasicSudokuWriter<Geo>::appendJsonString(std::string &out, std::string_view text)
+    {
+        static const char HEX[] = "0123456789abcdef";
+        out += '"';
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out += "\\u00";
+                    out += HEX[(c >> 4) & 0xF];
+                    out += HEX[c & 0xF];
+                }
+                else
+                {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+#define SUDOKU_INSTANTIATE_WRITER(R, C) template class BasicSudokuWriter<Geometry<R, C>>;
+    SUDOKU_FOR_EACH_GEOMETRY(SUDOKU_INSTANTIATE_WRITER)
+#undef SUDOKU_INSTANTIATE_WRITER
+
+} // namespace sudoku
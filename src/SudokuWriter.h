@@ -0,0 +1,111 @@
+/**
+ * @file SudokuWriter.h
+ * @brief Buffer-based writers for grids, puzzles and solutions
+ *
+ * All writers format straight into a caller-owned buffer with std::to_chars:
+ * no streams, no locale. Appending writers take a std::string that the
+ * caller clears and reuses between records, so steady-state output does not
+ * allocate. writeGridLine fills a fixed-size char array instead.
+ */
+
+#ifndef SUDOKU_WRITER_H
+#define SUDOKU_WRITER_H
+
+#include "SudokuTypes.h"
+#include <string>
+#include <string_view>
+
+namespace sudoku
+{
+
+    /**
+     * @brief Output formatting for one geometry
+     *
+     * Instantiated for every geometry in SUDOKU_FOR_EACH_GEOMETRY.
+     */
+    template <class Geo>
+    class BasicSudokuWriter
+    {
+    public:
+        using Puzzle = BasicSudokuPuzzle<Geo>;
+        using Solution = BasicSudokuSolution<Geo>;
+
+        static constexpr int GRID_SIZE = Geo::GRID_SIZE;
+        static constexpr int NUM_CELLS = Geo::NUM_CELLS;
+
+        /**
+         * @brief Write a grid as NUM_CELLS symbols ('.' for empty), no terminator
+         * @param grid The grid
+         * @param out Buffer of at least NUM_CELLS characters
+         * @return Pointer one past the last character written
+         */
+        static char *writeGridLine(const int grid[GRID_SIZE][GRID_SIZE], char *out);
+
+        /**
+         * @brief Append a grid as NUM_CELLS symbols
+         */
+        static void appendGridLine(std::string &out, const int grid[GRID_SIZE][GRID_SIZE]);
+
+        /**
+         * @brief Append a grid with box separators (see BasicSudokuParser::toPrettyGrid)
+         */
+        static void appendPrettyGrid(std::string &out, const int grid[GRID_SIZE][GRID_SIZE]);
+
+        /**
+         * @brief Append a puzzle in the custom text format
+         * @param out Buffer to append to
+         * @param puzzle The puzzle
+         * @param solution If not null, appended as a SOLUTION section
+         */
+        static void appendCustomFormat(std::string &out, const Puzzle &puzzle, const Solution *solution = nullptr);
+
+        /**
+         * @brief Append a puzzle as a single-line JSON object (schema in SudokuJson.h)
+         */
+        static void appendPuzzleJson(std::string &out, const Puzzle &puzzle);
+
+        /**
+         * @brief Append a solution as a single-line JSON object (schema in SudokuJson.h)
+         * @param out Buffer to append to
+         * @param solution The solution
+         * @param id Raw JSON value to write as "id" (omitted if empty)
+         */
+        static void appendSolutionJson(std::string &out, const Solution &solution, std::string_view id = {});
+
+        /**
+         * @brief Append a JSON array of rows, e.g. [[5,3,4,...],...]
+         */
+        static void appendGridJson(std::string &out, const int grid[GRID_SIZE][GRID_SIZE]);
+
+        /**
+         * @brief Append a record of the compact binary format (see SudokuBinary.h)
+         */
+        static void appendBinary(std::string &out, const Puzzle &puzzle, const Solution *solution = nullptr);
+
+        /**
+         * @brief Append a decimal integer
+         */
+        static void appendInt(std::string &out, long long value);
+
+        /**
+         * @brief Append a number with a fixed count of decimals
+         */
+        static void appendFixed(std::string &out, double value, int decimals);
+
+        /**
+         * @brief Append a number with up to 6 significant digits, like a default ostream
+         */
+        static void appendGeneral(std::string &out, double value);
+
+        /**
+         * @brief Append a JSON string literal with escaping
+         */
+        static void appendJsonString(std::string &out, std::string_view text);
+    };
+
+    // Classic 9x9 writer
+    using SudokuWriter = BasicSudokuWriter<StandardGeometry>;
+
+} // namespace sudoku
+
+#endif // SUDOKU_WRITER_H
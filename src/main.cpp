@@ -5,6 +5,9 @@
  * Usage:
  *   sudoku_solve <puzzle_file>
  *   sudoku_solve --string "<81-char grid>"
+ *   sudoku_solve --batch <file|-> [options]
+ *   sudoku_solve --serve [options]
+ *   sudoku_solve --daemon [options]
  *   sudoku_solve --generate [options]
  *   sudoku_solve --help
  */
@@ -12,10 +15,31 @@
 #include "SudokuSolver.h"
 #include "SudokuParser.h"
 #include "SudokuGenerator.h"
+#include "SudokuDiskCache.h"
+#include "SudokuCorpus.h"
+#include "SudokuJson.h"
+#include "SudokuServer.h"
+#include "SudokuDaemon.h"
+#include "SudokuShard.h"
+#include "SudokuCheckpoint.h"
+#include "SudokuPipeline.h"
+#include "SudokuLatency.h"
+#include "SudokuGzip.h"
+#include "SudokuWriter.h"
+#include "SudokuCanonical.h"
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <cctype>
+#include <csignal>
 #include <fstream>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 void printUsage(const char *progName)
 {
@@ -24,10 +48,52 @@ void printUsage(const char *progName)
     std::cout << "Usage:\n";
     std::cout << "  " << progName << " <puzzle_file>        Solve puzzle from file\n";
     std::cout << "  " << progName << " --string \"<grid>\"    Solve from 81-char string\n";
+    std::cout << "  " << progName << " --batch <file|->     Solve one 81-char puzzle per line\n";
+    std::cout << "  " << progName << " --serve [options]    Answer JSON requests on stdin, one per line\n";
+    std::cout << "  " << progName << " --daemon [options]   Serve the same requests to many clients over a socket\n";
     std::cout << "  " << progName << " --generate [options] Generate a new puzzle\n";
     std::cout << "  " << progName << " --help               Show this help\n\n";
     std::cout << "Solve Options:\n";
-    std::cout << "  --unique, -u         Check if solution is unique\n\n";
+    std::cout << "  --unique, -u         Check if solution is unique\n";
+    std::cout << "  --cache <file>       Persistent solution cache (created if missing)\n";
+    std::cout << "  --to-binary <file>   Convert the puzzle to the compact binary format instead of solving\n";
+    std::cout << "  --to-text <file>     Convert the puzzle to the custom text format instead of solving\n";
+    std::cout << "  --to-json <file>     Convert the puzzle to JSON instead of solving\n\n";
+    std::cout << "Batch Options:\n";
+    std::cout << "  --output <file>      Output file (default: stdout)\n";
+    std::cout << "  --threads <N>        Solver threads (default: 1, 0 = all cores)\n";
+    std::cout << "  --parse-threads <N>  Parser threads feeding the solvers (default: 1)\n";
+    std::cout << "  --verify             Check every solution against its puzzle (timed in the latency report)\n";
+    std::cout << "  --latency-report <file> Write per-type latency percentiles and the slowest puzzles as JSON\n";
+    std::cout << "  --unordered          Write results as they finish, prefixed with the puzzle index\n";
+    std::cout << "  --jsonl              Write one JSON result object per line (echoes \"id\")\n";
+    std::cout << "  --dedup              Solve each symmetry class once; rotated, reflected or relabelled\n";
+    std::cout << "                       copies of a solved puzzle are answered from the cache\n";
+    std::cout << "  Batch files may also hold GRID/CAGES/INEQUALITIES blocks, one puzzle per block,\n";
+    std::cout << "  or one JSON puzzle object per line (JSON Lines). Gzip input is detected and\n";
+    std::cout << "  decompressed on the fly; an --output name ending in .gz is compressed (also for --generate).\n";
+    std::cout << "  (--unique and --cache also apply; unsolvable lines are written as 81 dots)\n";
+    std::cout << "  --shard [K/M]        Solve in worker processes sharing the mapped input and --output file;\n";
+    std::cout << "                       with K/M, only shard K of M (hosts split a corpus by shard)\n";
+    std::cout << "  --workers <N>        Worker processes for --shard (default: 0 = all cores)\n";
+    std::cout << "  --manifest <file>    Chunk table for --shard, built and saved if missing\n";
+    std::cout << "  --chunk <N>          Records per chunk when building a manifest (default: 4096)\n\n";
+    std::cout << "Serve Options:\n";
+    std::cout << "  --threads <N>        Worker threads (default: 1, 0 = all cores)\n";
+    std::cout << "  --cache <file>       Persistent solution cache shared by all workers\n";
+    std::cout << "  Requests: {\"id\":1,\"op\":\"solve\"|\"unique\"|\"generate\"|\"verify\",...}\n";
+    std::cout << "  Responses are written as they finish and carry the request's \"id\".\n";
+    std::cout << "  {\"op\":\"metrics\"} returns Prometheus metrics; SIGUSR1 dumps them to stderr.\n\n";
+    std::cout << "Daemon Options:\n";
+    std::cout << "  --socket <path>      Listen on a Unix domain socket\n";
+    std::cout << "  --port <N>           Listen on 127.0.0.1:N\n";
+    std::cout << "  --threads <N>        Solve workers (default: 1, 0 = all cores)\n";
+    std::cout << "  --bulk-threads <N>   Generate workers (default: 1)\n";
+    std::cout << "  --max-queue <N>      Queued requests per queue before rejecting (default: 1024)\n";
+    std::cout << "  --micro-batch <N>    Standard solves taken per worker wakeup (default: 16)\n";
+    std::cout << "  --deadline <ms>      Default queueing deadline (default: none)\n";
+    std::cout << "  --cache <file>       Persistent solution cache shared by all workers\n";
+    std::cout << "  Metrics: GET /metrics over HTTP on the same socket, or SIGUSR1 to dump to stderr\n\n";
     std::cout << "Generate Options:\n";
     std::cout << "  --type <TYPE>        Puzzle type: standard, killer, inequality, mixed (default: mixed)\n";
     std::cout << "  --cages <MIN> <MAX>  Number of cages (default: 10 20)\n";
@@ -36,12 +102,20 @@ void printUsage(const char *progName)
     std::cout << "  --seed <N>           Random seed for reproducibility\n";
     std::cout << "  --output <file>      Output file (default: stdout)\n";
     std::cout << "  --with-solution      Include solution in output\n";
+    std::cout << "  --binary             Write the compact binary format instead of text\n";
     std::cout << "  --fill-all           Make cages cover all cells (for killer/mixed)\n";
-    std::cout << "  --no-unique          Don't ensure unique solution (faster generation)\n\n";
+    std::cout << "  --no-unique          Don't ensure unique solution (faster generation)\n";
+    std::cout << "  --count <N>          Generate N puzzles, each from its own seed, separated by blank lines\n";
+    std::cout << "  --dedup              With --count, skip puzzles equivalent by symmetry to one already written\n\n";
+    std::cout << "Checkpoints (--batch with ordered output, --shard, --generate --count):\n";
+    std::cout << "  --checkpoint <file>  Save progress to file periodically and at the end\n";
+    std::cout << "  --checkpoint-interval <s> Seconds between checkpoints (default: 10)\n";
+    std::cout << "  --resume             Continue from the checkpoint; the output ends up identical\n\n";
     std::cout << "Input Formats:\n";
     std::cout << "  1. Simple grid (81 characters, use . or 0 for empty cells):\n";
     std::cout << "     530070000600195000098000060800060003400803001700020006060000280000419005000080079\n\n";
-    std::cout << "  2. Custom text format:\n";
+    std::cout << "  2. JSON, or the compact binary format written by --binary / --to-binary\n\n";
+    std::cout << "  3. Custom text format:\n";
     std::cout << "     GRID\n";
     std::cout << "     5 3 0 0 7 0 0 0 0\n";
     std::cout << "     6 0 0 1 9 5 0 0 0\n";
@@ -80,6 +154,198 @@ sudoku::SudokuType parseType(const std::string &typeStr)
     throw std::runtime_error("Unknown puzzle type: " + typeStr);
 }
 
+/**
+ * @brief Start a checkpoint for a job, or load the one to resume
+ * @return false (after reporting why) if the saved checkpoint is for another job
+ */
+bool openCheckpoint(const std::string &path, bool resume, const std::string &job,
+                    sudoku::JobCheckpoint &checkpoint)
+{
+    checkpoint = sudoku::JobCheckpoint(job);
+    if (!resume || !std::ifstream(path).good())
+    {
+        if (resume)
+        {
+            std::cerr << "No checkpoint at " << path << "; starting from the beginning\n";
+        }
+        return true;
+    }
+
+    sudoku::JobCheckpoint saved = sudoku::JobCheckpoint::load(path);
+    if (saved.getJob() != job)
+    {
+        std::cerr << "Error: Checkpoint " << path << " is for another job (" << saved.getJob() << ")\n";
+        return false;
+    }
+    checkpoint = saved;
+    return true;
+}
+
+/**
+ * @brief Format a generated puzzle as requested on the command line
+ */
+std::string formatGenerated(const sudoku::SudokuPuzzle &puzzle, const sudoku::SudokuSolution &solution,
+                            bool withSolution, bool binary)
+{
+    if (binary)
+    {
+        return sudoku::SudokuGenerator::toBinaryFormat(puzzle, withSolution ? &solution : nullptr);
+    }
+    if (withSolution)
+    {
+        return sudoku::SudokuGenerator::toCustomFormatWithSolution(puzzle, solution);
+    }
+    return sudoku::SudokuGenerator::toCustomFormat(puzzle);
+}
+
+/**
+ * @brief --generate --count: write many puzzles, optionally checkpointed
+ *
+ * Every puzzle is generated from its own seed, drawn from one job-wide
+ * generator; checkpoints store that generator's state so a resumed job
+ * draws the same seeds and writes the same bytes. With dedup, a puzzle
+ * equivalent to one already written is dropped and the next seed drawn.
+ */
+int generateMany(sudoku::GeneratorConfig config, uint64_t count, const std::string &outputFile,
+                 bool withSolution, bool binary, bool dedup, const std::string &checkpointFile,
+                 double checkpointSeconds, bool resume)
+{
+    if (dedup && !checkpointFile.empty())
+    {
+        // The bank of written puzzles is not part of the checkpoint
+        std::cerr << "Error: --dedup cannot be combined with --checkpoint\n";
+        return 1;
+    }
+    if ((resume || !checkpointFile.empty()) && (checkpointFile.empty() || outputFile.empty()))
+    {
+        std::cerr << "Error: --checkpoint and --resume need --checkpoint <file> and --output <file>\n";
+        return 1;
+    }
+    bool gzipOutput = sudoku::hasGzipSuffix(outputFile);
+    if (!checkpointFile.empty() && gzipOutput)
+    {
+        std::cerr << "Error: --checkpoint needs uncompressed output\n";
+        return 1;
+    }
+
+    // The count is left out so that a finished job can be resumed with a larger one
+    std::ostringstream job;
+    job << "generate type " << static_cast<int>(config.type) << " cages " << config.minCages << ' '
+        << config.maxCages << " ineq " << config.minInequalities << ' ' << config.maxInequalities << " givens "
+        << config.minGivens << ' ' << config.maxGivens << " seed " << config.seed << " fill "
+        << config.fillAllCells << " unique " << config.ensureUniqueSolution << " solution " << withSolution
+        << " binary " << binary;
+    sudoku::JobCheckpoint checkpoint;
+    if (!checkpointFile.empty() && !openCheckpoint(checkpointFile, resume, job.str(), checkpoint))
+    {
+        return 1;
+    }
+
+    std::mt19937 seeds(config.seed != 0 ? config.seed : std::random_device{}());
+    const uint64_t skip = checkpoint.completedPrefix();
+    uint64_t bytesWritten = checkpoint.getOutputBytes();
+    if (skip > 0)
+    {
+        checkpoint.restoreRng(seeds);
+        sudoku::truncateOutput(outputFile, bytesWritten);
+        std::cerr << "Resuming after " << skip << " puzzles\n";
+    }
+
+    std::ofstream file;
+    std::unique_ptr<sudoku::GzipOutputStream> gzipOut;
+    if (gzipOutput)
+    {
+        gzipOut = std::make_unique<sudoku::GzipOutputStream>(outputFile);
+    }
+    else if (!outputFile.empty())
+    {
+        file.open(outputFile, std::ios::binary | (skip > 0 ? std::ios::app : std::ios::trunc));
+        if (!file)
+        {
+            std::cerr << "Error: Cannot write to file " << outputFile << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = gzipOut ? *gzipOut : outputFile.empty() ? std::cout : static_cast<std::ostream &>(file);
+
+    auto saveCheckpoint = [&](uint64_t completed)
+    {
+        out.flush();
+        checkpoint.markCompleted(0, completed);
+        checkpoint.setOutputBytes(bytesWritten);
+        checkpoint.setRng(seeds);
+        checkpoint.save(checkpointFile);
+    };
+
+    // Consecutive duplicates after which the configuration is taken to be exhausted
+    constexpr int MAX_DUPLICATES = 1000;
+
+    sudoku::SudokuGenerator generator;
+    sudoku::PuzzleBank bank;
+    uint64_t duplicates = 0;
+    sudoku::CheckpointTimer checkpointTimer(checkpointSeconds);
+    auto startTime = std::chrono::steady_clock::now();
+    for (uint64_t i = skip; i < count; i++)
+    {
+        sudoku::SudokuSolution solution;
+        sudoku::SudokuPuzzle puzzle;
+        for (int attempt = 0;; attempt++)
+        {
+            do
+            {
+                config.seed = static_cast<unsigned int>(seeds());
+            } while (config.seed == 0); // 0 would mean "seed from the clock"
+
+            puzzle = generator.generateWithSolution(config, solution);
+            if (!dedup || bank.add(puzzle))
+            {
+                break;
+            }
+            duplicates++;
+            if (attempt + 1 >= MAX_DUPLICATES)
+            {
+                std::cerr << "Error: Only " << i << " puzzles of this configuration are distinct up to symmetry\n";
+                return 1;
+            }
+        }
+        std::string output = formatGenerated(puzzle, solution, withSolution, binary);
+        if (!binary)
+        {
+            output += '\n'; // Blank line between blocks
+        }
+        out << output;
+        bytesWritten += output.size();
+
+        if (!checkpointFile.empty() && checkpointTimer.due())
+        {
+            saveCheckpoint(i + 1);
+        }
+    }
+    out.flush();
+    if (gzipOut)
+    {
+        gzipOut->close();
+    }
+    if (!checkpointFile.empty())
+    {
+        saveCheckpoint(std::max(count, skip));
+    }
+
+    double totalSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    uint64_t generated = count > skip ? count - skip : 0;
+    std::cerr << "Generated " << generated << " puzzles";
+    if (skip > 0)
+    {
+        std::cerr << " (" << skip << " before resuming)";
+    }
+    std::cerr << std::fixed << std::setprecision(3) << " in " << totalSec << " s\n";
+    if (dedup)
+    {
+        std::cerr << "Skipped " << duplicates << " duplicates\n";
+    }
+    return 0;
+}
+
 int runGenerate(int argc, char *argv[])
 {
     sudoku::GeneratorConfig config;
@@ -87,6 +353,12 @@ int runGenerate(int argc, char *argv[])
 
     std::string outputFile;
     bool withSolution = false;
+    bool binary = false;
+    bool dedup = false;
+    uint64_t count = 0;
+    std::string checkpointFile;
+    double checkpointSeconds = 10.0;
+    bool resume = false;
 
     // Parse generate options
     for (int i = 2; i < argc; i++)
@@ -124,6 +396,10 @@ int runGenerate(int argc, char *argv[])
         {
             withSolution = true;
         }
+        else if (arg == "--binary")
+        {
+            binary = true;
+        }
         else if (arg == "--fill-all")
         {
             config.fillAllCells = true;
@@ -132,6 +408,26 @@ int runGenerate(int argc, char *argv[])
         {
             config.ensureUniqueSolution = false;
         }
+        else if (arg == "--count" && i + 1 < argc)
+        {
+            count = std::stoull(argv[++i]);
+        }
+        else if (arg == "--dedup")
+        {
+            dedup = true;
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc)
+        {
+            checkpointFile = argv[++i];
+        }
+        else if (arg == "--checkpoint-interval" && i + 1 < argc)
+        {
+            checkpointSeconds = std::stod(argv[++i]);
+        }
+        else if (arg == "--resume")
+        {
+            resume = true;
+        }
         else if (arg[0] == '-')
         {
             std::cerr << "Error: Unknown generate option: " << arg << "\n";
@@ -172,21 +468,18 @@ int runGenerate(int argc, char *argv[])
         typeName = "Mixed (Killer + Inequality) Sudoku";
         break;
     }
+    if (count > 0)
+    {
+        std::cerr << "Generating " << count << " " << typeName << " puzzles...\n";
+        return generateMany(config, count, outputFile, withSolution, binary, dedup, checkpointFile,
+                            checkpointSeconds, resume);
+    }
     std::cerr << "Generating " << typeName << " puzzle...\n";
 
     sudoku::SudokuGenerator generator;
     sudoku::SudokuSolution solution;
     auto puzzle = generator.generateWithSolution(config, solution);
-
-    std::string output;
-    if (withSolution)
-    {
-        output = generator.toCustomFormatWithSolution(puzzle, solution);
-    }
-    else
-    {
-        output = generator.toCustomFormat(puzzle);
-    }
+    std::string output = formatGenerated(puzzle, solution, withSolution, binary);
 
     if (outputFile.empty())
     {
@@ -194,14 +487,14 @@ int runGenerate(int argc, char *argv[])
     }
     else
     {
-        std::ofstream file(outputFile);
+        std::ofstream file(outputFile, std::ios::binary);
         if (!file)
         {
             std::cerr << "Error: Cannot write to file " << outputFile << "\n";
             return 1;
         }
         file << output;
-        std::cerr << "Puzzle saved to " << outputFile << "\n";
+        std::cerr << "Puzzle saved to " << outputFile << " (" << output.size() << " bytes)\n";
     }
 
     // Print info to stderr
@@ -222,6 +515,778 @@ int runGenerate(int argc, char *argv[])
     return 0;
 }
 
+/**
+ * @brief --batch --shard: solve a corpus file in worker processes
+ */
+int runShardedBatch(const std::string &inputFile, const std::string &outputFile, const std::string &manifestFile,
+                    size_t chunkRecords, const sudoku::ShardConfig &config)
+{
+    if (inputFile == "-" || outputFile.empty())
+    {
+        std::cerr << "Error: --shard needs an input file and --output <file>\n";
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    sudoku::CorpusManifest manifest;
+    if (!manifestFile.empty() && std::ifstream(manifestFile).good())
+    {
+        manifest = sudoku::CorpusManifest::load(manifestFile);
+    }
+    else
+    {
+        sudoku::MappedFile mapped(inputFile);
+        manifest = sudoku::CorpusManifest::build(mapped.contents(), chunkRecords);
+        if (!manifestFile.empty())
+        {
+            manifest.save(manifestFile);
+        }
+    }
+
+    sudoku::ShardRunner runner(config);
+    sudoku::ShardStats stats = runner.run(inputFile, manifest, outputFile);
+
+    double totalSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cerr << "\nBatch statistics:\n";
+    std::cerr << "  Shard: " << config.shardId << " of " << config.numShards << " (" << manifest.chunks.size()
+              << " chunks in the corpus)\n";
+    std::cerr << "  Puzzles: " << stats.records << "\n";
+    if (stats.resumed > 0)
+    {
+        std::cerr << "  Resumed after: " << stats.resumed << "\n";
+    }
+    std::cerr << "  Solved: " << stats.solved << "\n";
+    if (stats.invalid > 0)
+    {
+        std::cerr << "  Invalid records: " << stats.invalid << "\n";
+    }
+    if (config.checkUniqueness)
+    {
+        std::cerr << "  Not unique: " << stats.notUnique << "\n";
+    }
+    std::cerr << "  Worker processes: " << config.workers << "\n";
+    if (stats.failedWorkers > 0)
+    {
+        std::cerr << "  Failed workers: " << stats.failedWorkers << "\n";
+    }
+    std::cerr << std::fixed << std::setprecision(3);
+    std::cerr << "  Total time: " << totalSec << " s\n";
+    if (stats.records > 0 && totalSec > 0)
+    {
+        std::cerr << "  Throughput: " << std::setprecision(1) << stats.records / totalSec << " puzzles/s\n";
+    }
+
+    return stats.solved == stats.records && stats.failedWorkers == 0 ? 0 : 1;
+}
+
+int runBatch(int argc, char *argv[])
+{
+    std::string inputFile;
+    std::string outputFile;
+    std::string cacheFile;
+    bool checkUniqueness = false;
+    bool unordered = false;
+    bool jsonl = false;
+    bool dedup = false;
+    int numThreads = 1;
+    int parseThreads = 1;
+    bool verify = false;
+    std::string latencyFile;
+    bool shard = false;
+    std::string manifestFile;
+    size_t chunkRecords = 4096;
+    sudoku::ShardConfig shardConfig;
+    shardConfig.workers = 0;
+    std::string checkpointFile;
+    double checkpointSeconds = 10.0;
+    bool resume = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if ((arg == "--batch" || arg == "-b") && i + 1 < argc)
+        {
+            inputFile = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            outputFile = argv[++i];
+        }
+        else if (arg == "--cache" && i + 1 < argc)
+        {
+            cacheFile = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            numThreads = std::stoi(argv[++i]);
+            if (numThreads == 0)
+            {
+                numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+        }
+        else if (arg == "--parse-threads" && i + 1 < argc)
+        {
+            parseThreads = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--unordered")
+        {
+            unordered = true;
+        }
+        else if (arg == "--jsonl")
+        {
+            jsonl = true;
+        }
+        else if (arg == "--dedup")
+        {
+            dedup = true;
+        }
+        else if (arg == "--unique" || arg == "-u")
+        {
+            checkUniqueness = true;
+        }
+        else if (arg == "--verify")
+        {
+            verify = true;
+        }
+        else if (arg == "--latency-report" && i + 1 < argc)
+        {
+            latencyFile = argv[++i];
+        }
+        else if (arg == "--shard")
+        {
+            shard = true;
+            // Optional K/M selects one shard of the manifest
+            if (i + 1 < argc && std::strchr(argv[i + 1], '/') && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+            {
+                std::string spec = argv[++i];
+                size_t slash = spec.find('/');
+                shardConfig.shardId = std::stoi(spec.substr(0, slash));
+                shardConfig.numShards = std::stoi(spec.substr(slash + 1));
+            }
+        }
+        else if (arg == "--workers" && i + 1 < argc)
+        {
+            shardConfig.workers = std::stoi(argv[++i]);
+        }
+        else if (arg == "--manifest" && i + 1 < argc)
+        {
+            manifestFile = argv[++i];
+        }
+        else if (arg == "--chunk" && i + 1 < argc)
+        {
+            chunkRecords = static_cast<size_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc)
+        {
+            checkpointFile = argv[++i];
+        }
+        else if (arg == "--checkpoint-interval" && i + 1 < argc)
+        {
+            checkpointSeconds = std::stod(argv[++i]);
+        }
+        else if (arg == "--resume")
+        {
+            resume = true;
+        }
+        else
+        {
+            std::cerr << "Error: Unknown batch option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (inputFile.empty())
+    {
+        std::cerr << "Error: --batch requires a file name or -\n";
+        return 1;
+    }
+    if ((resume || !checkpointFile.empty()) && (checkpointFile.empty() || outputFile.empty() || unordered))
+    {
+        std::cerr << "Error: --checkpoint and --resume need --checkpoint <file>, --output <file> and ordered output\n";
+        return 1;
+    }
+    bool gzipInput = inputFile != "-" && sudoku::isGzipFile(inputFile);
+    bool gzipOutput = sudoku::hasGzipSuffix(outputFile);
+    if (!checkpointFile.empty() && gzipOutput)
+    {
+        std::cerr << "Error: --checkpoint needs uncompressed output\n";
+        return 1;
+    }
+
+    if (shard)
+    {
+        if (unordered || jsonl || dedup || !cacheFile.empty())
+        {
+            std::cerr << "Error: --shard writes fixed-size grid lines; --unordered, --jsonl, --dedup and --cache do "
+                         "not apply\n";
+            return 1;
+        }
+        if (shardConfig.workers <= 0)
+        {
+            shardConfig.workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        shardConfig.checkUniqueness = checkUniqueness;
+        shardConfig.checkpointPath = checkpointFile;
+        shardConfig.checkpointSeconds = checkpointSeconds;
+        shardConfig.resume = resume;
+        if (gzipInput || gzipOutput)
+        {
+            std::cerr << "Error: --shard maps its input and output; decompress the corpus first\n";
+            return 1;
+        }
+        return runShardedBatch(inputFile, outputFile, manifestFile, chunkRecords, shardConfig);
+    }
+
+    // Files are memory-mapped, .gz files decompressed on a reader thread; stdin is read line by line
+    std::unique_ptr<sudoku::MappedFile> mapped;
+    std::unique_ptr<sudoku::CorpusReader> corpus;
+    std::unique_ptr<sudoku::GzipCorpusReader> gzipCorpus;
+    bool blocks = false;
+    if (gzipInput)
+    {
+        gzipCorpus = std::make_unique<sudoku::GzipCorpusReader>(inputFile);
+        blocks = gzipCorpus->getFormat() == sudoku::CorpusFormat::BLOCKS;
+    }
+    else if (inputFile != "-")
+    {
+        mapped = std::make_unique<sudoku::MappedFile>(inputFile);
+        corpus = std::make_unique<sudoku::CorpusReader>(mapped->contents());
+        blocks = corpus->getFormat() == sudoku::CorpusFormat::BLOCKS;
+    }
+
+    // Resuming keeps the output of the finished records and appends after it
+    sudoku::JobCheckpoint checkpoint;
+    std::string job = "batch " + inputFile + (checkUniqueness ? " unique" : "") + (jsonl ? " jsonl" : "");
+    if (!checkpointFile.empty() && !openCheckpoint(checkpointFile, resume, job, checkpoint))
+    {
+        return 1;
+    }
+    const size_t skip = static_cast<size_t>(checkpoint.completedPrefix());
+    sudoku::CheckpointTimer checkpointTimer(checkpointSeconds);
+    uint64_t bytesWritten = checkpoint.getOutputBytes();
+    if (skip > 0)
+    {
+        sudoku::truncateOutput(outputFile, bytesWritten);
+        std::cerr << "Resuming after " << skip << " puzzles\n";
+    }
+
+    std::ofstream outFile;
+    std::unique_ptr<sudoku::GzipOutputStream> gzipOut;
+    if (gzipOutput)
+    {
+        gzipOut = std::make_unique<sudoku::GzipOutputStream>(outputFile);
+    }
+    else if (!outputFile.empty())
+    {
+        outFile.open(outputFile, skip > 0 ? std::ios::app : std::ios::trunc);
+        if (!outFile)
+        {
+            std::cerr << "Error: Cannot write to file " << outputFile << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = gzipOut ? *gzipOut : outputFile.empty() ? std::cout : static_cast<std::ostream &>(outFile);
+    std::ios::sync_with_stdio(false);
+
+    // Statistics and output are only touched by the pipeline's writer stage
+    long long solved = 0;
+    long long notUnique = 0;
+    long long invalid = 0;
+    long long failedVerify = 0;
+    long long cachedResults = 0;
+    sudoku::LatencyReport latency;
+    const std::string unsolvedLine(sudoku::GRID_SIZE * sudoku::GRID_SIZE, '.');
+
+    // Lines are formatted into one buffer and written in large chunks
+    constexpr size_t FLUSH_BYTES = 1 << 16;
+    std::string pending;
+    pending.reserve(FLUSH_BYTES + 1024);
+    auto writeLine = [&](size_t index, const std::string &text)
+    {
+        if (unordered && !jsonl)
+        {
+            sudoku::SudokuWriter::appendInt(pending, static_cast<long long>(index));
+            pending += ' ';
+        }
+        pending += text;
+        pending += '\n';
+        if (pending.size() >= FLUSH_BYTES)
+        {
+            out.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+            bytesWritten += pending.size();
+            pending.clear();
+
+            // Output is ordered, so every record up to this one is in the file
+            if (!checkpointFile.empty() && checkpointTimer.due())
+            {
+                out.flush();
+                checkpoint.markCompleted(0, index + 1);
+                checkpoint.setOutputBytes(bytesWritten);
+                try
+                {
+                    checkpoint.save(checkpointFile);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << "Warning: " << e.what() << "\n";
+                }
+            }
+        }
+    };
+
+    // Runs on the parser threads
+    auto parse = [blocks](std::string_view record, sudoku::SudokuPuzzle &puzzle, std::string &id, std::string &error)
+    {
+        if (sudoku::SudokuParser::parseCompactGrid(record, puzzle))
+        {
+            return true;
+        }
+        bool isJson = sudoku::SudokuJson::isJson(record);
+        if (!isJson && !blocks)
+        {
+            error = "not an 81-character grid";
+            return false;
+        }
+        try
+        {
+            puzzle = isJson ? sudoku::SudokuJson::parsePuzzle(record, &id)
+                            : sudoku::SudokuParser::parseFromString(std::string(record));
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            error = e.what();
+            return false;
+        }
+    };
+
+    // Runs on the writer stage, in input order unless --unordered
+    std::string text;
+    auto report = [&](const sudoku::PipelineResult &result)
+    {
+        size_t index = result.index;
+        const std::string id = result.id.empty() ? std::to_string(index) : result.id;
+        if (!result.parsed)
+        {
+            std::cerr << "Error: Puzzle " << index + 1 << ": " << result.error << "\n";
+            invalid++;
+            if (jsonl)
+            {
+                sudoku::SudokuSolution failure;
+                failure.errorMessage = result.error;
+                text.clear();
+                sudoku::SudokuJson::writeSolution(failure, text, id);
+                writeLine(index, text);
+            }
+            else
+            {
+                writeLine(index, unsolvedLine);
+            }
+            return;
+        }
+
+        const sudoku::SudokuSolution &solution = result.solution;
+        if (solution.solved)
+        {
+            solved++;
+            if (checkUniqueness && !solution.isUnique())
+                notUnique++;
+        }
+        if (verify && solution.solved && !result.verified)
+        {
+            std::cerr << "Error: Puzzle " << index + 1 << ": solution failed verification\n";
+            failedVerify++;
+        }
+
+        sudoku::PuzzleTiming timing;
+        if (result.stats.cached)
+        {
+            cachedResults++;
+        }
+        else
+        {
+            timing.encodeMs = result.stats.encodeMs;
+            timing.solveMs = result.stats.searchMs;
+            if (solution.uniquenessChecked())
+                timing.uniqueMs = result.stats.uniqueMs;
+        }
+        timing.verifyMs = result.verifyMs;
+        timing.totalMs = solution.solveTimeMs + std::max(0.0, result.verifyMs);
+        latency.record(result.puzzle.type, id, timing);
+        if (jsonl)
+        {
+            text.clear();
+            sudoku::SudokuJson::writeSolution(solution, text, id);
+            writeLine(index, text);
+        }
+        else if (!solution.solved)
+        {
+            writeLine(index, unsolvedLine);
+        }
+        else
+        {
+            text.assign(sudoku::SudokuWriter::NUM_CELLS, '.');
+            sudoku::SudokuWriter::writeGridLine(solution.grid, &text[0]);
+            writeLine(index, text);
+        }
+    };
+
+    std::string line;
+    std::string_view record;
+    size_t total = 0;
+
+    auto nextRecord = [&]() -> bool
+    {
+        if (corpus)
+        {
+            return corpus->next(record);
+        }
+        if (gzipCorpus)
+        {
+            return gzipCorpus->next(record);
+        }
+        while (std::getline(std::cin, line))
+        {
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+            {
+                line.pop_back();
+            }
+            if (!line.empty() && line[0] != '#')
+            {
+                record = line;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Finished before the checkpoint
+    while (total < skip && nextRecord())
+    {
+        total++;
+    }
+
+    sudoku::PipelineConfig pipelineConfig;
+    pipelineConfig.parseThreads = parseThreads;
+    pipelineConfig.solveThreads = numThreads;
+    pipelineConfig.checkUniqueness = checkUniqueness;
+    pipelineConfig.verify = verify;
+    pipelineConfig.ordered = !unordered;
+    pipelineConfig.stableRecords = corpus != nullptr; // Mapped records outlive the run
+    pipelineConfig.firstIndex = skip;
+    pipelineConfig.deduplicate = dedup;
+    sudoku::BatchPipeline pipeline(pipelineConfig, parse, report);
+
+    std::shared_ptr<sudoku::SolutionCache> cache;
+    if (!cacheFile.empty())
+    {
+        cache = std::make_shared<sudoku::SolutionCache>();
+        cache->attachStore(std::make_shared<sudoku::DiskCache>(cacheFile));
+        pipeline.setCache(cache);
+    }
+
+    sudoku::PipelineStats pipelineStats = pipeline.run([&](std::string_view &next)
+                                                       {
+                                                           if (!nextRecord())
+                                                           {
+                                                               return false;
+                                                           }
+                                                           next = record;
+                                                           total++;
+                                                           return true; });
+    out.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+    out.flush();
+    if (gzipOut)
+    {
+        gzipOut->close();
+    }
+    if (!checkpointFile.empty())
+    {
+        checkpoint.markCompleted(0, total);
+        checkpoint.setOutputBytes(bytesWritten + pending.size());
+        checkpoint.save(checkpointFile);
+    }
+    total -= std::min(total, skip);
+
+    double totalSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cerr << "\nBatch statistics:\n";
+    std::cerr << "  Puzzles: " << total << "\n";
+    if (skip > 0)
+    {
+        std::cerr << "  Resumed after: " << skip << "\n";
+    }
+    std::cerr << "  Solved: " << solved << "\n";
+    if (invalid > 0)
+    {
+        std::cerr << "  Invalid lines: " << invalid << "\n";
+    }
+    if (checkUniqueness)
+    {
+        std::cerr << "  Not unique: " << notUnique << "\n";
+    }
+    if (numThreads > 1 || parseThreads > 1)
+    {
+        std::cerr << "  Threads: " << numThreads << " solvers, " << parseThreads << " parsers\n";
+        std::cerr << "  Stalls: reader " << pipelineStats.readerStalls << ", parser " << pipelineStats.parserStalls
+                  << ", solver " << pipelineStats.solverStalls << "\n";
+    }
+    std::cerr << std::fixed << std::setprecision(3);
+    std::cerr << "  Total time: " << totalSec << " s\n";
+    if (total > 0 && totalSec > 0)
+    {
+        std::cerr << "  Throughput: " << std::setprecision(1) << total / totalSec << " puzzles/s\n";
+        std::cerr << "  Average: " << std::setprecision(3) << totalSec * 1000.0 / total << " ms/puzzle\n";
+    }
+    if (cache)
+    {
+        auto stats = cache->getStats();
+        std::cerr << "  Cache hits: " << stats.hits << " (" << stats.storeHits << " from disk)\n";
+    }
+    else if (dedup)
+    {
+        std::cerr << "  Symmetric duplicates: " << cachedResults << "\n";
+    }
+    if (failedVerify > 0)
+    {
+        std::cerr << "  Failed verification: " << failedVerify << "\n";
+    }
+    if (total > 0)
+    {
+        std::cerr << latency.formatText();
+    }
+
+    if (!latencyFile.empty())
+    {
+        std::ofstream latencyOut(latencyFile);
+        latencyOut << latency.toJson(totalSec) << "\n";
+        if (!latencyOut)
+        {
+            std::cerr << "Error: Cannot write to file " << latencyFile << "\n";
+            return 1;
+        }
+    }
+
+    return solved == static_cast<long long>(total) && failedVerify == 0 ? 0 : 1;
+}
+
+std::atomic<bool> metricsDumpRequested{false};
+
+void requestMetricsDump(int)
+{
+    metricsDumpRequested.store(true);
+}
+
+/**
+ * @brief Writes the metrics to stderr whenever SIGUSR1 arrives, while alive
+ */
+class MetricsDumper
+{
+public:
+    explicit MetricsDumper(std::shared_ptr<sudoku::ServiceMetrics> metrics)
+        : metrics(std::move(metrics)), thread([this]()
+                                              { run(); })
+    {
+        std::signal(SIGUSR1, requestMetricsDump);
+    }
+
+    ~MetricsDumper()
+    {
+        done.store(true);
+        thread.join();
+    }
+
+private:
+    std::shared_ptr<sudoku::ServiceMetrics> metrics;
+    std::atomic<bool> done{false};
+    std::thread thread;
+
+    void run()
+    {
+        while (!done.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (metricsDumpRequested.exchange(false))
+            {
+                std::cerr << metrics->renderPrometheus() << std::flush;
+            }
+        }
+    }
+};
+
+int runServe(int argc, char *argv[])
+{
+    std::string cacheFile;
+    int numThreads = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--serve")
+        {
+            continue;
+        }
+        else if (arg == "--cache" && i + 1 < argc)
+        {
+            cacheFile = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            numThreads = std::stoi(argv[++i]);
+            if (numThreads == 0)
+            {
+                numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+        }
+        else
+        {
+            std::cerr << "Error: Unknown serve option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    // Each response is flushed so a client can wait for it before sending more
+    sudoku::RequestServer server(numThreads, [](const std::string &response)
+                                 { std::cout << response << '\n'
+                                             << std::flush; });
+
+    auto metrics = std::make_shared<sudoku::ServiceMetrics>();
+    server.setMetrics(metrics);
+    if (!cacheFile.empty())
+    {
+        auto cache = std::make_shared<sudoku::SolutionCache>();
+        cache->attachStore(std::make_shared<sudoku::DiskCache>(cacheFile));
+        server.setCache(cache);
+        metrics->watchCache(cache);
+    }
+    MetricsDumper dumper(metrics);
+
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+        server.submit(std::move(line));
+    }
+    server.finish();
+
+    return 0;
+}
+
+sudoku::SudokuDaemon *runningDaemon = nullptr;
+
+void stopDaemon(int)
+{
+    if (runningDaemon)
+    {
+        runningDaemon->stop();
+    }
+}
+
+int runDaemon(int argc, char *argv[])
+{
+    sudoku::DaemonConfig config;
+    std::string cacheFile;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if (arg == "--daemon")
+        {
+            continue;
+        }
+        else if (arg == "--socket" && i + 1 < argc)
+        {
+            config.socketPath = argv[++i];
+        }
+        else if (arg == "--port" && i + 1 < argc)
+        {
+            config.tcpPort = std::stoi(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            config.interactiveThreads = std::stoi(argv[++i]);
+            if (config.interactiveThreads == 0)
+            {
+                config.interactiveThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            }
+        }
+        else if (arg == "--bulk-threads" && i + 1 < argc)
+        {
+            config.bulkThreads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--max-queue" && i + 1 < argc)
+        {
+            config.maxQueued = std::stoul(argv[++i]);
+        }
+        else if (arg == "--micro-batch" && i + 1 < argc)
+        {
+            config.microBatch = std::max<size_t>(1, std::stoul(argv[++i]));
+        }
+        else if (arg == "--deadline" && i + 1 < argc)
+        {
+            config.defaultDeadlineMs = std::stod(argv[++i]);
+        }
+        else if (arg == "--cache" && i + 1 < argc)
+        {
+            cacheFile = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Error: Unknown daemon option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    sudoku::SudokuDaemon daemon(config);
+    auto metrics = std::make_shared<sudoku::ServiceMetrics>();
+    daemon.setMetrics(metrics);
+    if (!cacheFile.empty())
+    {
+        auto cache = std::make_shared<sudoku::SolutionCache>();
+        cache->attachStore(std::make_shared<sudoku::DiskCache>(cacheFile));
+        daemon.setCache(cache);
+        metrics->watchCache(cache);
+    }
+    MetricsDumper dumper(metrics);
+
+    if (!config.socketPath.empty())
+    {
+        std::cerr << "Listening on " << config.socketPath << "\n";
+    }
+    if (daemon.getTcpPort() >= 0)
+    {
+        std::cerr << "Listening on 127.0.0.1:" << daemon.getTcpPort() << "\n";
+    }
+
+    runningDaemon = &daemon;
+    std::signal(SIGINT, stopDaemon);
+    std::signal(SIGTERM, stopDaemon);
+    daemon.run();
+    runningDaemon = nullptr;
+
+    auto stats = daemon.getStats();
+    std::cerr << "Daemon stopped:\n";
+    std::cerr << "  Connections: " << stats.connections << "\n";
+    std::cerr << "  Requests: " << stats.requests << "\n";
+    std::cerr << "  Coalesced: " << stats.coalesced << "\n";
+    std::cerr << "  Micro-batches: " << stats.batches << "\n";
+    std::cerr << "  Rejected: " << stats.rejected << "\n";
+    std::cerr << "  Expired: " << stats.expired << "\n";
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     if (argc < 2)
@@ -244,12 +1309,43 @@ int main(int argc, char *argv[])
         return runGenerate(argc, argv);
     }
 
+    // Handle batch, serve and daemon modes
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--serve") == 0 || std::strcmp(argv[i], "--daemon") == 0)
+        {
+            try
+            {
+                return std::strcmp(argv[i], "--serve") == 0 ? runServe(argc, argv) : runDaemon(argc, argv);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 1;
+            }
+        }
+        if (std::strcmp(argv[i], "--batch") == 0 || std::strcmp(argv[i], "-b") == 0)
+        {
+            try
+            {
+                return runBatch(argc, argv);
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Error: " << e.what() << "\n";
+                return 1;
+            }
+        }
+    }
+
     try
     {
         sudoku::SudokuSolver solver;
         sudoku::SudokuPuzzle puzzle;
         bool checkUniqueness = false;
         bool puzzleLoaded = false;
+        std::string convertFormat;
+        std::string convertFile;
 
         // Parse arguments
         for (int i = 1; i < argc; i++)
@@ -259,6 +1355,16 @@ int main(int argc, char *argv[])
             {
                 checkUniqueness = true;
             }
+            else if (arg == "--cache" && i + 1 < argc)
+            {
+                solver.enableCache();
+                solver.getCache()->attachStore(std::make_shared<sudoku::DiskCache>(argv[++i]));
+            }
+            else if ((arg == "--to-binary" || arg == "--to-text" || arg == "--to-json") && i + 1 < argc)
+            {
+                convertFormat = arg.substr(5);
+                convertFile = argv[++i];
+            }
             else if (arg == "--string" || arg == "-s")
             {
                 if (puzzleLoaded)
@@ -302,6 +1408,27 @@ int main(int argc, char *argv[])
             return 1;
         }
 
+        if (!convertFile.empty())
+        {
+            std::string output;
+            if (convertFormat == "binary")
+                output = sudoku::SudokuGenerator::toBinaryFormat(puzzle);
+            else if (convertFormat == "json")
+                output = sudoku::SudokuJson::writePuzzle(puzzle) + "\n";
+            else
+                output = sudoku::SudokuGenerator::toCustomFormat(puzzle);
+
+            std::ofstream file(convertFile, std::ios::binary);
+            if (!file || !(file << output))
+            {
+                std::cerr << "Error: Cannot write to file " << convertFile << "\n";
+                return 1;
+            }
+            std::cerr << "Converted to " << convertFormat << ": " << convertFile << " (" << output.size()
+                      << " bytes)\n";
+            return 0;
+        }
+
         printPuzzleInfo(puzzle);
         std::cout << "\nSolving" << (checkUniqueness ? " (with uniqueness check)" : "") << "...\n\n";
 
@@ -335,8 +1462,15 @@ int main(int argc, char *argv[])
             }
 
             std::cout << "\nStatistics:\n";
-            std::cout << "  Variables: " << solver.getNumVariables() << "\n";
-            std::cout << "  Clauses: " << solver.getNumClauses() << "\n";
+            if (solver.getCache() && solver.getCache()->getStats().hits > 0)
+            {
+                std::cout << "  Answered from cache\n";
+            }
+            else
+            {
+                std::cout << "  Variables: " << solver.getNumVariables() << "\n";
+                std::cout << "  Clauses: " << solver.getNumClauses() << "\n";
+            }
             std::cout << "  Solve time: " << solution.solveTimeMs << " ms\n";
         }
 
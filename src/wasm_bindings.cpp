@@ -3,15 +3,50 @@
  * @brief WebAssembly bindings for Sudoku Solver
  *
  * Provides JavaScript-callable functions for solving and generating Sudoku puzzles.
+ *
+ * Two APIs are exported:
+ * - String API (solvePuzzle, generatePuzzle, verifySolution): custom-format
+ *   text in, JSON text out. Kept for compatibility.
+ * - Typed-array API (getBuffers, solveGrid, generateGrid, verifyGrid,
+ *   generateBatch):
+ *   puzzles, solutions and stats are exchanged through fixed buffers in
+ *   WASM memory that JavaScript reads and writes as Uint8Array, Int32Array
+ *   and Float64Array views, with no text serialization either way.
+ *
+ * Typed-array buffer layouts:
+ *   grid          Uint8Array(81)   puzzle givens, row-major, 0 = empty
+ *   solution      Uint8Array(81)   solution grid, row-major
+ *   cages         Int32Array       [count, then per cage: sum, size, cell...] (cell = row * 9 + col)
+ *   inequalities  Int32Array       [count, then per constraint: cell1, cell2, 1 if cell1 > cell2 else -1]
+ *   stats         Float64Array(8)  see StatsSlot
+ *
+ * Views become detached when WASM memory grows, so take fresh ones from
+ * getBuffers() before each use rather than keeping them.
+ *
+ * setProgressCallback() reports generation progress to JavaScript and lets
+ * the callback cancel a slow generation by returning false.
+ *
+ * Built with -DSUDOKU_WASM_THREADS=ON this file becomes sudoku_wasm_mt, a
+ * pthreads module whose generator tests constraint removals on the worker
+ * pool in parallel. It needs SharedArrayBuffer (a cross-origin isolated
+ * page or Node); getThreadCount() reports 1 for the single-threaded module.
  */
 
 #include "SudokuSolver.h"
 #include "SudokuGenerator.h"
 #include "SudokuParser.h"
+#include "SudokuWriter.h"
 #include <emscripten/emscripten.h>
 #include <emscripten/bind.h>
+#include <emscripten/val.h>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
 #include <string>
-#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace sudoku;
 using namespace emscripten;
@@ -19,6 +54,180 @@ using namespace emscripten;
 // Global instances for reuse
 static SudokuSolver g_solver;
 static SudokuGenerator g_generator;
+static std::vector<std::unique_ptr<SudokuGenerator>> g_batchGenerators; // Extra threads of generateBatch
+
+namespace
+{
+    const int kNumCells = GRID_SIZE * GRID_SIZE;
+
+    // Typed-array buffer capacities
+    const int kMaxCageInts = 1 + 3 * kNumCells; // At most one cage per cell: sum, size, cell
+    const int kMaxInequalities = 256;
+    const int kMaxInequalityInts = 1 + 3 * kMaxInequalities;
+
+    /**
+     * @brief Slots of the stats buffer
+     */
+    enum StatsSlot
+    {
+        STATS_SOLVE_MS,
+        STATS_ENCODE_MS,
+        STATS_SEARCH_MS,
+        STATS_UNIQUE_MS,
+        STATS_VARIABLES,
+        STATS_CLAUSES,
+        STATS_CONFLICTS,
+        STATS_DECISIONS,
+        NUM_STATS
+    };
+
+    /**
+     * @brief Return codes of the typed-array API
+     */
+    enum TypedStatus
+    {
+        STATUS_CANCELLED = -2, // Generation stopped by the progress callback
+        STATUS_ERROR = -1,     // Invalid buffers; see getLastError()
+        STATUS_UNSOLVED = 0,   // No solution
+        STATUS_SOLVED = 1,     // Solved, uniqueness not checked
+        STATUS_UNIQUE = 2,     // Solved, and the solution is unique
+        STATUS_NOT_UNIQUE = 3  // Solved, but another solution exists
+    };
+
+    // Shared with JavaScript through typed-array views
+    struct ExchangeBuffers
+    {
+        uint8_t grid[kNumCells];
+        uint8_t solution[kNumCells];
+        int32_t cages[kMaxCageInts];
+        int32_t inequalities[kMaxInequalityInts];
+        double stats[NUM_STATS];
+    };
+
+    ExchangeBuffers g_buffers;
+    std::string g_lastError;
+
+#if defined(__EMSCRIPTEN_PTHREADS__) && defined(SUDOKU_WASM_POOL_SIZE)
+    // The preallocated pool plus the calling thread
+    const int kMaxThreads = SUDOKU_WASM_POOL_SIZE + 1;
+#else
+    const int kMaxThreads = 1;
+#endif
+
+    int checkedCell(int32_t cell)
+    {
+        if (cell < 0 || cell >= kNumCells)
+        {
+            throw std::runtime_error("cell index out of range: " + std::to_string(cell));
+        }
+        return cell;
+    }
+
+    /**
+     * @brief Build a puzzle from the grid, cages and inequalities buffers
+     */
+    SudokuPuzzle readPuzzle()
+    {
+        SudokuPuzzle puzzle;
+        for (int i = 0; i < kNumCells; i++)
+        {
+            if (g_buffers.grid[i] > MAX_VALUE)
+            {
+                throw std::runtime_error("grid value out of range at cell " + std::to_string(i));
+            }
+            puzzle.grid[i / GRID_SIZE][i % GRID_SIZE] = g_buffers.grid[i];
+        }
+
+        const int32_t *cages = g_buffers.cages;
+        int pos = 1;
+        for (int32_t n = 0; n < cages[0]; n++)
+        {
+            if (pos + 2 > kMaxCageInts || cages[pos + 1] < 1 || pos + 2 + cages[pos + 1] > kMaxCageInts)
+            {
+                throw std::runtime_error("cages buffer is malformed");
+            }
+            Cage cage;
+            cage.targetSum = cages[pos];
+            int size = cages[pos + 1];
+            pos += 2;
+            for (int i = 0; i < size; i++)
+            {
+                int cell = checkedCell(cages[pos++]);
+                cage.cells.emplace_back(cell / GRID_SIZE, cell % GRID_SIZE);
+            }
+            puzzle.addCage(cage);
+        }
+
+        const int32_t *inequalities = g_buffers.inequalities;
+        if (inequalities[0] < 0 || inequalities[0] > kMaxInequalities)
+        {
+            throw std::runtime_error("inequalities buffer is malformed");
+        }
+        for (int32_t n = 0; n < inequalities[0]; n++)
+        {
+            const int32_t *entry = inequalities + 1 + 3 * n;
+            int cell1 = checkedCell(entry[0]);
+            int cell2 = checkedCell(entry[1]);
+            puzzle.addInequality(InequalityConstraint(
+                Cell(cell1 / GRID_SIZE, cell1 % GRID_SIZE), Cell(cell2 / GRID_SIZE, cell2 % GRID_SIZE),
+                entry[2] > 0 ? InequalityType::GREATER_THAN : InequalityType::LESS_THAN));
+        }
+        return puzzle;
+    }
+
+    /**
+     * @brief Store a puzzle in the grid, cages and inequalities buffers
+     */
+    /**
+     * @brief Write a puzzle to the grid, cages and inequalities buffers
+     * @return Number of ints used in the cages buffer
+     */
+    int writePuzzle(const SudokuPuzzle &puzzle)
+    {
+        if (static_cast<int>(puzzle.inequalities.size()) > kMaxInequalities)
+        {
+            throw std::runtime_error("too many inequalities for the typed-array buffers");
+        }
+        for (int i = 0; i < kNumCells; i++)
+        {
+            g_buffers.grid[i] = static_cast<uint8_t>(puzzle.grid[i / GRID_SIZE][i % GRID_SIZE]);
+        }
+
+        int pos = 1;
+        for (const Cage &cage : puzzle.cages)
+        {
+            if (pos + 2 + static_cast<int>(cage.cells.size()) > kMaxCageInts)
+            {
+                throw std::runtime_error("too many cage cells for the typed-array buffers");
+            }
+            g_buffers.cages[pos++] = cage.targetSum;
+            g_buffers.cages[pos++] = static_cast<int32_t>(cage.cells.size());
+            for (const Cell &cell : cage.cells)
+            {
+                g_buffers.cages[pos++] = cell.row * GRID_SIZE + cell.col;
+            }
+        }
+        g_buffers.cages[0] = static_cast<int32_t>(puzzle.cages.size());
+
+        g_buffers.inequalities[0] = static_cast<int32_t>(puzzle.inequalities.size());
+        int32_t *entry = g_buffers.inequalities + 1;
+        for (const InequalityConstraint &ineq : puzzle.inequalities)
+        {
+            *entry++ = ineq.cell1.row * GRID_SIZE + ineq.cell1.col;
+            *entry++ = ineq.cell2.row * GRID_SIZE + ineq.cell2.col;
+            *entry++ = ineq.type == InequalityType::GREATER_THAN ? 1 : -1;
+        }
+        return pos;
+    }
+
+    void writeSolution(const SudokuSolution &solution)
+    {
+        for (int i = 0; i < kNumCells; i++)
+        {
+            g_buffers.solution[i] = static_cast<uint8_t>(solution.grid[i / GRID_SIZE][i % GRID_SIZE]);
+        }
+    }
+} // namespace
 
 /**
  * @brief Solve a Sudoku puzzle from custom format string
@@ -28,22 +237,25 @@ static SudokuGenerator g_generator;
  */
 std::string solvePuzzle(const std::string &input, bool checkUniqueness)
 {
-    std::ostringstream result;
+    std::string result;
 
     try
     {
         SudokuPuzzle puzzle = SudokuParser::parseFromString(input);
         SudokuSolution solution = g_solver.solve(puzzle, checkUniqueness);
 
-        result << "{";
-        result << "\"solved\":" << (solution.solved ? "true" : "false") << ",";
-        result << "\"solveTimeMs\":" << solution.solveTimeMs << ",";
-        result << "\"variables\":" << g_solver.getNumVariables() << ",";
-        result << "\"clauses\":" << g_solver.getNumClauses() << ",";
+        result.reserve(512);
+        result += solution.solved ? "{\"solved\":true" : "{\"solved\":false";
+        result += ",\"solveTimeMs\":";
+        SudokuWriter::appendGeneral(result, solution.solveTimeMs);
+        result += ",\"variables\":";
+        SudokuWriter::appendInt(result, g_solver.getNumVariables());
+        result += ",\"clauses\":";
+        SudokuWriter::appendInt(result, g_solver.getNumClauses());
 
         if (checkUniqueness)
         {
-            std::string uniqueStatus = "unknown";
+            const char *uniqueStatus = "unknown";
             if (solution.uniqueness == UniquenessStatus::UNIQUE)
             {
                 uniqueStatus = "unique";
@@ -52,66 +264,64 @@ std::string solvePuzzle(const std::string &input, bool checkUniqueness)
             {
                 uniqueStatus = "not_unique";
             }
-            result << "\"uniqueness\":\"" << uniqueStatus << "\",";
+            result += ",\"uniqueness\":\"";
+            result += uniqueStatus;
+            result += '"';
         }
 
         if (solution.solved)
         {
-            result << "\"grid\":[";
-            for (int r = 0; r < GRID_SIZE; r++)
-            {
-                if (r > 0)
-                    result << ",";
-                result << "[";
-                for (int c = 0; c < GRID_SIZE; c++)
-                {
-                    if (c > 0)
-                        result << ",";
-                    result << solution.grid[r][c];
-                }
-                result << "]";
-            }
-            result << "]";
+            result += ",\"grid\":";
+            SudokuWriter::appendGridJson(result, solution.grid);
         }
         else
         {
-            result << "\"error\":\"" << solution.errorMessage << "\"";
+            result += ",\"error\":";
+            SudokuWriter::appendJsonString(result, solution.errorMessage);
         }
 
-        result << "}";
+        result += '}';
     }
     catch (const std::exception &e)
     {
-        result.str("");
-        result << "{\"solved\":false,\"error\":\"" << e.what() << "\"}";
+        result = "{\"solved\":false,\"error\":";
+        SudokuWriter::appendJsonString(result, e.what());
+        result += '}';
     }
 
-    return result.str();
+    return result;
 }
 
 /**
- * @brief Generate a new Sudoku puzzle
+ * @brief Threads the generator minimizes with: 1 unless this is the pthreads module
+ */
+int getThreadCount()
+{
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, std::min(kMaxThreads, cores));
+}
+
+/**
+ * @brief Build the generator settings shared by the string and typed-array APIs
  * @param typeStr Puzzle type: "standard", "killer", "inequality", "mixed"
  * @param minCages Minimum number of cages (for killer/mixed)
  * @param maxCages Maximum number of cages
  * @param minInequalities Minimum number of inequalities (for inequality/mixed)
  * @param maxInequalities Maximum number of inequalities
  * @param seed Random seed (0 for random)
- * @param includeSolution Whether to include solution in output
  * @param fillAllCells Whether cages should fill all cells
  * @param ensureUniqueSolution Whether to ensure unique solution
  * @param difficulty Difficulty percentage (0-100): controls constraint removal ratio
  *                   0 = easiest (keep most constraints), 100 = hardest (remove most constraints)
- * @return Puzzle in custom format string
+ * @return Generator settings for the type and difficulty
  */
-std::string generatePuzzle(
+static GeneratorConfig makeGeneratorConfig(
     const std::string &typeStr,
     int minCages,
     int maxCages,
     int minInequalities,
     int maxInequalities,
     unsigned int seed,
-    bool includeSolution,
     bool fillAllCells,
     bool ensureUniqueSolution,
     int difficulty)
@@ -168,6 +378,40 @@ std::string generatePuzzle(
         config.minCages = config.maxCages = 0;
     }
 
+    config.minimizeThreads = getThreadCount();
+    return config;
+}
+
+/**
+ * @brief Generate a new Sudoku puzzle
+ * @param typeStr Puzzle type: "standard", "killer", "inequality", "mixed"
+ * @param minCages Minimum number of cages (for killer/mixed)
+ * @param maxCages Maximum number of cages
+ * @param minInequalities Minimum number of inequalities (for inequality/mixed)
+ * @param maxInequalities Maximum number of inequalities
+ * @param seed Random seed (0 for random)
+ * @param includeSolution Whether to include solution in output
+ * @param fillAllCells Whether cages should fill all cells
+ * @param ensureUniqueSolution Whether to ensure unique solution
+ * @param difficulty Difficulty percentage (0-100): controls constraint removal ratio
+ *                   0 = easiest (keep most constraints), 100 = hardest (remove most constraints)
+ * @return Puzzle in custom format string
+ */
+std::string generatePuzzle(
+    const std::string &typeStr,
+    int minCages,
+    int maxCages,
+    int minInequalities,
+    int maxInequalities,
+    unsigned int seed,
+    bool includeSolution,
+    bool fillAllCells,
+    bool ensureUniqueSolution,
+    int difficulty)
+{
+    GeneratorConfig config = makeGeneratorConfig(typeStr, minCages, maxCages, minInequalities, maxInequalities,
+                                                 seed, fillAllCells, ensureUniqueSolution, difficulty);
+
     SudokuSolution solution;
     SudokuPuzzle puzzle = g_generator.generateWithSolution(config, solution);
 
@@ -189,7 +433,7 @@ std::string generatePuzzle(
  */
 std::string verifySolution(const std::string &puzzleStr, const std::string &solutionStr)
 {
-    std::ostringstream result;
+    std::string result;
 
     try
     {
@@ -224,14 +468,319 @@ std::string verifySolution(const std::string &puzzleStr, const std::string &solu
 
         bool valid = SudokuSolver::verifySolution(puzzle, solution);
 
-        result << "{\"valid\":" << (valid ? "true" : "false") << "}";
+        result = valid ? "{\"valid\":true}" : "{\"valid\":false}";
     }
     catch (const std::exception &e)
     {
-        result << "{\"valid\":false,\"error\":\"" << e.what() << "\"}";
+        result = "{\"valid\":false,\"error\":";
+        SudokuWriter::appendJsonString(result, e.what());
+        result += '}';
     }
 
-    return result.str();
+    return result;
+}
+
+/**
+ * @brief Typed-array views of the exchange buffers
+ * @return Object with grid, solution, cages, inequalities and stats views
+ */
+val getBuffers()
+{
+    val buffers = val::object();
+    buffers.set("grid", val(typed_memory_view(kNumCells, g_buffers.grid)));
+    buffers.set("solution", val(typed_memory_view(kNumCells, g_buffers.solution)));
+    buffers.set("cages", val(typed_memory_view(kMaxCageInts, g_buffers.cages)));
+    buffers.set("inequalities", val(typed_memory_view(kMaxInequalityInts, g_buffers.inequalities)));
+    buffers.set("stats", val(typed_memory_view(static_cast<size_t>(NUM_STATS), g_buffers.stats)));
+    return buffers;
+}
+
+/**
+ * @brief Solve the puzzle held in the grid, cages and inequalities buffers
+ *
+ * Writes the solution to the solution buffer and the timings and formula
+ * size to the stats buffer.
+ *
+ * @param checkUniqueness Whether to check for unique solution
+ * @return A TypedStatus code
+ */
+int solveGrid(bool checkUniqueness)
+{
+    try
+    {
+        SudokuPuzzle puzzle = readPuzzle();
+        SudokuSolution solution = g_solver.solve(puzzle, checkUniqueness);
+
+        const SolveStats &stats = g_solver.getLastStats();
+        double *out = g_buffers.stats;
+        out[STATS_SOLVE_MS] = solution.solveTimeMs;
+        out[STATS_ENCODE_MS] = stats.encodeMs;
+        out[STATS_SEARCH_MS] = stats.searchMs;
+        out[STATS_UNIQUE_MS] = stats.uniqueMs;
+        out[STATS_VARIABLES] = g_solver.getNumVariables();
+        out[STATS_CLAUSES] = g_solver.getNumClauses();
+        out[STATS_CONFLICTS] = static_cast<double>(stats.conflicts);
+        out[STATS_DECISIONS] = static_cast<double>(stats.decisions);
+
+        if (!solution.solved)
+        {
+            g_lastError = solution.errorMessage;
+            return STATUS_UNSOLVED;
+        }
+        writeSolution(solution);
+        if (solution.uniqueness == UniquenessStatus::UNIQUE)
+        {
+            return STATUS_UNIQUE;
+        }
+        if (solution.uniqueness == UniquenessStatus::NOT_UNIQUE)
+        {
+            return STATUS_NOT_UNIQUE;
+        }
+        return STATUS_SOLVED;
+    }
+    catch (const std::exception &e)
+    {
+        g_lastError = e.what();
+        return STATUS_ERROR;
+    }
+}
+
+/**
+ * @brief Generate a puzzle into the grid, cages and inequalities buffers
+ *
+ * Takes the same settings as generatePuzzle; the solution always goes to
+ * the solution buffer.
+ *
+ * @return STATUS_SOLVED, or STATUS_ERROR
+ */
+int generateGrid(
+    const std::string &typeStr,
+    int minCages,
+    int maxCages,
+    int minInequalities,
+    int maxInequalities,
+    unsigned int seed,
+    bool fillAllCells,
+    bool ensureUniqueSolution,
+    int difficulty)
+{
+    try
+    {
+        GeneratorConfig config = makeGeneratorConfig(typeStr, minCages, maxCages, minInequalities, maxInequalities,
+                                                     seed, fillAllCells, ensureUniqueSolution, difficulty);
+        SudokuSolution solution;
+        SudokuPuzzle puzzle = g_generator.generateWithSolution(config, solution);
+        writePuzzle(puzzle);
+        writeSolution(solution);
+        return STATUS_SOLVED;
+    }
+    catch (const std::exception &e)
+    {
+        g_lastError = e.what();
+        return g_generator.wasCancelled() ? STATUS_CANCELLED : STATUS_ERROR;
+    }
+}
+
+/**
+ * @brief Report generation progress to a JavaScript function; null removes it
+ *
+ * Called as callback(phase, trialsDone, trialsRemaining) between solver
+ * calls, with phase 0 = fill, 1 = uniqueness, 2 = minimize. Returning false
+ * cancels: the SAT search is interrupted and generateGrid returns
+ * STATUS_CANCELLED (generatePuzzle returns an error).
+ */
+void setProgressCallback(val callback)
+{
+    if (callback.isNull() || callback.isUndefined())
+    {
+        g_generator.setProgressCallback(nullptr);
+        return;
+    }
+    g_generator.setProgressCallback([callback](const GenerationProgress &progress)
+                                    {
+        val keepGoing = callback(static_cast<int>(progress.phase), progress.trialsDone, progress.trialsRemaining);
+        return !keepGoing.isFalse(); });
+}
+
+namespace
+{
+    template <class T>
+    T configField(const val &options, const char *key, T fallback)
+    {
+        val field = options[key];
+        return field.isUndefined() || field.isNull() ? fallback : field.as<T>();
+    }
+
+    // Copy a buffer prefix out of WASM memory into a new typed array
+    template <class T>
+    val copyArray(const char *type, const T *data, size_t count)
+    {
+        return val::global(type).new_(typed_memory_view(count, data));
+    }
+} // namespace
+
+/**
+ * @brief Generate several puzzles in one call
+ *
+ * Keeps the generators and their solvers warm between puzzles and returns
+ * typed arrays instead of text. With a nonzero seed, puzzle i uses seed + i,
+ * so a batch is reproducible. The pthreads module generates on up to
+ * getThreadCount() threads at once.
+ *
+ * @param options Object with the generatePuzzle parameters as fields (type,
+ *                minCages, maxCages, minInequalities, maxInequalities, seed,
+ *                fillAllCells, ensureUniqueSolution, difficulty); missing
+ *                fields take the worker's defaults
+ * @param count Number of puzzles
+ * @return Array of {grid, solution, cages, inequalities} in the exchange
+ *         buffer layouts. Shorter than count if the progress callback
+ *         cancelled; empty with getLastError() set on failure.
+ */
+val generateBatch(val options, int count)
+{
+    val puzzles = val::array();
+    try
+    {
+        GeneratorConfig config = makeGeneratorConfig(
+            configField<std::string>(options, "type", "mixed"),
+            configField(options, "minCages", 12),
+            configField(options, "maxCages", 18),
+            configField(options, "minInequalities", 15),
+            configField(options, "maxInequalities", 25),
+            configField(options, "seed", 0u),
+            configField(options, "fillAllCells", false),
+            configField(options, "ensureUniqueSolution", true),
+            configField(options, "difficulty", 50));
+
+        count = std::max(0, count);
+        std::vector<SudokuPuzzle> generated(static_cast<size_t>(count));
+        std::vector<SudokuSolution> solutions(static_cast<size_t>(count));
+        std::vector<char> done(static_cast<size_t>(count), 0);
+
+        // One puzzle per thread; parallel minimization only when a single thread generates
+        const int threads = std::max(1, std::min(config.minimizeThreads, count));
+        if (threads > 1)
+        {
+            config.minimizeThreads = 1;
+        }
+        while (static_cast<int>(g_batchGenerators.size()) < threads - 1)
+        {
+            g_batchGenerators.push_back(std::make_unique<SudokuGenerator>());
+        }
+
+        auto generateEvery = [&](SudokuGenerator &generator, int first)
+        {
+            for (int i = first; i < count; i += threads)
+            {
+                GeneratorConfig puzzleConfig = config;
+                if (config.seed != 0)
+                {
+                    puzzleConfig.seed = config.seed + static_cast<unsigned int>(i);
+                }
+                generated[i] = generator.generateWithSolution(puzzleConfig, solutions[i]);
+                done[i] = 1;
+            }
+        };
+
+        // Only this thread may call the JavaScript progress callback, so only
+        // g_generator has it; when it cancels, the other generators follow
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> failures(static_cast<size_t>(threads));
+        for (int t = 1; t < threads; t++)
+        {
+            workers.emplace_back([&, t]()
+                                 {
+                try
+                {
+                    generateEvery(*g_batchGenerators[t - 1], t);
+                }
+                catch (...)
+                {
+                    failures[t] = std::current_exception();
+                } });
+        }
+        try
+        {
+            generateEvery(g_generator, 0);
+        }
+        catch (...)
+        {
+            failures[0] = std::current_exception();
+            for (int t = 1; t < threads; t++)
+            {
+                g_batchGenerators[t - 1]->cancel();
+            }
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        if (failures[0] && !g_generator.wasCancelled())
+        {
+            std::rethrow_exception(failures[0]);
+        }
+        for (int t = 1; t < threads; t++)
+        {
+            if (failures[t] && !g_batchGenerators[t - 1]->wasCancelled())
+            {
+                std::rethrow_exception(failures[t]);
+            }
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            if (!done[i])
+            {
+                continue;
+            }
+            int cageInts = writePuzzle(generated[i]);
+            writeSolution(solutions[i]);
+            val entry = val::object();
+            entry.set("grid", copyArray("Uint8Array", g_buffers.grid, kNumCells));
+            entry.set("solution", copyArray("Uint8Array", g_buffers.solution, kNumCells));
+            entry.set("cages", copyArray("Int32Array", g_buffers.cages, static_cast<size_t>(cageInts)));
+            entry.set("inequalities", copyArray("Int32Array", g_buffers.inequalities,
+                                                1 + 3 * generated[i].inequalities.size()));
+            puzzles.call<void>("push", entry);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        g_lastError = e.what();
+        return val::array();
+    }
+    return puzzles;
+}
+
+/**
+ * @brief Verify the solution buffer against the puzzle buffers
+ */
+bool verifyGrid()
+{
+    try
+    {
+        SudokuPuzzle puzzle = readPuzzle();
+        SudokuSolution solution;
+        solution.solved = true;
+        for (int i = 0; i < kNumCells; i++)
+        {
+            solution.grid[i / GRID_SIZE][i % GRID_SIZE] = g_buffers.solution[i];
+        }
+        return SudokuSolver::verifySolution(puzzle, solution);
+    }
+    catch (const std::exception &e)
+    {
+        g_lastError = e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Reason for the last STATUS_ERROR or STATUS_UNSOLVED of the typed-array API
+ */
+std::string getLastError()
+{
+    return g_lastError;
 }
 
 /**
@@ -249,4 +798,14 @@ EMSCRIPTEN_BINDINGS(sudoku_solver)
     function("generatePuzzle", &generatePuzzle);
     function("verifySolution", &verifySolution);
     function("getVersion", &getVersion);
+    function("getThreadCount", &getThreadCount);
+
+    // Typed-array API
+    function("getBuffers", &getBuffers);
+    function("solveGrid", &solveGrid);
+    function("generateGrid", &generateGrid);
+    function("verifyGrid", &verifyGrid);
+    function("getLastError", &getLastError);
+    function("setProgressCallback", &setProgressCallback);
+    function("generateBatch", &generateBatch);
 }
@@ -0,0 +1,93 @@
+/**
+ * @file test_batch.cpp
+ * @brief Tests for the work-stealing pool and the reorder buffer
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuBatch.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+using namespace sudoku;
+
+// Test: Every task runs exactly once and wait() covers all of them
+TEST(WorkStealingPoolTest, RunsEveryTask)
+{
+    std::atomic<int> sum{0};
+    {
+        WorkStealingPool pool(4);
+        for (int i = 1; i <= 1000; i++)
+        {
+            pool.submit([&sum, i](int)
+                        { sum += i; });
+        }
+        pool.wait();
+        EXPECT_EQ(sum.load(), 500500);
+    }
+}
+
+// Test: Idle workers steal from a worker with slow tasks
+TEST(WorkStealingPoolTest, StealsFromBusyWorker)
+{
+    WorkStealingPool pool(2);
+    std::atomic<int> done{0};
+    // Round-robin puts every even task on worker 0; make those slow
+    for (int i = 0; i < 20; i++)
+    {
+        pool.submit([&done, i](int)
+                    {
+                        if (i % 2 == 0)
+                            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                        done++; });
+    }
+    pool.wait();
+    EXPECT_EQ(done.load(), 20);
+    EXPECT_GT(pool.getSteals(), 0u);
+}
+
+// Test: A worker starts its own tasks in submission order
+TEST(WorkStealingPoolTest, OwnTasksRunOldestFirst)
+{
+    WorkStealingPool pool(1);
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::vector<int> order;
+
+    // The first task keeps the worker busy until the rest are queued behind it
+    pool.submit([&](int)
+                { std::lock_guard<std::mutex> lock(gate); });
+    for (int i = 0; i < 10; i++)
+    {
+        pool.submit([&order, i](int)
+                    { order.push_back(i); });
+    }
+    hold.unlock();
+    pool.wait();
+
+    ASSERT_EQ(order.size(), 10u);
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+// Test: Results come back in input order through the reorder buffer
+TEST(ReorderBufferTest, EmitsInOrder)
+{
+    std::vector<size_t> emitted;
+    ReorderBuffer<int> buffer([&](size_t index, const int &value)
+                              {
+                                  EXPECT_EQ(static_cast<int>(index) * 10, value);
+                                  emitted.push_back(index); });
+
+    buffer.put(2, 20);
+    buffer.put(1, 10);
+    EXPECT_TRUE(emitted.empty());
+    EXPECT_EQ(buffer.waiting(), 2u);
+    buffer.put(0, 0);
+    buffer.put(3, 30);
+    EXPECT_EQ(emitted, (std::vector<size_t>{0, 1, 2, 3}));
+    EXPECT_EQ(buffer.waiting(), 0u);
+}
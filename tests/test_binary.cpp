@@ -0,0 +1,120 @@
+/**
+ * @file test_binary.cpp
+ * @brief Tests for the compact binary puzzle format
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuBinary.h"
+#include "SudokuGenerator.h"
+#include "SudokuParser.h"
+#include <set>
+#include <tuple>
+
+using namespace sudoku;
+
+namespace
+{
+    // Inequalities as (smaller cell, larger cell) so orientation does not matter
+    std::set<std::pair<Cell, Cell>> normalizedInequalities(const SudokuPuzzle &puzzle)
+    {
+        std::set<std::pair<Cell, Cell>> result;
+        for (const auto &ineq : puzzle.inequalities)
+        {
+            if (ineq.type == InequalityType::LESS_THAN)
+                result.insert({ineq.cell1, ineq.cell2});
+            else
+                result.insert({ineq.cell2, ineq.cell1});
+        }
+        return result;
+    }
+
+    std::set<std::pair<int, std::set<Cell>>> cageSet(const SudokuPuzzle &puzzle)
+    {
+        std::set<std::pair<int, std::set<Cell>>> result;
+        for (const auto &cage : puzzle.cages)
+        {
+            result.insert({cage.targetSum, std::set<Cell>(cage.cells.begin(), cage.cells.end())});
+        }
+        return result;
+    }
+} // namespace
+
+// Test: A generated mixed puzzle and its solution round-trip in a small record
+TEST(BinaryTest, MixedPuzzleRoundTrip)
+{
+    GeneratorConfig config;
+    config.type = SudokuType::KILLER_INEQUALITY;
+    config.minCages = config.maxCages = 12;
+    config.minInequalities = config.maxInequalities = 15;
+    config.ensureUniqueSolution = false;
+    config.seed = 7;
+
+    SudokuGenerator generator;
+    SudokuSolution solution;
+    SudokuPuzzle puzzle = generator.generateWithSolution(config, solution);
+    solution.uniqueness = UniquenessStatus::UNIQUE;
+
+    std::string binary = SudokuGenerator::toBinaryFormat(puzzle, &solution);
+    std::string text = SudokuGenerator::toCustomFormat(puzzle);
+    EXPECT_LT(binary.size(), 200u);
+    EXPECT_LT(binary.size() * 3, text.size());
+
+    SudokuSolution stored;
+    size_t consumed = 0;
+    SudokuPuzzle parsed = SudokuBinary::read(binary, &stored, &consumed);
+    EXPECT_EQ(consumed, binary.size());
+    EXPECT_EQ(parsed.type, puzzle.type);
+    EXPECT_EQ(cageSet(parsed), cageSet(puzzle));
+    EXPECT_EQ(normalizedInequalities(parsed), normalizedInequalities(puzzle));
+    ASSERT_TRUE(stored.solved);
+    EXPECT_EQ(stored.uniqueness, UniquenessStatus::UNIQUE);
+    for (int r = 0; r < 9; r++)
+    {
+        for (int c = 0; c < 9; c++)
+        {
+            EXPECT_EQ(parsed.grid[r][c], puzzle.grid[r][c]);
+            EXPECT_EQ(stored.grid[r][c], solution.grid[r][c]);
+        }
+    }
+
+    // The text parser recognizes binary records too
+    EXPECT_EQ(cageSet(SudokuParser::parseFromString(binary)), cageSet(puzzle));
+}
+
+// Test: Records are self-delimiting and larger geometries are supported
+TEST(BinaryTest, ConcatenatedRecordsAndGeometry)
+{
+    using Binary16 = BasicSudokuBinary<Geometry16x16>;
+    BasicSudokuPuzzle<Geometry16x16> big;
+    big.setCell(15, 15, 16);
+    big.addCage(Cage({Cell(0, 0), Cell(0, 1), Cell(1, 0)}, 48));
+    big.addInequality(InequalityConstraint(Cell(7, 3), Cell(6, 3), InequalityType::GREATER_THAN));
+
+    std::string data = Binary16::write(big) + Binary16::write(BasicSudokuPuzzle<Geometry16x16>());
+    size_t consumed = 0;
+    auto first = Binary16::read(data, nullptr, &consumed);
+    auto second = Binary16::read(std::string_view(data).substr(consumed));
+    EXPECT_EQ(first.grid[15][15], 16);
+    EXPECT_EQ(first.cages[0].targetSum, 48);
+    ASSERT_EQ(first.inequalities.size(), 1u);
+    EXPECT_EQ(first.inequalities[0].cell1, Cell(6, 3));
+    EXPECT_EQ(first.inequalities[0].type, InequalityType::LESS_THAN);
+    EXPECT_EQ(second.type, SudokuType::STANDARD);
+
+    // A 16x16 record is rejected by the 9x9 reader
+    EXPECT_THROW(SudokuBinary::read(data), std::runtime_error);
+}
+
+// Test: Unrepresentable constraints and damaged records are reported
+TEST(BinaryTest, Errors)
+{
+    SudokuPuzzle puzzle;
+    puzzle.addInequality(InequalityConstraint(Cell(0, 0), Cell(0, 2), InequalityType::LESS_THAN));
+    EXPECT_THROW(SudokuBinary::write(puzzle), std::runtime_error);
+
+    std::string data = SudokuBinary::write(SudokuPuzzle());
+    EXPECT_THROW(SudokuBinary::read(data.substr(0, data.size() - 1)), std::runtime_error);
+    data[4] = 9;
+    EXPECT_THROW(SudokuBinary::read(data), std::runtime_error);
+    EXPECT_THROW(SudokuBinary::read("GRID"), std::runtime_error);
+}
@@ -0,0 +1,256 @@
+/**
+ * @file test_cache.cpp
+ * @brief Tests for the solution cache
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuCache.h"
+#include "SudokuDiskCache.h"
+#include "SudokuSolver.h"
+#include "SudokuParser.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace sudoku;
+
+class SolutionCacheTest : public ::testing::Test
+{
+protected:
+    SudokuPuzzle puzzle = SudokuParser::parseSimpleGrid(
+        "530070000"
+        "600195000"
+        "098000060"
+        "800060003"
+        "400803001"
+        "700020006"
+        "060000280"
+        "000419005"
+        "000080079");
+};
+
+// Test: Hashes depend on the grid and every constraint
+TEST_F(SolutionCacheTest, HashCoversConstraints)
+{
+    PuzzleHash base = hashPuzzle(puzzle);
+    EXPECT_EQ(base, hashPuzzle(puzzle));
+
+    SudokuPuzzle changed = puzzle;
+    changed.grid[8][8] = EMPTY_CELL;
+    EXPECT_NE(base, hashPuzzle(changed));
+
+    SudokuPuzzle killer = puzzle;
+    killer.addCage(Cage({Cell(0, 2), Cell(0, 3)}, 7));
+    SudokuPuzzle killerOtherSum = puzzle;
+    killerOtherSum.addCage(Cage({Cell(0, 2), Cell(0, 3)}, 8));
+    EXPECT_NE(base, hashPuzzle(killer));
+    EXPECT_NE(hashPuzzle(killer), hashPuzzle(killerOtherSum));
+
+    SudokuPuzzle greater = puzzle;
+    greater.addInequality(InequalityConstraint(Cell(0, 2), Cell(0, 3), InequalityType::GREATER_THAN));
+    SudokuPuzzle less = puzzle;
+    less.addInequality(InequalityConstraint(Cell(0, 2), Cell(0, 3), InequalityType::LESS_THAN));
+    EXPECT_NE(hashPuzzle(greater), hashPuzzle(less));
+}
+
+// Test: Repeated solves hit the cache and return the same solution
+TEST_F(SolutionCacheTest, SolverUsesCache)
+{
+    SudokuSolver solver;
+    solver.enableCache(16);
+
+    auto first = solver.solve(puzzle);
+    auto second = solver.solve(puzzle);
+    ASSERT_TRUE(second.solved);
+    EXPECT_EQ(second.uniqueness, UniquenessStatus::NOT_CHECKED);
+    EXPECT_TRUE(SudokuSolver::verifySolution(puzzle, second));
+    EXPECT_TRUE(std::equal(&first.grid[0][0], &first.grid[0][0] + 81, &second.grid[0][0]));
+
+    // An unchecked entry cannot answer a uniqueness request
+    auto checked = solver.solve(puzzle, true);
+    EXPECT_TRUE(checked.isUnique());
+    auto checkedAgain = solver.solve(puzzle, true);
+    EXPECT_TRUE(checkedAgain.isUnique());
+
+    CacheStats stats = solver.getCache()->getStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.size, 1u);
+}
+
+// Test: The least recently used entry is evicted first
+TEST_F(SolutionCacheTest, EvictsLeastRecentlyUsed)
+{
+    SolutionCache cache(2);
+    SudokuSolution solution;
+    solution.solved = true;
+
+    PuzzleHash a(1, 1), b(2, 2), c(3, 3);
+    cache.store(a, solution);
+    cache.store(b, solution);
+    ASSERT_TRUE(cache.lookup(a, false, solution)); // a becomes most recent
+    cache.store(c, solution);                      // evicts b
+
+    EXPECT_TRUE(cache.lookup(a, false, solution));
+    EXPECT_FALSE(cache.lookup(b, false, solution));
+    EXPECT_TRUE(cache.lookup(c, false, solution));
+    EXPECT_EQ(cache.getStats().evictions, 1u);
+}
+
+// Test: A shared cache can be used from several threads
+TEST_F(SolutionCacheTest, SharedBetweenThreads)
+{
+    auto cache = std::make_shared<SolutionCache>(64);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&]()
+                             {
+                                 SudokuSolver solver;
+                                 solver.setCache(cache);
+                                 for (int i = 0; i < 10; i++)
+                                 {
+                                     auto solution = solver.solve(puzzle);
+                                     EXPECT_TRUE(solution.solved);
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    CacheStats stats = cache->getStats();
+    EXPECT_EQ(stats.hits + stats.misses, 40u);
+    EXPECT_GE(stats.hits, 36u);
+    EXPECT_EQ(stats.size, 1u);
+}
+
+// Test: Solutions written to a disk cache are served by a new process-level cache
+TEST_F(SolutionCacheTest, DiskCacheSurvivesReopen)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "sudoku_test_disk_cache.bin").string();
+    std::filesystem::remove(path);
+
+    SudokuSolution original;
+    {
+        SudokuSolver solver;
+        solver.enableCache();
+        solver.getCache()->attachStore(std::make_shared<DiskCache>(path));
+        original = solver.solve(puzzle, true);
+        ASSERT_TRUE(original.isUnique());
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), 24 + DiskCache::RECORD_SIZE);
+
+    // Simulate a crash in the middle of an append
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << "partial";
+    }
+
+    {
+        SudokuSolver solver;
+        solver.enableCache();
+        auto disk = std::make_shared<DiskCache>(path);
+        solver.getCache()->attachStore(disk);
+
+        auto cached = solver.solve(puzzle, true);
+        ASSERT_TRUE(cached.solved);
+        EXPECT_TRUE(cached.isUnique());
+        EXPECT_TRUE(std::equal(&original.grid[0][0], &original.grid[0][0] + 81, &cached.grid[0][0]));
+        EXPECT_EQ(solver.getCache()->getStats().storeHits, 1u);
+
+        // Appending after the torn record keeps the file aligned
+        SudokuPuzzle empty;
+        solver.solve(empty);
+        EXPECT_EQ(disk->size(), 2u);
+    }
+
+    DiskCache reopened(path);
+    EXPECT_EQ(reopened.size(), 2u);
+    EXPECT_EQ(std::filesystem::file_size(path), 24 + 2 * DiskCache::RECORD_SIZE);
+    std::filesystem::remove(path);
+}
+
+// Test: A disk cache for another geometry is rejected
+TEST_F(SolutionCacheTest, DiskCacheRejectsOtherGeometry)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "sudoku_test_disk_cache_4x4.bin").string();
+    std::filesystem::remove(path);
+    {
+        BasicDiskCache<Geometry4x4> small(path);
+        BasicSudokuSolution<Geometry4x4> solution;
+        small.store(PuzzleHash(1, 2), solution);
+    }
+
+    DiskCache standard(path);
+    SudokuSolution solution;
+    EXPECT_THROW(standard.lookup(PuzzleHash(1, 2), false, solution), std::runtime_error);
+
+    // Attaching opens the file, so a wrong one is reported before any lookup
+    SolutionCache cache;
+    EXPECT_THROW(cache.attachStore(std::make_shared<DiskCache>(path)), std::runtime_error);
+    std::filesystem::remove(path);
+}
+
+// Test: Two writers on one file keep each other's records
+TEST_F(SolutionCacheTest, DiskCacheSharedBetweenWriters)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "sudoku_test_disk_cache_shared.bin").string();
+    std::filesystem::remove(path);
+
+    SudokuSolution first;
+    first.solved = true;
+    first.uniqueness = UniquenessStatus::UNIQUE;
+    SudokuSolution second = first;
+    second.grid[0][0] = 7;
+
+    // Both caches are opened before either writes, like two processes started together
+    DiskCache a(path);
+    DiskCache b(path);
+    SudokuSolution found;
+    EXPECT_FALSE(a.lookup(PuzzleHash(1, 1), false, found));
+    EXPECT_FALSE(b.lookup(PuzzleHash(2, 2), false, found));
+
+    b.store(PuzzleHash(2, 2), second);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << "torn";
+    }
+    a.store(PuzzleHash(1, 1), first);
+    EXPECT_EQ(std::filesystem::file_size(path), 24 + 2 * DiskCache::RECORD_SIZE);
+
+    // The writer that appended last has indexed the other's record
+    ASSERT_TRUE(a.lookup(PuzzleHash(2, 2), false, found));
+    EXPECT_EQ(found.grid[0][0], 7);
+    EXPECT_EQ(a.size(), 2u);
+
+    DiskCache reopened(path);
+    EXPECT_EQ(reopened.size(), 2u);
+    std::filesystem::remove(path);
+}
+
+// Test: A lookup that misses leaves the caller's solution unchanged
+TEST_F(SolutionCacheTest, DiskCacheMissLeavesSolution)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "sudoku_test_disk_cache_miss.bin").string();
+    std::filesystem::remove(path);
+
+    SudokuSolution unchecked;
+    unchecked.solved = true;
+    unchecked.grid[0][0] = 7;
+    DiskCache disk(path);
+    disk.store(PuzzleHash(1, 1), unchecked);
+
+    // The record is usable without a uniqueness check but not with one
+    SudokuSolution found;
+    found.grid[0][0] = 3;
+    EXPECT_FALSE(disk.lookup(PuzzleHash(1, 1), true, found));
+    EXPECT_FALSE(found.solved);
+    EXPECT_EQ(found.grid[0][0], 3);
+
+    ASSERT_TRUE(disk.lookup(PuzzleHash(1, 1), false, found));
+    EXPECT_TRUE(found.solved);
+    EXPECT_EQ(found.grid[0][0], 7);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_canonical.cpp
+ * @brief Tests for puzzle canonicalization and symmetry deduplication
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuCanonical.h"
+#include "SudokuSolver.h"
+#include "SudokuParser.h"
+
+using namespace sudoku;
+
+class CanonicalTest : public ::testing::Test
+{
+protected:
+    SudokuSolver solver;
+
+    SudokuPuzzle basePuzzle()
+    {
+        return SudokuParser::parseSimpleGrid(
+            "530070000"
+            "600195000"
+            "098000060"
+            "800060003"
+            "400803001"
+            "700020006"
+            "060000280"
+            "000419005"
+            "000080079");
+    }
+
+    // Transpose, swap the first two bands and rows 0/1, and relabel v -> 10 - v
+    SudokuPuzzle scrambled(const SudokuPuzzle &puzzle)
+    {
+        const int rowMap[GRID_SIZE] = {4, 3, 5, 0, 1, 2, 6, 7, 8};
+        SudokuPuzzle result;
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int c = 0; c < GRID_SIZE; c++)
+            {
+                int value = puzzle.grid[c][rowMap[r]];
+                result.grid[r][c] = value == EMPTY_CELL ? EMPTY_CELL : 10 - value;
+            }
+        }
+        return result;
+    }
+};
+
+// Test: Symmetric variants of a standard puzzle share a canonical key
+TEST_F(CanonicalTest, StandardVariantsShareKey)
+{
+    auto puzzle = basePuzzle();
+    auto variant = scrambled(puzzle);
+
+    EXPECT_EQ(SudokuCanonicalizer::canonicalKey(puzzle), SudokuCanonicalizer::canonicalKey(variant));
+
+    // A genuinely different puzzle gets a different key
+    auto other = puzzle;
+    other.grid[0][0] = EMPTY_CELL;
+    EXPECT_NE(SudokuCanonicalizer::canonicalKey(puzzle), SudokuCanonicalizer::canonicalKey(other));
+}
+
+// Test: The canonical form is minlex and its transform round-trips
+TEST_F(CanonicalTest, TransformRoundTrip)
+{
+    auto puzzle = basePuzzle();
+    auto form = SudokuCanonicalizer::canonicalize(puzzle);
+
+    // Digits are relabeled by first appearance, so the first given is a 1
+    int firstGiven = 0;
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE && firstGiven == 0; i++)
+    {
+        firstGiven = form.puzzle.grid[i / GRID_SIZE][i % GRID_SIZE];
+    }
+    EXPECT_EQ(firstGiven, 1);
+
+    auto solution = solver.solve(form.puzzle);
+    ASSERT_TRUE(solution.solved);
+    auto mapped = form.transform.invert(solution);
+    EXPECT_TRUE(SudokuSolver::verifySolution(puzzle, mapped));
+}
+
+// Test: Deduplicated solving returns a valid solution for every input
+TEST_F(CanonicalTest, SolveDeduplicated)
+{
+    auto puzzle = basePuzzle();
+    std::vector<SudokuPuzzle> puzzles = {puzzle, scrambled(puzzle), puzzle};
+
+    auto classes = SudokuCanonicalizer::group(puzzles);
+    EXPECT_EQ(classes.representatives.size(), 1u);
+
+    auto solutions = SudokuCanonicalizer::solveDeduplicated(solver, puzzles, true);
+    ASSERT_EQ(solutions.size(), puzzles.size());
+    for (size_t i = 0; i < puzzles.size(); i++)
+    {
+        ASSERT_TRUE(solutions[i].solved);
+        EXPECT_TRUE(solutions[i].isUnique());
+        EXPECT_TRUE(SudokuSolver::verifySolution(puzzles[i], solutions[i]));
+    }
+}
+
+// Test: A rotated killer puzzle is recognized as a duplicate
+TEST_F(CanonicalTest, KillerRotation)
+{
+    SudokuPuzzle puzzle;
+    puzzle.addCage(Cage({Cell(0, 0), Cell(0, 1)}, 3));
+    puzzle.addCage(Cage({Cell(4, 4), Cell(5, 4), Cell(5, 5)}, 20));
+    puzzle.addInequality(InequalityConstraint(Cell(2, 3), Cell(2, 4), InequalityType::GREATER_THAN));
+
+    // Rotate 90 degrees clockwise: (r, c) -> (c, 8 - r)
+    auto rotate = [](const Cell &cell) { return Cell(cell.col, GRID_SIZE - 1 - cell.row); };
+    SudokuPuzzle rotated;
+    for (auto it = puzzle.cages.rbegin(); it != puzzle.cages.rend(); ++it)
+    {
+        std::vector<Cell> cells;
+        for (const auto &cell : it->cells)
+        {
+            cells.push_back(rotate(cell));
+        }
+        rotated.addCage(Cage(cells, it->targetSum));
+    }
+    // Stated from the other side with the opposite direction
+    rotated.addInequality(InequalityConstraint(rotate(Cell(2, 4)), rotate(Cell(2, 3)), InequalityType::LESS_THAN));
+
+    auto form = SudokuCanonicalizer::canonicalize(puzzle);
+    EXPECT_EQ(form.key, SudokuCanonicalizer::canonicalKey(rotated));
+
+    // Cage sums change under relabeling, so a different sum is a different class
+    SudokuPuzzle changed = puzzle;
+    changed.cages[0].targetSum = 4;
+    EXPECT_NE(form.key, SudokuCanonicalizer::canonicalKey(changed));
+
+    auto solution = solver.solve(form.puzzle);
+    ASSERT_TRUE(solution.solved);
+    EXPECT_TRUE(SudokuSolver::verifySolution(rotated, SudokuCanonicalizer::canonicalize(rotated).transform.invert(solution)));
+}
+
+// Test: The puzzle bank rejects symmetric duplicates
+TEST_F(CanonicalTest, PuzzleBankRejectsDuplicates)
+{
+    PuzzleBank bank;
+    auto puzzle = basePuzzle();
+
+    EXPECT_TRUE(bank.add(puzzle));
+    EXPECT_FALSE(bank.add(scrambled(puzzle)));
+    EXPECT_TRUE(bank.contains(scrambled(puzzle)));
+    EXPECT_EQ(bank.size(), 1u);
+}
+
+// Test: A cage and an inequality whose cell codes line up do not share a key
+TEST_F(CanonicalTest, ConstraintKeysDoNotCollide)
+{
+    // One cage over flat cells 0, 12, 13 and 22. Cell 12 written as a
+    // character is '<', the marker that starts an inequality in a text key
+    SudokuPuzzle cageOnly;
+    cageOnly.type = SudokuType::KILLER_INEQUALITY;
+    cageOnly.addCage(Cage({Cell(0, 0), Cell(1, 3), Cell(1, 4), Cell(2, 4)}, 20));
+
+    // The same cage cut after cell 0, followed by cell 13 < cell 22
+    SudokuPuzzle split;
+    split.type = SudokuType::KILLER_INEQUALITY;
+    split.addCage(Cage({Cell(0, 0)}, 20));
+    split.addInequality(InequalityConstraint(Cell(1, 4), Cell(2, 4), InequalityType::LESS_THAN));
+
+    EXPECT_NE(SudokuCanonicalizer::canonicalKey(cageOnly), SudokuCanonicalizer::canonicalKey(split));
+
+    PuzzleBank bank;
+    EXPECT_TRUE(bank.add(cageOnly));
+    EXPECT_TRUE(bank.add(split));
+    EXPECT_EQ(bank.size(), 2u);
+}
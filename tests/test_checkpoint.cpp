@@ -0,0 +1,130 @@
+/**
+ * @file test_checkpoint.cpp
+ * @brief Tests for job checkpoints and resumed shard runs
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuCheckpoint.h"
+#include "SudokuShard.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+using namespace sudoku;
+
+namespace
+{
+    const std::string kClassic =
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+    std::string tempPath(const char *name)
+    {
+        return "/tmp/sudoku_test_" + std::to_string(::getpid()) + "_" + name;
+    }
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+}
+
+// Test: Completed ranges merge, and everything round-trips through the file
+TEST(CheckpointTest, RangesAndRoundTrip)
+{
+    JobCheckpoint checkpoint("batch input.txt unique");
+    checkpoint.markCompleted(10, 20);
+    checkpoint.markCompleted(30, 40);
+    EXPECT_EQ(checkpoint.completedPrefix(), 0u);
+    checkpoint.markCompleted(0, 10);
+    checkpoint.markCompleted(15, 32);
+    EXPECT_EQ(checkpoint.getCompleted().size(), 1u);
+    EXPECT_EQ(checkpoint.completedPrefix(), 40u);
+    checkpoint.markCompleted(50, 60);
+    EXPECT_TRUE(checkpoint.isCompleted(39));
+    EXPECT_FALSE(checkpoint.isCompleted(40));
+    EXPECT_TRUE(checkpoint.isCompleted(55));
+    EXPECT_FALSE(checkpoint.isCompleted(60));
+
+    std::mt19937 rng(7);
+    rng.discard(100);
+    checkpoint.setRng(rng);
+    checkpoint.setOutputBytes(3280);
+
+    std::string path = tempPath("checkpoint.txt");
+    checkpoint.save(path);
+    JobCheckpoint loaded = JobCheckpoint::load(path);
+    EXPECT_EQ(loaded.getJob(), "batch input.txt unique");
+    EXPECT_EQ(loaded.getOutputBytes(), 3280u);
+    EXPECT_EQ(loaded.getCompleted().size(), 2u);
+    EXPECT_TRUE(loaded.isCompleted(50));
+    std::mt19937 restored;
+    loaded.restoreRng(restored);
+    EXPECT_EQ(restored(), rng());
+
+    std::ofstream(path) << "# sudoku checkpoint\nversion 1\njob x\noutput many\n";
+    EXPECT_THROW(JobCheckpoint::load(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(JobCheckpoint::load(path), std::runtime_error);
+
+    std::string output = tempPath("output.txt");
+    std::ofstream(output) << "kept|dropped";
+    truncateOutput(output, 4);
+    EXPECT_EQ(readFile(output), "kept");
+    EXPECT_THROW(truncateOutput(output, 5), std::runtime_error);
+    std::remove(output.c_str());
+}
+
+// Test: A resumed shard run only redoes the chunks the checkpoint lacks
+TEST(CheckpointTest, ResumesShard)
+{
+    std::string text;
+    for (int i = 0; i < 12; i++)
+    {
+        text += kClassic + "\n";
+    }
+    std::string corpusPath = tempPath("resume_corpus.txt");
+    std::string outputPath = tempPath("resume_out.txt");
+    std::string checkpointPath = tempPath("resume_checkpoint.txt");
+    std::ofstream(corpusPath) << text;
+
+    CorpusManifest manifest = CorpusManifest::build(text, 4);
+    ShardConfig config;
+    config.workers = 2;
+    config.checkpointPath = checkpointPath;
+    ShardStats first = ShardRunner(config).run(corpusPath, manifest, outputPath);
+    EXPECT_EQ(first.records, 12u);
+    std::string expected = readFile(outputPath);
+    EXPECT_EQ(JobCheckpoint::load(checkpointPath).completedPrefix(), 12u);
+
+    // As if the job died with only the middle chunk recorded and the rest half written
+    JobCheckpoint partial(JobCheckpoint::load(checkpointPath).getJob());
+    partial.markCompleted(4, 8);
+    partial.setOutputBytes(expected.size());
+    partial.save(checkpointPath);
+    std::string damaged = expected;
+    damaged.replace(0, 10, "##########");
+    damaged.replace(8 * ShardRunner::RECORD_BYTES, 10, "##########");
+    std::ofstream(outputPath, std::ios::binary) << damaged;
+
+    config.resume = true;
+    ShardStats resumed = ShardRunner(config).run(corpusPath, manifest, outputPath);
+    EXPECT_EQ(resumed.resumed, 4u);
+    EXPECT_EQ(resumed.records, 8u);
+    EXPECT_EQ(resumed.solved, 8u);
+    EXPECT_EQ(readFile(outputPath), expected);
+    EXPECT_EQ(JobCheckpoint::load(checkpointPath).completedPrefix(), 12u);
+
+    // Checkpoints of another job are refused
+    config.checkUniqueness = true;
+    EXPECT_THROW(ShardRunner(config).run(corpusPath, manifest, outputPath), std::runtime_error);
+
+    std::remove(corpusPath.c_str());
+    std::remove(outputPath.c_str());
+    std::remove(checkpointPath.c_str());
+}
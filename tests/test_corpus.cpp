@@ -0,0 +1,102 @@
+/**
+ * @file test_corpus.cpp
+ * @brief Tests for the memory-mapped corpus reader
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuCorpus.h"
+#include "SudokuParser.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace sudoku;
+
+namespace
+{
+    std::vector<std::string> readAll(CorpusReader reader)
+    {
+        std::vector<std::string> records;
+        std::string_view record;
+        while (reader.next(record))
+        {
+            records.emplace_back(record);
+        }
+        return records;
+    }
+}
+
+// Test: Line corpora skip blanks and comments and trim line endings
+TEST(CorpusReaderTest, LineRecords)
+{
+    std::string text = "# header\r\n123\r\n\n  \n456  \n789";
+    CorpusReader reader(text);
+    EXPECT_EQ(reader.getFormat(), CorpusFormat::LINES);
+    EXPECT_EQ(readAll(reader), (std::vector<std::string>{"123", "456", "789"}));
+}
+
+// Test: Block corpora yield one record per GRID block, constraints included
+TEST(CorpusReaderTest, BlockRecords)
+{
+    std::string text =
+        "\nGRID\n5 3 0\nCAGES\n10 0 0 0 1\n\n"
+        "GRID\n0 0 0\nINEQUALITIES\n0 0 > 0 1\n";
+    CorpusReader reader(text);
+    EXPECT_EQ(reader.getFormat(), CorpusFormat::BLOCKS);
+
+    auto records = readAll(reader);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0], "GRID\n5 3 0\nCAGES\n10 0 0 0 1");
+    EXPECT_EQ(records[1], "GRID\n0 0 0\nINEQUALITIES\n0 0 > 0 1");
+}
+
+// Test: Split ranges cover every record exactly once
+TEST(CorpusReaderTest, SplitCoversAllRecords)
+{
+    std::string lines;
+    std::string blocks;
+    for (int i = 0; i < 100; i++)
+    {
+        lines += std::to_string(i * 7919) + "\n";
+        blocks += "GRID\n" + std::to_string(i) + "\nCAGES\n" + std::to_string(i * 3) + "\n";
+    }
+
+    for (const std::string &text : {lines, blocks})
+    {
+        auto expected = readAll(CorpusReader(text));
+        for (int parts : {1, 3, 7, 250})
+        {
+            std::vector<std::string> combined;
+            auto ranges = CorpusReader::split(text, parts);
+            EXPECT_LE(ranges.size(), static_cast<size_t>(parts));
+            for (const auto &range : ranges)
+            {
+                auto part = readAll(CorpusReader(text, range, CorpusFormat::AUTO));
+                combined.insert(combined.end(), part.begin(), part.end());
+            }
+            EXPECT_EQ(combined, expected) << "parts = " << parts;
+        }
+    }
+}
+
+// Test: Mapped files expose the file contents
+TEST(CorpusReaderTest, MappedFile)
+{
+    std::string path = (std::filesystem::temp_directory_path() / "sudoku_test_corpus.txt").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "530070000600195000098000060800060003400803001700020006060000280000419005000080079\n";
+    }
+
+    {
+        MappedFile file(path);
+        EXPECT_EQ(file.size(), 82u);
+        auto records = readAll(CorpusReader(file.contents()));
+        ASSERT_EQ(records.size(), 1u);
+        EXPECT_EQ(SudokuParser::parseFromFile(path).grid[0][0], 5);
+    }
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(MappedFile("/nonexistent/corpus.txt"), std::runtime_error);
+}
@@ -0,0 +1,256 @@
+/**
+ * @file test_daemon.cpp
+ * @brief Tests for the local socket daemon
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuDaemon.h"
+#include "SudokuJson.h"
+#include "SudokuMetrics.h"
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace sudoku;
+
+namespace
+{
+    const std::string kClassic =
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+    std::string socketPath(const char *name)
+    {
+        return "/tmp/sudoku_test_" + std::to_string(::getpid()) + "_" + name + ".sock";
+    }
+
+    // Runs the daemon's accept loop on a background thread for one test
+    class RunningDaemon
+    {
+    public:
+        explicit RunningDaemon(DaemonConfig config, std::shared_ptr<ServiceMetrics> metrics = nullptr)
+            : daemon(std::move(config))
+        {
+            if (metrics)
+                daemon.setMetrics(metrics);
+            thread = std::thread([this]()
+                                 { daemon.run(); });
+        }
+        ~RunningDaemon()
+        {
+            daemon.stop();
+            thread.join();
+        }
+
+        SudokuDaemon daemon;
+
+    private:
+        std::thread thread;
+    };
+
+    class TestClient
+    {
+    public:
+        explicit TestClient(const std::string &path)
+        {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)), 0);
+        }
+        ~TestClient() { ::close(fd); }
+
+        void send(const std::string &text) { ::send(fd, text.data(), text.size(), 0); }
+
+        std::vector<std::string> readLines(size_t count)
+        {
+            std::vector<std::string> lines;
+            char chunk[4096];
+            while (lines.size() < count)
+            {
+                size_t end = buffer.find('\n');
+                if (end != std::string::npos)
+                {
+                    lines.push_back(buffer.substr(0, end));
+                    buffer.erase(0, end + 1);
+                    continue;
+                }
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0)
+                    break;
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            return lines;
+        }
+
+    private:
+        int fd = -1;
+        std::string buffer;
+    };
+
+    std::string member(const std::string &response, std::string_view name)
+    {
+        std::string found;
+        json::forEachMember(response, [&](std::string_view key, std::string_view value)
+                            {
+            if (key == name)
+                found = std::string(value); });
+        return found;
+    }
+}
+
+// Test: Concurrent clients each get their own answers, identified by id
+TEST(DaemonTest, ServesConcurrentClients)
+{
+    DaemonConfig config;
+    config.socketPath = socketPath("clients");
+    config.interactiveThreads = 2;
+    RunningDaemon running(config);
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < 3; c++)
+    {
+        threads.emplace_back([&, c]()
+                             {
+            TestClient client(config.socketPath);
+            std::string prefix = "\"c" + std::to_string(c) + "-";
+            client.send("{\"id\":" + prefix + "solve\",\"op\":\"solve\",\"puzzle\":\"" + kClassic + "\"}\n"
+                        "{\"id\":" + prefix + "gen\",\"op\":\"generate\",\"type\":\"standard\",\"unique\":false}\n"
+                        "\n"
+                        "{\"id\":" + prefix + "bad\",\"op\":\"nope\"}\n");
+
+            std::set<std::string> ids;
+            for (const std::string &line : client.readLines(3))
+            {
+                std::string id = member(line, "id");
+                ids.insert(id);
+                if (id == prefix + "bad\"")
+                    EXPECT_EQ(member(line, "error"), "\"unknown op: nope\"");
+                else
+                    EXPECT_EQ(member(line, "error"), "") << line;
+            }
+            EXPECT_EQ(ids, (std::set<std::string>{prefix + "solve\"", prefix + "gen\"", prefix + "bad\""})); });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    DaemonStats stats = running.daemon.getStats();
+    EXPECT_EQ(stats.connections, 3u);
+    EXPECT_EQ(stats.requests, 9u);
+}
+
+// Test: Identical solves share one result, and every requester is answered
+TEST(DaemonTest, CoalescesIdenticalSolves)
+{
+    DaemonConfig config;
+    config.socketPath = socketPath("coalesce");
+    RunningDaemon running(config);
+
+    TestClient client(config.socketPath);
+    std::string requests;
+    for (int i = 0; i < 20; i++)
+    {
+        requests += "{\"id\":" + std::to_string(i) + ",\"op\":\"unique\",\"puzzle\":\"" + kClassic + "\"}\n";
+    }
+    client.send(requests);
+
+    std::vector<std::string> lines = client.readLines(20);
+    ASSERT_EQ(lines.size(), 20u);
+    std::set<std::string> ids;
+    for (const std::string &line : lines)
+    {
+        EXPECT_EQ(member(line, "solved"), "true");
+        EXPECT_EQ(member(line, "uniqueness"), "\"unique\"");
+        ids.insert(member(line, "id"));
+    }
+    EXPECT_EQ(ids.size(), 20u);
+    // The first solve is still running when the rest arrive in the same write
+    EXPECT_GT(running.daemon.getStats().coalesced, 0u);
+}
+
+// Test: Full queues reject and queued requests past their deadline expire
+TEST(DaemonTest, AdmissionAndDeadlines)
+{
+    DaemonConfig config;
+    config.socketPath = socketPath("admission");
+    config.maxQueued = 1;
+    RunningDaemon running(config);
+
+    TestClient client(config.socketPath);
+    const std::string generate = "\"op\":\"generate\",\"type\":\"mixed\",\"seed\":3";
+    client.send("{\"id\":1," + generate + "}\n"
+                "{\"id\":2," + generate + ",\"deadlineMs\":0.001}\n"
+                "{\"id\":3," + generate + "}\n"
+                "{\"id\":4," + generate + "}\n");
+
+    std::vector<std::string> lines = client.readLines(4);
+    ASSERT_EQ(lines.size(), 4u);
+    size_t overloaded = 0;
+    size_t expired = 0;
+    for (const std::string &line : lines)
+    {
+        std::string error = member(line, "error");
+        overloaded += error == "\"overloaded\"";
+        expired += error == "\"deadline exceeded\"";
+    }
+
+    DaemonStats stats = running.daemon.getStats();
+    EXPECT_GT(overloaded, 0u);
+    EXPECT_EQ(overloaded, stats.rejected);
+    EXPECT_EQ(expired, stats.expired);
+}
+
+// Test: A queued request is answered at its deadline while the only worker is still busy
+TEST(DaemonTest, ExpiresWhileWorkersAreBusy)
+{
+    DaemonConfig config;
+    config.socketPath = socketPath("sweep");
+    RunningDaemon running(config);
+
+    TestClient client(config.socketPath);
+    const std::string generate = "\"op\":\"generate\",\"type\":\"mixed\",\"seed\":3";
+    client.send("{\"id\":1," + generate + "}\n"
+                "{\"id\":2," + generate + ",\"deadlineMs\":20}\n");
+
+    // The long generation of request 1 is answered after the expiry of request 2
+    std::vector<std::string> lines = client.readLines(2);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(member(lines[0], "id"), "2");
+    EXPECT_EQ(member(lines[0], "error"), "\"deadline exceeded\"");
+    EXPECT_EQ(member(lines[1], "id"), "1");
+    EXPECT_EQ(member(lines[1], "error"), "");
+    EXPECT_EQ(running.daemon.getStats().expired, 1u);
+}
+
+// Test: A plain HTTP GET on the daemon socket returns the metrics
+TEST(DaemonTest, ServesMetricsOverHttp)
+{
+    DaemonConfig config;
+    config.socketPath = socketPath("metrics");
+    RunningDaemon running(config, std::make_shared<ServiceMetrics>());
+
+    {
+        TestClient client(config.socketPath);
+        client.send("{\"id\":1,\"op\":\"solve\",\"puzzle\":\"" + kClassic + "\"}\n");
+        ASSERT_EQ(client.readLines(1).size(), 1u);
+    }
+
+    TestClient scraper(config.socketPath);
+    scraper.send("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    std::string response;
+    for (const std::string &line : scraper.readLines(10000))
+    {
+        response += line + "\n";
+    }
+    EXPECT_EQ(response.rfind("HTTP/1.0 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("sudoku_queue_depth{queue=\"interactive\"} 0\n"), std::string::npos);
+    EXPECT_NE(response.find("sudoku_requests_total{op=\"solve\",outcome=\"ok\"} 1\n"), std::string::npos);
+    EXPECT_NE(response.find("sudoku_daemon_connections_total 2\n"), std::string::npos);
+}
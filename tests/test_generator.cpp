@@ -328,3 +328,71 @@ TEST_F(GeneratorTest, RoundTripGenerateParseSolve)
     ASSERT_TRUE(solvedSolution.solved);
     EXPECT_TRUE(SudokuSolver::verifySolution(parsedPuzzle, solvedSolution));
 }
+
+// Test that parallel minimization produces the same puzzle as the sequential pass
+TEST_F(GeneratorTest, ParallelMinimizationMatchesSequential)
+{
+    GeneratorConfig config;
+    config.type = SudokuType::KILLER_INEQUALITY;
+    config.minGivens = 10;
+    config.maxGivens = 20;
+    config.difficulty = 80;
+    config.seed = 2024;
+
+    SudokuSolution sequentialSolution;
+    auto sequential = generator.generateWithSolution(config, sequentialSolution);
+
+    config.minimizeThreads = 4;
+    SudokuGenerator parallelGenerator;
+    SudokuSolution parallelSolution;
+    auto parallel = parallelGenerator.generateWithSolution(config, parallelSolution);
+
+    EXPECT_EQ(SudokuGenerator::toCustomFormatWithSolution(sequential, sequentialSolution),
+              SudokuGenerator::toCustomFormatWithSolution(parallel, parallelSolution));
+    auto check = solver.solve(parallel, true);
+    EXPECT_TRUE(check.solved && check.isUnique());
+}
+
+// Test that progress is reported per phase and that the callback can cancel
+TEST_F(GeneratorTest, ProgressAndCancellation)
+{
+    GeneratorConfig config;
+    config.type = SudokuType::KILLER_INEQUALITY;
+    config.difficulty = 100;
+    config.seed = 7;
+
+    std::vector<GenerationProgress> reports;
+    generator.setProgressCallback([&](const GenerationProgress &progress)
+                                  {
+                                      reports.push_back(progress);
+                                      return true; });
+    generator.generate(config);
+
+    ASSERT_GE(reports.size(), 3u);
+    EXPECT_EQ(reports.front().phase, GenerationPhase::FILL);
+    EXPECT_EQ(reports.back().phase, GenerationPhase::MINIMIZE);
+    int minimizeTotal = -1;
+    for (const auto &report : reports)
+    {
+        EXPECT_GE(report.trialsRemaining, 0);
+        if (report.phase == GenerationPhase::MINIMIZE)
+        {
+            // Done plus remaining only shrinks as removal targets are reached
+            int total = report.trialsDone + report.trialsRemaining;
+            EXPECT_TRUE(minimizeTotal < 0 || total <= minimizeTotal);
+            minimizeTotal = total;
+        }
+    }
+
+    // Cancel on the first minimization report
+    generator.setProgressCallback([](const GenerationProgress &progress)
+                                  { return progress.phase != GenerationPhase::MINIMIZE; });
+    EXPECT_THROW(generator.generate(config), std::runtime_error);
+
+    // The next generation runs normally
+    generator.setProgressCallback(nullptr);
+    SudokuSolution solution;
+    auto puzzle = generator.generateWithSolution(config, solution);
+    auto check = solver.solve(puzzle, true);
+    EXPECT_TRUE(check.solved && check.isUnique());
+}
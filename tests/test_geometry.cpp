@@ -0,0 +1,117 @@
+/**
+ * @file test_geometry.cpp
+ * @brief Tests for non-9x9 grid geometries
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuGenerator.h"
+#include "SudokuSolver.h"
+#include "SudokuParser.h"
+#include "SudokuTopology.h"
+
+using namespace sudoku;
+
+template <class Geo>
+class GeometryTest : public ::testing::Test
+{
+protected:
+    BasicSudokuSolver<Geo> solver;
+};
+
+using Geometries = ::testing::Types<Geometry4x4, Geometry6x6, Geometry8x8, Geometry12x12, Geometry16x16>;
+TYPED_TEST_SUITE(GeometryTest, Geometries);
+
+// Test: An empty grid of every geometry solves to a valid grid
+TYPED_TEST(GeometryTest, SolvesEmptyGrid)
+{
+    BasicSudokuPuzzle<TypeParam> puzzle;
+    auto solution = this->solver.solve(puzzle);
+
+    ASSERT_TRUE(solution.solved);
+    EXPECT_TRUE(BasicSudokuSolver<TypeParam>::verifySolution(puzzle, solution));
+}
+
+// Test: Solutions round-trip through the simple grid format
+TYPED_TEST(GeometryTest, SimpleGridRoundTrip)
+{
+    BasicSudokuPuzzle<TypeParam> empty;
+    auto solution = this->solver.solve(empty);
+    ASSERT_TRUE(solution.solved);
+
+    std::string line;
+    for (int r = 0; r < TypeParam::GRID_SIZE; r++)
+    {
+        for (int c = 0; c < TypeParam::GRID_SIZE; c++)
+        {
+            line += BasicSudokuParser<TypeParam>::valueSymbol(solution.grid[r][c]);
+        }
+    }
+    line[0] = '.';
+
+    auto parsed = BasicSudokuParser<TypeParam>::parseFromString(line);
+    EXPECT_EQ(parsed.grid[0][0], EMPTY_CELL);
+    for (int i = 1; i < TypeParam::NUM_CELLS; i++)
+    {
+        int r = i / TypeParam::GRID_SIZE;
+        int c = i % TypeParam::GRID_SIZE;
+        EXPECT_EQ(parsed.grid[r][c], solution.grid[r][c]);
+    }
+
+    auto resolved = this->solver.solve(parsed, true);
+    ASSERT_TRUE(resolved.solved);
+    EXPECT_TRUE(resolved.isUnique());
+}
+
+// Test: Generated killer puzzles round-trip through the custom format
+TYPED_TEST(GeometryTest, GeneratedKillerRoundTrip)
+{
+    BasicSudokuGenerator<TypeParam> generator;
+    GeneratorConfig config;
+    config.type = SudokuType::KILLER;
+    config.fillAllCells = true;
+    config.seed = 7;
+    config.ensureUniqueSolution = false;
+
+    BasicSudokuSolution<TypeParam> solution;
+    auto puzzle = generator.generateWithSolution(config, solution);
+    ASSERT_TRUE(solution.solved);
+    EXPECT_TRUE(BasicSudokuSolver<TypeParam>::verifySolution(puzzle, solution));
+
+    std::string text = BasicSudokuGenerator<TypeParam>::toCustomFormat(puzzle);
+    auto parsed = BasicSudokuParser<TypeParam>::parseFromString(text);
+    EXPECT_EQ(parsed.cages.size(), puzzle.cages.size());
+    EXPECT_TRUE(BasicSudokuSolver<TypeParam>::verifySolution(parsed, solution));
+}
+
+// Test: Rectangular boxes have the expected shape
+TEST(GeometryLayoutTest, RectangularBoxes)
+{
+    using Topo = BasicTopology<Geometry6x6>;
+    static_assert(Topo::NUM_PEERS == 12, "6x6 grid with 2x3 boxes has 12 peers");
+
+    // Box 1 is the top-right 2x3 block
+    const auto &box = Topo::UNITS[Topo::FIRST_BOX_UNIT + 1];
+    EXPECT_EQ(box[0], Topo::cellIndex(0, 3));
+    EXPECT_EQ(box[2], Topo::cellIndex(0, 5));
+    EXPECT_EQ(box[3], Topo::cellIndex(1, 3));
+    EXPECT_EQ(box[5], Topo::cellIndex(1, 5));
+}
+
+// Test: Pretty grid separators follow the box shape
+TEST(GeometryLayoutTest, PrettyGridFor6x6)
+{
+    BasicSudokuPuzzle<Geometry6x6> puzzle;
+    std::string pretty = BasicSudokuParser<Geometry6x6>::toPrettyGrid(puzzle.grid);
+    EXPECT_EQ(pretty.substr(0, pretty.find('\n')), "+-------+-------+");
+}
+
+// Test: 16x16 custom format uses space-separated multi-digit values
+TEST(GeometryLayoutTest, Parse16x16CustomFormat)
+{
+    std::string input = "GRID\n16 0 0 0 0 0 0 0 0 0 0 0 0 0 0 10\n";
+    auto puzzle = BasicSudokuParser<Geometry16x16>::parseFromString(input);
+    EXPECT_EQ(puzzle.grid[0][0], 16);
+    EXPECT_EQ(puzzle.grid[0][15], 10);
+    EXPECT_EQ(BasicSudokuParser<Geometry16x16>::symbolValue('G'), 16);
+    EXPECT_EQ(BasicSudokuParser<Geometry16x16>::symbolValue('H'), -1);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file test_grid_scan.cpp
+ * @brief Tests for the vectorized 81-character grid parser
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuGridScan.h"
+#include "SudokuParser.h"
+#include <random>
+#include <string>
+
+using namespace sudoku;
+
+// Test: The selected kernel agrees with the scalar kernel on valid and invalid input
+TEST(GridScanTest, MatchesScalarKernel)
+{
+    const std::string alphabet = "0123456789._*/:-+ \t\n9A#";
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> valid(0, 12);
+    std::uniform_int_distribution<int> any(0, static_cast<int>(alphabet.size()) - 1);
+    std::uniform_int_distribution<int> position(0, 80);
+
+    for (int n = 0; n < 2000; n++)
+    {
+        std::string text(81, '.');
+        for (char &c : text)
+        {
+            c = alphabet[valid(rng)];
+        }
+        // Half of the lines get one bad character somewhere, including the tail cell
+        if (n % 2 == 1)
+        {
+            text[n % 4 == 1 ? 80 : position(rng)] = alphabet[any(rng)];
+        }
+
+        uint8_t fast[81];
+        uint8_t reference[81];
+        bool fastOk = gridscan::scanGrid81(text.data(), fast);
+        bool referenceOk = gridscan::scanGrid81Scalar(text.data(), reference);
+        ASSERT_EQ(fastOk, referenceOk) << text << " (" << gridscan::kernelName() << ")";
+        if (referenceOk)
+        {
+            ASSERT_EQ(std::string(fast, fast + 81), std::string(reference, reference + 81)) << text;
+        }
+    }
+}
+
+// Test: Bytes outside the ASCII range are rejected
+TEST(GridScanTest, RejectsHighBytes)
+{
+    std::string text(81, '0');
+    uint8_t cells[81];
+    EXPECT_TRUE(gridscan::scanGrid81(text.data(), cells));
+    for (char bad : {'\x80', '\xb9', '\xff', '\0'})
+    {
+        text[40] = bad;
+        EXPECT_FALSE(gridscan::scanGrid81(text.data(), cells));
+    }
+}
+
+// Test: The parser uses the fast path for exact lines and falls back otherwise
+TEST(GridScanTest, ParserFastPathAndFallback)
+{
+    const std::string line =
+        "53..7...."
+        "6..195..."
+        ".98....6."
+        "8...6...3"
+        "4..8.3..1"
+        "7...2...6"
+        ".6....28."
+        "...419..5"
+        "....8..79";
+
+    SudokuPuzzle puzzle;
+    ASSERT_TRUE(SudokuParser::parseCompactGrid(line, puzzle));
+    EXPECT_EQ(puzzle.grid[0][0], 5);
+    EXPECT_EQ(puzzle.grid[0][2], EMPTY_CELL);
+    EXPECT_EQ(puzzle.grid[8][8], 9);
+
+    EXPECT_FALSE(SudokuParser::parseCompactGrid(line.substr(1), puzzle));
+    EXPECT_FALSE(SudokuParser::parseCompactGrid(line.substr(0, 80) + "x", puzzle));
+
+    // Messy input still parses through the scalar path
+    std::string spaced;
+    for (size_t i = 0; i < line.size(); i++)
+    {
+        spaced += line[i];
+        if (i % 9 == 8)
+            spaced += " | ";
+    }
+    auto messy = SudokuParser::parseFromString(spaced);
+    auto fast = SudokuParser::parseFromString(line + "\r\n");
+    for (int r = 0; r < 9; r++)
+    {
+        for (int c = 0; c < 9; c++)
+        {
+            EXPECT_EQ(messy.grid[r][c], fast.grid[r][c]);
+        }
+    }
+}
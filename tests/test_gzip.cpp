@@ -0,0 +1,102 @@
+/**
+ * @file test_gzip.cpp
+ * @brief Tests for gzip corpus input and output
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuGzip.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace sudoku;
+
+namespace
+{
+    std::string tempPath(const char *name)
+    {
+        return "/tmp/sudoku_test_" + std::to_string(::getpid()) + "_" + name;
+    }
+
+    std::vector<std::string> readAll(GzipCorpusReader &reader)
+    {
+        std::vector<std::string> records;
+        std::string_view record;
+        while (reader.next(record))
+        {
+            records.emplace_back(record);
+        }
+        return records;
+    }
+}
+
+// Test: Lines written compressed read back in order across many chunks
+TEST(GzipTest, LineCorpusRoundTrip)
+{
+#ifndef SUDOKU_HAVE_ZLIB
+    GTEST_SKIP() << "built without zlib";
+#endif
+    // About 2.5 MB uncompressed, so several chunks go through the queue
+    std::vector<std::string> expected;
+    std::string path = tempPath("lines.txt.gz");
+    {
+        GzipOutputStream out(path);
+        out << "# comment\n";
+        for (int i = 0; i < 30000; i++)
+        {
+            std::string line = std::to_string(i);
+            line.resize(81, static_cast<char>('1' + i % 9));
+            expected.push_back(line);
+            out << line << "\r\n";
+        }
+        out.close();
+    }
+    EXPECT_TRUE(isGzipFile(path));
+    EXPECT_TRUE(hasGzipSuffix(path));
+
+    GzipCorpusReader reader(path);
+    EXPECT_EQ(reader.getFormat(), CorpusFormat::LINES);
+    EXPECT_EQ(readAll(reader), expected);
+    std::remove(path.c_str());
+
+    std::string plain = tempPath("plain.txt");
+    std::ofstream(plain) << "123\n";
+    EXPECT_FALSE(isGzipFile(plain));
+    EXPECT_FALSE(hasGzipSuffix(plain));
+    std::remove(plain.c_str());
+}
+
+// Test: GRID blocks are never cut between chunks, and a reader may stop early
+TEST(GzipTest, BlockCorpusRoundTrip)
+{
+#ifndef SUDOKU_HAVE_ZLIB
+    GTEST_SKIP() << "built without zlib";
+#endif
+    std::vector<std::string> expected;
+    std::string path = tempPath("blocks.txt.gz");
+    {
+        GzipOutputStream out(path);
+        for (int i = 0; i < 40000; i++)
+        {
+            std::string block = "GRID\n" + std::to_string(i) + " 0 0\nCAGES\n10 0 0 0 1";
+            expected.push_back(block);
+            out << block << "\n\n";
+        }
+    }
+
+    {
+        GzipCorpusReader reader(path);
+        EXPECT_EQ(reader.getFormat(), CorpusFormat::BLOCKS);
+        EXPECT_EQ(readAll(reader), expected);
+    }
+    {
+        GzipCorpusReader reader(path);
+        std::string_view record;
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record, expected[0]);
+    }
+    std::remove(path.c_str());
+}
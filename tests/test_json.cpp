@@ -0,0 +1,130 @@
+/**
+ * @file test_json.cpp
+ * @brief Tests for the JSON puzzle and solution format
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuJson.h"
+#include "SudokuParser.h"
+#include "SudokuSolver.h"
+#include <string>
+
+using namespace sudoku;
+
+// Test: A puzzle with every constraint kind survives a write/read round trip
+TEST(JsonTest, PuzzleRoundTrip)
+{
+    SudokuPuzzle puzzle;
+    puzzle.setCell(0, 0, 5);
+    puzzle.setCell(8, 8, 9);
+    puzzle.addCage(Cage({Cell(1, 1), Cell(1, 2)}, 10));
+    puzzle.addInequality(InequalityConstraint(Cell(4, 4), Cell(4, 5), InequalityType::LESS_THAN));
+
+    std::string text = SudokuJson::writePuzzle(puzzle);
+    EXPECT_EQ(text.find('\n'), std::string::npos);
+
+    SudokuPuzzle parsed = SudokuJson::parsePuzzle(text);
+    EXPECT_EQ(parsed.type, SudokuType::KILLER_INEQUALITY);
+    EXPECT_EQ(parsed.grid[0][0], 5);
+    EXPECT_EQ(parsed.grid[8][8], 9);
+    ASSERT_EQ(parsed.cages.size(), 1u);
+    EXPECT_EQ(parsed.cages[0].targetSum, 10);
+    EXPECT_EQ(parsed.cages[0].cells[1], Cell(1, 2));
+    ASSERT_EQ(parsed.inequalities.size(), 1u);
+    EXPECT_EQ(parsed.inequalities[0].type, InequalityType::LESS_THAN);
+    EXPECT_EQ(SudokuJson::writePuzzle(parsed), text);
+}
+
+// Test: Grid layouts, whitespace, unknown keys and the id all parse
+TEST(JsonTest, GridFormsAndId)
+{
+    const std::string line =
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+    std::string id;
+    SudokuPuzzle fromString = SudokuJson::parsePuzzle(
+        "{ \"id\" : {\"set\": \"easy\", \"n\": [1, 2]},\n  \"grid\": \"" + line + "\",\n"
+        "  \"comment\": \"ignored \\\" value\", \"rating\": -1.5e3, \"tags\": [true, null] }",
+        &id);
+    EXPECT_EQ(id, "{\"set\": \"easy\", \"n\": [1, 2]}");
+
+    std::string flat = "{\"grid\": [";
+    for (size_t i = 0; i < line.size(); i++)
+    {
+        flat += i > 0 ? "," : "";
+        flat += line[i] == '.' ? '0' : line[i];
+    }
+    flat += "]}";
+    SudokuPuzzle fromFlat = SudokuParser::parseFromString(flat);
+
+    for (int r = 0; r < 9; r++)
+    {
+        for (int c = 0; c < 9; c++)
+        {
+            EXPECT_EQ(fromString.grid[r][c], fromFlat.grid[r][c]);
+        }
+    }
+    EXPECT_EQ(fromFlat.type, SudokuType::STANDARD);
+}
+
+// Test: Errors report the byte offset of the problem
+TEST(JsonTest, ErrorsReportOffset)
+{
+    auto errorOf = [](const std::string &text) -> std::string
+    {
+        try
+        {
+            SudokuJson::parsePuzzle(text);
+        }
+        catch (const std::runtime_error &e)
+        {
+            return e.what();
+        }
+        return "";
+    };
+
+    EXPECT_NE(errorOf("{\"grid\": [1, 2, x]}").find("offset 16"), std::string::npos);
+    EXPECT_NE(errorOf("{\"grid\": [1, 2]}").find("81 cells"), std::string::npos);
+    EXPECT_NE(errorOf("{\"cages\": [{\"cells\": [[0, 9]], \"sum\": 3}]}").find("out of range"), std::string::npos);
+    EXPECT_NE(errorOf("{\"type\": \"jigsaw\"}").find("unknown puzzle type"), std::string::npos);
+    EXPECT_NE(errorOf("{\"type\": \"killer\"}").find("does not match"), std::string::npos);
+    EXPECT_NE(errorOf("{\"type\": \"standard\", \"cages\": [{\"cells\": [[0, 0]], \"sum\": 3}]}")
+                  .find("does not match"),
+              std::string::npos);
+    EXPECT_NE(errorOf("{\"grid\": \"123").find("unterminated"), std::string::npos);
+    EXPECT_NE(errorOf("{} {}").find("trailing"), std::string::npos);
+}
+
+// Test: Deeply nested input is rejected instead of recursing without bound
+TEST(JsonTest, RejectsDeepNesting)
+{
+    const std::string deep = "{\"id\":" + std::string(200000, '[');
+    EXPECT_THROW(json::forEachMember(deep, [](std::string_view, std::string_view) {}), std::runtime_error);
+    EXPECT_THROW(SudokuJson::parsePuzzle(deep), std::runtime_error);
+
+    // Nesting within the limit still parses
+    std::string id;
+    SudokuJson::parsePuzzle("{\"id\":" + std::string(32, '[') + std::string(32, ']') + "}", &id);
+    EXPECT_EQ(id, std::string(32, '[') + std::string(32, ']'));
+}
+
+// Test: Solutions are written with escaped errors and an echoed id
+TEST(JsonTest, WriteSolution)
+{
+    SudokuSolution failure;
+    failure.errorMessage = "bad \"input\"\n";
+    std::string out;
+    SudokuJson::writeSolution(failure, out, "\"p1\"");
+    EXPECT_EQ(out, "{\"id\":\"p1\",\"solved\":false,\"solveTimeMs\":0.000,\"error\":\"bad \\\"input\\\"\\n\"}");
+
+    SudokuPuzzle puzzle = SudokuParser::parseFromString(
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79");
+    SudokuSolver solver;
+    SudokuSolution solution = solver.solve(puzzle, true);
+    ASSERT_TRUE(solution.solved);
+
+    out.clear();
+    SudokuJson::writeSolution(solution, out);
+    EXPECT_EQ(out.rfind("{\"solved\":true,\"uniqueness\":\"unique\",\"solveTimeMs\":", 0), 0u);
+    EXPECT_NE(out.find("\"grid\":[[5,3,4,6,7,8,9,1,2],"), std::string::npos);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file test_latency.cpp
+ * @brief Tests for latency histograms and the batch latency report
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuLatency.h"
+#include <cmath>
+#include <string>
+
+using namespace sudoku;
+
+// Test: Percentiles stay within 1% of the exact values over a wide range
+TEST(LatencyHistogramTest, PercentilesWithinPrecision)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0.0);
+
+    // 1 ms .. 10000 ms in 1 ms steps
+    for (int i = 1; i <= 10000; i++)
+    {
+        histogram.record(i);
+    }
+    EXPECT_EQ(histogram.getCount(), 10000u);
+    EXPECT_DOUBLE_EQ(histogram.getMax(), 10000.0);
+    EXPECT_NEAR(histogram.getMean(), 5000.5, 1e-6);
+
+    const double expected[][2] = {{50, 5000}, {90, 9000}, {99, 9900}, {99.9, 9990}};
+    for (const auto &check : expected)
+    {
+        double value = histogram.percentile(check[0]);
+        EXPECT_GE(value, check[1]);
+        EXPECT_LE(value, check[1] * 1.01);
+    }
+    EXPECT_DOUBLE_EQ(histogram.percentile(100), 10000.0);
+
+    // Small values are exact to the microsecond
+    LatencyHistogram small;
+    small.record(0.1);
+    small.record(0.2);
+    EXPECT_DOUBLE_EQ(small.percentile(50), 0.1);
+
+    small.merge(histogram);
+    EXPECT_EQ(small.getCount(), 10002u);
+    EXPECT_DOUBLE_EQ(small.getMax(), 10000.0);
+}
+
+// Test: The report splits by type and phase, skips phases that did not run and names the slowest
+TEST(LatencyReportTest, TypesPhasesAndSlowest)
+{
+    LatencyReport report(2);
+    for (int i = 0; i < 10; i++)
+    {
+        PuzzleTiming timing;
+        timing.encodeMs = 0.5;
+        timing.solveMs = i;
+        timing.totalMs = i + 0.5;
+        report.record(SudokuType::STANDARD, "s" + std::to_string(i), timing);
+    }
+    PuzzleTiming killer;
+    killer.encodeMs = 1.0;
+    killer.solveMs = 40.0;
+    killer.uniqueMs = 8.0;
+    killer.verifyMs = 0.01;
+    killer.totalMs = 49.01;
+    report.record(SudokuType::KILLER, "k0", killer);
+
+    EXPECT_EQ(report.get(SudokuType::STANDARD, LatencyPhase::SOLVE).getCount(), 10u);
+    EXPECT_EQ(report.get(SudokuType::STANDARD, LatencyPhase::UNIQUENESS).getCount(), 0u);
+    EXPECT_EQ(report.get(SudokuType::KILLER, LatencyPhase::VERIFY).getCount(), 1u);
+    EXPECT_EQ(report.get(SudokuType::INEQUALITY, LatencyPhase::TOTAL).getCount(), 0u);
+
+    auto slowest = report.getSlowest();
+    ASSERT_EQ(slowest.size(), 2u);
+    EXPECT_EQ(slowest[0].id, "k0");
+    EXPECT_EQ(slowest[0].type, SudokuType::KILLER);
+    EXPECT_EQ(slowest[1].id, "s9");
+
+    std::string text = report.formatText();
+    EXPECT_NE(text.find("standard"), std::string::npos);
+    EXPECT_NE(text.find("uniqueness"), std::string::npos);
+    EXPECT_EQ(text.find("inequality"), std::string::npos);
+    EXPECT_NE(text.find("Slowest: k0"), std::string::npos);
+
+    std::string json = report.toJson(2.0);
+    EXPECT_EQ(json.rfind("{\"puzzles\":11,\"wallSeconds\":2.000,\"throughput\":5.5,", 0), 0u);
+    EXPECT_NE(json.find("\"killer\":{\"encode\":{\"count\":1,\"mean\":1.000,\"p50\":1.000"), std::string::npos);
+    EXPECT_NE(json.find("\"slowest\":[{\"id\":\"k0\",\"type\":\"killer\",\"totalMs\":49.010}"), std::string::npos);
+    EXPECT_EQ(json.find("\"uniqueness\""), json.rfind("\"uniqueness\"")); // Killer only
+}
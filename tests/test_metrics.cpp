@@ -0,0 +1,87 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Tests for the Prometheus metrics
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuMetrics.h"
+#include "SudokuServer.h"
+#include <string>
+
+using namespace sudoku;
+
+namespace
+{
+    const std::string kClassic =
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+    bool contains(const std::string &text, const std::string &line)
+    {
+        return text.find(line + "\n") != std::string::npos;
+    }
+}
+
+// Test: Counters, cumulative histogram buckets and watched gauges render in text format
+TEST(MetricsTest, RendersPrometheusText)
+{
+    MetricsRegistry registry;
+    registry.describe("jobs_total", "Jobs done", MetricType::COUNTER);
+    registry.describe("latency_seconds", "Latency", MetricType::HISTOGRAM, {0.1, 1});
+    registry.describe("depth", "Depth", MetricType::GAUGE);
+
+    registry.increment("jobs_total", "kind=\"a\"");
+    registry.increment("jobs_total", "kind=\"a\"", 2);
+    registry.observe("latency_seconds", {}, 0.05);
+    registry.observe("latency_seconds", {}, 0.5);
+    registry.observe("latency_seconds", {}, 5);
+    registry.watch("depth", "queue=\"q\"", []()
+                   { return 7.0; });
+
+    std::string text = registry.renderPrometheus();
+    EXPECT_EQ(text.rfind("# HELP jobs_total Jobs done\n# TYPE jobs_total counter\n", 0), 0u);
+    EXPECT_TRUE(contains(text, "jobs_total{kind=\"a\"} 3"));
+    EXPECT_TRUE(contains(text, "# TYPE latency_seconds histogram"));
+    EXPECT_TRUE(contains(text, "latency_seconds_bucket{le=\"0.1\"} 1"));
+    EXPECT_TRUE(contains(text, "latency_seconds_bucket{le=\"1\"} 2"));
+    EXPECT_TRUE(contains(text, "latency_seconds_bucket{le=\"+Inf\"} 3"));
+    EXPECT_TRUE(contains(text, "latency_seconds_sum 5.55"));
+    EXPECT_TRUE(contains(text, "latency_seconds_count 3"));
+    EXPECT_TRUE(contains(text, "depth{queue=\"q\"} 7"));
+
+    EXPECT_THROW(registry.increment("missing_total"), std::runtime_error);
+}
+
+// Test: Requests served by a handler feed the service metrics
+TEST(MetricsTest, RecordsRequests)
+{
+    auto metrics = std::make_shared<ServiceMetrics>();
+    auto cache = std::make_shared<SolutionCache>();
+    metrics->watchCache(cache);
+
+    RequestHandler handler;
+    handler.setMetrics(metrics);
+    handler.setCache(cache);
+
+    const std::string solve = "{\"op\":\"unique\",\"puzzle\":\"" + kClassic + "\"}";
+    handler.handle(solve);
+    handler.handle(solve); // From the cache
+    handler.handle("{\"op\":\"generate\",\"type\":\"killer\",\"seed\":4}");
+    handler.handle("{\"op\":\"fly\"}");
+
+    std::string response = handler.handle("{\"id\":9,\"op\":\"metrics\"}");
+    EXPECT_EQ(response.rfind("{\"id\":9,\"metrics\":\"# HELP sudoku_requests_total", 0), 0u);
+
+    std::string text = metrics->renderPrometheus();
+    EXPECT_TRUE(contains(text, "sudoku_requests_total{op=\"unique\",outcome=\"ok\"} 2"));
+    EXPECT_TRUE(contains(text, "sudoku_requests_total{op=\"generate\",outcome=\"ok\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_requests_total{op=\"invalid\",outcome=\"error\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_solve_seconds_count{engine=\"sat\",type=\"standard\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_solve_seconds_count{engine=\"cache\",type=\"standard\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_uniqueness_check_seconds_count{type=\"standard\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_solve_conflicts_count{type=\"standard\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_generate_seconds_count{type=\"killer\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_generate_phase_seconds_count{phase=\"fill\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_generate_phase_seconds_count{phase=\"minimize\"} 1"));
+    EXPECT_TRUE(contains(text, "sudoku_cache_hits_total 1"));
+    EXPECT_NE(text.find("process_resident_memory_bytes "), std::string::npos);
+}
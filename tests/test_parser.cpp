@@ -0,0 +1,104 @@
+/**
+ * @file test_parser.cpp
+ * @brief Tests for the custom text format parser
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuGenerator.h"
+#include "SudokuParser.h"
+#include <string>
+
+using namespace sudoku;
+
+// Test: Generator output parses back, SOLUTION section included
+TEST(ParserTest, GeneratorRoundTrip)
+{
+    GeneratorConfig config;
+    config.type = SudokuType::KILLER_INEQUALITY;
+    config.ensureUniqueSolution = false;
+    config.seed = 11;
+
+    SudokuGenerator generator;
+    SudokuSolution solution;
+    SudokuPuzzle puzzle = generator.generateWithSolution(config, solution);
+
+    SudokuPuzzle parsed;
+    ParseResult result =
+        SudokuParser::parseCustomFormat(SudokuGenerator::toCustomFormatWithSolution(puzzle, solution), parsed);
+    ASSERT_TRUE(result.ok()) << result.toString();
+    EXPECT_EQ(parsed.type, puzzle.type);
+    ASSERT_EQ(parsed.cages.size(), puzzle.cages.size());
+    ASSERT_EQ(parsed.inequalities.size(), puzzle.inequalities.size());
+    for (size_t i = 0; i < puzzle.cages.size(); i++)
+    {
+        EXPECT_EQ(parsed.cages[i].targetSum, puzzle.cages[i].targetSum);
+        EXPECT_EQ(parsed.cages[i].cells, puzzle.cages[i].cells);
+    }
+    for (size_t i = 0; i < puzzle.inequalities.size(); i++)
+    {
+        EXPECT_EQ(parsed.inequalities[i].cell1, puzzle.inequalities[i].cell1);
+        EXPECT_EQ(parsed.inequalities[i].cell2, puzzle.inequalities[i].cell2);
+        EXPECT_EQ(parsed.inequalities[i].type, puzzle.inequalities[i].type);
+    }
+}
+
+// Test: Errors carry the status, line and column instead of throwing
+TEST(ParserTest, ErrorPositions)
+{
+    struct Case
+    {
+        const char *text;
+        ParseStatus status;
+        int line;
+        int column;
+    };
+    const Case cases[] = {
+        {"CAGES\n10 0 0 0 x", ParseStatus::INVALID_NUMBER, 2, 10},
+        {"CAGES\n  10 0 0 0", ParseStatus::INVALID_CAGE, 2, 11},
+        {"CAGES\n10", ParseStatus::INVALID_CAGE, 2, 3},
+        {"GRID\n\nCAGES\n10 0 0 9 1", ParseStatus::CELL_OUT_OF_RANGE, 4, 8},
+        {"INEQUALITIES\n0 0 > 0 1\n0 0 = 0 1", ParseStatus::INVALID_INEQUALITY, 3, 5},
+        {"INEQUALITIES\n0 0 < 0 1 2", ParseStatus::INVALID_INEQUALITY, 2, 11},
+    };
+
+    SudokuPuzzle puzzle;
+    for (const Case &c : cases)
+    {
+        ParseResult result = SudokuParser::parseCustomFormat(std::string_view(c.text), puzzle);
+        EXPECT_EQ(result.status, c.status) << c.text;
+        EXPECT_EQ(result.line, c.line) << c.text;
+        EXPECT_EQ(result.column, c.column) << c.text;
+    }
+
+    // The throwing entry points report the same position
+    try
+    {
+        SudokuParser::parseFromString("GRID\nCAGES\n10 0 0 0 x");
+        FAIL() << "expected an error";
+    }
+    catch (const std::runtime_error &e)
+    {
+        EXPECT_NE(std::string(e.what()).find("line 3, column 10"), std::string::npos) << e.what();
+    }
+}
+
+// Test: A reused puzzle is fully overwritten and keeps its cage storage
+TEST(ParserTest, ReusesPuzzle)
+{
+    SudokuPuzzle puzzle;
+    ASSERT_TRUE(SudokuParser::parseCustomFormat(std::string_view("GRID\n5\nCAGES\n10 0 0 0 1\n3 1 0 1 1\n"
+                                                                 "INEQUALITIES\n2 2 gt 2 3"),
+                                                puzzle));
+    EXPECT_EQ(puzzle.type, SudokuType::KILLER_INEQUALITY);
+    EXPECT_EQ(puzzle.grid[0][0], 5);
+    const Cell *cells = puzzle.cages[0].cells.data();
+
+    ASSERT_TRUE(SudokuParser::parseCustomFormat(std::string_view("cages\n\t12 4 4   4 5\r\n"), puzzle));
+    EXPECT_EQ(puzzle.type, SudokuType::KILLER);
+    EXPECT_EQ(puzzle.grid[0][0], EMPTY_CELL);
+    ASSERT_EQ(puzzle.cages.size(), 1u);
+    EXPECT_EQ(puzzle.cages[0].targetSum, 12);
+    EXPECT_EQ(puzzle.cages[0].cells, (std::vector<Cell>{Cell(4, 4), Cell(4, 5)}));
+    EXPECT_EQ(puzzle.cages[0].cells.data(), cells);
+    EXPECT_TRUE(puzzle.inequalities.empty());
+}
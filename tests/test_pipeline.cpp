@@ -0,0 +1,173 @@
+/**
+ * @file test_pipeline.cpp
+ * @brief Tests for the staged batch pipeline
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuPipeline.h"
+#include "SudokuParser.h"
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace sudoku;
+
+namespace
+{
+    const char *const kPuzzle =
+        "530070000600195000098000060800060003400803001700020006060000280000419005000080079";
+
+    bool parseLine(std::string_view record, SudokuPuzzle &puzzle, std::string &, std::string &error)
+    {
+        if (SudokuParser::parseCompactGrid(record, puzzle))
+        {
+            return true;
+        }
+        error = "not a grid";
+        return false;
+    }
+
+    // Every third record is invalid
+    std::vector<std::string> makeRecords(size_t count)
+    {
+        std::vector<std::string> records;
+        for (size_t i = 0; i < count; i++)
+        {
+            records.push_back(i % 3 == 2 ? "bad " + std::to_string(i) : kPuzzle);
+        }
+        return records;
+    }
+
+    BatchPipeline::Source sourceOf(const std::vector<std::string> &records)
+    {
+        auto next = std::make_shared<size_t>(0);
+        return [&records, next](std::string_view &record)
+        {
+            if (*next == records.size())
+            {
+                return false;
+            }
+            record = records[(*next)++];
+            return true;
+        };
+    }
+}
+
+// Test: The queue keeps FIFO order, refuses pushes when full and keeps the value
+TEST(BoundedQueueTest, FifoAndCapacity)
+{
+    BoundedQueue<std::unique_ptr<int>> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    for (int i = 0; i < 4; i++)
+    {
+        auto value = std::make_unique<int>(i);
+        EXPECT_TRUE(queue.tryPush(value));
+        EXPECT_FALSE(value);
+    }
+    auto extra = std::make_unique<int>(99);
+    EXPECT_FALSE(queue.tryPush(extra));
+    ASSERT_TRUE(extra);
+    EXPECT_EQ(*extra, 99);
+
+    std::unique_ptr<int> value;
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(*value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_FALSE(queue.isClosed());
+    queue.close();
+    EXPECT_TRUE(queue.isClosed());
+}
+
+// Test: Results arrive in input order with a tiny in-flight budget; bad records skip the solvers
+TEST(BatchPipelineTest, OrderedWithSmallBudget)
+{
+    std::vector<std::string> records = makeRecords(60);
+
+    PipelineConfig config;
+    config.parseThreads = 2;
+    config.solveThreads = 3;
+    config.maxInFlight = 4;
+    config.firstIndex = 100;
+    std::vector<size_t> order;
+    size_t invalid = 0;
+    BatchPipeline pipeline(config, parseLine, [&](const PipelineResult &result)
+                           {
+                               order.push_back(result.index);
+                               EXPECT_EQ(result.record, records[result.index - 100]);
+                               if (result.parsed)
+                               {
+                                   EXPECT_TRUE(result.solution.solved);
+                               }
+                               else
+                               {
+                                   EXPECT_EQ(result.error, "not a grid");
+                                   invalid++;
+                               } });
+
+    PipelineStats stats = pipeline.run(sourceOf(records));
+    EXPECT_EQ(stats.records, records.size());
+    EXPECT_EQ(invalid, 20u);
+    ASSERT_EQ(order.size(), records.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        EXPECT_EQ(order[i], 100 + i);
+    }
+}
+
+// Test: Unordered runs report every record once; a sink exception stops the run
+TEST(BatchPipelineTest, UnorderedAndFailure)
+{
+    std::vector<std::string> records = makeRecords(30);
+
+    PipelineConfig config;
+    config.solveThreads = 2;
+    config.ordered = false;
+    config.stableRecords = true;
+    std::set<size_t> seen;
+    BatchPipeline unordered(config, parseLine, [&](const PipelineResult &result)
+                            { EXPECT_TRUE(seen.insert(result.index).second); });
+    unordered.run(sourceOf(records));
+    EXPECT_EQ(seen.size(), records.size());
+
+    size_t reported = 0;
+    BatchPipeline failing(PipelineConfig(), parseLine, [&](const PipelineResult &)
+                          {
+                              if (++reported == 5)
+                              {
+                                  throw std::runtime_error("disk full");
+                              } });
+    EXPECT_THROW(failing.run(sourceOf(records)), std::runtime_error);
+    EXPECT_EQ(reported, 5u);
+}
+
+// Test: With deduplicate, a rotated copy is answered from the cache and mapped back
+TEST(BatchPipelineTest, DeduplicateSolvesEachClassOnce)
+{
+    // The puzzle and its transpose
+    std::string transposed;
+    for (int c = 0; c < 9; c++)
+    {
+        for (int r = 0; r < 9; r++)
+        {
+            transposed += kPuzzle[r * 9 + c];
+        }
+    }
+    std::vector<std::string> records = {kPuzzle, transposed};
+
+    PipelineConfig config;
+    config.deduplicate = true;
+    config.verify = true;
+    size_t cached = 0;
+    BatchPipeline pipeline(config, parseLine, [&](const PipelineResult &result)
+                           {
+                               ASSERT_TRUE(result.solution.solved);
+                               EXPECT_TRUE(result.verified);
+                               cached += result.stats.cached ? 1 : 0; });
+    pipeline.run(sourceOf(records));
+    EXPECT_EQ(cached, 1u);
+}
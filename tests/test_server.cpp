@@ -0,0 +1,127 @@
+/**
+ * @file test_server.cpp
+ * @brief Tests for the --serve JSON request loop
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuJson.h"
+#include "SudokuServer.h"
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace sudoku;
+
+namespace
+{
+    const std::string kClassic =
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+    std::string idOf(const std::string &response)
+    {
+        std::string id;
+        json::forEachMember(response, [&](std::string_view key, std::string_view value)
+                            {
+            if (key == "id")
+                id = std::string(value); });
+        return id;
+    }
+}
+
+// Test: Each op answers with its own response shape and echoes the id
+TEST(ServerTest, HandlesEachOp)
+{
+    RequestServer server(1, [](const std::string &) {});
+
+    std::string solved = server.handle("{\"id\": \"a\", \"op\": \"unique\", \"puzzle\": \"" + kClassic + "\"}");
+    EXPECT_EQ(solved.rfind("{\"id\":\"a\",\"solved\":true,\"uniqueness\":\"unique\"", 0), 0u);
+
+    std::string generated = server.handle(
+        "{\"id\": 2, \"op\": \"generate\", \"type\": \"killer\", \"seed\": 7, \"unique\": false}");
+    EXPECT_EQ(generated.rfind("{\"id\":2,\"puzzle\":{\"type\":\"killer\"", 0), 0u);
+
+    // Feed the generated puzzle and its solution back through verify
+    std::string puzzle;
+    std::string solution;
+    json::forEachMember(generated, [&](std::string_view key, std::string_view value)
+                        {
+        if (key == "puzzle")
+            puzzle = std::string(value);
+        else if (key == "solution")
+            solution = std::string(value); });
+    std::string verify = "{\"id\":3,\"op\":\"verify\",\"puzzle\":" + puzzle + ",\"solution\":" + solution + "}";
+    EXPECT_EQ(server.handle(verify), "{\"id\":3,\"valid\":true}");
+
+    solution[2] = solution[2] == '1' ? '2' : '1';
+    verify = "{\"id\":4,\"op\":\"verify\",\"puzzle\":" + puzzle + ",\"solution\":" + solution + "}";
+    EXPECT_EQ(server.handle(verify), "{\"id\":4,\"valid\":false}");
+}
+
+// Test: Bad requests produce an error response instead of stopping the loop
+TEST(ServerTest, ReportsErrors)
+{
+    RequestServer server(1, [](const std::string &) {});
+
+    EXPECT_EQ(server.handle("{\"id\": 1, \"op\": \"fly\"}"), "{\"id\":1,\"error\":\"unknown op: fly\"}");
+    EXPECT_EQ(server.handle("{\"id\": 2}"), "{\"id\":2,\"error\":\"missing \\\"op\\\"\"}");
+    EXPECT_EQ(server.handle("{\"id\": 3, \"op\": \"solve\", \"puzzle\": {\"grid\": \"123\"}}").rfind("{\"id\":3,\"error\":", 0), 0u);
+    EXPECT_EQ(server.handle("not json").rfind("{\"error\":", 0), 0u);
+}
+
+// Test: Submitted requests are all answered, with matching ids, across workers
+TEST(ServerTest, PipelinesRequests)
+{
+    std::mutex mutex;
+    std::vector<std::string> responses;
+    {
+        RequestServer server(3, [&](const std::string &response)
+                             {
+                                 std::lock_guard<std::mutex> lock(mutex);
+                                 responses.push_back(response); },
+                             2);
+        for (int i = 0; i < 20; i++)
+        {
+            std::string body = i % 2 == 0 ? "\"op\": \"solve\", \"puzzle\": \"" + kClassic + "\""
+                                          : "\"op\": \"generate\", \"type\": \"standard\", \"unique\": false";
+            server.submit("{\"id\": " + std::to_string(i) + ", " + body + "}");
+        }
+        server.finish();
+        EXPECT_EQ(server.getRequests(), 20u);
+    }
+
+    ASSERT_EQ(responses.size(), 20u);
+    std::set<std::string> ids;
+    for (const std::string &response : responses)
+    {
+        EXPECT_EQ(response.find("error"), std::string::npos) << response;
+        ids.insert(idOf(response));
+    }
+    EXPECT_EQ(ids.size(), 20u);
+}
+
+// Test: One worker answers queued requests in the order they arrived
+TEST(ServerTest, AnswersInArrivalOrder)
+{
+    std::mutex mutex;
+    std::vector<std::string> ids;
+    {
+        RequestServer server(1, [&](const std::string &response)
+                             {
+                                 std::lock_guard<std::mutex> lock(mutex);
+                                 ids.push_back(idOf(response)); });
+        // The first request is slow, so the rest queue up behind it
+        server.submit("{\"id\": 0, \"op\": \"generate\", \"type\": \"killer\"}");
+        for (int i = 1; i < 8; i++)
+        {
+            server.submit("{\"id\": " + std::to_string(i) + ", \"op\": \"solve\", \"puzzle\": \"" + kClassic + "\"}");
+        }
+        server.finish();
+    }
+
+    ASSERT_EQ(ids.size(), 8u);
+    for (int i = 0; i < 8; i++)
+    {
+        EXPECT_EQ(ids[i], std::to_string(i));
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @file test_shard.cpp
+ * @brief Tests for the corpus manifest and multi-process shard runner
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuShard.h"
+#include "SudokuSolver.h"
+#include "SudokuParser.h"
+#include "SudokuWriter.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+using namespace sudoku;
+
+namespace
+{
+    const std::string kClassic =
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+
+    std::string tempPath(const char *name)
+    {
+        return "/tmp/sudoku_test_" + std::to_string(::getpid()) + "_" + name;
+    }
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    // 40 puzzles: the classic grid with up to four givens removed, one bad line and one unsolvable grid
+    std::string makeCorpus()
+    {
+        std::string text = "# corpus\n";
+        for (int i = 0; i < 40; i++)
+        {
+            std::string grid = kClassic;
+            if (i == 13)
+            {
+                grid = "not a puzzle";
+            }
+            else if (i == 27)
+            {
+                grid[2] = '5'; // Same digit twice in the first row
+            }
+            else
+            {
+                size_t cleared = 0;
+                for (char &c : grid)
+                {
+                    if (c != '.' && cleared++ < static_cast<size_t>(i % 5))
+                        c = '.';
+                }
+            }
+            text += grid + "\n";
+        }
+        return text;
+    }
+
+    std::string expectedLine(const std::string &record)
+    {
+        SudokuPuzzle puzzle;
+        std::string line(SudokuWriter::NUM_CELLS, '.');
+        if (SudokuParser::parseCompactGrid(record, puzzle))
+        {
+            SudokuSolver solver;
+            SudokuSolution solution = solver.solve(puzzle);
+            if (solution.solved)
+                SudokuWriter::writeGridLine(solution.grid, &line[0]);
+        }
+        return line + "\n";
+    }
+}
+
+// Test: Chunks cover every record once, round-trip through a file and split into shards
+TEST(ShardTest, ManifestChunksAndShards)
+{
+    std::string text = makeCorpus();
+    CorpusManifest manifest = CorpusManifest::build(text, 8);
+    EXPECT_EQ(manifest.format, CorpusFormat::LINES);
+    EXPECT_EQ(manifest.totalRecords, 40u);
+    ASSERT_EQ(manifest.chunks.size(), 5u);
+    EXPECT_EQ(manifest.chunks[0].begin, 0u);
+    EXPECT_EQ(manifest.chunks[4].end, text.size());
+    for (size_t i = 0; i < manifest.chunks.size(); i++)
+    {
+        EXPECT_EQ(manifest.chunks[i].firstRecord, i * 8);
+        EXPECT_EQ(manifest.chunks[i].records, 8u);
+        if (i > 0)
+        {
+            EXPECT_EQ(manifest.chunks[i].begin, manifest.chunks[i - 1].end);
+            EXPECT_EQ(text[manifest.chunks[i].begin - 1], '\n');
+        }
+    }
+
+    std::string path = tempPath("manifest.txt");
+    manifest.save(path);
+    CorpusManifest loaded = CorpusManifest::load(path);
+    EXPECT_EQ(loaded.totalRecords, manifest.totalRecords);
+    EXPECT_EQ(loaded.corpusBytes, manifest.corpusBytes);
+    ASSERT_EQ(loaded.chunks.size(), manifest.chunks.size());
+    EXPECT_EQ(loaded.chunks[3].begin, manifest.chunks[3].begin);
+
+    std::ofstream(path) << "# sudoku corpus manifest\nversion 9\n";
+    EXPECT_THROW(CorpusManifest::load(path), std::runtime_error);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(manifest.shardChunks(0, 2), (std::pair<size_t, size_t>{0, 2}));
+    EXPECT_EQ(manifest.shardChunks(1, 2), (std::pair<size_t, size_t>{2, 5}));
+    EXPECT_THROW(manifest.shardChunks(2, 2), std::runtime_error);
+}
+
+// Test: Forked workers write every result at its record's index
+TEST(ShardTest, WorkersWriteResultsInPlace)
+{
+    std::string text = makeCorpus();
+    std::string corpusPath = tempPath("corpus.txt");
+    std::ofstream(corpusPath) << text;
+
+    std::string expected;
+    std::istringstream lines(text);
+    std::string record;
+    while (std::getline(lines, record))
+    {
+        if (record[0] != '#')
+            expected += expectedLine(record);
+    }
+
+    CorpusManifest manifest = CorpusManifest::build(text, 3);
+    ShardConfig config;
+    config.workers = 3;
+    config.checkUniqueness = true;
+    std::string outputPath = tempPath("out.txt");
+    ShardStats stats = ShardRunner(config).run(corpusPath, manifest, outputPath);
+
+    EXPECT_EQ(stats.records, 40u);
+    EXPECT_EQ(stats.solved, 38u);
+    EXPECT_EQ(stats.invalid, 1u);
+    EXPECT_EQ(stats.failedWorkers, 0);
+    EXPECT_GT(stats.notUnique, 0u); // Removing givens from a minimal puzzle adds solutions
+    EXPECT_EQ(readFile(outputPath), expected);
+
+    // Shards written separately concatenate to the same output
+    std::string joined;
+    config.numShards = 3;
+    for (int shard = 0; shard < 3; shard++)
+    {
+        config.shardId = shard;
+        EXPECT_EQ(ShardRunner(config).run(corpusPath, manifest, outputPath).failedWorkers, 0);
+        joined += readFile(outputPath);
+    }
+    EXPECT_EQ(joined, expected);
+
+    std::ofstream(corpusPath, std::ios::app) << kClassic << "\n";
+    EXPECT_THROW(ShardRunner(config).run(corpusPath, manifest, outputPath), std::runtime_error);
+
+    std::remove(corpusPath.c_str());
+    std::remove(outputPath.c_str());
+}
@@ -216,3 +216,19 @@ TEST_F(StandardSudokuTest, PerformanceMultiplePuzzles)
         EXPECT_LT(solution.solveTimeMs, 1000.0) << "Solve time exceeds 1 second";
     }
 }
+
+// Test: An interrupted solve reports unsolved until the interrupt is cleared
+TEST_F(StandardSudokuTest, InterruptStopsSolve)
+{
+    SudokuPuzzle empty;
+    solver.interrupt();
+    auto interrupted = solver.solve(empty, true);
+    EXPECT_FALSE(interrupted.solved);
+    EXPECT_TRUE(solver.getLastStats().interrupted);
+
+    solver.clearInterrupt();
+    auto solution = solver.solve(empty);
+    ASSERT_TRUE(solution.solved);
+    EXPECT_FALSE(solver.getLastStats().interrupted);
+    EXPECT_TRUE(SudokuSolver::verifySolution(empty, solution));
+}
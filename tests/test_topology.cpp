@@ -0,0 +1,91 @@
+/**
+ * @file test_topology.cpp
+ * @brief Tests for compile-time grid topology tables
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuTopology.h"
+#include <set>
+#include <cstdlib>
+
+using namespace sudoku;
+using namespace sudoku::topology;
+
+// Tables are usable in constant expressions
+static_assert(UNITS[0][8] == 8, "First row ends at cell 8");
+static_assert(UNITS[FIRST_COL_UNIT][1] == 9, "First column continues at cell 9");
+static_assert(UNITS[FIRST_BOX_UNIT + 4][0] == 30, "Centre box starts at (3,3)");
+static_assert(ADJACENT_PAIRS[1].second == 9, "Second pair is (0,0)-(1,0)");
+
+// Test: Every unit holds 9 distinct cells and matches its mask
+TEST(TopologyTest, UnitsAreComplete)
+{
+    for (int u = 0; u < NUM_UNITS; u++)
+    {
+        std::set<int> cells(UNITS[u].begin(), UNITS[u].end());
+        EXPECT_EQ(cells.size(), 9u);
+        for (int cell = 0; cell < NUM_CELLS; cell++)
+        {
+            EXPECT_EQ(UNIT_MASKS[u].test(cell), cells.count(cell) == 1);
+        }
+    }
+}
+
+// Test: Peers are exactly the cells sharing a row, column or box
+TEST(TopologyTest, PeersMatchDefinition)
+{
+    for (int cell = 0; cell < NUM_CELLS; cell++)
+    {
+        std::set<int> expected;
+        for (int other = 0; other < NUM_CELLS; other++)
+        {
+            if (other == cell)
+                continue;
+            if (cellRow(other) == cellRow(cell) || cellCol(other) == cellCol(cell) ||
+                cellBox(other) == cellBox(cell))
+            {
+                expected.insert(other);
+            }
+        }
+        std::set<int> actual(PEERS[cell].begin(), PEERS[cell].end());
+        EXPECT_EQ(actual, expected);
+        for (int other = 0; other < NUM_CELLS; other++)
+        {
+            EXPECT_EQ(PEER_MASKS[cell].test(other), expected.count(other) == 1);
+        }
+    }
+}
+
+// Test: Neighbours are orthogonal and corner cells have two
+TEST(TopologyTest, NeighboursAreOrthogonal)
+{
+    EXPECT_EQ(NEIGHBOURS[0].count, 2);
+    EXPECT_EQ(NEIGHBOURS[cellIndex(4, 4)].count, 4);
+    EXPECT_EQ(NEIGHBOURS[cellIndex(0, 4)].count, 3);
+
+    for (int cell = 0; cell < NUM_CELLS; cell++)
+    {
+        for (int adj : NEIGHBOURS[cell])
+        {
+            int dr = std::abs(cellRow(adj) - cellRow(cell));
+            int dc = std::abs(cellCol(adj) - cellCol(cell));
+            EXPECT_EQ(dr + dc, 1);
+        }
+    }
+}
+
+// Test: Adjacent pairs are unique and indexable
+TEST(TopologyTest, AdjacentPairIndexRoundTrips)
+{
+    std::set<std::pair<int, int>> seen;
+    for (int p = 0; p < NUM_ADJACENT_PAIRS; p++)
+    {
+        const auto &pair = ADJACENT_PAIRS[p];
+        EXPECT_LT(pair.first, pair.second);
+        EXPECT_TRUE(seen.insert({pair.first, pair.second}).second);
+        EXPECT_EQ(adjacentPairIndex(pair.first, pair.second), p);
+        EXPECT_EQ(adjacentPairIndex(pair.second, pair.first), p);
+    }
+    EXPECT_EQ(adjacentPairIndex(0, 10), -1);
+    EXPECT_EQ(adjacentPairIndex(8, 9), -1);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file test_writer.cpp
+ * @brief Tests for the buffer-based output writers
+ */
+
+#include <gtest/gtest.h>
+#include "SudokuBinary.h"
+#include "SudokuGenerator.h"
+#include "SudokuJson.h"
+#include "SudokuParser.h"
+#include "SudokuWriter.h"
+#include <sstream>
+#include <string>
+
+using namespace sudoku;
+
+// Test: Grid lines use the parser's symbols and round-trip through the fast path
+TEST(WriterTest, GridLine)
+{
+    const std::string line =
+        "53..7....6..195....98....6.8...6...34..8.3..17...2...6.6....28....419..5....8..79";
+    SudokuPuzzle puzzle = SudokuParser::parseFromString(line);
+
+    char buffer[SudokuWriter::NUM_CELLS];
+    EXPECT_EQ(SudokuWriter::writeGridLine(puzzle.grid, buffer), buffer + 81);
+    EXPECT_EQ(std::string(buffer, 81), line);
+
+    BasicSudokuPuzzle<Geometry16x16> big;
+    big.setCell(0, 0, 16);
+    big.setCell(0, 1, 9);
+    std::string out = "> ";
+    BasicSudokuWriter<Geometry16x16>::appendGridLine(out, big.grid);
+    EXPECT_EQ(out.substr(0, 5), "> G9.");
+    EXPECT_EQ(out.size(), 2u + 256u);
+}
+
+// Test: Text, JSON and binary writers agree with the readers
+TEST(WriterTest, FormatsRoundTrip)
+{
+    GeneratorConfig config;
+    config.type = SudokuType::KILLER_INEQUALITY;
+    config.ensureUniqueSolution = false;
+    config.seed = 5;
+    SudokuGenerator generator;
+    SudokuSolution solution;
+    SudokuPuzzle puzzle = generator.generateWithSolution(config, solution);
+
+    std::string buffer;
+    SudokuWriter::appendCustomFormat(buffer, puzzle, &solution);
+    EXPECT_EQ(buffer, SudokuGenerator::toCustomFormatWithSolution(puzzle, solution));
+    SudokuPuzzle fromText;
+    ASSERT_TRUE(SudokuParser::parseCustomFormat(std::string_view(buffer), fromText));
+    EXPECT_EQ(fromText.cages.size(), puzzle.cages.size());
+
+    buffer.clear();
+    SudokuWriter::appendPuzzleJson(buffer, puzzle);
+    EXPECT_EQ(SudokuJson::writePuzzle(SudokuJson::parsePuzzle(buffer)), buffer);
+
+    buffer.clear();
+    SudokuWriter::appendBinary(buffer, puzzle, &solution);
+    EXPECT_EQ(buffer, SudokuBinary::write(puzzle, &solution));
+}
+
+// Test: A cleared buffer is reused without reallocating
+TEST(WriterTest, ReusesBuffer)
+{
+    SudokuSolution solution;
+    solution.solved = true;
+    solution.solveTimeMs = 1.5;
+    for (int r = 0; r < 9; r++)
+        for (int c = 0; c < 9; c++)
+            solution.grid[r][c] = (r * 3 + r / 3 + c) % 9 + 1;
+
+    std::string buffer;
+    SudokuWriter::appendSolutionJson(buffer, solution, "7");
+    EXPECT_EQ(buffer.rfind("{\"id\":7,\"solved\":true,\"solveTimeMs\":1.500,\"grid\":[[1,2,3,", 0), 0u);
+
+    const char *data = buffer.data();
+    for (int i = 0; i < 100; i++)
+    {
+        buffer.clear();
+        SudokuWriter::appendSolutionJson(buffer, solution, "7");
+    }
+    EXPECT_EQ(buffer.data(), data);
+}
+
+// Test: Numbers match what the stream-based output produced
+TEST(WriterTest, NumberFormatting)
+{
+    for (double value : {0.0, 1.5, 15.500123, 0.000123456, 123456789.0, 2.0 / 3.0})
+    {
+        std::ostringstream expected;
+        expected << value;
+        std::string actual;
+        SudokuWriter::appendGeneral(actual, value);
+        EXPECT_EQ(actual, expected.str());
+    }
+
+    std::string out;
+    SudokuWriter::appendInt(out, -42);
+    SudokuWriter::appendFixed(out, 2.0 / 3.0, 3);
+    EXPECT_EQ(out, "-420.667");
+}
@@ -0,0 +1,62 @@
+/**
+ * @file wasm_smoke.js
+ * @brief Headless smoke test of the pthreads WebAssembly module under Node
+ *
+ * Usage: node tests/wasm_smoke.js path/to/sudoku_wasm_mt.js
+ *
+ * Generates a mixed puzzle on the worker pool, then checks that it solves
+ * back to the generated solution with a unique result, and that a batch
+ * generated on several threads starts with the same puzzle.
+ */
+
+const path = require('path');
+
+const STATUS_UNIQUE = 2;
+
+async function main() {
+    const createSudokuModule = require(path.resolve(process.argv[2]));
+    const module = await createSudokuModule();
+
+    const threads = module.getThreadCount();
+    console.log('threads: ' + threads);
+
+    const started = Date.now();
+    const status = module.generateGrid('mixed', 10, 15, 20, 30, 12345, false, true, 80);
+    if (status < 0) {
+        throw new Error('generateGrid failed: ' + module.getLastError());
+    }
+    console.log('generated in ' + (Date.now() - started) + ' ms');
+
+    const expected = Array.from(module.getBuffers().solution);
+    if (module.solveGrid(true) !== STATUS_UNIQUE) {
+        throw new Error('generated puzzle is not unique: ' + module.getLastError());
+    }
+    const solved = Array.from(module.getBuffers().solution);
+    if (solved.join('') !== expected.join('')) {
+        throw new Error('solution does not match the generated one');
+    }
+    if (!module.verifyGrid()) {
+        throw new Error('verifyGrid rejected the solution');
+    }
+
+    const batchStarted = Date.now();
+    const batch = module.generateBatch({
+        type: 'mixed', minCages: 10, maxCages: 15, minInequalities: 20, maxInequalities: 30,
+        seed: 12345, difficulty: 80
+    }, 4);
+    console.log('batch of ' + batch.length + ' in ' + (Date.now() - batchStarted) + ' ms');
+    if (batch.length !== 4) {
+        throw new Error('generateBatch returned ' + batch.length + ' puzzles: ' + module.getLastError());
+    }
+    if (Array.from(batch[0].solution).join('') !== expected.join('')) {
+        throw new Error('first batch puzzle differs from generateGrid with the same seed');
+    }
+}
+
+// The worker pool keeps Node alive, so exit explicitly
+main().then(
+    () => process.exit(0),
+    (err) => {
+        console.error(err.message);
+        process.exit(1);
+    });